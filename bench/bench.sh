@@ -0,0 +1,196 @@
+#!/bin/bash
+################################################################################
+# SCRIPT FILE: bench.sh
+#
+# PROGRAM: Covert
+#
+# DATE: October 18, 2026
+#
+# DESIGNER: Karl Castillo (c)
+#
+# PROGRAMMER: Karl Castillo (c)
+#
+# USAGE: bench.sh [bin directory]
+#
+# NOTES:
+# End-to-end benchmark. The client and the server run in two network
+# namespaces joined by a veth pair, so the packets cross a real link without
+# touching the host's interfaces. Every combination of payload size, path
+# condition and mode is run once: a random payload is sent, the server output
+# is compared byte for byte, and one CSV row is written per run.
+#
+# The throughput is measured from the start of the client until the whole
+# payload is in the server's output file. CPU per byte is the user + system
+# time of each side over the payload size.
+#
+# Settings come from the environment:
+#       SIZES   payload sizes, as head -c takes them   (64K 1M 4M)
+#       NETEMS  path conditions, netem arguments or none,
+#               separated by commas                     (none,delay 1ms,
+#                                                        loss 1%)
+#       MODES   blind, feedback or fec                  (blind feedback)
+#       LAYOUT  the layout both sides use               (id,seq)
+#       RATE    the client rate                         (0, unpaced)
+#       CARGS   more client arguments
+#       SARGS   more server arguments
+#       OUT     where the rows go                       (bin/bench.csv)
+#       TIMEOUT seconds a run may take                  (60)
+# A path condition the kernel cannot emulate, when sch_netem is missing, is
+# reported with status skipped instead of failing the whole run.
+################################################################################
+
+BDIR=${1:-./bin}
+SIZES=${SIZES:-64K 1M 4M}
+NETEMS=${NETEMS:-none,delay 1ms,loss 1%}
+MODES=${MODES:-blind feedback}
+LAYOUT=${LAYOUT:-id,seq}
+RATE=${RATE:-0}
+OUT=${OUT:-$BDIR/bench.csv}
+TIMEOUT=${TIMEOUT:-60}
+
+CNS=covert-bench-c
+SNS=covert-bench-s
+CIP=10.203.0.1
+SIP=10.203.0.2
+PORT=8000
+FEED_PORT=9000
+
+if [ "$(id -u)" != 0 ]; then
+        echo "The benchmark must run as root" >&2
+        exit 1
+fi
+if [ ! -x "$BDIR/client" ] || [ ! -x "$BDIR/server" ]; then
+        echo "Build the client and the server first" >&2
+        exit 1
+fi
+BDIR=$(cd "$BDIR" && pwd)
+
+TMP=$(mktemp -d)
+
+cleanup() {
+        ip netns pids $SNS 2>/dev/null | xargs -r kill -9
+        ip netns pids $CNS 2>/dev/null | xargs -r kill -9
+        ip netns del $CNS 2>/dev/null
+        ip netns del $SNS 2>/dev/null
+        rm -rf "$TMP"
+}
+trap cleanup EXIT
+trap 'exit 1' INT TERM
+
+# two namespaces and the link between them
+ip netns del $CNS 2>/dev/null
+ip netns del $SNS 2>/dev/null
+ip netns add $CNS && ip netns add $SNS &&
+        ip link add cvt-c type veth peer name cvt-s &&
+        ip link set cvt-c netns $CNS && ip link set cvt-s netns $SNS &&
+        ip -n $CNS addr add $CIP/24 dev cvt-c &&
+        ip -n $SNS addr add $SIP/24 dev cvt-s &&
+        ip -n $CNS link set cvt-c up && ip -n $SNS link set cvt-s up &&
+        ip -n $CNS link set lo up && ip -n $SNS link set lo up
+if [ $? != 0 ]; then
+        echo "Cannot create the namespaces and the veth pair" >&2
+        exit 1
+fi
+
+BUILD=$(git describe --always --dirty 2>/dev/null || echo unknown)
+if [ ! -s "$OUT" ]; then
+        printf "%s,%s,%s\n" "build,layout,mode,netem,bytes,packets,seconds" \
+                "bytes_per_s,packets_per_s,client_ns_per_byte" \
+                "server_ns_per_byte,correct,status" > "$OUT"
+fi
+
+# run SIZE NETEM MODE
+run() {
+        local size=$1 netem=$2 mode=$3
+        local in=$TMP/in.bin out=$TMP/out.bin
+        local cargs="-S $CIP -D $SIP -d $PORT -L $LAYOUT -r $RATE $CARGS"
+        local sargs="-S $CIP -s $PORT -L $LAYOUT -i 2 $SARGS"
+        local bytes packets start end seconds ccpu scpu correct status=ok
+
+        head -c "$size" /dev/urandom > "$in"
+        bytes=$(stat -c %s "$in")
+        rm -f "$out"
+
+        case $mode in
+        feedback)
+                cargs="$cargs -A $FEED_PORT"
+                sargs="$sargs -A $FEED_PORT"
+                ;;
+        fec)
+                cargs="$cargs -E 16:2"
+                sargs="$sargs -E 16:2"
+                ;;
+        esac
+
+        ( TIMEFORMAT='%3U %3S'; time ip netns exec $SNS "$BDIR/server" \
+                $sargs -f "$out" > "$TMP/server.log" 2>&1 ) \
+                2> "$TMP/server.time" &
+        sleep 0.3
+
+        start=$(date +%s%N)
+        ( TIMEFORMAT='%3U %3S'; time timeout "$TIMEOUT" ip netns exec $CNS \
+                "$BDIR/client" $cargs -f "$in" > "$TMP/client.log" 2>&1 ) \
+                2> "$TMP/client.time"
+        while [ "$(stat -c %s "$out" 2>/dev/null || echo 0)" -lt "$bytes" ] &&
+                        [ $(( ($(date +%s%N) - start) / 1000000000 )) -lt \
+                        "$TIMEOUT" ]; do
+                sleep 0.01
+        done
+        end=$(date +%s%N)
+
+        ip netns pids $SNS | xargs -r kill -INT
+        wait
+
+        if cmp -s "$in" "$out"; then
+                correct=1
+        else
+                correct=0
+                status=mismatch
+        fi
+        packets=$(awk '/^Sent [0-9]+ packets/ { print $2 }' "$TMP/client.log")
+        seconds=$(awk -v ns=$((end - start)) 'BEGIN { printf "%.3f", ns / 1e9 }')
+        ccpu=$(awk '{ print $1 + $2 }' "$TMP/client.time")
+        scpu=$(awk '{ print $1 + $2 }' "$TMP/server.time")
+
+        awk -v build="$BUILD" -v layout="$LAYOUT" -v mode="$mode" \
+                -v netem="$netem" -v bytes="$bytes" -v packets="${packets:-0}" \
+                -v seconds="$seconds" -v ccpu="${ccpu:-0}" \
+                -v scpu="${scpu:-0}" -v correct=$correct -v status=$status \
+                'BEGIN {
+                        printf "%s,\"%s\",%s,\"%s\",%d,%d,%.3f,%.0f,%.0f,%.2f,%.2f,%d,%s\n",
+                                build, layout, mode, netem, bytes, packets,
+                                seconds, bytes / seconds, packets / seconds,
+                                ccpu * 1e9 / bytes, scpu * 1e9 / bytes,
+                                correct, status
+                }' | tee -a "$OUT"
+}
+
+# skip SIZE NETEM MODE
+skip() {
+        local bytes=$(head -c "$1" /dev/zero | wc -c)
+
+        echo "$BUILD,\"$LAYOUT\",$3,\"$2\",$bytes,0,0,0,0,0,0,0,skipped" |
+                tee -a "$OUT"
+}
+
+IFS=, read -r -a conditions <<< "$NETEMS"
+for netem in "${conditions[@]}"; do
+        usable=1
+        if [ "$netem" = none ]; then
+                ip netns exec $CNS tc qdisc del dev cvt-c root 2>/dev/null
+        elif ! ip netns exec $CNS tc qdisc replace dev cvt-c root netem \
+                        $netem 2>/dev/null; then
+                echo "netem $netem is not available, skipped" >&2
+                usable=0
+        fi
+
+        for size in $SIZES; do
+                for mode in $MODES; do
+                        if [ $usable = 1 ]; then
+                                run "$size" "$netem" "$mode"
+                        else
+                                skip "$size" "$netem" "$mode"
+                        fi
+                done
+        done
+done
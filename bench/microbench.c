@@ -0,0 +1,878 @@
+/*******************************************************************************
+* SOURCE FILE: microbench.c
+*
+* PROGRAM: Covert
+*
+* FUNCTIONS:
+* int main(int argc, char* argv[]);
+* static int checkCksum(PPRNG prng);
+* static int checkOne(unsigned char *buffer, int offset, int nbytes);
+* static void benchTemplate(PTEMPLATE template, PLAYOUT layout, PPRNG prng);
+* static void measure(PKERNEL kernel, PCOUNTER counter, int ms,
+*        PRESULT result);
+* static void runCksum(PKERNEL kernel);
+* static void runBuild(PKERNEL kernel);
+* static void runDecode(PKERNEL kernel);
+* static void counterOpen(PCOUNTER counter);
+* static unsigned long long counterRead(PCOUNTER counter);
+* static long long benchClock(void);
+* static int baselineRead(char *name, PRESULT results, int count);
+* static int resultsWrite(char *name, PRESULT results, int count,
+*        PCOUNTER counter, int ms);
+*
+* DATE: October 18, 2026
+*
+* DESIGNER: Karl Castillo (c)
+*
+* PROGRAMMER: Karl Castillo (c)
+*
+* USAGE: microbench [-o json] [-c baseline json] [-t ms]
+*
+* NOTES:
+* Per-packet cost of the kernels on the hot paths, away from the network:
+* the checksum, the header build of the client and the decode of the server.
+* Every kernel is run over batches of distinct packets, the way the sender
+* and the capture hand them over, and for every batch size the fastest of
+* REPS repetitions is kept.
+*
+* Cycles come from the CPU cycle counter when perf events are allowed, from
+* the time stamp counter otherwise, which ticks at a fixed rate whatever the
+* clock of the core is.
+*
+* The vector checksums are compared with in_cksum before anything is timed;
+* a mismatch ends the run with 1. The results are written as JSON, one result
+* per line, and a file from an earlier build can be given to compare with.
+*******************************************************************************/
+/* INCLUDES */
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include <time.h>
+#include <unistd.h>
+#include <sys/syscall.h>
+#include <linux/perf_event.h>
+#include <arpa/inet.h>
+#include "cksum.h"
+#include "codec.h"
+#include "prng.h"
+#include "template.h"
+
+#if defined(__x86_64__) || defined(__i386__)
+#include <x86intrin.h>
+#define BENCH_TSC
+#endif
+
+/* DEFINES */
+#define DEF_OUT         "microbench.json"
+#define DEF_MS          20      /* ms each repetition runs for at least */
+#define REPS            5       /* repetitions, the fastest is kept */
+#define MAX_RESULTS     128
+#define MAX_PACKET      1500    /* the largest buffer checksummed */
+#define CHECK_LEN       2048    /* every length up to this is cross-checked */
+#define CHECK_BIG       (1 << 20) /* and one buffer this large */
+#define CYCLES_NONE     0
+#define CYCLES_TSC      1
+#define CYCLES_PERF     2
+
+/* STRUCTURES */
+typedef struct counter {
+        int source;                     /* CYCLES_PERF, _TSC or _NONE */
+        int fd;                         /* the perf event, or -1 */
+} COUNTER, *PCOUNTER;
+
+typedef struct result {
+        char kernel[32];                /* what was measured */
+        char layout[64];                /* the layout, - for checksums */
+        int bytes;                      /* bytes per packet */
+        int batch;                      /* packets per batch */
+        double ns;                      /* per packet, fastest repetition */
+        double cycles;                  /* per packet, -1 unknown */
+        double base;                    /* ns of the baseline, 0 none */
+} RESULT, *PRESULT;
+
+typedef struct kernel {
+        void (*run)(struct kernel *kernel); /* one batch */
+        int batch;                      /* packets per batch */
+        int bytes;                      /* bytes per packet */
+        unsigned char *buffer;          /* the packets, bytes apart */
+        unsigned short (*cksum)(unsigned short *ptr, int nbytes);
+        PTEMPLATE template;             /* builds the packets */
+        PLAYOUT layout;                 /* decodes them */
+        const void **packets;           /* the packets to decode */
+        unsigned long long *words;      /* built from, or decoded into */
+        unsigned int seq;               /* the next packet built */
+        unsigned int sink;              /* keeps the checksums alive */
+} KERNEL, *PKERNEL;
+
+/* PROTOTYPES */
+static int checkCksum(PPRNG prng);
+static int checkOne(unsigned char *buffer, int offset, int nbytes);
+static void benchTemplate(PTEMPLATE template, PLAYOUT layout, PPRNG prng);
+static void measure(PKERNEL kernel, PCOUNTER counter, int ms,
+        PRESULT result);
+static void runCksum(PKERNEL kernel);
+static void runBuild(PKERNEL kernel);
+static void runDecode(PKERNEL kernel);
+static void counterOpen(PCOUNTER counter);
+static unsigned long long counterRead(PCOUNTER counter);
+static long long benchClock(void);
+static int baselineRead(char *name, PRESULT results, int count);
+static int resultsWrite(char *name, PRESULT results, int count,
+        PCOUNTER counter, int ms);
+
+/* GLOBALS */
+static const int batches[] = { 1, 16, 64, 256, MAX_BATCH }; /* 64 is the
+                                        default receive batch */
+static const int sizes[] = { 20, 32, 60, MAX_PACKET }; /* IP header, IPv4
+                                        and IPv6 TCP pseudo-header, a frame */
+static char *layouts[] = { "id,seq", "tos,ttl,id,seq", "tc,flow,seq" };
+static char *cksums[] = { "cksum_scalar", "cksum_sse2", "cksum_avx2" };
+
+/*******************************************************************************
+* FUNCTION: main
+*
+* DATE: October 18, 2026
+*
+* REVISIONS: (Date and Description)
+*
+* DESIGNER: Karl Castillo (c)
+*
+* PROGRAMMER: Karl Castillo (c)
+*
+* INTERFACE: int main(int argc, char* argv[])
+* argc: number of arguments
+* argv: the arguments
+*
+* RETURN: int
+* 0: the benchmark ran
+* 1: a vector checksum differs from in_cksum
+* 2: invalid arguments or the baseline cannot be read
+* 3: cannot allocate the buffers
+* 4: cannot write the results
+*
+* NOTES:
+* The checksums the CPU cannot run are left out of the results.
+*******************************************************************************/
+int main(int argc, char* argv[])
+{
+        unsigned short (*functions[])(unsigned short *ptr, int nbytes) = {
+                in_cksum, cksumSse2, cksumAvx2 };
+        char *out_name = DEF_OUT;
+        char *base_name = NULL;
+        int ms = DEF_MS;
+        int option = 0;
+        int level = cksumLevel();
+        int count = 0;
+        unsigned long long mask;
+        RESULT results[MAX_RESULTS];
+        PRESULT result;
+        COUNTER counter;
+        KERNEL kernel;
+        TEMPLATE template;
+        LAYOUT layout;
+        PRNG prng;
+        int c;
+        int s;
+        int b;
+        int l;
+        int i;
+
+        while((option = getopt(argc, argv, ":o:c:t:")) != -1) {
+                switch(option) {
+                case 'o': /* where the results go */
+                        out_name = optarg;
+                        break;
+                case 'c': /* results to compare with */
+                        base_name = optarg;
+                        break;
+                case 't': /* ms per repetition */
+                        ms = atoi(optarg);
+                        break;
+                }
+        }
+
+        if(ms < 1) {
+                printf("Repetitions must last at least 1 ms\n");
+                return 2;
+        }
+
+        prngSeed(&prng, 1);
+        if(checkCksum(&prng) < 0) {
+                return 1;
+        }
+
+        memset(&kernel, 0, sizeof(kernel));
+        kernel.buffer = (unsigned char*)malloc(MAX_BATCH * MAX_PACKET);
+        kernel.packets = (const void**)malloc(MAX_BATCH * sizeof(void*));
+        kernel.words = (unsigned long long*)malloc(MAX_BATCH *
+                sizeof(unsigned long long));
+        if(kernel.buffer == NULL || kernel.packets == NULL ||
+                        kernel.words == NULL) {
+                perror("Cannot allocate the buffers");
+                return 3;
+        }
+        for(i = 0; i < MAX_BATCH * MAX_PACKET; i++) {
+                kernel.buffer[i] = (unsigned char)prngNext(&prng);
+        }
+
+        counterOpen(&counter);
+        printf("Cycles: %s\n", counter.source == CYCLES_PERF ? "perf" :
+                counter.source == CYCLES_TSC ? "tsc" : "none");
+        printf("%-14s %-16s %6s %6s %10s %10s\n", "Kernel", "Layout", "Bytes",
+                "Batch", "ns/pkt", "cyc/pkt");
+
+        kernel.run = runCksum;
+        for(c = 0; c <= level && c < 3; c++) {
+                kernel.cksum = functions[c];
+                for(s = 0; s < (int)(sizeof(sizes) / sizeof(int)); s++) {
+                        kernel.bytes = sizes[s];
+                        for(b = 0; b < (int)(sizeof(batches) / sizeof(int));
+                                        b++) {
+                                kernel.batch = batches[b];
+                                result = &results[count++];
+                                strcpy(result->kernel, cksums[c]);
+                                strcpy(result->layout, "-");
+                                measure(&kernel, &counter, ms, result);
+                        }
+                }
+        }
+
+        for(l = 0; l < (int)(sizeof(layouts) / sizeof(char*)); l++) {
+                if(layoutParse(layouts[l], &layout) < 0) {
+                        continue;
+                }
+                benchTemplate(&template, &layout, &prng);
+                mask = layout.bits == 64 ? ~0ULL : (1ULL << layout.bits) - 1;
+                kernel.template = &template;
+                kernel.layout = &layout;
+                kernel.bytes = template.size;
+                for(b = 0; b < (int)(sizeof(batches) / sizeof(int)); b++) {
+                        kernel.batch = batches[b];
+                        for(i = 0; i < kernel.batch; i++) {
+                                kernel.words[i] = (((unsigned long long)
+                                        prngNext(&prng) << 32) |
+                                        prngNext(&prng)) & mask;
+                                kernel.packets[i] = kernel.buffer +
+                                        i * kernel.bytes;
+                        }
+
+                        kernel.run = runBuild;
+                        result = &results[count++];
+                        strcpy(result->kernel, "build");
+                        strcpy(result->layout, layout.name);
+                        measure(&kernel, &counter, ms, result);
+
+                        kernel.run = runDecode;
+                        result = &results[count++];
+                        strcpy(result->kernel, "decode");
+                        strcpy(result->layout, layout.name);
+                        measure(&kernel, &counter, ms, result);
+                }
+        }
+
+        if(base_name != NULL && baselineRead(base_name, results, count) < 0) {
+                fprintf(stderr, "Cannot read the baseline %s\n", base_name);
+                return 2;
+        }
+
+        for(i = 0; i < count; i++) {
+                result = &results[i];
+                printf("%-14s %-16s %6d %6d %10.2f ", result->kernel,
+                        result->layout, result->bytes, result->batch,
+                        result->ns);
+                if(result->cycles < 0) {
+                        printf("%10s", "-");
+                } else {
+                        printf("%10.2f", result->cycles);
+                }
+                if(result->base > 0) {
+                        printf("   %.2fx of the baseline",
+                                result->base / result->ns);
+                }
+                printf("\n");
+        }
+
+        if(resultsWrite(out_name, results, count, &counter, ms) < 0) {
+                perror("Cannot write the results");
+                return 4;
+        }
+        printf("Results: %s\n", out_name);
+
+        free(kernel.buffer);
+        free(kernel.packets);
+        free(kernel.words);
+        if(counter.fd >= 0) {
+                close(counter.fd);
+        }
+
+        return 0;
+}
+
+/*******************************************************************************
+* FUNCTION: checkCksum
+*
+* DATE: October 18, 2026
+*
+* REVISIONS: (Date and Description)
+*
+* DESIGNER: Karl Castillo (c)
+*
+* PROGRAMMER: Karl Castillo (c)
+*
+* INTERFACE: static int checkCksum(PPRNG prng)
+* prng: fills the buffers
+*
+* RETURN: int
+* 0: the vector checksums match in_cksum
+* -1: one of them does not
+*
+* NOTES:
+* Random bytes at every length up to CHECK_LEN, odd ones included, from
+* every 16-bit offset of a vector so the loads are unaligned as often as
+* not. Then all ones, where the lanes come closest to overflowing, up to a
+* buffer large enough to be summed in several blocks.
+*******************************************************************************/
+static int checkCksum(PPRNG prng)
+{
+        unsigned char *buffer = (unsigned char*)malloc(CHECK_BIG + 32);
+        int checked = 0;
+        int length;
+        int offset;
+        int i;
+
+        if(buffer == NULL) {
+                perror("Cannot allocate the buffers");
+                return -1;
+        }
+
+        for(i = 0; i < CHECK_BIG + 32; i++) {
+                buffer[i] = (unsigned char)prngNext(prng);
+        }
+        for(length = 0; length <= CHECK_LEN; length++) {
+                for(offset = 0; offset < 32; offset += 2, checked++) {
+                        if(checkOne(buffer, offset, length) < 0) {
+                                free(buffer);
+                                return -1;
+                        }
+                }
+        }
+
+        memset(buffer, 0xff, CHECK_BIG + 32);
+        for(length = CHECK_LEN; length <= CHECK_BIG; length = length * 4 + 1,
+                        checked++) {
+                if(checkOne(buffer, 0, length) < 0) {
+                        free(buffer);
+                        return -1;
+                }
+        }
+        if(checkOne(buffer, 2, CHECK_BIG) < 0) {
+                free(buffer);
+                return -1;
+        }
+        checked++;
+
+        printf("Cross-check: %d buffers, %s\n", checked,
+                cksumLevel() == CKSUM_AVX2 ? "SSE2 and AVX2 match in_cksum" :
+                cksumLevel() == CKSUM_SSE2 ? "SSE2 matches in_cksum" :
+                "no vector unit to check");
+        free(buffer);
+
+        return 0;
+}
+
+/*******************************************************************************
+* FUNCTION: checkOne
+*
+* DATE: October 18, 2026
+*
+* REVISIONS: (Date and Description)
+*
+* DESIGNER: Karl Castillo (c)
+*
+* PROGRAMMER: Karl Castillo (c)
+*
+* INTERFACE: static int checkOne(unsigned char *buffer, int offset,
+*       int nbytes)
+* buffer: the bytes
+* offset: where the checksummed ones start
+* nbytes: how many are checksummed
+*
+* RETURN: int
+* 0: every checksum the CPU runs gives what in_cksum gives
+* -1: otherwise, and the difference is shown
+*******************************************************************************/
+static int checkOne(unsigned char *buffer, int offset, int nbytes)
+{
+        unsigned short *ptr = (unsigned short*)(buffer + offset);
+        unsigned short want = in_cksum(ptr, nbytes);
+        unsigned short sse2 = want;
+        unsigned short avx2 = want;
+
+        if(cksumLevel() >= CKSUM_SSE2) {
+                sse2 = cksumSse2(ptr, nbytes);
+        }
+        if(cksumLevel() >= CKSUM_AVX2) {
+                avx2 = cksumAvx2(ptr, nbytes);
+        }
+
+        if(sse2 != want || avx2 != want) {
+                fprintf(stderr, "Checksum mismatch: %d bytes at offset %d, "
+                        "in_cksum %04x, sse2 %04x, avx2 %04x\n", nbytes,
+                        offset, want, sse2, avx2);
+                return -1;
+        }
+
+        return 0;
+}
+
+/*******************************************************************************
+* FUNCTION: benchTemplate
+*
+* DATE: October 18, 2026
+*
+* REVISIONS: (Date and Description)
+*
+* DESIGNER: Karl Castillo (c)
+*
+* PROGRAMMER: Karl Castillo (c)
+*
+* INTERFACE: static void benchTemplate(PTEMPLATE template, PLAYOUT layout,
+*       PPRNG prng)
+* template: the template to set up
+* layout: the fields it patches, and its family
+* prng: the generator of the template
+*
+* RETURN: void
+*
+* NOTES:
+* The headers the client starts a transfer with, as createIphdr,
+* createIp6hdr and createTcphdr make them. They are made once per transfer,
+* so it is the template built from them that is timed. The self-check is off.
+*******************************************************************************/
+static void benchTemplate(PTEMPLATE template, PLAYOUT layout, PPRNG prng)
+{
+        struct iphdr ip;
+        struct ip6_hdr ip6;
+        struct tcphdr tcp;
+
+        memset(&tcp, 0, sizeof(tcp));
+        tcp.source = htons(8000);
+        tcp.dest = htons(8000);
+        tcp.seq = prngNext(prng);
+        tcp.doff = 5;
+        tcp.syn = 1;
+        tcp.window = htons(FLOW_WINDOW);
+
+        if(layout->family == AF_INET6) {
+                memset(&ip6, 0, sizeof(ip6));
+                ip6.ip6_flow = htonl(6 << 28);
+                ip6.ip6_plen = htons(sizeof(struct tcphdr));
+                ip6.ip6_nxt = IPPROTO_TCP;
+                ip6.ip6_hlim = 64;
+                inet_pton(AF_INET6, "fd00::1", &ip6.ip6_src);
+                inet_pton(AF_INET6, "fd00::2", &ip6.ip6_dst);
+                templateInit6(template, ip6, tcp, layout, prng, 0);
+        } else {
+                memset(&ip, 0, sizeof(ip));
+                ip.ihl = 5;
+                ip.version = 4;
+                ip.tot_len = htons(40);
+                ip.id = (unsigned short)prngNext(prng);
+                ip.ttl = 64;
+                ip.protocol = IPPROTO_TCP;
+                ip.saddr = inet_addr("10.0.0.1");
+                ip.daddr = inet_addr("10.0.0.2");
+                templateInit(template, ip, tcp, layout, prng, 0);
+        }
+}
+
+/*******************************************************************************
+* FUNCTION: measure
+*
+* DATE: October 18, 2026
+*
+* REVISIONS: (Date and Description)
+*
+* DESIGNER: Karl Castillo (c)
+*
+* PROGRAMMER: Karl Castillo (c)
+*
+* INTERFACE: static void measure(PKERNEL kernel, PCOUNTER counter, int ms,
+*       PRESULT result)
+* kernel: what is timed
+* counter: counts the cycles
+* ms: how long a repetition lasts at least
+* result: where the fastest repetition is kept
+*
+* RETURN: void
+*
+* NOTES:
+* The batches per repetition are doubled until a repetition lasts ms, so the
+* clock is read once per repetition rather than once per batch; the first
+* repetitions also warm up the caches and the branch predictors.
+*******************************************************************************/
+static void measure(PKERNEL kernel, PCOUNTER counter, int ms,
+        PRESULT result)
+{
+        long long budget = ms * 1000000LL;
+        long long start;
+        long long elapsed;
+        unsigned long long cycles;
+        double packets;
+        long rounds = 1;
+        long i;
+        int rep;
+
+        for(;;) {
+                start = benchClock();
+                for(i = 0; i < rounds; i++) {
+                        kernel->run(kernel);
+                }
+                if(benchClock() - start >= budget) {
+                        break;
+                }
+                rounds *= 2;
+        }
+
+        packets = (double)rounds * kernel->batch;
+        result->ns = -1;
+        for(rep = 0; rep < REPS; rep++) {
+                cycles = counterRead(counter);
+                start = benchClock();
+                for(i = 0; i < rounds; i++) {
+                        kernel->run(kernel);
+                }
+                elapsed = benchClock() - start;
+                cycles = counterRead(counter) - cycles;
+
+                if(result->ns < 0 || elapsed / packets < result->ns) {
+                        result->ns = elapsed / packets;
+                        result->cycles = counter->source == CYCLES_NONE ?
+                                -1 : cycles / packets;
+                }
+        }
+
+        result->bytes = kernel->bytes;
+        result->batch = kernel->batch;
+        result->base = 0;
+}
+
+/*******************************************************************************
+* FUNCTION: runCksum
+*
+* DATE: October 18, 2026
+*
+* REVISIONS: (Date and Description)
+*
+* DESIGNER: Karl Castillo (c)
+*
+* PROGRAMMER: Karl Castillo (c)
+*
+* INTERFACE: static void runCksum(PKERNEL kernel)
+* kernel: the checksum and the packets
+*
+* RETURN: void
+*******************************************************************************/
+static void runCksum(PKERNEL kernel)
+{
+        unsigned char *packet = kernel->buffer;
+        int i;
+
+        for(i = 0; i < kernel->batch; i++) {
+                kernel->sink += kernel->cksum((unsigned short*)packet,
+                        kernel->bytes);
+                packet += kernel->bytes;
+        }
+}
+
+/*******************************************************************************
+* FUNCTION: runBuild
+*
+* DATE: October 18, 2026
+*
+* REVISIONS: (Date and Description)
+*
+* DESIGNER: Karl Castillo (c)
+*
+* PROGRAMMER: Karl Castillo (c)
+*
+* INTERFACE: static void runBuild(PKERNEL kernel)
+* kernel: the template, the words and where the packets go
+*
+* RETURN: void
+*
+* NOTES:
+* What the client does for every packet it sends.
+*******************************************************************************/
+static void runBuild(PKERNEL kernel)
+{
+        int i;
+
+        for(i = 0; i < kernel->batch; i++) {
+                templateBuild(kernel->template, kernel->buffer +
+                        i * kernel->bytes, kernel->seq++, kernel->words[i],
+                        -1);
+        }
+}
+
+/*******************************************************************************
+* FUNCTION: runDecode
+*
+* DATE: October 18, 2026
+*
+* REVISIONS: (Date and Description)
+*
+* DESIGNER: Karl Castillo (c)
+*
+* PROGRAMMER: Karl Castillo (c)
+*
+* INTERFACE: static void runDecode(PKERNEL kernel)
+* kernel: the layout and the packets
+*
+* RETURN: void
+*
+* NOTES:
+* What doDecoding does for every batch the capture returns. The packets are
+* the ones runBuild left in the buffer.
+*******************************************************************************/
+static void runDecode(PKERNEL kernel)
+{
+        layoutDecode(kernel->layout, kernel->packets, kernel->words,
+                kernel->batch);
+}
+
+/*******************************************************************************
+* FUNCTION: counterOpen
+*
+* DATE: October 18, 2026
+*
+* REVISIONS: (Date and Description)
+*
+* DESIGNER: Karl Castillo (c)
+*
+* PROGRAMMER: Karl Castillo (c)
+*
+* INTERFACE: static void counterOpen(PCOUNTER counter)
+* counter: the counter to open
+*
+* RETURN: void
+*
+* NOTES:
+* Virtual machines often let the event be opened without counting anything,
+* so the counter must also be seen to move before it is trusted.
+*******************************************************************************/
+static void counterOpen(PCOUNTER counter)
+{
+        struct perf_event_attr attr;
+        unsigned long long before;
+        long long start;
+
+        memset(&attr, 0, sizeof(attr));
+        attr.type = PERF_TYPE_HARDWARE;
+        attr.size = sizeof(attr);
+        attr.config = PERF_COUNT_HW_CPU_CYCLES;
+        attr.exclude_kernel = 1;
+        attr.exclude_hv = 1;
+
+        counter->fd = syscall(SYS_perf_event_open, &attr, 0, -1, -1, 0);
+        if(counter->fd >= 0) {
+                counter->source = CYCLES_PERF;
+                before = counterRead(counter);
+                start = benchClock();
+                while(benchClock() - start < 1000000);
+                if(counterRead(counter) != before) {
+                        return;
+                }
+                close(counter->fd);
+                counter->fd = -1;
+        }
+
+#ifdef BENCH_TSC
+        counter->source = CYCLES_TSC;
+#else
+        counter->source = CYCLES_NONE;
+#endif
+}
+
+/*******************************************************************************
+* FUNCTION: counterRead
+*
+* DATE: October 18, 2026
+*
+* REVISIONS: (Date and Description)
+*
+* DESIGNER: Karl Castillo (c)
+*
+* PROGRAMMER: Karl Castillo (c)
+*
+* INTERFACE: static unsigned long long counterRead(PCOUNTER counter)
+* counter: the counter
+*
+* RETURN: unsigned long long: the cycles so far, 0 when there is no counter
+*******************************************************************************/
+static unsigned long long counterRead(PCOUNTER counter)
+{
+        unsigned long long count = 0;
+
+        if(counter->source == CYCLES_PERF) {
+                if(read(counter->fd, &count, sizeof(count)) !=
+                                sizeof(count)) {
+                        count = 0;
+                }
+        }
+#ifdef BENCH_TSC
+        else if(counter->source == CYCLES_TSC) {
+                count = __rdtsc();
+        }
+#endif
+
+        return count;
+}
+
+/*******************************************************************************
+* FUNCTION: benchClock
+*
+* DATE: October 18, 2026
+*
+* REVISIONS: (Date and Description)
+*
+* DESIGNER: Karl Castillo (c)
+*
+* PROGRAMMER: Karl Castillo (c)
+*
+* INTERFACE: static long long benchClock(void)
+*
+* RETURN: long long: the monotonic clock, ns
+*******************************************************************************/
+static long long benchClock(void)
+{
+        struct timespec now;
+
+        clock_gettime(CLOCK_MONOTONIC, &now);
+        return now.tv_sec * 1000000000LL + now.tv_nsec;
+}
+
+/*******************************************************************************
+* FUNCTION: baselineRead
+*
+* DATE: October 18, 2026
+*
+* REVISIONS: (Date and Description)
+*
+* DESIGNER: Karl Castillo (c)
+*
+* PROGRAMMER: Karl Castillo (c)
+*
+* INTERFACE: static int baselineRead(char *name, PRESULT results, int count)
+* name: results written by an earlier run
+* results: the results of this run
+* count: how many there are
+*
+* RETURN: int
+* 0: the baseline was read; every result it also has gets its time in base
+* -1: the file cannot be opened
+*
+* NOTES:
+* Only files written by resultsWrite are understood: one result per line,
+* the keys always in the same order.
+*******************************************************************************/
+static int baselineRead(char *name, PRESULT results, int count)
+{
+        FILE *in;
+        char line[256];
+        char kernel[32];
+        char layout[64];
+        int bytes;
+        int batch;
+        double ns;
+        int i;
+
+        if((in = fopen(name, "r")) == NULL) {
+                return -1;
+        }
+
+        while(fgets(line, sizeof(line), in) != NULL) {
+                if(sscanf(line, " {\"kernel\": \"%31[^\"]\", \"layout\": "
+                                "\"%63[^\"]\", \"bytes\": %d, \"batch\": %d, "
+                                "\"ns_per_packet\": %lf", kernel, layout,
+                                &bytes, &batch, &ns) != 5) {
+                        continue;
+                }
+                for(i = 0; i < count; i++) {
+                        if(strcmp(results[i].kernel, kernel) == 0 &&
+                                        strcmp(results[i].layout, layout) ==
+                                        0 && results[i].bytes == bytes &&
+                                        results[i].batch == batch) {
+                                results[i].base = ns;
+                        }
+                }
+        }
+        fclose(in);
+
+        return 0;
+}
+
+/*******************************************************************************
+* FUNCTION: resultsWrite
+*
+* DATE: October 18, 2026
+*
+* REVISIONS: (Date and Description)
+*
+* DESIGNER: Karl Castillo (c)
+*
+* PROGRAMMER: Karl Castillo (c)
+*
+* INTERFACE: static int resultsWrite(char *name, PRESULT results, int count,
+*       PCOUNTER counter, int ms)
+* name: the file to write
+* results: the results
+* count: how many there are
+* counter: where the cycles came from
+* ms: how long a repetition lasted at least
+*
+* RETURN: int
+* 0: the results were written
+* -1: the file cannot be written
+*
+* NOTES:
+* Cycles are null when there was nothing to count them with.
+*******************************************************************************/
+static int resultsWrite(char *name, PRESULT results, int count,
+        PCOUNTER counter, int ms)
+{
+        FILE *out;
+        int i;
+
+        if((out = fopen(name, "w")) == NULL) {
+                return -1;
+        }
+
+        fprintf(out, "{\n  \"repetitions\": %d,\n  \"ms\": %d,\n"
+                "  \"cycles\": \"%s\",\n  \"cksum\": \"%s\",\n"
+                "  \"results\": [\n", REPS, ms,
+                counter->source == CYCLES_PERF ? "perf" :
+                counter->source == CYCLES_TSC ? "tsc" : "none",
+                cksumLevel() == CKSUM_AVX2 ? "avx2" :
+                cksumLevel() == CKSUM_SSE2 ? "sse2" : "scalar");
+        for(i = 0; i < count; i++) {
+                fprintf(out, "    {\"kernel\": \"%s\", \"layout\": \"%s\", "
+                        "\"bytes\": %d, \"batch\": %d, \"ns_per_packet\": "
+                        "%.3f, \"cycles_per_packet\": ", results[i].kernel,
+                        results[i].layout, results[i].bytes,
+                        results[i].batch, results[i].ns);
+                if(results[i].cycles < 0) {
+                        fprintf(out, "null");
+                } else {
+                        fprintf(out, "%.2f", results[i].cycles);
+                }
+                fprintf(out, "}%s\n", i + 1 < count ? "," : "");
+        }
+        fprintf(out, "  ]\n}\n");
+
+        if(fclose(out) != 0) {
+                return -1;
+        }
+
+        return 0;
+}
@@ -0,0 +1,1256 @@
+/*******************************************************************************
+* SOURCE FILE: capture.c
+*
+* PROGRAM: Covert
+*
+* FUNCTIONS:
+* int captureOpen(PCAPTURE capture, int batch, int rcvbuf, int dual);
+* int captureOpenRing(PCAPTURE capture, int batch, int blocks, int block_size,
+*        int huge, int dual);
+* int captureOpenPcap(PCAPTURE capture, char *path, int batch);
+* int captureOpenUring(PCAPTURE capture, int batch, int rcvbuf, int dual,
+*        PURING ring);
+* int captureNext(PCAPTURE capture);
+* int captureTimeout(PCAPTURE capture, int ms);
+* unsigned int captureDrops(PCAPTURE capture);
+* void captureClose(PCAPTURE capture);
+* void captureReport(PCAPTURE capture, FILE *out);
+* static int captureNextSock(PCAPTURE capture);
+* static int captureNextRing(PCAPTURE capture);
+* static int captureNextPcap(PCAPTURE capture);
+* static int captureNextUring(PCAPTURE capture);
+* static void captureArm(PCAPTURE capture);
+* static void captureDone(PURINGOP op, int res, unsigned int flags);
+* static int captureSocket(int dual);
+* static int captureTcp(const unsigned char *ip, unsigned int len);
+* static int captureLink(PCAPTURE capture, unsigned char *data,
+*        unsigned int caplen);
+* static unsigned int capturePcapWord(PCAPTURE capture, unsigned int word);
+* static double captureNow(void);
+* static void captureFree(PCAPTURE capture);
+*
+* DATE: October 18, 2026
+*
+* DESIGNER: Karl Castillo (c)
+*
+* PROGRAMMER: Karl Castillo (c)
+*
+* NOTES:
+* One raw socket is kept open for the whole run so nothing is lost between
+* reads. Its receive buffer is enlarged to ride out bursts and packets are
+* drained with recvmmsg into buffers allocated once up front. The kernel
+* reports its own drop count through SO_RXQ_OVFL, and stamps every packet
+* with its arrival time through SO_TIMESTAMPNS.
+*
+* The ring capture skips the copy altogether. A packet socket shares a
+* TPACKET_V3 ring with the kernel and the decoder is handed pointers straight
+* into the ring blocks; a block goes back to the kernel once every packet in
+* it has been handed out.
+*
+* A pcap capture maps a file written by the client, or by tcpdump, and hands
+* its records to the decoder through the same batches, so a transfer can be
+* decoded again without root or a network. The file ending ends the capture.
+*
+* An io_uring capture keeps the raw socket but leaves the receiving to one
+* multishot request. The kernel picks a buffer from a ring of provided
+* buffers for every packet and posts a completion for it, so a batch is
+* gathered without a system call per packet, and the same wait also reaps
+* the completions of whatever else shares the ring. The buffers of a batch
+* go back to the kernel on the following call.
+*
+* A raw IPv6 socket never hands out the IPv6 header, so a dual-stack capture
+* reads a packet socket of every protocol instead, which starts its packets
+* at the network header whatever it is. The filter of the server keeps only
+* the TCP packets of either family, and the ring and pcap captures check the
+* version themselves.
+*******************************************************************************/
+/* INCLUDES */
+#define _GNU_SOURCE
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include <stdint.h>
+#include <errno.h>
+#include <fcntl.h>
+#include <unistd.h>
+#include <poll.h>
+#include <time.h>
+#include <byteswap.h>
+#include <sys/time.h>
+#include <sys/mman.h>
+#include <sys/stat.h>
+#include <sys/socket.h>
+#include <arpa/inet.h>
+#include <linux/if_ether.h>
+#include <linux/if_packet.h>
+#include "capture.h"
+#include "pcapfile.h"
+
+/* DEFINES */
+#define CONTROL_SIZE    (CMSG_SPACE(sizeof(unsigned int)) + \
+                        CMSG_SPACE(sizeof(struct timespec)))
+#define CAPTURE_IP(type) ((type) == ETH_P_IP || (type) == ETH_P_IPV6)
+
+/* PROTOTYPES */
+static int captureNextSock(PCAPTURE capture);
+static int captureNextRing(PCAPTURE capture);
+static int captureNextPcap(PCAPTURE capture);
+static int captureNextUring(PCAPTURE capture);
+static void captureArm(PCAPTURE capture);
+static void captureDone(PURINGOP op, int res, unsigned int flags);
+static int captureSocket(int dual);
+static int captureTcp(const unsigned char *ip, unsigned int len);
+static int captureLink(PCAPTURE capture, unsigned char *data,
+        unsigned int caplen);
+static unsigned int capturePcapWord(PCAPTURE capture, unsigned int word);
+static double captureNow(void);
+static void captureFree(PCAPTURE capture);
+
+/*******************************************************************************
+* FUNCTION: captureOpen
+*
+* DATE: October 18, 2026
+*
+* REVISIONS: (Date and Description)
+*
+* DESIGNER: Karl Castillo (c)
+*
+* PROGRAMMER: Karl Castillo (c)
+*
+* INTERFACE: int captureOpen(PCAPTURE capture, int batch, int rcvbuf,
+*       int dual)
+* capture: the capture to open
+* batch: the most packets returned by one call to captureNext
+* rcvbuf: the socket receive buffer size in bytes
+* dual: receive IPv6 packets as well
+*
+* RETURN: int
+* 0: in success
+* -1: the socket could not be created or the buffers could not be allocated
+*
+* NOTES:
+* SO_RCVBUFFORCE is tried first since it is not capped by rmem_max; we run as
+* root so it normally succeeds.
+*******************************************************************************/
+int captureOpen(PCAPTURE capture, int batch, int rcvbuf, int dual)
+{
+        socklen_t len = sizeof(capture->rcvbuf);
+        int on = 1;
+        int i;
+
+        memset(capture, 0, sizeof(CAPTURE));
+        capture->mode = CAPTURE_SOCK;
+        capture->timeout = -1;
+
+        if((capture->sock = captureSocket(dual)) < 0) {
+                return -1;
+        }
+
+        if(setsockopt(capture->sock, SOL_SOCKET, SO_RCVBUFFORCE, &rcvbuf,
+                        sizeof(rcvbuf)) < 0) {
+                setsockopt(capture->sock, SOL_SOCKET, SO_RCVBUF, &rcvbuf,
+                        sizeof(rcvbuf));
+        }
+        getsockopt(capture->sock, SOL_SOCKET, SO_RCVBUF, &capture->rcvbuf, &len);
+        setsockopt(capture->sock, SOL_SOCKET, SO_RXQ_OVFL, &on, sizeof(on));
+        setsockopt(capture->sock, SOL_SOCKET, SO_TIMESTAMPNS, &on, sizeof(on));
+
+        capture->batch = batch;
+        capture->buffers = (PRECVHDR)malloc(batch * sizeof(RECVHDR));
+        capture->msgs = (struct mmsghdr*)calloc(batch, sizeof(struct mmsghdr));
+        capture->iovs = (struct iovec*)calloc(batch, sizeof(struct iovec));
+        capture->controls = (char*)calloc(batch, CONTROL_SIZE);
+        capture->frames = (PRECVHDR*)calloc(batch, sizeof(PRECVHDR));
+        capture->lens = (int*)calloc(batch, sizeof(int));
+        capture->stamps = (long long*)calloc(batch, sizeof(long long));
+        if(capture->buffers == NULL || capture->msgs == NULL ||
+                        capture->iovs == NULL || capture->controls == NULL ||
+                        capture->frames == NULL || capture->lens == NULL ||
+                        capture->stamps == NULL) {
+                captureFree(capture);
+                errno = ENOMEM;
+                return -1;
+        }
+
+        for(i = 0; i < batch; i++) {
+                capture->iovs[i].iov_base = &capture->buffers[i];
+                capture->iovs[i].iov_len = sizeof(RECVHDR);
+                capture->msgs[i].msg_hdr.msg_iov = &capture->iovs[i];
+                capture->msgs[i].msg_hdr.msg_iovlen = 1;
+                capture->frames[i] = &capture->buffers[i];
+        }
+
+        return 0;
+}
+
+/*******************************************************************************
+* FUNCTION: captureOpenRing
+*
+* DATE: October 18, 2026
+*
+* REVISIONS: (Date and Description)
+*
+* DESIGNER: Karl Castillo (c)
+*
+* PROGRAMMER: Karl Castillo (c)
+*
+* INTERFACE: int captureOpenRing(PCAPTURE capture, int batch, int blocks,
+*       int block_size, int huge, int dual)
+* capture: the capture to open
+* batch: the most packets returned by one call to captureNext
+* blocks: the number of blocks in the ring
+* block_size: the size of a block in bytes, a multiple of the page size
+* huge: back the ring with huge pages
+* dual: receive IPv6 packets as well
+*
+* RETURN: int
+* 0: in success
+* -1: the socket, the ring or the buffers could not be set up
+*
+* NOTES:
+* With huge set the blocks are rounded up to the huge page size so that each
+* block is one physically contiguous allocation, and the mapping asks for
+* MAP_HUGETLB. The kernel may refuse to map a packet ring that way, in which
+* case regular pages are used and capture->huge is left at 0.
+*******************************************************************************/
+int captureOpenRing(PCAPTURE capture, int batch, int blocks, int block_size,
+        int huge, int dual)
+{
+        struct tpacket_req3 req;
+        int version = TPACKET_V3;
+
+        memset(capture, 0, sizeof(CAPTURE));
+        capture->mode = CAPTURE_RING;
+        capture->timeout = -1;
+
+        if((capture->sock = socket(AF_PACKET, SOCK_DGRAM,
+                        htons(dual ? ETH_P_ALL : ETH_P_IP))) < 0) {
+                return -1;
+        }
+
+        if(setsockopt(capture->sock, SOL_PACKET, PACKET_VERSION, &version,
+                        sizeof(version)) < 0) {
+                close(capture->sock);
+                return -1;
+        }
+
+        if(huge) {
+                block_size = (block_size + HUGE_PAGE - 1) / HUGE_PAGE * HUGE_PAGE;
+        }
+
+        memset(&req, 0, sizeof(req));
+        req.tp_block_size = block_size;
+        req.tp_block_nr = blocks;
+        req.tp_frame_size = RING_FRAME;
+        req.tp_frame_nr = (block_size / RING_FRAME) * blocks;
+        req.tp_retire_blk_tov = RING_TIMEOUT;
+
+        if(setsockopt(capture->sock, SOL_PACKET, PACKET_RX_RING, &req,
+                        sizeof(req)) < 0) {
+                close(capture->sock);
+                return -1;
+        }
+
+        capture->blocks = blocks;
+        capture->block_size = block_size;
+        capture->ring_size = (size_t)block_size * blocks;
+        capture->ring = MAP_FAILED;
+
+        if(huge) {
+                capture->ring = mmap(NULL, capture->ring_size,
+                        PROT_READ | PROT_WRITE, MAP_SHARED | MAP_HUGETLB,
+                        capture->sock, 0);
+                capture->huge = (capture->ring != MAP_FAILED);
+        }
+        if(capture->ring == MAP_FAILED) {
+                capture->ring = mmap(NULL, capture->ring_size,
+                        PROT_READ | PROT_WRITE, MAP_SHARED, capture->sock, 0);
+        }
+        if(capture->ring == MAP_FAILED) {
+                capture->ring = NULL;
+                close(capture->sock);
+                return -1;
+        }
+
+        capture->batch = batch;
+        capture->frames = (PRECVHDR*)calloc(batch, sizeof(PRECVHDR));
+        capture->lens = (int*)calloc(batch, sizeof(int));
+        capture->stamps = (long long*)calloc(batch, sizeof(long long));
+        if(capture->frames == NULL || capture->lens == NULL ||
+                        capture->stamps == NULL) {
+                captureFree(capture);
+                errno = ENOMEM;
+                return -1;
+        }
+
+        return 0;
+}
+
+/*******************************************************************************
+* FUNCTION: captureOpenPcap
+*
+* DATE: October 18, 2026
+*
+* REVISIONS: (Date and Description)
+*
+* DESIGNER: Karl Castillo (c)
+*
+* PROGRAMMER: Karl Castillo (c)
+*
+* INTERFACE: int captureOpenPcap(PCAPTURE capture, char *path, int batch)
+* capture: the capture to open
+* path: the pcap file to read
+* batch: the most packets returned by one call to captureNext
+*
+* RETURN: int
+* 0: in success
+* -1: the file could not be mapped, or it is not a pcap file with raw IP,
+*       IPv4, IPv6, Ethernet or Linux cooked records
+*
+* NOTES:
+* Files in either byte order are read, with microsecond or nanosecond
+* timestamps. The records are copied out of the mapping into receive buffers
+* like the socket capture does, since a record is not aligned in the file.
+*******************************************************************************/
+int captureOpenPcap(PCAPTURE capture, char *path, int batch)
+{
+        struct stat st;
+        PCAPHDR hdr;
+        int fd;
+        int i;
+
+        memset(capture, 0, sizeof(CAPTURE));
+        capture->mode = CAPTURE_PCAP;
+        capture->timeout = -1;
+        capture->sock = -1;
+
+        if((fd = open(path, O_RDONLY)) < 0) {
+                return -1;
+        }
+        if(fstat(fd, &st) < 0 || st.st_size < (off_t)sizeof(PCAPHDR)) {
+                close(fd);
+                errno = EINVAL;
+                return -1;
+        }
+
+        capture->ring_size = st.st_size;
+        capture->ring = mmap(NULL, capture->ring_size, PROT_READ, MAP_PRIVATE,
+                fd, 0);
+        close(fd);
+        if(capture->ring == MAP_FAILED) {
+                capture->ring = NULL;
+                return -1;
+        }
+        madvise(capture->ring, capture->ring_size, MADV_SEQUENTIAL);
+
+        memcpy(&hdr, capture->ring, sizeof(hdr));
+        if(hdr.magic != PCAP_MAGIC && hdr.magic != PCAP_MAGIC_NS) {
+                capture->swapped = 1;
+        }
+        capture->linktype = capturePcapWord(capture, hdr.linktype) & 0xffff;
+
+        if((capturePcapWord(capture, hdr.magic) != PCAP_MAGIC &&
+                        capturePcapWord(capture, hdr.magic) != PCAP_MAGIC_NS) ||
+                        (capture->linktype != LINKTYPE_ETHERNET &&
+                        capture->linktype != LINKTYPE_RAW &&
+                        capture->linktype != LINKTYPE_SLL &&
+                        capture->linktype != LINKTYPE_IPV4 &&
+                        capture->linktype != LINKTYPE_IPV6 &&
+                        capture->linktype != LINKTYPE_SLL2)) {
+                munmap(capture->ring, capture->ring_size);
+                capture->ring = NULL;
+                errno = EINVAL;
+                return -1;
+        }
+        capture->cursor = capture->ring + sizeof(hdr);
+
+        capture->batch = batch;
+        capture->buffers = (PRECVHDR)malloc(batch * sizeof(RECVHDR));
+        capture->frames = (PRECVHDR*)calloc(batch, sizeof(PRECVHDR));
+        capture->lens = (int*)calloc(batch, sizeof(int));
+        capture->stamps = (long long*)calloc(batch, sizeof(long long));
+        if(capture->buffers == NULL || capture->frames == NULL ||
+                        capture->lens == NULL || capture->stamps == NULL) {
+                captureFree(capture);
+                errno = ENOMEM;
+                return -1;
+        }
+
+        for(i = 0; i < batch; i++) {
+                capture->frames[i] = &capture->buffers[i];
+        }
+
+        return 0;
+}
+
+/*******************************************************************************
+* FUNCTION: captureOpenUring
+*
+* DATE: October 18, 2026
+*
+* REVISIONS: (Date and Description)
+*
+* DESIGNER: Karl Castillo (c)
+*
+* PROGRAMMER: Karl Castillo (c)
+*
+* INTERFACE: int captureOpenUring(PCAPTURE capture, int batch, int rcvbuf,
+*       int dual, PURING ring)
+* capture: the capture to open
+* batch: the most packets returned by one call to captureNext
+* rcvbuf: the socket receive buffer size in bytes
+* dual: receive IPv6 packets as well
+* ring: the ring the receive goes through, open until the capture is closed
+*
+* RETURN: int
+* 0: in success
+* -1: the socket could not be created, the ring refused the buffers or the
+*       arrays could not be allocated
+*
+* NOTES:
+* At least four batches of buffers, and never fewer than URING_MIN_BUFS, are
+* given to the kernel so that it can keep receiving while a batch is being
+* decoded. The kernel does not hand out its drop count or timestamps this
+* way, so neither is kept.
+*******************************************************************************/
+int captureOpenUring(PCAPTURE capture, int batch, int rcvbuf, int dual,
+        PURING ring)
+{
+        socklen_t len = sizeof(capture->rcvbuf);
+        int count = URING_MIN_BUFS;
+
+        memset(capture, 0, sizeof(CAPTURE));
+        capture->mode = CAPTURE_URING;
+        capture->timeout = -1;
+
+        if((capture->sock = captureSocket(dual)) < 0) {
+                return -1;
+        }
+
+        if(setsockopt(capture->sock, SOL_SOCKET, SO_RCVBUFFORCE, &rcvbuf,
+                        sizeof(rcvbuf)) < 0) {
+                setsockopt(capture->sock, SOL_SOCKET, SO_RCVBUF, &rcvbuf,
+                        sizeof(rcvbuf));
+        }
+        getsockopt(capture->sock, SOL_SOCKET, SO_RCVBUF, &capture->rcvbuf,
+                &len);
+
+        while(count < batch * 4) {
+                count *= 2;
+        }
+        if(uringBuffers(ring, &capture->bufs, URING_GROUP, count,
+                        URING_FRAME) < 0) {
+                close(capture->sock);
+                return -1;
+        }
+
+        capture->uring = ring;
+        capture->recv.owner = capture;
+        capture->recv.complete = captureDone;
+        capture->batch = batch;
+        capture->frames = (PRECVHDR*)calloc(batch, sizeof(PRECVHDR));
+        capture->lens = (int*)calloc(batch, sizeof(int));
+        capture->stamps = (long long*)calloc(batch, sizeof(long long));
+        capture->held = (int*)calloc(batch, sizeof(int));
+        capture->results = (int*)calloc(count * 2, sizeof(int));
+        capture->flags = (unsigned int*)calloc(count * 2,
+                sizeof(unsigned int));
+        if(capture->frames == NULL || capture->lens == NULL ||
+                        capture->stamps == NULL || capture->held == NULL ||
+                        capture->results == NULL || capture->flags == NULL) {
+                captureFree(capture);
+                errno = ENOMEM;
+                return -1;
+        }
+
+        return 0;
+}
+
+/*******************************************************************************
+* FUNCTION: captureNext
+*
+* DATE: October 18, 2026
+*
+* REVISIONS: (Date and Description)
+*
+* DESIGNER: Karl Castillo (c)
+*
+* PROGRAMMER: Karl Castillo (c)
+*
+* INTERFACE: int captureNext(PCAPTURE capture)
+* capture: the capture
+*
+* RETURN: int: the number of packets in capture->frames, 0 when the timeout
+*       expired, -1 on error or when interrupted by a signal
+*
+* NOTES:
+* Blocks until at least one packet is available and returns up to a batch of
+* them. The packets stay valid until the next call. A pcap capture never
+* blocks, and sets capture->ended once the last record has been returned.
+*******************************************************************************/
+int captureNext(PCAPTURE capture)
+{
+        if(capture->mode == CAPTURE_RING) {
+                return captureNextRing(capture);
+        }
+        if(capture->mode == CAPTURE_PCAP) {
+                return captureNextPcap(capture);
+        }
+        if(capture->mode == CAPTURE_URING) {
+                return captureNextUring(capture);
+        }
+        return captureNextSock(capture);
+}
+
+/*******************************************************************************
+* FUNCTION: captureTimeout
+*
+* DATE: October 18, 2026
+*
+* REVISIONS: (Date and Description)
+*
+* DESIGNER: Karl Castillo (c)
+*
+* PROGRAMMER: Karl Castillo (c)
+*
+* INTERFACE: int captureTimeout(PCAPTURE capture, int ms)
+* capture: the capture
+* ms: how long captureNext waits for a packet, -1 for ever
+*
+* RETURN: int
+* 0: in success
+* -1: the timeout could not be set
+*
+* NOTES:
+* Lets the caller do housekeeping while no packets arrive.
+*******************************************************************************/
+int captureTimeout(PCAPTURE capture, int ms)
+{
+        struct timeval tv;
+
+        capture->timeout = ms;
+        if(capture->mode != CAPTURE_SOCK) {
+                return 0;
+        }
+
+        tv.tv_sec = (ms < 0) ? 0 : ms / 1000;
+        tv.tv_usec = (ms < 0) ? 0 : (ms % 1000) * 1000;
+
+        return setsockopt(capture->sock, SOL_SOCKET, SO_RCVTIMEO, &tv,
+                sizeof(tv));
+}
+
+/*******************************************************************************
+* FUNCTION: captureNextSock
+*
+* DATE: October 18, 2026
+*
+* REVISIONS: (Date and Description)
+*
+* DESIGNER: Karl Castillo (c)
+*
+* PROGRAMMER: Karl Castillo (c)
+*
+* INTERFACE: static int captureNextSock(PCAPTURE capture)
+* capture: the capture
+*
+* RETURN: int: the number of packets in capture->frames, -1 on error
+*
+* NOTES:
+* Blocks until at least one packet is queued, then takes everything else
+* that is already waiting up to the batch size.
+*******************************************************************************/
+static int captureNextSock(PCAPTURE capture)
+{
+        struct cmsghdr *cmsg;
+        struct timespec stamp;
+        int n;
+        int i;
+
+        for(i = 0; i < capture->batch; i++) {
+                capture->msgs[i].msg_hdr.msg_control =
+                        capture->controls + i * CONTROL_SIZE;
+                capture->msgs[i].msg_hdr.msg_controllen = CONTROL_SIZE;
+        }
+
+        if((n = recvmmsg(capture->sock, capture->msgs, capture->batch,
+                        MSG_WAITFORONE, NULL)) < 0) {
+                return (errno == EAGAIN || errno == EWOULDBLOCK) ? 0 : -1;
+        }
+
+        for(i = 0; i < n; i++) {
+                capture->lens[i] = capture->msgs[i].msg_len;
+                capture->stamps[i] = 0;
+
+                for(cmsg = CMSG_FIRSTHDR(&capture->msgs[i].msg_hdr);
+                                cmsg != NULL;
+                                cmsg = CMSG_NXTHDR(&capture->msgs[i].msg_hdr,
+                                cmsg)) {
+                        if(cmsg->cmsg_level == SOL_SOCKET &&
+                                        cmsg->cmsg_type == SO_RXQ_OVFL) {
+                                memcpy(&capture->drops, CMSG_DATA(cmsg),
+                                        sizeof(capture->drops));
+                        } else if(cmsg->cmsg_level == SOL_SOCKET &&
+                                        cmsg->cmsg_type == SO_TIMESTAMPNS) {
+                                memcpy(&stamp, CMSG_DATA(cmsg), sizeof(stamp));
+                                capture->stamps[i] = stamp.tv_sec *
+                                        1000000000LL + stamp.tv_nsec;
+                        }
+                }
+        }
+
+        capture->received += n;
+        capture->batches++;
+
+        return n;
+}
+
+/*******************************************************************************
+* FUNCTION: captureNextRing
+*
+* DATE: October 18, 2026
+*
+* REVISIONS: (Date and Description)
+*
+* DESIGNER: Karl Castillo (c)
+*
+* PROGRAMMER: Karl Castillo (c)
+*
+* INTERFACE: static int captureNextRing(PCAPTURE capture)
+* capture: the capture
+*
+* RETURN: int: the number of packets in capture->frames, -1 on error
+*
+* NOTES:
+* Walks the current block in place. Once the block has been handed out in
+* full it is given back to the kernel on the following call, and the capture
+* moves on to the next block, sleeping in poll until the kernel retires it.
+* Our own outgoing packets, which loopback shows twice, and anything that is
+* not TCP over IPv4 or IPv6 are skipped.
+*******************************************************************************/
+static int captureNextRing(PCAPTURE capture)
+{
+        struct tpacket_block_desc *desc;
+        struct tpacket3_hdr *hdr;
+        struct sockaddr_ll *sll;
+        struct iphdr *ip;
+        struct pollfd pfd;
+        int n = 0;
+
+        while(n == 0) {
+                desc = (struct tpacket_block_desc*)(capture->ring +
+                        (size_t)capture->block * capture->block_size);
+
+                if(capture->left == 0) {
+                        if(capture->cursor != NULL) { /* block is finished */
+                                desc->hdr.bh1.block_status = TP_STATUS_KERNEL;
+                                capture->block = (capture->block + 1) %
+                                        capture->blocks;
+                                capture->cursor = NULL;
+                                continue;
+                        }
+
+                        if(!(desc->hdr.bh1.block_status & TP_STATUS_USER)) {
+                                pfd.fd = capture->sock;
+                                pfd.events = POLLIN | POLLERR;
+                                pfd.revents = 0;
+                                if((n = poll(&pfd, 1, capture->timeout)) <= 0) {
+                                        return n;
+                                }
+                                n = 0;
+                                continue;
+                        }
+
+                        capture->left = desc->hdr.bh1.num_pkts;
+                        capture->cursor = (unsigned char*)desc +
+                                desc->hdr.bh1.offset_to_first_pkt;
+                }
+
+                while(capture->left > 0 && n < capture->batch) {
+                        hdr = (struct tpacket3_hdr*)capture->cursor;
+                        sll = (struct sockaddr_ll*)(capture->cursor +
+                                TPACKET_ALIGN(sizeof(struct tpacket3_hdr)));
+                        ip = (struct iphdr*)(capture->cursor + hdr->tp_net);
+
+                        if(sll->sll_pkttype != PACKET_OUTGOING &&
+                                        captureTcp((unsigned char*)ip,
+                                        hdr->tp_snaplen)) {
+                                capture->frames[n] = (PRECVHDR)ip;
+                                capture->lens[n] = hdr->tp_snaplen;
+                                capture->stamps[n] = hdr->tp_sec *
+                                        1000000000LL + hdr->tp_nsec;
+                                n++;
+                        }
+
+                        capture->cursor += hdr->tp_next_offset;
+                        capture->left--;
+                }
+        }
+
+        capture->received += n;
+        capture->batches++;
+
+        return n;
+}
+
+/*******************************************************************************
+* FUNCTION: captureNextPcap
+*
+* DATE: October 18, 2026
+*
+* REVISIONS: (Date and Description)
+*
+* DESIGNER: Karl Castillo (c)
+*
+* PROGRAMMER: Karl Castillo (c)
+*
+* INTERFACE: static int captureNextPcap(PCAPTURE capture)
+* capture: the capture
+*
+* RETURN: int: the number of packets in capture->frames
+*
+* NOTES:
+* Copies the next batch of TCP packets out of the file, over IPv4 or IPv6,
+* skipping every other record. A record cut short by the end of the file
+* ends the capture like the end itself does.
+*******************************************************************************/
+static int captureNextPcap(PCAPTURE capture)
+{
+        unsigned char *end = capture->ring + capture->ring_size;
+        unsigned char *data;
+        PCAPREC rec;
+        unsigned int caplen;
+        int offset;
+        int len;
+        int n = 0;
+
+        if(capture->started == 0) {
+                capture->started = captureNow();
+        }
+
+        while(n < capture->batch &&
+                        (size_t)(end - capture->cursor) >= sizeof(rec)) {
+                memcpy(&rec, capture->cursor, sizeof(rec));
+                caplen = capturePcapWord(capture, rec.caplen);
+                data = capture->cursor + sizeof(rec);
+                if(caplen > (size_t)(end - data)) {
+                        capture->cursor = end;
+                        break;
+                }
+                capture->cursor = data + caplen;
+
+                if((offset = captureLink(capture, data, caplen)) < 0 ||
+                                !captureTcp(data + offset, caplen - offset)) {
+                        capture->skipped++;
+                        continue;
+                }
+
+                len = caplen - offset;
+                memcpy(&capture->buffers[n], data + offset,
+                        len < (int)sizeof(RECVHDR) ? (size_t)len :
+                        sizeof(RECVHDR));
+                capture->lens[n] = len;
+                capture->stamps[n] = 0;
+                n++;
+        }
+
+        if((size_t)(end - capture->cursor) < sizeof(rec)) {
+                capture->ended = 1;
+                capture->elapsed = captureNow() - capture->started;
+        }
+
+        capture->received += n;
+        if(n > 0) {
+                capture->batches++;
+        }
+
+        return n;
+}
+
+/*******************************************************************************
+* FUNCTION: captureNextUring
+*
+* DATE: October 18, 2026
+*
+* REVISIONS: (Date and Description)
+*
+* DESIGNER: Karl Castillo (c)
+*
+* PROGRAMMER: Karl Castillo (c)
+*
+* INTERFACE: static int captureNextUring(PCAPTURE capture)
+* capture: the capture
+*
+* RETURN: int: the number of packets in capture->frames, 0 when the timeout
+*       expired, -1 on error or when interrupted by a signal
+*
+* NOTES:
+* Gives back the buffers of the last batch, then hands out the receives that
+* were reaped, waiting on the ring only when there are none. The receive
+* ends whenever the kernel runs out of buffers; the packets wait in the
+* socket until it is started again.
+*******************************************************************************/
+static int captureNextUring(PCAPTURE capture)
+{
+        unsigned int size = capture->bufs.count * 2;
+        unsigned int slot;
+        int id;
+        int n = 0;
+        int i;
+
+        for(i = 0; i < capture->holding; i++) {
+                uringRecycle(&capture->bufs, capture->held[i]);
+        }
+        if(capture->holding > 0) {
+                uringPublish(&capture->bufs);
+        }
+        capture->holding = 0;
+
+        while(n == 0) {
+                if(capture->recv.pending == 0) {
+                        captureArm(capture);
+                }
+
+                if(capture->done_head == capture->done_tail) {
+                        if(uringEnter(capture->uring, 1,
+                                        capture->timeout) < 0) {
+                                return -1;
+                        }
+                        if(capture->done_head == capture->done_tail) {
+                                return 0;
+                        }
+                }
+
+                while(capture->done_head != capture->done_tail &&
+                                n < capture->batch) {
+                        slot = capture->done_head++ % size;
+                        if(capture->results[slot] < 0) {
+                                if(capture->results[slot] != -ENOBUFS &&
+                                                n == 0) {
+                                        errno = -capture->results[slot];
+                                        return -1;
+                                }
+                                continue;
+                        }
+                        if(!(capture->flags[slot] & IORING_CQE_F_BUFFER)) {
+                                continue;
+                        }
+
+                        id = capture->flags[slot] >> IORING_CQE_BUFFER_SHIFT;
+                        capture->held[capture->holding++] = id;
+                        capture->frames[n] = (PRECVHDR)(capture->bufs.base +
+                                (size_t)id * capture->bufs.size);
+                        capture->lens[n] = capture->results[slot];
+                        capture->stamps[n] = 0;
+                        n++;
+                }
+        }
+
+        capture->received += n;
+        capture->batches++;
+
+        return n;
+}
+
+/*******************************************************************************
+* FUNCTION: captureArm
+*
+* DATE: October 18, 2026
+*
+* REVISIONS: (Date and Description)
+*
+* DESIGNER: Karl Castillo (c)
+*
+* PROGRAMMER: Karl Castillo (c)
+*
+* INTERFACE: static void captureArm(PCAPTURE capture)
+* capture: the capture
+*
+* RETURN: void
+*
+* NOTES:
+* Starts the multishot receive. It is only submitted by the next wait on the
+* ring.
+*******************************************************************************/
+static void captureArm(PCAPTURE capture)
+{
+        struct io_uring_sqe *sqe;
+
+        if((sqe = uringGet(capture->uring, &capture->recv)) == NULL) {
+                return;
+        }
+        sqe->opcode = IORING_OP_RECV;
+        sqe->fd = capture->sock;
+        sqe->ioprio = IORING_RECV_MULTISHOT;
+        sqe->flags = IOSQE_BUFFER_SELECT;
+        sqe->buf_group = capture->bufs.group;
+        capture->arms++;
+}
+
+/*******************************************************************************
+* FUNCTION: captureDone
+*
+* DATE: October 18, 2026
+*
+* REVISIONS: (Date and Description)
+*
+* DESIGNER: Karl Castillo (c)
+*
+* PROGRAMMER: Karl Castillo (c)
+*
+* INTERFACE: static void captureDone(PURINGOP op, int res,
+*       unsigned int flags)
+* op: the receive of the capture
+* res: the length of the packet, or an error
+* flags: the flags of the completion, holding the buffer id
+*
+* RETURN: void
+*
+* NOTES:
+* Completions can be reaped by any wait on the ring, so they are queued for
+* captureNext. Every queued packet holds a buffer and there are never more
+* receives than buffers, so twice as many slots cannot run out.
+*******************************************************************************/
+static void captureDone(PURINGOP op, int res, unsigned int flags)
+{
+        PCAPTURE capture = (PCAPTURE)op->owner;
+        unsigned int slot = capture->done_tail++ % (capture->bufs.count * 2);
+
+        capture->results[slot] = res;
+        capture->flags[slot] = flags;
+}
+
+/*******************************************************************************
+* FUNCTION: captureSocket
+*
+* DATE: October 18, 2026
+*
+* REVISIONS: (Date and Description)
+*
+* DESIGNER: Karl Castillo (c)
+*
+* PROGRAMMER: Karl Castillo (c)
+*
+* INTERFACE: static int captureSocket(int dual)
+* dual: receive IPv6 packets as well
+*
+* RETURN: int: the socket, -1 when it could not be created
+*
+* NOTES:
+* The packet socket of a dual-stack capture is asked not to see our own
+* outgoing packets at all; older kernels without PACKET_IGNORE_OUTGOING
+* leave that to the filter.
+*******************************************************************************/
+static int captureSocket(int dual)
+{
+        int on = 1;
+        int sock;
+
+        if(!dual) {
+                return socket(AF_INET, SOCK_RAW, IPPROTO_TCP);
+        }
+
+        if((sock = socket(AF_PACKET, SOCK_DGRAM, htons(ETH_P_ALL))) >= 0) {
+                setsockopt(sock, SOL_PACKET, PACKET_IGNORE_OUTGOING, &on,
+                        sizeof(on));
+        }
+
+        return sock;
+}
+
+/*******************************************************************************
+* FUNCTION: captureTcp
+*
+* DATE: October 18, 2026
+*
+* REVISIONS: (Date and Description)
+*
+* DESIGNER: Karl Castillo (c)
+*
+* PROGRAMMER: Karl Castillo (c)
+*
+* INTERFACE: static int captureTcp(const unsigned char *ip, unsigned int len)
+* ip: a packet, starting at the IP header
+* len: the bytes in the packet
+*
+* RETURN: int: 1 when the packet is IPv4 or IPv6 carrying TCP, 0 otherwise
+*
+* NOTES:
+* An IPv4 packet with options is refused like the capture filter refuses
+* it, since the decoder expects the TCP header right after the fixed one.
+*******************************************************************************/
+static int captureTcp(const unsigned char *ip, unsigned int len)
+{
+        if(len >= 20 && ip[0] == 0x45) {
+                return ip[9] == IPPROTO_TCP;
+        }
+        if(len >= 40 && (ip[0] >> 4) == 6) {
+                return ip[6] == IPPROTO_TCP;
+        }
+        return 0;
+}
+
+/*******************************************************************************
+* FUNCTION: captureLink
+*
+* DATE: October 18, 2026
+*
+* REVISIONS: (Date and Description)
+*
+* DESIGNER: Karl Castillo (c)
+*
+* PROGRAMMER: Karl Castillo (c)
+*
+* INTERFACE: static int captureLink(PCAPTURE capture, unsigned char *data,
+*       unsigned int caplen)
+* capture: the capture
+* data: the start of a record
+* caplen: the bytes in the record
+*
+* RETURN: int: where the IP header starts in the record, -1 when the record
+*       does not hold an IPv4 or IPv6 packet
+*
+* NOTES:
+* Ethernet frames may carry one VLAN tag. Cooked records of our own outgoing
+* packets are skipped, as loopback shows each packet twice.
+*******************************************************************************/
+static int captureLink(PCAPTURE capture, unsigned char *data,
+        unsigned int caplen)
+{
+        unsigned int offset;
+
+        switch(capture->linktype) {
+        case LINKTYPE_RAW:
+        case LINKTYPE_IPV4:
+        case LINKTYPE_IPV6:
+                return 0;
+        case LINKTYPE_ETHERNET:
+                offset = ETH_HLEN;
+                if(caplen >= ETH_HLEN + 4 &&
+                                ((data[12] << 8) | data[13]) == ETH_P_8021Q) {
+                        offset += 4;
+                }
+                if(caplen < offset || !CAPTURE_IP((data[offset - 2] << 8) |
+                                data[offset - 1])) {
+                        return -1;
+                }
+                return offset;
+        case LINKTYPE_SLL:
+                if(caplen < 16 || ((data[0] << 8) | data[1]) == SLL_OUTGOING ||
+                                !CAPTURE_IP((data[14] << 8) | data[15])) {
+                        return -1;
+                }
+                return 16;
+        case LINKTYPE_SLL2:
+                if(caplen < 20 || data[10] == SLL_OUTGOING ||
+                                !CAPTURE_IP((data[0] << 8) | data[1])) {
+                        return -1;
+                }
+                return 20;
+        }
+
+        return -1;
+}
+
+/*******************************************************************************
+* FUNCTION: capturePcapWord
+*
+* DATE: October 18, 2026
+*
+* REVISIONS: (Date and Description)
+*
+* DESIGNER: Karl Castillo (c)
+*
+* PROGRAMMER: Karl Castillo (c)
+*
+* INTERFACE: static unsigned int capturePcapWord(PCAPTURE capture,
+*       unsigned int word)
+* capture: the capture
+* word: a 32 bit field of the pcap file
+*
+* RETURN: unsigned int: the field in our byte order
+*******************************************************************************/
+static unsigned int capturePcapWord(PCAPTURE capture, unsigned int word)
+{
+        return capture->swapped ? bswap_32(word) : word;
+}
+
+/*******************************************************************************
+* FUNCTION: captureNow
+*
+* DATE: October 18, 2026
+*
+* REVISIONS: (Date and Description)
+*
+* DESIGNER: Karl Castillo (c)
+*
+* PROGRAMMER: Karl Castillo (c)
+*
+* INTERFACE: static double captureNow(void)
+*
+* RETURN: double: the monotonic clock in seconds
+*******************************************************************************/
+static double captureNow(void)
+{
+        struct timespec now;
+
+        clock_gettime(CLOCK_MONOTONIC, &now);
+        return now.tv_sec + now.tv_nsec / 1e9;
+}
+
+/*******************************************************************************
+* FUNCTION: captureDrops
+*
+* DATE: October 18, 2026
+*
+* REVISIONS: (Date and Description)
+*
+* DESIGNER: Karl Castillo (c)
+*
+* PROGRAMMER: Karl Castillo (c)
+*
+* INTERFACE: unsigned int captureDrops(PCAPTURE capture)
+* capture: the capture
+*
+* RETURN: unsigned int: the packets the kernel dropped so far
+*
+* NOTES:
+* For a ring the drop and freeze counts come from PACKET_STATISTICS. Reading
+* them resets the kernel counters, so they are added up here.
+*******************************************************************************/
+unsigned int captureDrops(PCAPTURE capture)
+{
+        struct tpacket_stats_v3 stats;
+        socklen_t len = sizeof(stats);
+
+        if(capture->mode == CAPTURE_RING && getsockopt(capture->sock,
+                        SOL_PACKET, PACKET_STATISTICS, &stats, &len) == 0) {
+                capture->drops += stats.tp_drops;
+                capture->freezes += stats.tp_freeze_q_cnt;
+        }
+
+        return capture->drops;
+}
+
+/*******************************************************************************
+* FUNCTION: captureClose
+*
+* DATE: October 18, 2026
+*
+* REVISIONS: (Date and Description)
+*
+* DESIGNER: Karl Castillo (c)
+*
+* PROGRAMMER: Karl Castillo (c)
+*
+* INTERFACE: void captureClose(PCAPTURE capture)
+* capture: the capture
+*
+* RETURN: void
+*******************************************************************************/
+void captureClose(PCAPTURE capture)
+{
+        struct io_uring_sqe *sqe;
+
+        if(capture->mode == CAPTURE_URING) {
+                if(capture->recv.pending > 0 && (sqe = uringGet(
+                                capture->uring, NULL)) != NULL) {
+                        sqe->opcode = IORING_OP_ASYNC_CANCEL;
+                        sqe->fd = -1;
+                        sqe->addr = (unsigned long long)(uintptr_t)
+                                &capture->recv;
+                        uringWait(capture->uring, &capture->recv);
+                }
+        }
+        captureFree(capture);
+}
+
+/*******************************************************************************
+* FUNCTION: captureFree
+*
+* DATE: October 18, 2026
+*
+* REVISIONS: (Date and Description)
+*
+* DESIGNER: Karl Castillo (c)
+*
+* PROGRAMMER: Karl Castillo (c)
+*
+* INTERFACE: static void captureFree(PCAPTURE capture)
+* capture: the capture
+*
+* RETURN: void
+*
+* NOTES:
+* Releases whatever has been set up so far, so an open that fails half way
+* can call it too. The open functions clear the capture first, and what was
+* never allocated is NULL.
+*******************************************************************************/
+static void captureFree(PCAPTURE capture)
+{
+        if(capture->uring != NULL) {
+                uringBuffersFree(capture->uring, &capture->bufs);
+        }
+        if(capture->ring != NULL) {
+                munmap(capture->ring, capture->ring_size);
+        }
+        if(capture->sock >= 0) {
+                close(capture->sock);
+        }
+        free(capture->held);
+        free(capture->results);
+        free(capture->flags);
+        free(capture->buffers);
+        free(capture->msgs);
+        free(capture->iovs);
+        free(capture->controls);
+        free(capture->frames);
+        free(capture->lens);
+        free(capture->stamps);
+}
+
+/*******************************************************************************
+* FUNCTION: captureReport
+*
+* DATE: October 18, 2026
+*
+* REVISIONS: (Date and Description)
+*
+* DESIGNER: Karl Castillo (c)
+*
+* PROGRAMMER: Karl Castillo (c)
+*
+* INTERFACE: void captureReport(PCAPTURE capture, FILE *out)
+* capture: the capture
+* out: where the report will be printed
+*
+* RETURN: void
+*
+*******************************************************************************/
+void captureReport(PCAPTURE capture, FILE *out)
+{
+        fprintf(out, "Received %lu packets in %lu batches, %u dropped\n",
+                capture->received, capture->batches, captureDrops(capture));
+
+        if(capture->mode == CAPTURE_RING) {
+                fprintf(out, "Ring: %d blocks of %d bytes (%s pages), "
+                        "%lu freezes\n", capture->blocks, capture->block_size,
+                        capture->huge ? "huge" : "regular", capture->freezes);
+        }
+
+        if(capture->mode == CAPTURE_URING) {
+                fprintf(out, "io_uring: %d buffers of %d bytes, receive "
+                        "started %lu times\n", capture->bufs.count,
+                        capture->bufs.size, capture->arms);
+        }
+
+        if(capture->mode == CAPTURE_PCAP) {
+                if(!capture->ended && capture->started > 0) {
+                        capture->elapsed = captureNow() - capture->started;
+                }
+                fprintf(out, "Pcap: %lu records skipped, read in %.3f s "
+                        "(%.0f packets/s)\n", capture->skipped,
+                        capture->elapsed, capture->elapsed > 0 ?
+                        capture->received / capture->elapsed : 0.0);
+        }
+}
@@ -0,0 +1,122 @@
+/*******************************************************************************
+* HEADER FILE: capture.h
+*
+* PROGRAM: Covert
+*
+* FUNCTIONS:
+* int captureOpen(PCAPTURE capture, int batch, int rcvbuf, int dual);
+* int captureOpenRing(PCAPTURE capture, int batch, int blocks, int block_size,
+*        int huge, int dual);
+* int captureOpenPcap(PCAPTURE capture, char *path, int batch);
+* int captureOpenUring(PCAPTURE capture, int batch, int rcvbuf, int dual,
+*        PURING ring);
+* int captureNext(PCAPTURE capture);
+* int captureTimeout(PCAPTURE capture, int ms);
+* unsigned int captureDrops(PCAPTURE capture);
+* void captureClose(PCAPTURE capture);
+* void captureReport(PCAPTURE capture, FILE *out);
+*
+* DATE: October 18, 2026
+*
+* DESIGNER: Karl Castillo (c)
+*
+* PROGRAMMER: Karl Castillo (c)
+*
+* NOTES:
+* The receive path of the server. A capture hands the decoder batches of
+* packets, each starting at the IP header. Packets are either copied out of a
+* raw socket or read in place from a memory-mapped TPACKET_V3 ring, received
+* into provided buffers by a multishot io_uring request, or replayed from a
+* pcap file. A dual-stack capture returns IPv6 packets as well as IPv4 ones.
+*******************************************************************************/
+#ifndef CAPTURE_H
+#define CAPTURE_H
+
+#include <stdio.h>
+#include <netinet/in.h>
+#include <netinet/tcp.h>
+#include <sys/socket.h>
+#include <linux/ip.h>
+#include "uring.h"
+
+/* DEFINES */
+#define DEF_RBATCH      64
+#define MAX_RBATCH      1024
+#define DEF_RCVBUF      (8 * 1024 * 1024)
+#define CAPTURE_SOCK    1
+#define CAPTURE_RING    2
+#define CAPTURE_PCAP    3
+#define CAPTURE_URING   4
+#define DEF_RING_BLOCKS 64
+#define DEF_RING_KB     1024
+#define RING_FRAME      2048
+#define RING_TIMEOUT    10              /* ms before a partial block retires */
+#define HUGE_PAGE       (2 * 1024 * 1024)
+#define URING_FRAME     2048            /* bytes per provided buffer */
+#define URING_GROUP     1               /* the buffer group of the capture */
+
+/* STRUCTURES */
+typedef struct recvdhr {
+        struct iphdr ip;
+        struct tcphdr tcp;
+        char buffer[10000];
+} RECVHDR, *PRECVHDR;
+
+typedef struct capture {
+        int mode;               /* CAPTURE_SOCK, CAPTURE_RING, CAPTURE_PCAP
+                                   or CAPTURE_URING */
+        int sock;               /* raw TCP socket, packet socket or -1 */
+        int batch;              /* most packets returned per call */
+        int rcvbuf;             /* socket receive buffer the kernel gave us */
+        PRECVHDR buffers;       /* the batch of receive buffers */
+        struct mmsghdr *msgs;   /* one message per buffer */
+        struct iovec *iovs;     /* one vector per buffer */
+        char *controls;         /* one control buffer per message */
+        PRECVHDR *frames;       /* the packets returned by captureNext */
+        int *lens;              /* the length of each returned packet */
+        long long *stamps;      /* when the kernel got each one, ns, or 0 */
+        int timeout;            /* ms captureNext waits, -1 for ever */
+        unsigned long received; /* packets received */
+        unsigned long batches;  /* calls that returned packets */
+        unsigned int drops;     /* packets the socket dropped, SO_RXQ_OVFL */
+        unsigned char *ring;    /* the mapped ring or pcap file */
+        size_t ring_size;       /* bytes mapped */
+        int huge;               /* the ring is backed by huge pages */
+        int blocks;             /* blocks in the ring */
+        int block_size;         /* bytes per block */
+        int block;              /* the block being read */
+        int left;               /* packets left to read in that block */
+        unsigned char *cursor;  /* the next packet in that block */
+        unsigned long freezes;  /* times the ring filled up, PACKET_STATISTICS */
+        unsigned int linktype;  /* what a pcap record starts with */
+        int swapped;            /* the pcap file is in the other byte order */
+        int ended;              /* every pcap record has been read */
+        unsigned long skipped;  /* pcap records that are not TCP */
+        double started;         /* when the first pcap batch was read, s */
+        double elapsed;         /* seconds from then to the end of the file */
+        PURING uring;           /* the ring of an io_uring capture */
+        URINGOP recv;           /* the multishot receive */
+        URINGBUFS bufs;         /* the buffers it fills */
+        int *held;              /* buffers handed out by the last call */
+        int holding;            /* the number of them */
+        int *results;           /* receives not handed out yet */
+        unsigned int *flags;    /* and their flags */
+        unsigned int done_head; /* the oldest of them */
+        unsigned int done_tail; /* one past the newest */
+        unsigned long arms;     /* times the receive was started */
+} CAPTURE, *PCAPTURE;
+
+/* PROTOTYPES */
+int captureOpen(PCAPTURE capture, int batch, int rcvbuf, int dual);
+int captureOpenRing(PCAPTURE capture, int batch, int blocks, int block_size,
+        int huge, int dual);
+int captureOpenPcap(PCAPTURE capture, char *path, int batch);
+int captureOpenUring(PCAPTURE capture, int batch, int rcvbuf, int dual,
+        PURING ring);
+int captureNext(PCAPTURE capture);
+int captureTimeout(PCAPTURE capture, int ms);
+unsigned int captureDrops(PCAPTURE capture);
+void captureClose(PCAPTURE capture);
+void captureReport(PCAPTURE capture, FILE *out);
+
+#endif
@@ -0,0 +1,416 @@
+/*******************************************************************************
+* SOURCE FILE: cksum.c
+*
+* PROGRAM: Covert
+*
+* FUNCTIONS:
+* unsigned short in_cksum(unsigned short *ptr, int nbytes);
+* unsigned short cksumFold(unsigned int sum);
+* unsigned short cksumSse2(unsigned short *ptr, int nbytes);
+* unsigned short cksumAvx2(unsigned short *ptr, int nbytes);
+* unsigned short cksumSimd(unsigned short *ptr, int nbytes);
+* int cksumLevel(void);
+* static unsigned short cksumTail(long sum, unsigned short *ptr, int nbytes);
+*
+* DATE: October 18, 2026
+*
+* DESIGNER: Karl Castillo (c)
+*
+* PROGRAMMER: Karl Castillo (c)
+*
+* NOTES:
+* The Internet checksum. In_cksum used to live in client.c; it is on its own
+* now that the packet template needs it as well.
+*
+* The vector variants are built for x86 only, with the instructions enabled
+* per function so the library still runs on any x86 CPU; elsewhere they are
+* in_cksum itself.
+*******************************************************************************/
+/* INCLUDES */
+#include <sys/types.h>
+#include "cksum.h"
+
+#if defined(__x86_64__) || defined(__i386__)
+#include <immintrin.h>
+#define CKSUM_X86
+#endif
+
+/* DEFINES */
+#define CKSUM_BLOCK     16384   /* vectors summed before a 32-bit lane could
+                                   overflow, two words per lane each */
+
+/* PROTOTYPES */
+#ifdef CKSUM_X86
+static unsigned short cksumTail(long sum, unsigned short *ptr, int nbytes);
+#endif
+
+/*******************************************************************************
+* FUNCTION: in_cksum
+*
+* DATE: September 13, 2012
+*
+* REVISIONS: (Date and Description)
+*
+* DESIGNER: Craig Rowland (c)
+*
+* PROGRAMMER: Karl Castillo (c)
+*
+* INTERFACE: unsigned short in_cksum(unsigned short *ptr, int nbytes)
+* ptr: pointer to the header
+* nbytes: size of the header
+*
+* RETURN: unsigned short: the calculated checksum
+*
+* NOTES:
+* In_cksum calculates the poper checksum depending on the header type.
+*******************************************************************************/
+unsigned short in_cksum(unsigned short *ptr, int nbytes)
+{
+	register long sum;
+	u_short oddbyte;
+	register u_short answer;
+
+	/*
+	 * Our algorithm is simple, using a 32-bit accumulator (sum),
+	 * we add sequential 16-bit words to it, and at the end, fold back
+	 * all the carry bits from the top 16 bits into the lower 16 bits.
+	 */
+
+	sum = 0;
+	while (nbytes > 1)  {
+		sum += *ptr++;
+		nbytes -= 2;
+	}
+
+	/* mop up an odd byte, if necessary */
+	if (nbytes == 1) {
+		oddbyte = 0; /* make sure top half is zero */
+		*((u_char *) &oddbyte) = *(u_char *)ptr; /* one byte only */
+		sum += oddbyte;
+	}
+
+	/*
+	 * Add back carry outs from top 16 bits to low 16 bits.
+	 */
+
+	sum  = (sum >> 16) + (sum & 0xffff); /* add high-16 to low-16 */
+	sum += (sum >> 16); /* add carry */
+	answer = ~sum; /* ones-complement, then truncate to 16 bits */
+	
+	return(answer);
+}
+
+/*******************************************************************************
+* FUNCTION: cksumFold
+*
+* DATE: October 18, 2026
+*
+* REVISIONS: (Date and Description)
+*
+* DESIGNER: Karl Castillo (c)
+*
+* PROGRAMMER: Karl Castillo (c)
+*
+* INTERFACE: unsigned short cksumFold(unsigned int sum)
+* sum: a 32-bit ones-complement sum of 16-bit words
+*
+* RETURN: unsigned short: the checksum of the sum
+*
+* NOTES:
+* The last step of in_cksum on its own, for checksums that are summed
+* incrementally.
+*******************************************************************************/
+unsigned short cksumFold(unsigned int sum)
+{
+        sum = (sum >> 16) + (sum & 0xffff);
+        sum += (sum >> 16);
+
+        return (unsigned short)~sum;
+}
+
+#ifdef CKSUM_X86
+/*******************************************************************************
+* FUNCTION: cksumSse2
+*
+* DATE: October 18, 2026
+*
+* REVISIONS: (Date and Description)
+*
+* DESIGNER: Karl Castillo (c)
+*
+* PROGRAMMER: Karl Castillo (c)
+*
+* INTERFACE: unsigned short cksumSse2(unsigned short *ptr, int nbytes)
+* ptr: pointer to the header
+* nbytes: size of the header
+*
+* RETURN: unsigned short: the checksum, as in_cksum calculates it
+*
+* NOTES:
+* Sixteen bytes at a time: the eight words are widened to 32 bits and added
+* into four lanes. The lanes are added into the scalar sum every CKSUM_BLOCK
+* vectors, before they can overflow, so the sum is the very one in_cksum
+* builds and folding it gives the same bits.
+*******************************************************************************/
+__attribute__((target("sse2")))
+unsigned short cksumSse2(unsigned short *ptr, int nbytes)
+{
+        __m128i zero = _mm_setzero_si128();
+        __m128i acc;
+        __m128i v;
+        unsigned int lanes[4];
+        long sum = 0;
+        int n;
+        int i;
+
+        while(nbytes >= 16) {
+                acc = zero;
+                for(n = 0; n < CKSUM_BLOCK && nbytes >= 16; n++) {
+                        v = _mm_loadu_si128((const __m128i*)ptr);
+                        acc = _mm_add_epi32(acc, _mm_unpacklo_epi16(v, zero));
+                        acc = _mm_add_epi32(acc, _mm_unpackhi_epi16(v, zero));
+                        ptr += 8;
+                        nbytes -= 16;
+                }
+                _mm_storeu_si128((__m128i*)lanes, acc);
+                for(i = 0; i < 4; i++) {
+                        sum += lanes[i];
+                }
+        }
+
+        return cksumTail(sum, ptr, nbytes);
+}
+
+/*******************************************************************************
+* FUNCTION: cksumAvx2
+*
+* DATE: October 18, 2026
+*
+* REVISIONS: (Date and Description)
+*
+* DESIGNER: Karl Castillo (c)
+*
+* PROGRAMMER: Karl Castillo (c)
+*
+* INTERFACE: unsigned short cksumAvx2(unsigned short *ptr, int nbytes)
+* ptr: pointer to the header
+* nbytes: size of the header
+*
+* RETURN: unsigned short: the checksum, as in_cksum calculates it
+*
+* NOTES:
+* CksumSse2 with 32 bytes and eight lanes at a time, then one 16 byte step
+* if that much is left. Only call it when cksumLevel says the CPU has AVX2.
+*******************************************************************************/
+__attribute__((target("avx2")))
+unsigned short cksumAvx2(unsigned short *ptr, int nbytes)
+{
+        __m256i zero = _mm256_setzero_si256();
+        __m256i acc;
+        __m256i v;
+        __m128i half;
+        unsigned int lanes[8];
+        long sum = 0;
+        int n;
+        int i;
+
+        while(nbytes >= 32) {
+                acc = zero;
+                for(n = 0; n < CKSUM_BLOCK && nbytes >= 32; n++) {
+                        v = _mm256_loadu_si256((const __m256i*)ptr);
+                        acc = _mm256_add_epi32(acc,
+                                _mm256_unpacklo_epi16(v, zero));
+                        acc = _mm256_add_epi32(acc,
+                                _mm256_unpackhi_epi16(v, zero));
+                        ptr += 16;
+                        nbytes -= 32;
+                }
+                _mm256_storeu_si256((__m256i*)lanes, acc);
+                for(i = 0; i < 8; i++) {
+                        sum += lanes[i];
+                }
+        }
+
+        if(nbytes >= 16) {
+                half = _mm_loadu_si128((const __m128i*)ptr);
+                half = _mm_add_epi32(_mm_unpacklo_epi16(half,
+                        _mm_setzero_si128()), _mm_unpackhi_epi16(half,
+                        _mm_setzero_si128()));
+                _mm_storeu_si128((__m128i*)lanes, half);
+                for(i = 0; i < 4; i++) {
+                        sum += lanes[i];
+                }
+                ptr += 8;
+                nbytes -= 16;
+        }
+
+        return cksumTail(sum, ptr, nbytes);
+}
+#else
+/*******************************************************************************
+* FUNCTION: cksumSse2
+*
+* DATE: October 18, 2026
+*
+* REVISIONS: (Date and Description)
+*
+* DESIGNER: Karl Castillo (c)
+*
+* PROGRAMMER: Karl Castillo (c)
+*
+* INTERFACE: unsigned short cksumSse2(unsigned short *ptr, int nbytes)
+* ptr: pointer to the header
+* nbytes: size of the header
+*
+* RETURN: unsigned short: the calculated checksum
+*
+* NOTES:
+* Not an x86 build: in_cksum.
+*******************************************************************************/
+unsigned short cksumSse2(unsigned short *ptr, int nbytes)
+{
+        return in_cksum(ptr, nbytes);
+}
+
+/*******************************************************************************
+* FUNCTION: cksumAvx2
+*
+* DATE: October 18, 2026
+*
+* REVISIONS: (Date and Description)
+*
+* DESIGNER: Karl Castillo (c)
+*
+* PROGRAMMER: Karl Castillo (c)
+*
+* INTERFACE: unsigned short cksumAvx2(unsigned short *ptr, int nbytes)
+* ptr: pointer to the header
+* nbytes: size of the header
+*
+* RETURN: unsigned short: the calculated checksum
+*
+* NOTES:
+* Not an x86 build: in_cksum.
+*******************************************************************************/
+unsigned short cksumAvx2(unsigned short *ptr, int nbytes)
+{
+        return in_cksum(ptr, nbytes);
+}
+#endif
+
+/*******************************************************************************
+* FUNCTION: cksumSimd
+*
+* DATE: October 18, 2026
+*
+* REVISIONS: (Date and Description)
+*
+* DESIGNER: Karl Castillo (c)
+*
+* PROGRAMMER: Karl Castillo (c)
+*
+* INTERFACE: unsigned short cksumSimd(unsigned short *ptr, int nbytes)
+* ptr: pointer to the header
+* nbytes: size of the header
+*
+* RETURN: unsigned short: the checksum, as in_cksum calculates it
+*
+* NOTES:
+* The widest variant the CPU runs.
+*******************************************************************************/
+unsigned short cksumSimd(unsigned short *ptr, int nbytes)
+{
+        switch(cksumLevel()) {
+        case CKSUM_AVX2:
+                return cksumAvx2(ptr, nbytes);
+        case CKSUM_SSE2:
+                return cksumSse2(ptr, nbytes);
+        }
+
+        return in_cksum(ptr, nbytes);
+}
+
+/*******************************************************************************
+* FUNCTION: cksumLevel
+*
+* DATE: October 18, 2026
+*
+* REVISIONS: (Date and Description)
+*
+* DESIGNER: Karl Castillo (c)
+*
+* PROGRAMMER: Karl Castillo (c)
+*
+* INTERFACE: int cksumLevel(void)
+*
+* RETURN: int
+* CKSUM_AVX2: the CPU runs cksumAvx2 and cksumSse2
+* CKSUM_SSE2: the CPU runs cksumSse2
+* CKSUM_SCALAR: only in_cksum is of any use
+*
+* NOTES:
+* The CPU is asked once. Threads racing on the first call store the same
+* answer.
+*******************************************************************************/
+int cksumLevel(void)
+{
+        static int level = -1;
+
+        if(level < 0) {
+#ifdef CKSUM_X86
+                level = __builtin_cpu_supports("avx2") ? CKSUM_AVX2 :
+                        __builtin_cpu_supports("sse2") ? CKSUM_SSE2 :
+                        CKSUM_SCALAR;
+#else
+                level = CKSUM_SCALAR;
+#endif
+        }
+
+        return level;
+}
+
+#ifdef CKSUM_X86
+/*******************************************************************************
+* FUNCTION: cksumTail
+*
+* DATE: October 18, 2026
+*
+* REVISIONS: (Date and Description)
+*
+* DESIGNER: Karl Castillo (c)
+*
+* PROGRAMMER: Karl Castillo (c)
+*
+* INTERFACE: static unsigned short cksumTail(long sum, unsigned short *ptr,
+*       int nbytes)
+* sum: the words summed so far
+* ptr: the words left
+* nbytes: the bytes left, fewer than a vector
+*
+* RETURN: unsigned short: the checksum
+*
+* NOTES:
+* The end of in_cksum, step for step, so the vector variants fold the same
+* way it does.
+*******************************************************************************/
+static unsigned short cksumTail(long sum, unsigned short *ptr, int nbytes)
+{
+        unsigned short oddbyte;
+
+        while(nbytes > 1) {
+                sum += *ptr++;
+                nbytes -= 2;
+        }
+
+        if(nbytes == 1) {
+                oddbyte = 0;
+                *((unsigned char*)&oddbyte) = *(unsigned char*)ptr;
+                sum += oddbyte;
+        }
+
+        sum = (sum >> 16) + (sum & 0xffff);
+        sum += (sum >> 16);
+
+        return (unsigned short)~sum;
+}
+#endif
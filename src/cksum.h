@@ -0,0 +1,40 @@
+/*******************************************************************************
+* HEADER FILE: cksum.h
+*
+* PROGRAM: Covert
+*
+* FUNCTIONS:
+* unsigned short in_cksum(unsigned short *ptr, int nbytes);
+* unsigned short cksumFold(unsigned int sum);
+* unsigned short cksumSse2(unsigned short *ptr, int nbytes);
+* unsigned short cksumAvx2(unsigned short *ptr, int nbytes);
+* unsigned short cksumSimd(unsigned short *ptr, int nbytes);
+* int cksumLevel(void);
+*
+* DATE: October 18, 2026
+*
+* DESIGNER: Karl Castillo (c)
+*
+* PROGRAMMER: Karl Castillo (c)
+*
+* NOTES:
+* The Internet checksum. The SSE2 and AVX2 variants give exactly what
+* in_cksum gives.
+*******************************************************************************/
+#ifndef CKSUM_H
+#define CKSUM_H
+
+/* DEFINES */
+#define CKSUM_SCALAR    0       /* cksumLevel: no vector unit to use */
+#define CKSUM_SSE2      1
+#define CKSUM_AVX2      2
+
+/* PROTOTYPES */
+unsigned short in_cksum(unsigned short *ptr, int nbytes);
+unsigned short cksumFold(unsigned int sum);
+unsigned short cksumSse2(unsigned short *ptr, int nbytes);
+unsigned short cksumAvx2(unsigned short *ptr, int nbytes);
+unsigned short cksumSimd(unsigned short *ptr, int nbytes);
+int cksumLevel(void);
+
+#endif
@@ -4,13 +4,19 @@
 * PROGRAM: Covert
 *
 * FUNCTIONS:
-* unsigned int ip_convert(char *hostname);
-* unsigned short in_cksum(unsigned short *ptr, int nbytes);
-* void doEncode(unsigned int source_ip, unsigned int dest_ip, unsigned short
-*        source_port, unsigned short dest_port, char *filename, int option);
-* struct iphdr createIphdr(unsigned int source_ip, unsigned int dest_ip, int type,
-*        char c);
-* struct tcphdr createTcphdr(unsigned short source_port, unsigned short dest_port);
+* void doEncode(PINPUT input, PTEMPLATE template, PSENDER sender,
+*        PPARITY parity, PFEEDBACK feedback, int verbose);
+* int doFeedback(PTEMPLATE template, PSENDER sender, PFEEDBACK feedback,
+*        int finish);
+* void doParallel(PINPUT input, PLAYOUT layout, PFEC fec, PFLOW flows,
+*        int count);
+* void doStats(void *context, int due);
+* struct iphdr createIphdr(unsigned int source_ip, unsigned int dest_ip,
+*        PPRNG prng);
+* struct tcphdr createTcphdr(unsigned short source_port, unsigned short dest_port,
+*        PPRNG prng);
+* struct ip6_hdr createIp6hdr(struct in6_addr source_ip,
+*        struct in6_addr dest_ip);
 *
 * DATE: September 13, 2012
 *
@@ -34,43 +40,57 @@
 #include <netdb.h>
 #include <netinet/in.h>
 #include <netinet/tcp.h>
+#include <netinet/ip6.h>
 #include <sys/socket.h>
 #include <arpa/inet.h>
 #include <linux/ip.h>
+#include "covert.h"
+#include "fec.h"
+#include "feedback.h"
+#include "flow.h"
+#include "input.h"
+#include "lz.h"
+#include "pacer.h"
+#include "prng.h"
+#include "sender.h"
+#include "stats.h"
+#include "template.h"
+#include "uring.h"
 
 /* DEFINES */
 #define VERSION         "1.0"
-#define TOS             1
-#define TTL             2
 #define DEF_SPORT       8000
 #define DEF_DPORT       8000
 #define DEF_SIP         "192.168.1.71"
 #define DEF_DIP         "192.168.1.71"
 #define DEF_FIL         "secret.txt"
+#define DEF_RATE        "1p"
+#define DEF_MAC         "00:00:00:00:00:00"
 
 /* STRUCTURES */
-typedef struct sendhdr {
-        struct iphdr ip;
-        struct tcphdr tcp;
-} SENDHDR, *PSENDHDR;
-
-typedef struct pseudo_header {
-      unsigned int source_address;
-      unsigned int dest_address;
-      unsigned char placeholder;
-      unsigned char protocol;
-      unsigned short tcp_length;
-      struct tcphdr tcp;
-} PSEUDOHDR, *PPSEUDOHDR;
+typedef struct watch {
+        PSTATS stats;                   /* when the statistics are due */
+        PFLOW flows;                    /* the flows of a parallel client */
+        int count;                      /* the number of flows */
+        PSENDER sender;                 /* the sender of a single flow */
+        PPACER pacer;                   /* and its pacer */
+        PFEEDBACK feedback;             /* the feedback, or NULL */
+} WATCH, *PWATCH;
 
 /* PROTOTYPES */
-unsigned int ip_convert(char *hostname);
-unsigned short in_cksum(unsigned short *ptr, int nbytes);
-void doEncode(unsigned int source_ip, unsigned int dest_ip, unsigned short
-        source_port, unsigned short dest_port, char *filename, int option);
-struct iphdr createIphdr(unsigned int source_ip, unsigned int dest_ip, int type,
-        char c);
-struct tcphdr createTcphdr(unsigned short source_port, unsigned short dest_port);
+void doEncode(PINPUT input, PTEMPLATE template, PSENDER sender,
+        PPARITY parity, PFEEDBACK feedback, int verbose);
+int doFeedback(PTEMPLATE template, PSENDER sender, PFEEDBACK feedback,
+        int finish);
+void doParallel(PINPUT input, PLAYOUT layout, PFEC fec, PFLOW flows,
+        int count);
+void doStats(void *context, int due);
+struct iphdr createIphdr(unsigned int source_ip, unsigned int dest_ip,
+        PPRNG prng);
+struct tcphdr createTcphdr(unsigned short source_port, unsigned short dest_port,
+        PPRNG prng);
+struct ip6_hdr createIp6hdr(struct in6_addr source_ip,
+        struct in6_addr dest_ip);
 
 /*******************************************************************************
 * FUNCTION: main
@@ -78,6 +98,8 @@ struct tcphdr createTcphdr(unsigned short source_port, unsigned short dest_port)
 * DATE: September 13, 2012
 *
 * REVISIONS: (Date and Description)
+* October 18, 2026: Sends over IPv6 with -6.
+* October 18, 2026: Compresses in small frames when losses are not repaired.
 *
 * DESIGNER: Karl Castillo (c)
 *
@@ -91,39 +113,102 @@ struct tcphdr createTcphdr(unsigned short source_port, unsigned short dest_port)
 * RETURN: int
 * 0: in success
 * 1: not running in root error
-* 2: no decoding type chosen
+* 2: no or invalid encoding layout chosen
+* 4: cannot open the input
+* 5: invalid rate
+* 6: invalid batch size
+* 7: invalid MAC address
+* 8: invalid number of flows
+* 9: invalid FEC code
+* 10: invalid feedback port, or feedback with more than one flow or a pcap
+*       file
+* 11: invalid statistics interval
+* 12: io_uring with a transmit ring or a pcap file
+* 13: IPv6 without both the source and the destination
+* EXIT_FAILURE: cannot open the sender, the compression stage, the io_uring
+*       or the statistics
 *
 * NOTES:
 * A generic main function where the command line arguments are parsed, and the
 * proper preparations are made.
+*
+* The addresses are converted once every option is known, since -6 decides
+* whether they are IPv4 or IPv6. IPv6 has no default for either of them.
+*
+* A compressed input is cut into frames of LZ_BLOCK bytes when FEC or
+* feedback repairs losses, and of LZ_SMALL bytes otherwise: a lost packet
+* makes the server drop the frame it falls in, or the two it straddles, so
+* without repair one loss costs at most 8 KB of the input rather than 128 KB.
 *******************************************************************************/
 int main(int argc, char* argv[])
 {
         unsigned int source_ip = 0;
         unsigned int dest_ip = 0;
+        struct in6_addr source_ip6;
+        struct in6_addr dest_ip6;
+        struct sockaddr_storage dest;
+        struct sockaddr_in *sin = (struct sockaddr_in*)&dest;
+        struct sockaddr_in6 *sin6 = (struct sockaddr_in6*)&dest;
+        int family = AF_INET;
+        int source_given = 0;
+        int dest_given = 0;
         unsigned short source_port = DEF_SPORT;
         unsigned short dest_port = DEF_DPORT;
-        int encoding_type = 0;
         int option = 0;
-        char file_name[80] = DEF_FIL;
-        char *encoding_name;
+        char *file_name = DEF_FIL;
+        char *encoding_name = NULL;
         char *source_name = DEF_SIP;
         char *dest_name = DEF_DIP;
+        char *rate_name = DEF_RATE;
+        double rate;
+        int rate_unit;
+        int batch = DEF_BATCH;
+        char *ifname = NULL;
+        char *mac_name = DEF_MAC;
+        char *pcap_name = NULL;
+        int pcap = -1;
+        unsigned char mac[6];
+        PACER pacer;
+        SENDER sender;
+        LAYOUT layout;
+        TEMPLATE template;
+        PRNG prng;
+        int check_every = 0;
+        int count = DEF_FLOWS;
+        PFLOW flows;
+        PFLOW flow;
+        struct tcphdr tcp;
+        INPUT input;
+        int verbose = 0;
+        int compress = 0;
+        LZ lz;
+        char *fec_name = NULL;
+        FEC fec;
+        PFEC code = NULL;
+        PARITY parity;
+        int feedback_port = 0;
+        FEEDBACK feedback;
+        int interval = 0;
+        STATS stats;
+        WATCH watch;
+        int use_uring = 0;
+        int transfer;
+        URING uring;
+        URING reported;
+        int i;
         
-        if(getuid() != 0) { /* check if user is in ROOT */
-                printf("\nYou must run this in root!\n");
-                return 1;
-        }
-        
-        while((option = getopt(argc, argv, ":S:D:s:d:f:tl")) != -1) {
+        while((option = getopt(argc, argv, ":S:D:s:d:f:r:b:T:M:L:C:P:E:A:w:I:tlvzU6")) != -1) {
                 switch(option) {
                 case 'S': /* source IP */
                 	source_name = optarg;
-                        source_ip = ip_convert(optarg);
+                        source_given = 1;
                         break;
                 case 'D': /* destination IP */
                 	dest_name = optarg;
-                        dest_ip = ip_convert(optarg);
+                        dest_given = 1;
+                        break;
+                case '6': /* send over IPv6 */
+                        family = AF_INET6;
                         break;
                 case 's': /* source port */
                         source_port = atoi(optarg);
@@ -132,24 +217,153 @@ int main(int argc, char* argv[])
                         dest_port = atoi(optarg);
                         break;
                 case 't': /* tos */
-                        encoding_type = TOS;
-                        encoding_name = "TOS";
+                        encoding_name = "tos";
                         break;
                 case 'l': /* ttl */
-                        encoding_type = TTL;
-                        encoding_name = "TTL";
+                        encoding_name = "ttl";
+                        break;
+                case 'L': /* multi-field layout */
+                        encoding_name = optarg;
+                        break;
+                case 'C': /* checksum self-check interval */
+                        check_every = atoi(optarg);
+                        break;
+                case 'P': /* parallel flows */
+                        count = atoi(optarg);
+                        break;
+                case 'E': /* FEC code, k:m */
+                        fec_name = optarg;
+                        break;
+                case 'A': /* UDP port the server reports to */
+                        feedback_port = atoi(optarg);
+                        break;
+                case 'z': /* compress the input, LZ_SMALL byte frames
+                             without FEC or feedback since one lost packet
+                             costs the frames it falls in */
+                        compress = 1;
+                        break;
+                case 'v': /* echo every byte sent */
+                        verbose = 1;
                         break;
                 case 'f': /* file name */
-                        strncpy(file_name, optarg, 79);
+                        file_name = optarg;
+                        break;
+                case 'r': /* send rate */
+                        rate_name = optarg;
+                        break;
+                case 'b': /* send batch size */
+                        batch = atoi(optarg);
+                        break;
+                case 'T': /* transmit ring interface */
+                        ifname = optarg;
+                        break;
+                case 'M': /* transmit ring next hop MAC */
+                        mac_name = optarg;
+                        break;
+                case 'w': /* write the packets to a pcap file */
+                        pcap_name = optarg;
+                        break;
+                case 'I': /* seconds between statistics summaries */
+                        interval = atoi(optarg);
+                        break;
+                case 'U': /* send and read through io_uring */
+                        use_uring = 1;
                         break;
                 }
         }
         
-        if(encoding_type == 0) {
-                perror("Please select an encoding type.\n");
+        if(getuid() != 0 && pcap_name == NULL) { /* check if user is in ROOT */
+                printf("\nYou must run this in root!\n");
+                return 1;
+        }
+        
+        if(encoding_name == NULL) {
+                fprintf(stderr, "Please select an encoding type.\n");
                 return 2;
         }
         
+        if(layoutParse(encoding_name, &layout) < 0) {
+                fprintf(stderr, "Invalid layout %s\n", encoding_name);
+                return 2;
+        }
+        
+        if(layoutFamily(&layout, family) < 0) {
+                fprintf(stderr, "Layout %s cannot be sent over %s\n",
+                        encoding_name, family == AF_INET6 ? "IPv6" : "IPv4");
+                return 2;
+        }
+        
+        memset(&dest, 0, sizeof(dest));
+        if(family == AF_INET6) {
+                if(!source_given || !dest_given) {
+                        fprintf(stderr, "IPv6 needs a source and a "
+                                "destination (-S and -D)\n");
+                        return 13;
+                }
+                source_ip6 = ip6_convert(source_name);
+                dest_ip6 = ip6_convert(dest_name);
+                sin6->sin6_family = AF_INET6;
+                sin6->sin6_addr = dest_ip6;
+        } else {
+                if(source_given) {
+                        source_ip = ip_convert(source_name);
+                }
+                if(dest_given) {
+                        dest_ip = ip_convert(dest_name);
+                }
+                sin->sin_family = AF_INET;
+                sin->sin_addr.s_addr = dest_ip;
+        }
+        
+        if(pacerParse(rate_name, &rate, &rate_unit) < 0) {
+                fprintf(stderr, "Invalid rate %s\n", rate_name);
+                return 5;
+        }
+        pacerInit(&pacer, rate, rate_unit);
+        
+        if(batch < 1 || batch > MAX_BATCH) {
+                fprintf(stderr, "Batch size must be between 1 and %d\n",
+                        MAX_BATCH);
+                return 6;
+        }
+        
+        if(senderParseMac(mac_name, mac) < 0) {
+                fprintf(stderr, "Invalid MAC address %s\n", mac_name);
+                return 7;
+        }
+        
+        if(count < 1 || count > MAX_FLOWS) {
+                fprintf(stderr, "Flows must be between 1 and %d\n", MAX_FLOWS);
+                return 8;
+        }
+        
+        if(fec_name != NULL) {
+                if(fecInit(&fec, fec_name, layout.bits) < 0) {
+                        fprintf(stderr, "Invalid FEC code %s, k:m with k "
+                                "from 1 to %d and m from 1 to %d\n",
+                                fec_name, MAX_DATA, MAX_PARITY);
+                        return 9;
+                }
+                code = &fec;
+        }
+        
+        if(feedback_port != 0 && (feedback_port < 1 || feedback_port > 65535 ||
+                        count > 1 || pcap_name != NULL)) {
+                fprintf(stderr, "Feedback needs a port from 1 to 65535, a "
+                        "single flow and the network\n");
+                return 10;
+        }
+        
+        if(interval < 0) {
+                fprintf(stderr, "Statistics interval must not be negative\n");
+                return 11;
+        }
+        
+        if(use_uring && (ifname != NULL || pcap_name != NULL)) {
+                fprintf(stderr, "io_uring only drives the raw socket\n");
+                return 12;
+        }
+        
         printf("Covert Data Transfer using TCP Version %s (Server)\n", VERSION);
         printf("Karl Castillo (c)\n\n");
         printf("Source IP: %s\n", source_name);
@@ -157,10 +371,239 @@ int main(int argc, char* argv[])
         printf("Destination IP: %s\n", dest_name);
         printf("Destination Port: %d\n", dest_port);
         printf("File Name: %s\n", file_name);
-        printf("Encoding: %s\n", encoding_name);
+        layoutReport(&layout, stdout);
+        printf("Rate: %s\n", rate_unit == PACE_NONE ? "unpaced" : rate_name);
+        printf("Batch Size: %d\n", batch);
+        fecReport(code, stdout);
+        if(feedback_port != 0) {
+                printf("Feedback: port %d\n", feedback_port);
+        } else {
+                printf("Feedback: off\n");
+        }
+        if(interval > 0) {
+                printf("Statistics: every %d s and on SIGUSR1\n", interval);
+        } else {
+                printf("Statistics: on SIGUSR1\n");
+        }
+        statsInit(&stats, interval);
+        memset(&watch, 0, sizeof(watch));
+        watch.stats = &stats;
+        
+        if(inputOpen(&input, file_name) < 0) {
+                fprintf(stderr, "Cannot open %s\n", file_name);
+                return 4;
+        }
+        printf("Input: %s%s\n", input.mapped ? "mapped" : "streamed",
+                compress ? ", compressed" : "");
+        
+        if(use_uring && (uringOpen(&uring, batch + URING_SPARE, 0) < 0 ||
+                        inputUring(&input, &uring) < 0)) {
+                perror("Cannot set up io_uring");
+                return EXIT_FAILURE;
+        }
+        
+        if(compress) {
+                if(lzInit(&lz) < 0) {
+                        perror("Cannot create the compression stage");
+                        return EXIT_FAILURE;
+                }
+                inputCompress(&input, &lz, code != NULL ||
+                        feedback_port != 0 ? LZ_BLOCK : LZ_SMALL);
+        }
+        
+        if(pcap_name != NULL && (pcap = senderPcapCreate(pcap_name)) < 0) {
+                perror("Cannot create the pcap file");
+                return EXIT_FAILURE;
+        }
+        
+        prngSeed(&prng, 0);
+        transfer = 1 + prngNext(&prng) % (TRANSFER_IDS - 1);
+        
+        if(count > 1) {
+                if((flows = (PFLOW)calloc(count, sizeof(FLOW))) == NULL) {
+                        perror("Cannot allocate the flows");
+                        return EXIT_FAILURE;
+                }
+                for(i = 0; i < count; i++) {
+                        flow = &flows[i];
+                        pacerInit(&flow->pacer, rate / count, rate_unit);
+                        if((use_uring && (uringOpen(&flow->uring,
+                                        batch + URING_SPARE, 0) < 0 ||
+                                        senderOpenUring(&flow->sender,
+                                        (struct sockaddr*)&dest, batch,
+                                        &flow->pacer, &flow->uring) < 0)) ||
+                                        (pcap >= 0 && senderOpenPcap(
+                                        &flow->sender, pcap, family, batch,
+                                        &flow->pacer) < 0) ||
+                                        (pcap < 0 && ifname != NULL &&
+                                        senderOpenRing(&flow->sender, ifname,
+                                        mac, family, batch,
+                                        &flow->pacer) < 0) ||
+                                        (!use_uring && pcap < 0 &&
+                                        ifname == NULL &&
+                                        senderOpen(&flow->sender,
+                                        (struct sockaddr*)&dest, batch,
+                                        &flow->pacer) < 0)) {
+                                perror("Cannot create socket");
+                                return EXIT_FAILURE;
+                        }
+                        
+                        prngSeed(&flow->prng, 0);
+                        tcp = createTcphdr(source_port + i, dest_port,
+                                &flow->prng);
+                        tcp.window = htons(transfer << FLOW_BITS | i);
+                        if(family == AF_INET6) {
+                                templateInit6(&flow->template,
+                                        createIp6hdr(source_ip6, dest_ip6),
+                                        tcp, &layout, &flow->prng,
+                                        check_every);
+                        } else {
+                                templateInit(&flow->template,
+                                        createIphdr(source_ip, dest_ip,
+                                        &flow->prng), tcp, &layout,
+                                        &flow->prng, check_every);
+                        }
+                }
+                printf("Transmit: %d flows from ports %d to %d%s%s%s\n",
+                        count, source_port, source_port + count - 1,
+                        pcap >= 0 ? ", pcap file " : "",
+                        pcap >= 0 ? pcap_name : "",
+                        use_uring ? ", io_uring" : "");
+                if(pcap >= 0) {
+                        close(pcap);
+                }
+                
+                watch.flows = flows;
+                watch.count = count;
+                if(statsStart(&stats, doStats, &watch) != 0) {
+                        perror("Cannot start the statistics");
+                        return EXIT_FAILURE;
+                }
+                doParallel(&input, &layout, code, flows, count);
+                statsStop(&stats);
+                
+                parityInit(&parity, code);
+                memset(&reported, 0, sizeof(reported));
+                for(i = 0; i < count; i++) {
+                        senderClose(&flows[i].sender);
+                        templateReport(&flows[i].template, stdout);
+                        if(use_uring) {
+                                reported.submitted +=
+                                        flows[i].uring.submitted;
+                                reported.completed +=
+                                        flows[i].uring.completed;
+                                reported.enters += flows[i].uring.enters;
+                                uringClose(&flows[i].uring);
+                        }
+                        parity.pushed += flows[i].parity.pushed;
+                        parity.groups += flows[i].parity.groups;
+                        parity.sent += flows[i].parity.sent;
+                }
+                flowReport(flows, count, stdout);
+                if(code != NULL) {
+                        parityReport(&parity, stdout);
+                        fecClose(code);
+                }
+                free(flows);
+                inputClose(&input);
+                if(use_uring) {
+                        reported.submitted += uring.submitted;
+                        reported.completed += uring.completed;
+                        reported.enters += uring.enters;
+                        uringReport(&reported, stdout);
+                        uringClose(&uring);
+                }
+                if(compress) {
+                        lzReport(&lz, layout.bits, stdout);
+                        lzClose(&lz);
+                }
+                
+                return 0;
+        }
+        
+        if(pcap >= 0) {
+                if(senderOpenPcap(&sender, pcap, family, batch,
+                                &pacer) < 0) {
+                        perror("Cannot create the pcap sender");
+                        return EXIT_FAILURE;
+                }
+                close(pcap);
+                printf("Transmit: pcap file %s\n", pcap_name);
+        } else if(use_uring) {
+                if(senderOpenUring(&sender, (struct sockaddr*)&dest, batch,
+                                &pacer, &uring) < 0) {
+                        perror("Cannot create socket");
+                        return EXIT_FAILURE;
+                }
+                printf("Transmit: raw socket through io_uring\n");
+        } else if(ifname != NULL) {
+                if(senderOpenRing(&sender, ifname, mac, family, batch,
+                                &pacer) < 0) {
+                        perror("Cannot create transmit ring");
+                        return EXIT_FAILURE;
+                }
+                printf("Transmit: ring on %s to %s\n", ifname, mac_name);
+        } else {
+                if(senderOpen(&sender, (struct sockaddr*)&dest, batch,
+                                &pacer) < 0) {
+                        perror("Cannot create socket");
+                        return EXIT_FAILURE;
+                }
+                printf("Transmit: raw socket\n");
+        }
         
-        doEncode(source_ip, dest_ip, source_port, dest_port, file_name, 
-                encoding_type);
+        prngSeed(&prng, 0);
+        tcp = createTcphdr(source_port, dest_port, &prng);
+        tcp.window = htons(transfer << FLOW_BITS);
+        if(family == AF_INET6) {
+                templateInit6(&template, createIp6hdr(source_ip6, dest_ip6),
+                        tcp, &layout, &prng, check_every);
+        } else {
+                templateInit(&template, createIphdr(source_ip, dest_ip,
+                        &prng), tcp, &layout, &prng, check_every);
+        }
+        
+        if(feedback_port != 0 && feedbackOpen(&feedback, feedback_port,
+                        family, source_port, dest_port) < 0) {
+                perror("Cannot open the feedback port");
+                return EXIT_FAILURE;
+        }
+        
+        watch.count = 1;
+        watch.sender = &sender;
+        watch.pacer = &pacer;
+        watch.feedback = feedback_port != 0 ? &feedback : NULL;
+        if(statsStart(&stats, doStats, &watch) != 0) {
+                perror("Cannot start the statistics");
+                return EXIT_FAILURE;
+        }
+        
+        parityInit(&parity, code);
+        doEncode(&input, &template, &sender, code != NULL ? &parity : NULL,
+                feedback_port != 0 ? &feedback : NULL, verbose);
+        statsStop(&stats);
+        
+        inputClose(&input);
+        senderClose(&sender);
+        templateReport(&template, stdout);
+        senderReport(&sender, stdout);
+        pacerReport(&pacer, stdout);
+        if(feedback_port != 0) {
+                feedbackReport(&feedback, stdout);
+                feedbackClose(&feedback);
+        }
+        if(code != NULL) {
+                parityReport(&parity, stdout);
+                fecClose(code);
+        }
+        if(compress) {
+                lzReport(&lz, layout.bits, stdout);
+                lzClose(&lz);
+        }
+        if(use_uring) {
+                uringReport(&uring, stdout);
+                uringClose(&uring);
+        }
         
         return 0;
 }
@@ -171,76 +614,340 @@ int main(int argc, char* argv[])
 * DATE: September 13, 2012
 *
 * REVISIONS: (Date and Description)
+* October 18, 2026: Replaced the fixed one second sleep with the pacer.
+* October 18, 2026: Packets are built in place and sent in batches.
+* October 18, 2026: The sender is opened by the caller so either transmit
+*       backend can be used.
+* October 18, 2026: The payload is packed across the fields of a layout and
+*       the last packet is marked.
+* October 18, 2026: Packets are copied from the session template instead of
+*       being built from scratch.
+* October 18, 2026: Every packet is numbered so the server can reorder them.
+* October 18, 2026: The input is mapped or streamed in large chunks instead
+*       of being read with fgetc, and the bytes are only echoed when verbose.
+* October 18, 2026: Every group of packets can be followed by parity.
+* October 18, 2026: With feedback only a window of packets is in flight and
+*       the packets the server misses are sent again.
+* October 18, 2026: Without feedback the data packets are built a batch at
+*       a time.
 *
 * DESIGNER: Karl Castillo (c)
 *
 * PROGRAMMER: Karl Castillo (c)
 *
-* INTERFACE: void doEncode(unsigned int source_ip, unsigned int dest_ip, unsigned
-        short source_port, unsigned short dest_port, char *file_name, int type)
-* source_ip: the ip where the data supposedly be coming from
-* dest_ip: the ip where the data will be sent to
-* source_port: the port where the data will be coming from
-* dest_port: the port where the data will go to
-* file_name: the name of the input file
-* type: the type of encoding that will be done
-*       1: TOS
-*       2:  TTL
+* INTERFACE: void doEncode(PINPUT input, PTEMPLATE template, PSENDER sender,
+*       PPARITY parity, PFEEDBACK feedback, int verbose)
+* input: the open input
+* template: the packet template of the session
+* sender: the open sender the packets are built in and sent through
+* parity: the FEC encoder, or NULL for none
+* feedback: the feedback channel, or NULL to send blind
+* verbose: echo every byte as it is sent
 *
 * RETURN: void
 *
 * NOTES:
 * DoEncode is the function where the client will send the hidden data to the
-* server. This is also where the file will be read for transfer.
+* server. The input is walked one span at a time, either the whole mapping
+* or one chunk read from the stream. The last
+* packet always carries whatever bits are left over, possibly none, and is
+* marked so the server knows where the transfer ends.
+*
+* With feedback every packet waits for room in the window, and the transfer
+* only ends once the server reports it complete. When the server goes quiet
+* the rest is sent blind. Sent blind, the words of a whole batch are kept
+* and built with one templateBatch, ahead of the parity of a group they
+* complete.
 *******************************************************************************/
-void doEncode(unsigned int source_ip, unsigned int dest_ip, unsigned short
-        source_port, unsigned short dest_port, char *file_name, int type)
+void doEncode(PINPUT input, PTEMPLATE template, PSENDER sender,
+        PPARITY parity, PFEEDBACK feedback, int verbose)
 {
-        PSENDHDR sendhdr = (PSENDHDR)malloc(sizeof(SENDHDR));
-        PPSEUDOHDR pseudohdr = (PPSEUDOHDR)malloc(sizeof(PSEUDOHDR));
-        int c;
-        int sock;
-        struct sockaddr_in sin;
-        FILE *file;
-        
-        if((file = fopen(file_name, "rb")) == NULL) {
-                fprintf(stderr, "Cannot open %s\n", file_name);
-                exit(4);
+        PACKER packer;
+        unsigned long long word;
+        unsigned long long words[MAX_BATCH];
+        int pending = 0;
+        int full;
+        unsigned long bytes = 0;
+        unsigned long packets = 0;
+        const unsigned char *data;
+        long length;
+        long i;
+        int valid;
+        
+        packerInit(&packer, template->layout->bits);
+        
+        while((length = inputNext(input, &data)) > 0) {
+                for(i = 0; i < length; i++) {
+                        if(verbose) {
+                                printf("Sending: %c\n", data[i]);
+                        }
+                        
+                        if(packerPush(&packer, data[i], &word)) {
+                                if(feedback != NULL && doFeedback(template,
+                                                sender, feedback, 0) < 0) {
+                                        feedback = NULL;
+                                }
+                                if(feedback != NULL) {
+                                        templateBuild(template,
+                                                senderSlot(sender), packets,
+                                                word, -1);
+                                        senderPush(sender);
+                                        feedbackSent(feedback, packets, word,
+                                                -1);
+                                } else {
+                                        words[pending++] = word;
+                                }
+                                full = parity != NULL && parityPush(parity,
+                                        packets, word);
+                                packets++;
+                                if(full || pending == sender->batch) {
+                                        templateBatch(template, sender,
+                                                packets - pending, words,
+                                                pending);
+                                        pending = 0;
+                                }
+                                if(full) {
+                                        templateParity(template, sender,
+                                                parity, -1);
+                                }
+                        }
+                }
+                bytes += length;
         }
+        if(length < 0) {
+                perror("Cannot read the input");
+        }
+        templateBatch(template, sender, packets - pending, words, pending);
         
-        if((sock = socket(AF_INET, SOCK_RAW, IPPROTO_RAW)) < 0) {
-                perror("Cannot create socket");
-                exit(EXIT_FAILURE);
+        valid = packerFlush(&packer, &word);
+        if(feedback != NULL && doFeedback(template, sender, feedback, 0) < 0) {
+                feedback = NULL;
+        }
+        templateBuild(template, senderSlot(sender), packets, word,
+                valid);
+        senderPush(sender);
+        if(feedback != NULL) {
+                feedbackSent(feedback, packets, word, valid);
+        }
+        if(parity != NULL) {
+                parityPush(parity, packets, word);
+                templateParity(template, sender, parity, valid);
         }
+        packets++;
         
-        while((c = fgetc(file)) != EOF) {
-                sleep(1);
-                
-                printf("Sending: %c\n", c);
-                
-                sendhdr->ip = createIphdr(source_ip, dest_ip, type, c);
-                sendhdr->tcp = createTcphdr(source_port, dest_port);
-                
-                sin.sin_family = AF_INET;
-                sin.sin_port = sendhdr->tcp.source;
-                sin.sin_addr.s_addr = sendhdr->ip.daddr;
-                
-                sendhdr->ip.check = in_cksum((unsigned short*)&sendhdr->ip, 20);
-                
-                pseudohdr->source_address = sendhdr->ip.saddr;
-                pseudohdr->dest_address = sendhdr->ip.daddr;
-                pseudohdr->placeholder = 0;
-                pseudohdr->protocol = IPPROTO_TCP;
-                pseudohdr->tcp_length = htons(20);
-                
-                bcopy((char*)&sendhdr->tcp, (char*)&pseudohdr->tcp, 20);
+        if(feedback != NULL) {
+                doFeedback(template, sender, feedback, 1);
+        }
+        
+        printf("Payload: %lu bytes in %lu packets (%.3f bytes per packet)\n",
+                bytes, packets, (double)bytes / packets);
+}
+
+/*******************************************************************************
+* FUNCTION: doFeedback
+*
+* DATE: October 18, 2026
+*
+* REVISIONS: (Date and Description)
+*
+* DESIGNER: Karl Castillo (c)
+*
+* PROGRAMMER: Karl Castillo (c)
+*
+* INTERFACE: int doFeedback(PTEMPLATE template, PSENDER sender,
+*       PFEEDBACK feedback, int finish)
+* template: the packet template of the session
+* sender: the open sender
+* feedback: the feedback channel
+* finish: wait until the server completes the transfer, else only until
+*       the window has room for the next packet
+*
+* RETURN: int
+* 0: in success
+* -1: the server stopped reporting
+*
+* NOTES:
+* Takes the reports that arrived every FEED_POLL packets, and while it has
+* to wait sends what is batched and waits for the next report or the
+* retransmit timeout. The packets the server is missing are sent again
+* right away.
+*******************************************************************************/
+int doFeedback(PTEMPLATE template, PSENDER sender, PFEEDBACK feedback,
+        int finish)
+{
+        PSENT sent;
+        int block;
+        int count;
+        int i;
+        
+        block = finish ? !feedback->done : feedbackRoom(feedback) == 0;
+        if(!block && feedback->sent % FEED_POLL != 0) {
+                return 0;
+        }
+        
+        do {
+                if(block) {
+                        senderFlush(sender);
+                }
+                if((count = feedbackWait(feedback, block)) < 0) {
+                        fprintf(stderr, "No report from the server for %d ms, "
+                                "giving up on feedback\n", FEED_GIVEUP);
+                        return -1;
+                }
                 
-                sendhdr->tcp.check = in_cksum((unsigned short*)pseudohdr, 32);
+                for(i = 0; i < count; i++) {
+                        sent = &feedback->slots[feedback->resend[i] %
+                                FEED_MAP];
+                        templateBuild(template, senderSlot(sender),
+                                feedback->resend[i], sent->word, sent->valid);
+                        senderPush(sender);
+                }
+                if(feedback->probe) {
+                        templateProbe(template, senderSlot(sender));
+                        senderPush(sender);
+                        feedback->probe = 0;
+                }
+                if(count > 0 || block) {
+                        senderFlush(sender);
+                }
                 
-                sendto(sock, sendhdr, 40, 0, (struct sockaddr *)&sin, sizeof(sin));
+                block = finish ? !feedback->done : feedbackRoom(feedback) == 0;
+        } while(block);
+        
+        return 0;
+}
+
+/*******************************************************************************
+* FUNCTION: doParallel
+*
+* DATE: October 18, 2026
+*
+* REVISIONS: (Date and Description)
+*
+* DESIGNER: Karl Castillo (c)
+*
+* PROGRAMMER: Karl Castillo (c)
+*
+* INTERFACE: void doParallel(PINPUT input, PLAYOUT layout, PFEC fec,
+*       PFLOW flows, int count)
+* input: the open input
+* layout: the header fields that carry the payload
+* fec: the FEC code, or NULL for none
+* flows: the flows, each with its sender and template ready
+* count: the number of flows
+*
+* RETURN: void
+*
+* NOTES:
+* The parallel counterpart of doEncode. The flows pack their chunks straight
+* from the mapping, so the bytes are not echoed. A stream, or an input that
+* goes through the compression stage, is gathered into memory first since
+* the flows need the whole transfer laid out in front of them.
+*******************************************************************************/
+void doParallel(PINPUT input, PLAYOUT layout, PFEC fec, PFLOW flows,
+        int count)
+{
+        unsigned char *gathered = NULL;
+        long size;
+        JOB job;
+        
+        memset(&job, 0, sizeof(job));
+        job.data = input->data;
+        job.size = input->size;
+        job.layout = layout;
+        job.fec = fec;
+        
+        if(!input->mapped || input->lz != NULL) {
+                if((size = inputGather(input, &gathered)) < 0) {
+                        perror("Cannot read the input");
+                        return;
+                }
+                job.data = gathered;
+                job.size = size;
+        }
+        
+        if(flowRun(flows, count, &job) < 0) {
+                perror("Cannot send in parallel");
         }
-        close(sock);
-        fclose(file);
+        
+        printf("Payload: %lu bytes in %lu chunks\n", job.size, job.chunks);
+        free(gathered);
+}
+
+/*******************************************************************************
+* FUNCTION: doStats
+*
+* DATE: October 18, 2026
+*
+* REVISIONS: (Date and Description)
+*
+* DESIGNER: Karl Castillo (c)
+*
+* PROGRAMMER: Karl Castillo (c)
+*
+* INTERFACE: void doStats(void *context, int due)
+* context: the WATCH of the client
+* due: STATS_LINE for the one-line summary, STATS_JSON for the JSON dump
+*
+* RETURN: void
+*
+* NOTES:
+* Runs in the monitor thread and adds up the counters of every flow. The
+* rate and the batch fill are those since the last time the statistics were
+* shown; everything else counts from the start.
+*******************************************************************************/
+void doStats(void *context, int due)
+{
+        PWATCH watch = (PWATCH)context;
+        PSTATS stats = watch->stats;
+        PSENDER sender = watch->sender;
+        PPACER pacer = watch->pacer;
+        unsigned long packets = 0;
+        unsigned long bytes = 0;
+        unsigned long batches = 0;
+        unsigned long errors = 0;
+        unsigned long retries = 0;
+        unsigned long retransmits = 0;
+        double uptime = statsNow() - stats->started;
+        int i;
+        
+        for(i = 0; i < watch->count; i++) {
+                if(watch->flows != NULL) {
+                        sender = &watch->flows[i].sender;
+                        pacer = &watch->flows[i].pacer;
+                }
+                packets += pacer->packets;
+                bytes += pacer->bytes;
+                batches += sender->batches;
+                errors += sender->errors;
+                retries += sender->retries;
+        }
+        if(watch->feedback != NULL) {
+                retransmits = watch->feedback->retransmits;
+        }
+        
+        statsMark(stats, packets, batches, due);
+        
+        if(due & STATS_LINE) {
+                printf("Stats: %.1f s, %lu sent (%.0f/s, %.1f of %d per "
+                        "batch), %lu bytes, %lu errors, %lu retries, "
+                        "%lu retransmits\n", uptime, packets, stats->rate,
+                        stats->fill, sender->batch, bytes, errors, retries,
+                        retransmits);
+        }
+        
+        if(due & STATS_JSON) {
+                printf("{\"side\":\"client\",\"uptime_s\":%.3f,"
+                        "\"flows\":%d,\"sent\":%lu,\"bytes\":%lu,"
+                        "\"batches\":%lu,\"batch_size\":%d,"
+                        "\"batch_fill\":%.2f,\"rate_pps\":%.0f,"
+                        "\"errors\":%lu,\"retries\":%lu,"
+                        "\"retransmits\":%lu}\n", uptime, watch->count,
+                        packets, bytes, batches, sender->batch, stats->fill,
+                        stats->rate, errors, retries, retransmits);
+        }
+        
+        fflush(stdout);
 }
 
 /*******************************************************************************
@@ -249,46 +956,36 @@ void doEncode(unsigned int source_ip, unsigned int dest_ip, unsigned short
 * DATE: September 13, 2012
 *
 * REVISIONS: (Date and Description)
+* October 18, 2026: The payload is now stored by layoutEncode.
+* October 18, 2026: The id comes from the session generator instead of rand.
 *
 * DESIGNER: Karl Castillo (c)
 *
 * PROGRAMMER: Karl Castillo (c)
 *
 * INTERFACE: struct iphdr createIphdr(unsigned int source_ip, unsigned int 
-        dest_ip, int type, char c)
+        dest_ip, PPRNG prng)
 * source_ip: the ip where the data supposedly be coming from
 * dest_ip: the ip where the data will be sent to
-* type: the type of encoding that will be done
-*       1: TOS
-*       2:  TTL
+* prng: the generator of the session
 *
 * RETURN: struct iphdr: a fully populate IP header
 *
 * NOTES:
-* CreateIphdr populates an IP header with the proper information including
-* encoding the data in its proper field.
+* CreateIphdr populates an IP header with the proper information.
 *******************************************************************************/
-struct iphdr createIphdr(unsigned int source_ip, unsigned int dest_ip, int type,
-        char c)
+struct iphdr createIphdr(unsigned int source_ip, unsigned int dest_ip,
+        PPRNG prng)
 {   
         struct iphdr ip;
-        srand((getpid())*(dest_ip)); 
         
         ip.ihl = 5;
         ip.version = 4;
-        if(type == TOS) {
-                ip.tos = c;
-        } else {
-                ip.tos = 0;
-        }
+        ip.tos = 0;
         ip.tot_len = htons(40);
-        ip.id = (int)(255.0 * rand() / (RAND_MAX + 1.0));
+        ip.id = (unsigned short)prngNext(prng);
         ip.frag_off = 0;
-        if(type == TTL) {
-                ip.ttl = 64 + c;
-        } else {
-                ip.ttl = 64;
-        }
+        ip.ttl = 64;
         ip.protocol = IPPROTO_TCP;
         ip.check = 0;
         ip.saddr = source_ip;
@@ -303,28 +1000,30 @@ struct iphdr createIphdr(unsigned int source_ip, unsigned int dest_ip, int type,
 * DATE: September 13, 2012
 *
 * REVISIONS: (Date and Description)
+* October 18, 2026: The seq comes from the session generator instead of rand.
 *
 * DESIGNER: Karl Castillo (c)
 *
 * PROGRAMMER: Karl Castillo (c)
 *
 * INTERFACE: struct tcphdr createTcphdr(unsigned short source_port, unsigned 
-        short dest_port)
+        short dest_port, PPRNG prng)
 * source_port: the port where the data will be coming from
 * dest_port: the port where the data will go to
+* prng: the generator of the session
 *
 * RETURN: struct tcphdr: a fully populate TCP header
 *
 * NOTES:
 * CreateIphdr populates an IP header with the proper information.
 *******************************************************************************/
-struct tcphdr createTcphdr(unsigned short source_port, unsigned short dest_port)
+struct tcphdr createTcphdr(unsigned short source_port, unsigned short dest_port,
+        PPRNG prng)
 {
         struct tcphdr tcp;
-        srand((getpid())*(dest_port)); 
         
         tcp.source = htons(source_port);
-        tcp.seq = 1 + (int)(10000.0 * rand() / (RAND_MAX + 1.0));
+        tcp.seq = prngNext(prng);
         tcp.dest = htons(dest_port);
         
         tcp.ack_seq = 0;
@@ -345,65 +1044,9 @@ struct tcphdr createTcphdr(unsigned short source_port, unsigned short dest_port)
 }
 
 /*******************************************************************************
-* FUNCTION: in_cksum
+* FUNCTION: createIp6hdr
 *
-* DATE: September 13, 2012
-*
-* REVISIONS: (Date and Description)
-*
-* DESIGNER: Craig Rowland (c)
-*
-* PROGRAMMER: Karl Castillo (c)
-*
-* INTERFACE: unsigned short in_cksum(unsigned short *ptr, int nbytes)
-* ptr: pointer to the header
-* nbytes: size of the header
-*
-* RETURN: unsigned short: the calculated checksum
-*
-* NOTES:
-* In_cksum calculates the poper checksum depending on the header type.
-*******************************************************************************/
-unsigned short in_cksum(unsigned short *ptr, int nbytes)
-{
-	register long sum;
-	u_short oddbyte;
-	register u_short answer;
-
-	/*
-	 * Our algorithm is simple, using a 32-bit accumulator (sum),
-	 * we add sequential 16-bit words to it, and at the end, fold back
-	 * all the carry bits from the top 16 bits into the lower 16 bits.
-	 */
-
-	sum = 0;
-	while (nbytes > 1)  {
-		sum += *ptr++;
-		nbytes -= 2;
-	}
-
-	/* mop up an odd byte, if necessary */
-	if (nbytes == 1) {
-		oddbyte = 0; /* make sure top half is zero */
-		*((u_char *) &oddbyte) = *(u_char *)ptr; /* one byte only */
-		sum += oddbyte;
-	}
-
-	/*
-	 * Add back carry outs from top 16 bits to low 16 bits.
-	 */
-
-	sum  = (sum >> 16) + (sum & 0xffff); /* add high-16 to low-16 */
-	sum += (sum >> 16); /* add carry */
-	answer = ~sum; /* ones-complement, then truncate to 16 bits */
-	
-	return(answer);
-}
-
-/*******************************************************************************
-* FUNCTION: ip_convert
-*
-* DATE: September 13, 2012
+* DATE: October 18, 2026
 *
 * REVISIONS: (Date and Description)
 *
@@ -411,25 +1054,28 @@ unsigned short in_cksum(unsigned short *ptr, int nbytes)
 *
 * PROGRAMMER: Karl Castillo (c)
 *
-* INTERFACE: unsigned int ip_convert(char *hostname)
-* hostname: the ip address that will be converted
+* INTERFACE: struct ip6_hdr createIp6hdr(struct in6_addr source_ip,
+*       struct in6_addr dest_ip)
+* source_ip: the address where the data supposedly be coming from
+* dest_ip: the address where the data will be sent to
 *
-* RETURN: unsigned int: converted hostname
+* RETURN: struct ip6_hdr: a fully populated IPv6 header
 *
 * NOTES:
-* Converts a hostname to the proper format for the socket
+* The traffic class and the flow label start at 0 and the hop limit at 64;
+* the layout patches in whichever of them it uses.
 *******************************************************************************/
-unsigned int ip_convert(char *hostname)
+struct ip6_hdr createIp6hdr(struct in6_addr source_ip,
+        struct in6_addr dest_ip)
 {
-        static struct in_addr inaddr;
-        struct hostent *host;
+        struct ip6_hdr ip6;
         
-        if((inaddr.s_addr = inet_addr(hostname)) == 0) {
-                if((host = gethostbyname(hostname)) == NULL) {
-                        fprintf(stderr, "Cannot resolve %s\n", hostname);
-                        exit(3);
-                }
-                bcopy(host->h_addr, (char*)&inaddr.s_addr, host->h_length);
-        }
-        return inaddr.s_addr;
+        ip6.ip6_flow = htonl(6 << 28);
+        ip6.ip6_plen = htons(sizeof(struct tcphdr));
+        ip6.ip6_nxt = IPPROTO_TCP;
+        ip6.ip6_hlim = 64;
+        ip6.ip6_src = source_ip;
+        ip6.ip6_dst = dest_ip;
+        
+        return ip6;
 }
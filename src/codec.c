@@ -0,0 +1,1100 @@
+/*******************************************************************************
+* SOURCE FILE: codec.c
+*
+* PROGRAM: Covert
+*
+* FUNCTIONS:
+* int layoutParse(char *arg, PLAYOUT layout);
+* int layoutFamily(PLAYOUT layout, int family);
+* void layoutEncode(PLAYOUT layout, const unsigned long long *words,
+*        void *packets, size_t stride, int count);
+* void layoutDecode(PLAYOUT layout, const void *const *packets,
+*        unsigned long long *words, int count);
+* void layoutReport(PLAYOUT layout, FILE *out);
+* void layoutWords(PLAYOUT layout, unsigned int *ip_words,
+*        unsigned int *tcp_words);
+* int layoutHas(PLAYOUT layout, int field);
+* void packerInit(PPACKER packer, int bits);
+* int packerPush(PPACKER packer, unsigned char c, unsigned long long *word);
+* int packerFlush(PPACKER packer, unsigned long long *word);
+* int unpackerPush(PPACKER packer, unsigned long long word, int valid,
+*        unsigned char *out);
+* static void tosEncode(const unsigned long long *words,
+*        unsigned char *packets, size_t stride, int count, int shift);
+* static void ttlEncode(const unsigned long long *words,
+*        unsigned char *packets, size_t stride, int count, int shift);
+* static void idEncode(const unsigned long long *words,
+*        unsigned char *packets, size_t stride, int count, int shift);
+* static void seqEncode(const unsigned long long *words,
+*        unsigned char *packets, size_t stride, int count, int shift);
+* static void tosDecode(const void *const *packets, unsigned long long *words,
+*        int count);
+* static void ttlDecode(const void *const *packets, unsigned long long *words,
+*        int count);
+* static void idDecode(const void *const *packets, unsigned long long *words,
+*        int count);
+* static void seqDecode(const void *const *packets, unsigned long long *words,
+*        int count);
+* static void tcEncode(const unsigned long long *words,
+*        unsigned char *packets, size_t stride, int count, int shift);
+* static void hlimEncode(const unsigned long long *words,
+*        unsigned char *packets, size_t stride, int count, int shift);
+* static void seq6Encode(const unsigned long long *words,
+*        unsigned char *packets, size_t stride, int count, int shift);
+* static void flowEncode(const unsigned long long *words,
+*        unsigned char *packets, size_t stride, int count, int shift);
+* static void tcDecode(const void *const *packets, unsigned long long *words,
+*        int count);
+* static void hlimDecode(const void *const *packets, unsigned long long *words,
+*        int count);
+* static void seq6Decode(const void *const *packets, unsigned long long *words,
+*        int count);
+* static void flowDecode(const void *const *packets, unsigned long long *words,
+*        int count);
+*
+* DATE: October 18, 2026
+*
+* DESIGNER: Karl Castillo (c)
+*
+* PROGRAMMER: Karl Castillo (c)
+*
+* NOTES:
+* The payload is treated as a stream of bits. Every packet carries one word
+* of layout->bits bits, and the word is spread over the fields of the layout
+* with the first field taking the most significant bits. A layout made of a
+* single tos or ttl field is the original one byte per packet encoding.
+*
+* The IP identification only carries 15 bits because a raw socket fills in
+* the identification itself whenever it is zero; keeping the top bit set
+* makes sure the kernel never touches it.
+*
+* Every field has an encode and a decode kernel of its own, and a batch is
+* run through the kernel of each field of the layout in turn. Which field is
+* which is decided once per batch instead of once per packet, so the loop of
+* a kernel has no branch in it and the compiler is free to unroll or
+* vectorize it.
+*
+* Over IPv6 the type of service is the traffic class and the time to live is
+* the hop limit, so a layout of those fields and the sequence number works
+* over either family. The 20 bit flow label only exists in IPv6 and the
+* identification only in IPv4; neither header has room for both. The IPv6
+* header has no checksum and the TCP checksum does not cover the traffic
+* class or the flow label, so neither costs a checksum update.
+*******************************************************************************/
+/* INCLUDES */
+#include <stdio.h>
+#include <string.h>
+#include <arpa/inet.h>
+#include <netinet/ip6.h>
+#include "codec.h"
+
+/* STRUCTURES */
+typedef struct field {
+        char *name;             /* the name used in a layout */
+        char *alias;            /* its IPv6 name, or NULL */
+        int bits;               /* payload bits the field carries */
+        unsigned int ip_words;  /* 16-bit words of the IP header it is in */
+        unsigned int tcp_words; /* 16-bit words of the TCP header it is in */
+        void (*encode)(const unsigned long long *words,
+                unsigned char *packets, size_t stride, int count, int shift);
+        void (*decode)(const void *const *packets, unsigned long long *words,
+                int count);
+        void (*encode6)(const unsigned long long *words,
+                unsigned char *packets, size_t stride, int count, int shift);
+        void (*decode6)(const void *const *packets, unsigned long long *words,
+                int count);             /* the kernels over IPv6, or NULL */
+} FIELD;
+
+/* PROTOTYPES */
+static void tosEncode(const unsigned long long *words,
+        unsigned char *packets, size_t stride, int count, int shift);
+static void ttlEncode(const unsigned long long *words,
+        unsigned char *packets, size_t stride, int count, int shift);
+static void idEncode(const unsigned long long *words,
+        unsigned char *packets, size_t stride, int count, int shift);
+static void seqEncode(const unsigned long long *words,
+        unsigned char *packets, size_t stride, int count, int shift);
+static void tosDecode(const void *const *packets, unsigned long long *words,
+        int count);
+static void ttlDecode(const void *const *packets, unsigned long long *words,
+        int count);
+static void idDecode(const void *const *packets, unsigned long long *words,
+        int count);
+static void seqDecode(const void *const *packets, unsigned long long *words,
+        int count);
+static void tcEncode(const unsigned long long *words,
+        unsigned char *packets, size_t stride, int count, int shift);
+static void hlimEncode(const unsigned long long *words,
+        unsigned char *packets, size_t stride, int count, int shift);
+static void seq6Encode(const unsigned long long *words,
+        unsigned char *packets, size_t stride, int count, int shift);
+static void flowEncode(const unsigned long long *words,
+        unsigned char *packets, size_t stride, int count, int shift);
+static void tcDecode(const void *const *packets, unsigned long long *words,
+        int count);
+static void hlimDecode(const void *const *packets, unsigned long long *words,
+        int count);
+static void seq6Decode(const void *const *packets, unsigned long long *words,
+        int count);
+static void flowDecode(const void *const *packets, unsigned long long *words,
+        int count);
+
+/* GLOBALS */
+static FIELD fields[NUM_FIELDS] = {
+        { "tos", "tc", 8, 1 << 0, 0, tosEncode, tosDecode,
+                tcEncode, tcDecode },
+        { "ttl", "hlim", 8, 1 << 4, 0, ttlEncode, ttlDecode,
+                hlimEncode, hlimDecode },
+        { "id", NULL, 15, 1 << 2, 0, idEncode, idDecode, NULL, NULL },
+        { "seq", NULL, 32, 0, (1 << 2) | (1 << 3), seqEncode, seqDecode,
+                seq6Encode, seq6Decode },
+        { "flow", NULL, 20, 0, 0, NULL, NULL, flowEncode, flowDecode }
+};
+
+/*******************************************************************************
+* FUNCTION: layoutParse
+*
+* DATE: October 18, 2026
+*
+* REVISIONS: (Date and Description)
+*
+* DESIGNER: Karl Castillo (c)
+*
+* PROGRAMMER: Karl Castillo (c)
+*
+* INTERFACE: int layoutParse(char *arg, PLAYOUT layout)
+* arg: the field names separated by commas, ex. tos,ttl,id,seq or tc,flow
+* layout: where the layout will be stored
+*
+* RETURN: int
+* 0: in success
+* -1: unknown or repeated field, more than MAX_BITS bits, or fields that no
+*       one header has
+*
+* NOTES:
+* The layout is carried over IPv4 when it can be, and over IPv6 otherwise;
+* layoutFamily picks another family.
+*******************************************************************************/
+int layoutParse(char *arg, PLAYOUT layout)
+{
+        char buffer[64];
+        char *name;
+        int used[NUM_FIELDS] = { 0 };
+        int shift;
+        int i;
+
+        memset(layout, 0, sizeof(LAYOUT));
+        strncpy(layout->name, arg, sizeof(layout->name) - 1);
+        strncpy(buffer, arg, sizeof(buffer) - 1);
+        buffer[sizeof(buffer) - 1] = '\0';
+
+        for(name = strtok(buffer, ",+"); name != NULL;
+                        name = strtok(NULL, ",+")) {
+                for(i = 0; i < NUM_FIELDS; i++) {
+                        if(strcmp(name, fields[i].name) == 0 ||
+                                        (fields[i].alias != NULL &&
+                                        strcmp(name, fields[i].alias) == 0)) {
+                                break;
+                        }
+                }
+                if(i == NUM_FIELDS || used[i]) {
+                        return -1;
+                }
+
+                used[i] = 1;
+                layout->fields[layout->count++] = i;
+                layout->bits += fields[i].bits;
+        }
+
+        shift = layout->bits;
+        for(i = 0; i < layout->count; i++) {
+                shift -= fields[layout->fields[i]].bits;
+                layout->shifts[i] = shift;
+        }
+
+        if(layout->count == 0 || layout->bits > MAX_BITS) {
+                return -1;
+        }
+        if(layoutFamily(layout, AF_INET) < 0 &&
+                        layoutFamily(layout, AF_INET6) < 0) {
+                return -1;
+        }
+
+        return 0;
+}
+
+/*******************************************************************************
+* FUNCTION: layoutFamily
+*
+* DATE: October 18, 2026
+*
+* REVISIONS: (Date and Description)
+*
+* DESIGNER: Karl Castillo (c)
+*
+* PROGRAMMER: Karl Castillo (c)
+*
+* INTERFACE: int layoutFamily(PLAYOUT layout, int family)
+* layout: the layout
+* family: AF_INET or AF_INET6
+*
+* RETURN: int
+* 0: in success
+* -1: a field of the layout is not in the header of that family, and the
+*       layout is left as it was
+*******************************************************************************/
+int layoutFamily(PLAYOUT layout, int family)
+{
+        int i;
+
+        for(i = 0; i < layout->count; i++) {
+                if((family == AF_INET6 ? fields[layout->fields[i]].encode6 :
+                                fields[layout->fields[i]].encode) == NULL) {
+                        return -1;
+                }
+        }
+        layout->family = family;
+
+        return 0;
+}
+
+/*******************************************************************************
+* FUNCTION: layoutEncode
+*
+* DATE: October 18, 2026
+*
+* REVISIONS: (Date and Description)
+*
+* DESIGNER: Karl Castillo (c)
+*
+* PROGRAMMER: Karl Castillo (c)
+*
+* INTERFACE: void layoutEncode(PLAYOUT layout, const unsigned long long *words,
+*       void *packets, size_t stride, int count)
+* layout: the layout
+* words: the payload bits of each packet
+* packets: the first packet the payload is stored in
+* stride: bytes from one packet to the next
+* count: the number of packets
+*
+* RETURN: void
+*
+* NOTES:
+* Only the fields in the layout are written; checksums are left to the
+* caller.
+*******************************************************************************/
+void layoutEncode(PLAYOUT layout, const unsigned long long *words,
+        void *packets, size_t stride, int count)
+{
+        FIELD *field;
+        int i;
+
+        for(i = 0; i < layout->count; i++) {
+                field = &fields[layout->fields[i]];
+                (layout->family == AF_INET6 ? field->encode6 :
+                        field->encode)(words, (unsigned char*)packets,
+                        stride, count, layout->shifts[i]);
+        }
+}
+
+/*******************************************************************************
+* FUNCTION: layoutDecode
+*
+* DATE: October 18, 2026
+*
+* REVISIONS: (Date and Description)
+*
+* DESIGNER: Karl Castillo (c)
+*
+* PROGRAMMER: Karl Castillo (c)
+*
+* INTERFACE: void layoutDecode(PLAYOUT layout, const void *const *packets,
+*       unsigned long long *words, int count)
+* layout: the layout
+* packets: the received packets
+* words: where the payload bits of each packet will be stored
+* count: the number of packets
+*
+* RETURN: void
+*
+* NOTES:
+* The packets are given by pointer since a capture hands them out wherever
+* they were received. Every kernel shifts its field in below what the
+* fields before it left.
+*******************************************************************************/
+void layoutDecode(PLAYOUT layout, const void *const *packets,
+        unsigned long long *words, int count)
+{
+        FIELD *field;
+        int i;
+
+        memset(words, 0, count * sizeof(unsigned long long));
+        for(i = 0; i < layout->count; i++) {
+                field = &fields[layout->fields[i]];
+                (layout->family == AF_INET6 ? field->decode6 :
+                        field->decode)(packets, words, count);
+        }
+}
+
+/*******************************************************************************
+* FUNCTION: layoutReport
+*
+* DATE: October 18, 2026
+*
+* REVISIONS: (Date and Description)
+*
+* DESIGNER: Karl Castillo (c)
+*
+* PROGRAMMER: Karl Castillo (c)
+*
+* INTERFACE: void layoutReport(PLAYOUT layout, FILE *out)
+* layout: the layout
+* out: where the report will be printed
+*
+* RETURN: void
+*
+* NOTES:
+* The efficiency is the share of the bits on the wire that are payload.
+*******************************************************************************/
+void layoutReport(PLAYOUT layout, FILE *out)
+{
+        int ipv6 = layout->family == AF_INET6;
+
+        fprintf(out, "Layout: %s (%d bits, %.3f bytes per packet, "
+                "%.1f%% payload efficiency%s)\n", layout->name, layout->bits,
+                layout->bits / 8.0, 100.0 * layout->bits /
+                (ipv6 ? PACKET6_BITS : PACKET_BITS), ipv6 ? ", IPv6" : "");
+}
+
+/*******************************************************************************
+* FUNCTION: layoutWords
+*
+* DATE: October 18, 2026
+*
+* REVISIONS: (Date and Description)
+*
+* DESIGNER: Karl Castillo (c)
+*
+* PROGRAMMER: Karl Castillo (c)
+*
+* INTERFACE: void layoutWords(PLAYOUT layout, unsigned int *ip_words,
+*       unsigned int *tcp_words)
+* layout: the layout
+* ip_words: where the mask of IP header words will be stored
+* tcp_words: where the mask of TCP header words will be stored
+*
+* RETURN: void
+*
+* NOTES:
+* Bit n of a mask is set when the layout writes the n-th 16-bit word of the
+* header. These are the only words a checksum has to be patched for. An IPv6
+* header has no checksum, so its mask is left empty.
+*******************************************************************************/
+void layoutWords(PLAYOUT layout, unsigned int *ip_words,
+        unsigned int *tcp_words)
+{
+        int i;
+
+        *ip_words = 0;
+        *tcp_words = 0;
+        for(i = 0; i < layout->count; i++) {
+                if(layout->family != AF_INET6) {
+                        *ip_words |= fields[layout->fields[i]].ip_words;
+                }
+                *tcp_words |= fields[layout->fields[i]].tcp_words;
+        }
+}
+
+/*******************************************************************************
+* FUNCTION: layoutHas
+*
+* DATE: October 18, 2026
+*
+* REVISIONS: (Date and Description)
+*
+* DESIGNER: Karl Castillo (c)
+*
+* PROGRAMMER: Karl Castillo (c)
+*
+* INTERFACE: int layoutHas(PLAYOUT layout, int field)
+* layout: the layout
+* field: the field id, ex. FIELD_SEQ
+*
+* RETURN: int
+* 1: the field carries payload
+* 0: the field is free
+*******************************************************************************/
+int layoutHas(PLAYOUT layout, int field)
+{
+        int i;
+
+        for(i = 0; i < layout->count; i++) {
+                if(layout->fields[i] == field) {
+                        return 1;
+                }
+        }
+
+        return 0;
+}
+
+/*******************************************************************************
+* FUNCTION: packerInit
+*
+* DATE: October 18, 2026
+*
+* REVISIONS: (Date and Description)
+*
+* DESIGNER: Karl Castillo (c)
+*
+* PROGRAMMER: Karl Castillo (c)
+*
+* INTERFACE: void packerInit(PPACKER packer, int bits)
+* packer: the packer to initialize
+* bits: the payload bits per packet of the layout
+*
+* RETURN: void
+*
+* NOTES:
+* The same structure packs bytes into words on the client and unpacks words
+* into bytes on the server.
+*******************************************************************************/
+void packerInit(PPACKER packer, int bits)
+{
+        packer->bits = bits;
+        packer->acc = 0;
+        packer->count = 0;
+}
+
+/*******************************************************************************
+* FUNCTION: packerPush
+*
+* DATE: October 18, 2026
+*
+* REVISIONS: (Date and Description)
+*
+* DESIGNER: Karl Castillo (c)
+*
+* PROGRAMMER: Karl Castillo (c)
+*
+* INTERFACE: int packerPush(PPACKER packer, unsigned char c,
+*       unsigned long long *word)
+* packer: the packer
+* c: the next payload byte
+* word: where a completed word will be stored
+*
+* RETURN: int
+* 1: a word was completed
+* 0: more bytes are needed
+*
+* NOTES:
+* Every field is at least 8 bits wide, so one byte completes at most one word.
+*******************************************************************************/
+int packerPush(PPACKER packer, unsigned char c, unsigned long long *word)
+{
+        int take;
+
+        if(packer->count + 8 < packer->bits) {
+                packer->acc = (packer->acc << 8) | c;
+                packer->count += 8;
+                return 0;
+        }
+
+        take = packer->bits - packer->count;
+        *word = (packer->acc << take) | (c >> (8 - take));
+        packer->acc = c & ((1 << (8 - take)) - 1);
+        packer->count = 8 - take;
+
+        return 1;
+}
+
+/*******************************************************************************
+* FUNCTION: packerFlush
+*
+* DATE: October 18, 2026
+*
+* REVISIONS: (Date and Description)
+*
+* DESIGNER: Karl Castillo (c)
+*
+* PROGRAMMER: Karl Castillo (c)
+*
+* INTERFACE: int packerFlush(PPACKER packer, unsigned long long *word)
+* packer: the packer
+* word: where the last, zero padded, word will be stored
+*
+* RETURN: int: the number of valid bits in the word, from 0 to bits - 1
+*******************************************************************************/
+int packerFlush(PPACKER packer, unsigned long long *word)
+{
+        int valid = packer->count;
+
+        *word = (valid == 0) ? 0 : packer->acc << (packer->bits - valid);
+        packer->acc = 0;
+        packer->count = 0;
+
+        return valid;
+}
+
+/*******************************************************************************
+* FUNCTION: unpackerPush
+*
+* DATE: October 18, 2026
+*
+* REVISIONS: (Date and Description)
+*
+* DESIGNER: Karl Castillo (c)
+*
+* PROGRAMMER: Karl Castillo (c)
+*
+* INTERFACE: int unpackerPush(PPACKER packer, unsigned long long word,
+*       int valid, unsigned char *out)
+* packer: the packer
+* word: the payload bits of a received packet
+* valid: how many of the word's bits are payload, counted from the top
+* out: where the completed bytes are stored, room for at least 9
+*
+* RETURN: int: the number of bytes stored in out
+*
+* NOTES:
+* The word is fed in pieces of at most 32 bits so the accumulator, which may
+* still hold up to 7 bits, never overflows.
+*******************************************************************************/
+int unpackerPush(PPACKER packer, unsigned long long word, int valid,
+        unsigned char *out)
+{
+        int n = 0;
+        int take;
+
+        if(valid <= 0) {
+                return 0;
+        }
+        word >>= packer->bits - valid;
+
+        while(valid > 0) {
+                take = (valid > 32) ? 32 : valid;
+                valid -= take;
+
+                packer->acc = (packer->acc << take) |
+                        ((word >> valid) & ((1ULL << take) - 1));
+                packer->count += take;
+
+                while(packer->count >= 8) {
+                        packer->count -= 8;
+                        out[n++] = (unsigned char)(packer->acc >> packer->count);
+                }
+                packer->acc &= (1ULL << packer->count) - 1;
+        }
+
+        return n;
+}
+
+/*******************************************************************************
+* FUNCTION: tosEncode
+*
+* DATE: October 18, 2026
+*
+* REVISIONS: (Date and Description)
+*
+* DESIGNER: Karl Castillo (c)
+*
+* PROGRAMMER: Karl Castillo (c)
+*
+* INTERFACE: static void tosEncode(const unsigned long long *words,
+*       unsigned char *packets, size_t stride, int count, int shift)
+* words: the payload bits of each packet
+* packets: the first packet
+* stride: bytes from one packet to the next
+* count: the number of packets
+* shift: where the field sits in a word
+*
+* RETURN: void
+*******************************************************************************/
+static void tosEncode(const unsigned long long *words,
+        unsigned char *packets, size_t stride, int count, int shift)
+{
+        int k;
+
+        for(k = 0; k < count; k++, packets += stride) {
+                ((struct iphdr*)packets)->tos =
+                        (unsigned char)(words[k] >> shift);
+        }
+}
+
+/*******************************************************************************
+* FUNCTION: ttlEncode
+*
+* DATE: October 18, 2026
+*
+* REVISIONS: (Date and Description)
+*
+* DESIGNER: Karl Castillo (c)
+*
+* PROGRAMMER: Karl Castillo (c)
+*
+* INTERFACE: static void ttlEncode(const unsigned long long *words,
+*       unsigned char *packets, size_t stride, int count, int shift)
+* words: the payload bits of each packet
+* packets: the first packet
+* stride: bytes from one packet to the next
+* count: the number of packets
+* shift: where the field sits in a word
+*
+* RETURN: void
+*
+* NOTES:
+* The TTL is an offset from 64 so the packets still look ordinary.
+*******************************************************************************/
+static void ttlEncode(const unsigned long long *words,
+        unsigned char *packets, size_t stride, int count, int shift)
+{
+        int k;
+
+        for(k = 0; k < count; k++, packets += stride) {
+                ((struct iphdr*)packets)->ttl =
+                        64 + (unsigned char)(words[k] >> shift);
+        }
+}
+
+/*******************************************************************************
+* FUNCTION: idEncode
+*
+* DATE: October 18, 2026
+*
+* REVISIONS: (Date and Description)
+*
+* DESIGNER: Karl Castillo (c)
+*
+* PROGRAMMER: Karl Castillo (c)
+*
+* INTERFACE: static void idEncode(const unsigned long long *words,
+*       unsigned char *packets, size_t stride, int count, int shift)
+* words: the payload bits of each packet
+* packets: the first packet
+* stride: bytes from one packet to the next
+* count: the number of packets
+* shift: where the field sits in a word
+*
+* RETURN: void
+*
+* NOTES:
+* The top bit is always set so the kernel never fills the id in itself.
+*******************************************************************************/
+static void idEncode(const unsigned long long *words,
+        unsigned char *packets, size_t stride, int count, int shift)
+{
+        int k;
+
+        for(k = 0; k < count; k++, packets += stride) {
+                ((struct iphdr*)packets)->id = htons(0x8000 |
+                        ((unsigned int)(words[k] >> shift) & 0x7fff));
+        }
+}
+
+/*******************************************************************************
+* FUNCTION: seqEncode
+*
+* DATE: October 18, 2026
+*
+* REVISIONS: (Date and Description)
+*
+* DESIGNER: Karl Castillo (c)
+*
+* PROGRAMMER: Karl Castillo (c)
+*
+* INTERFACE: static void seqEncode(const unsigned long long *words,
+*       unsigned char *packets, size_t stride, int count, int shift)
+* words: the payload bits of each packet
+* packets: the first packet
+* stride: bytes from one packet to the next
+* count: the number of packets
+* shift: where the field sits in a word
+*
+* RETURN: void
+*******************************************************************************/
+static void seqEncode(const unsigned long long *words,
+        unsigned char *packets, size_t stride, int count, int shift)
+{
+        int k;
+
+        for(k = 0; k < count; k++, packets += stride) {
+                ((struct tcphdr*)(packets + sizeof(struct iphdr)))->seq =
+                        htonl((unsigned int)(words[k] >> shift));
+        }
+}
+
+/*******************************************************************************
+* FUNCTION: tosDecode
+*
+* DATE: October 18, 2026
+*
+* REVISIONS: (Date and Description)
+*
+* DESIGNER: Karl Castillo (c)
+*
+* PROGRAMMER: Karl Castillo (c)
+*
+* INTERFACE: static void tosDecode(const void *const *packets,
+*       unsigned long long *words, int count)
+* packets: the received packets
+* words: the payload bits of each packet, shifted and added to
+* count: the number of packets
+*
+* RETURN: void
+*******************************************************************************/
+static void tosDecode(const void *const *packets, unsigned long long *words,
+        int count)
+{
+        int k;
+
+        for(k = 0; k < count; k++) {
+                words[k] = (words[k] << 8) |
+                        ((const struct iphdr*)packets[k])->tos;
+        }
+}
+
+/*******************************************************************************
+* FUNCTION: ttlDecode
+*
+* DATE: October 18, 2026
+*
+* REVISIONS: (Date and Description)
+*
+* DESIGNER: Karl Castillo (c)
+*
+* PROGRAMMER: Karl Castillo (c)
+*
+* INTERFACE: static void ttlDecode(const void *const *packets,
+*       unsigned long long *words, int count)
+* packets: the received packets
+* words: the payload bits of each packet, shifted and added to
+* count: the number of packets
+*
+* RETURN: void
+*******************************************************************************/
+static void ttlDecode(const void *const *packets, unsigned long long *words,
+        int count)
+{
+        int k;
+
+        for(k = 0; k < count; k++) {
+                words[k] = (words[k] << 8) | (unsigned char)
+                        (((const struct iphdr*)packets[k])->ttl - 64);
+        }
+}
+
+/*******************************************************************************
+* FUNCTION: idDecode
+*
+* DATE: October 18, 2026
+*
+* REVISIONS: (Date and Description)
+*
+* DESIGNER: Karl Castillo (c)
+*
+* PROGRAMMER: Karl Castillo (c)
+*
+* INTERFACE: static void idDecode(const void *const *packets,
+*       unsigned long long *words, int count)
+* packets: the received packets
+* words: the payload bits of each packet, shifted and added to
+* count: the number of packets
+*
+* RETURN: void
+*******************************************************************************/
+static void idDecode(const void *const *packets, unsigned long long *words,
+        int count)
+{
+        int k;
+
+        for(k = 0; k < count; k++) {
+                words[k] = (words[k] << 15) |
+                        (ntohs(((const struct iphdr*)packets[k])->id) &
+                        0x7fff);
+        }
+}
+
+/*******************************************************************************
+* FUNCTION: seqDecode
+*
+* DATE: October 18, 2026
+*
+* REVISIONS: (Date and Description)
+*
+* DESIGNER: Karl Castillo (c)
+*
+* PROGRAMMER: Karl Castillo (c)
+*
+* INTERFACE: static void seqDecode(const void *const *packets,
+*       unsigned long long *words, int count)
+* packets: the received packets
+* words: the payload bits of each packet, shifted and added to
+* count: the number of packets
+*
+* RETURN: void
+*******************************************************************************/
+static void seqDecode(const void *const *packets, unsigned long long *words,
+        int count)
+{
+        int k;
+
+        for(k = 0; k < count; k++) {
+                words[k] = (words[k] << 32) | ntohl(((const struct tcphdr*)
+                        ((const unsigned char*)packets[k] +
+                        sizeof(struct iphdr)))->seq);
+        }
+}
+
+/*******************************************************************************
+* FUNCTION: tcEncode
+*
+* DATE: October 18, 2026
+*
+* REVISIONS: (Date and Description)
+*
+* DESIGNER: Karl Castillo (c)
+*
+* PROGRAMMER: Karl Castillo (c)
+*
+* INTERFACE: static void tcEncode(const unsigned long long *words,
+*       unsigned char *packets, size_t stride, int count, int shift)
+* words: the payload bits of each packet
+* packets: the first packet
+* stride: bytes from one packet to the next
+* count: the number of packets
+* shift: where the field sits in a word
+*
+* RETURN: void
+*
+* NOTES:
+* The traffic class sits between the version and the flow label in the
+* first word of the header.
+*******************************************************************************/
+static void tcEncode(const unsigned long long *words,
+        unsigned char *packets, size_t stride, int count, int shift)
+{
+        int k;
+
+        for(k = 0; k < count; k++, packets += stride) {
+                ((struct ip6_hdr*)packets)->ip6_flow = htonl((ntohl(
+                        ((struct ip6_hdr*)packets)->ip6_flow) & 0xf00fffff) |
+                        ((unsigned int)(words[k] >> shift) & 0xff) << 20);
+        }
+}
+
+/*******************************************************************************
+* FUNCTION: hlimEncode
+*
+* DATE: October 18, 2026
+*
+* REVISIONS: (Date and Description)
+*
+* DESIGNER: Karl Castillo (c)
+*
+* PROGRAMMER: Karl Castillo (c)
+*
+* INTERFACE: static void hlimEncode(const unsigned long long *words,
+*       unsigned char *packets, size_t stride, int count, int shift)
+* words: the payload bits of each packet
+* packets: the first packet
+* stride: bytes from one packet to the next
+* count: the number of packets
+* shift: where the field sits in a word
+*
+* RETURN: void
+*******************************************************************************/
+static void hlimEncode(const unsigned long long *words,
+        unsigned char *packets, size_t stride, int count, int shift)
+{
+        int k;
+
+        for(k = 0; k < count; k++, packets += stride) {
+                ((struct ip6_hdr*)packets)->ip6_hlim =
+                        64 + (unsigned char)(words[k] >> shift);
+        }
+}
+
+/*******************************************************************************
+* FUNCTION: seq6Encode
+*
+* DATE: October 18, 2026
+*
+* REVISIONS: (Date and Description)
+*
+* DESIGNER: Karl Castillo (c)
+*
+* PROGRAMMER: Karl Castillo (c)
+*
+* INTERFACE: static void seq6Encode(const unsigned long long *words,
+*       unsigned char *packets, size_t stride, int count, int shift)
+* words: the payload bits of each packet
+* packets: the first packet
+* stride: bytes from one packet to the next
+* count: the number of packets
+* shift: where the field sits in a word
+*
+* RETURN: void
+*******************************************************************************/
+static void seq6Encode(const unsigned long long *words,
+        unsigned char *packets, size_t stride, int count, int shift)
+{
+        int k;
+
+        for(k = 0; k < count; k++, packets += stride) {
+                ((struct tcphdr*)(packets + sizeof(struct ip6_hdr)))->seq =
+                        htonl((unsigned int)(words[k] >> shift));
+        }
+}
+
+/*******************************************************************************
+* FUNCTION: flowEncode
+*
+* DATE: October 18, 2026
+*
+* REVISIONS: (Date and Description)
+*
+* DESIGNER: Karl Castillo (c)
+*
+* PROGRAMMER: Karl Castillo (c)
+*
+* INTERFACE: static void flowEncode(const unsigned long long *words,
+*       unsigned char *packets, size_t stride, int count, int shift)
+* words: the payload bits of each packet
+* packets: the first packet
+* stride: bytes from one packet to the next
+* count: the number of packets
+* shift: where the field sits in a word
+*
+* RETURN: void
+*******************************************************************************/
+static void flowEncode(const unsigned long long *words,
+        unsigned char *packets, size_t stride, int count, int shift)
+{
+        int k;
+
+        for(k = 0; k < count; k++, packets += stride) {
+                ((struct ip6_hdr*)packets)->ip6_flow = htonl((ntohl(
+                        ((struct ip6_hdr*)packets)->ip6_flow) & 0xfff00000) |
+                        ((unsigned int)(words[k] >> shift) & 0xfffff));
+        }
+}
+
+/*******************************************************************************
+* FUNCTION: tcDecode
+*
+* DATE: October 18, 2026
+*
+* REVISIONS: (Date and Description)
+*
+* DESIGNER: Karl Castillo (c)
+*
+* PROGRAMMER: Karl Castillo (c)
+*
+* INTERFACE: static void tcDecode(const void *const *packets,
+*       unsigned long long *words, int count)
+* packets: the received packets
+* words: the payload bits of each packet, shifted and added to
+* count: the number of packets
+*
+* RETURN: void
+*******************************************************************************/
+static void tcDecode(const void *const *packets, unsigned long long *words,
+        int count)
+{
+        int k;
+
+        for(k = 0; k < count; k++) {
+                words[k] = (words[k] << 8) | (ntohl(((const struct ip6_hdr*)
+                        packets[k])->ip6_flow) >> 20 & 0xff);
+        }
+}
+
+/*******************************************************************************
+* FUNCTION: hlimDecode
+*
+* DATE: October 18, 2026
+*
+* REVISIONS: (Date and Description)
+*
+* DESIGNER: Karl Castillo (c)
+*
+* PROGRAMMER: Karl Castillo (c)
+*
+* INTERFACE: static void hlimDecode(const void *const *packets,
+*       unsigned long long *words, int count)
+* packets: the received packets
+* words: the payload bits of each packet, shifted and added to
+* count: the number of packets
+*
+* RETURN: void
+*******************************************************************************/
+static void hlimDecode(const void *const *packets, unsigned long long *words,
+        int count)
+{
+        int k;
+
+        for(k = 0; k < count; k++) {
+                words[k] = (words[k] << 8) | (unsigned char)
+                        (((const struct ip6_hdr*)packets[k])->ip6_hlim - 64);
+        }
+}
+
+/*******************************************************************************
+* FUNCTION: seq6Decode
+*
+* DATE: October 18, 2026
+*
+* REVISIONS: (Date and Description)
+*
+* DESIGNER: Karl Castillo (c)
+*
+* PROGRAMMER: Karl Castillo (c)
+*
+* INTERFACE: static void seq6Decode(const void *const *packets,
+*       unsigned long long *words, int count)
+* packets: the received packets
+* words: the payload bits of each packet, shifted and added to
+* count: the number of packets
+*
+* RETURN: void
+*******************************************************************************/
+static void seq6Decode(const void *const *packets, unsigned long long *words,
+        int count)
+{
+        int k;
+
+        for(k = 0; k < count; k++) {
+                words[k] = (words[k] << 32) | ntohl(((const struct tcphdr*)
+                        ((const unsigned char*)packets[k] +
+                        sizeof(struct ip6_hdr)))->seq);
+        }
+}
+
+/*******************************************************************************
+* FUNCTION: flowDecode
+*
+* DATE: October 18, 2026
+*
+* REVISIONS: (Date and Description)
+*
+* DESIGNER: Karl Castillo (c)
+*
+* PROGRAMMER: Karl Castillo (c)
+*
+* INTERFACE: static void flowDecode(const void *const *packets,
+*       unsigned long long *words, int count)
+* packets: the received packets
+* words: the payload bits of each packet, shifted and added to
+* count: the number of packets
+*
+* RETURN: void
+*******************************************************************************/
+static void flowDecode(const void *const *packets, unsigned long long *words,
+        int count)
+{
+        int k;
+
+        for(k = 0; k < count; k++) {
+                words[k] = (words[k] << 20) | (ntohl(((const struct ip6_hdr*)
+                        packets[k])->ip6_flow) & 0xfffff);
+        }
+}
@@ -0,0 +1,96 @@
+/*******************************************************************************
+* HEADER FILE: codec.h
+*
+* PROGRAM: Covert
+*
+* FUNCTIONS:
+* int layoutParse(char *arg, PLAYOUT layout);
+* int layoutFamily(PLAYOUT layout, int family);
+* void layoutEncode(PLAYOUT layout, const unsigned long long *words,
+*        void *packets, size_t stride, int count);
+* void layoutDecode(PLAYOUT layout, const void *const *packets,
+*        unsigned long long *words, int count);
+* void layoutReport(PLAYOUT layout, FILE *out);
+* void layoutWords(PLAYOUT layout, unsigned int *ip_words,
+*        unsigned int *tcp_words);
+* int layoutHas(PLAYOUT layout, int field);
+* void packerInit(PPACKER packer, int bits);
+* int packerPush(PPACKER packer, unsigned char c, unsigned long long *word);
+* int packerFlush(PPACKER packer, unsigned long long *word);
+* int unpackerPush(PPACKER packer, unsigned long long word, int valid,
+*        unsigned char *out);
+*
+* DATE: October 18, 2026
+*
+* DESIGNER: Karl Castillo (c)
+*
+* PROGRAMMER: Karl Castillo (c)
+*
+* NOTES:
+* The codec shared by the client and the server. A layout lists the header
+* fields that carry payload and both sides must be given the same one.
+*
+* Packets are encoded and decoded a batch at a time. A packet is an IPv4 or
+* an IPv6 header without options, as the family of the layout says, followed
+* by the TCP header.
+*******************************************************************************/
+#ifndef CODEC_H
+#define CODEC_H
+
+#include <stdio.h>
+#include <stddef.h>
+#include <netinet/in.h>
+#include <netinet/tcp.h>
+#include <linux/ip.h>
+
+/* DEFINES */
+#define FIELD_TOS       0       /* IP type of service, IPv6 traffic class */
+#define FIELD_TTL       1       /* IP time to live or IPv6 hop limit, as an
+                                   offset from 64 */
+#define FIELD_ID        2       /* IP identification, top bit always set */
+#define FIELD_SEQ       3       /* TCP sequence number */
+#define FIELD_FLOW      4       /* IPv6 flow label */
+#define NUM_FIELDS      5
+#define MAX_BITS        64      /* payload bits one packet can carry */
+#define PACKET_BITS     (40 * 8)
+#define PACKET6_BITS    (60 * 8)
+#define FLOW_BITS       6       /* the low bits of the TCP window are the
+                                   flow that sent the packet */
+#define MAX_FLOWS       (1 << FLOW_BITS)
+#define TRANSFER_IDS    (1 << (16 - FLOW_BITS)) /* the bits above are the id
+                                   of the run, 1 and up */
+
+/* STRUCTURES */
+typedef struct layout {
+        int count;                      /* fields in the layout */
+        int fields[NUM_FIELDS];         /* field ids, most significant first */
+        int bits;                       /* payload bits per packet */
+        int shifts[NUM_FIELDS];         /* where each field sits in a word */
+        int family;                     /* AF_INET or AF_INET6 */
+        char name[64];                  /* the layout as given */
+} LAYOUT, *PLAYOUT;
+
+typedef struct packer {
+        int bits;                       /* payload bits per packet */
+        unsigned long long acc;         /* bits not yet packed or written */
+        int count;                      /* number of bits in acc */
+} PACKER, *PPACKER;
+
+/* PROTOTYPES */
+int layoutParse(char *arg, PLAYOUT layout);
+int layoutFamily(PLAYOUT layout, int family);
+void layoutEncode(PLAYOUT layout, const unsigned long long *words,
+        void *packets, size_t stride, int count);
+void layoutDecode(PLAYOUT layout, const void *const *packets,
+        unsigned long long *words, int count);
+void layoutReport(PLAYOUT layout, FILE *out);
+void layoutWords(PLAYOUT layout, unsigned int *ip_words,
+        unsigned int *tcp_words);
+int layoutHas(PLAYOUT layout, int field);
+void packerInit(PPACKER packer, int bits);
+int packerPush(PPACKER packer, unsigned char c, unsigned long long *word);
+int packerFlush(PPACKER packer, unsigned long long *word);
+int unpackerPush(PPACKER packer, unsigned long long word, int valid,
+        unsigned char *out);
+
+#endif
@@ -0,0 +1,132 @@
+/*******************************************************************************
+* SOURCE FILE: covert.c
+*
+* PROGRAM: Covert
+*
+* FUNCTIONS:
+* unsigned int ip_convert(char *hostname);
+* struct in6_addr ip6_convert(char *hostname);
+* void ip_map(unsigned int ip, struct in6_addr *addr);
+*
+* DATE: October 18, 2026
+*
+* DESIGNER: Karl Castillo (c)
+*
+* PROGRAMMER: Karl Castillo (c)
+*
+* NOTES:
+* The parts of libcovert that are neither the codec nor the checksum.
+* Ip_convert used to be copied in both client.c and server.c. IPv6 addresses
+* are looked up with getaddrinfo, and an IPv4 address is kept as an
+* IPv4-mapped one wherever both families share a table or a filter.
+*******************************************************************************/
+/* INCLUDES */
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include <strings.h>
+#include <netdb.h>
+#include <netinet/in.h>
+#include <arpa/inet.h>
+#include "covert.h"
+
+/*******************************************************************************
+* FUNCTION: ip_convert
+*
+* DATE: September 13, 2012
+*
+* REVISIONS: (Date and Description)
+* October 18, 2026: Moved to libcovert from the client and the server.
+*
+* DESIGNER: Karl Castillo (c)
+*
+* PROGRAMMER: Karl Castillo (c)
+*
+* INTERFACE: unsigned int ip_convert(char *hostname)
+* hostname: the ip address that will be converted
+*
+* RETURN: unsigned int: converted hostname
+*
+* NOTES:
+* Converts a hostname to the proper format for the socket
+*******************************************************************************/
+unsigned int ip_convert(char *hostname)
+{
+        static struct in_addr inaddr;
+        struct hostent *host;
+        
+        if((inaddr.s_addr = inet_addr(hostname)) == 0) {
+                if((host = gethostbyname(hostname)) == NULL) {
+                        fprintf(stderr, "Cannot resolve %s\n", hostname);
+                        exit(3);
+                }
+                bcopy(host->h_addr, (char*)&inaddr.s_addr, host->h_length);
+        }
+        return inaddr.s_addr;
+}
+
+/*******************************************************************************
+* FUNCTION: ip6_convert
+*
+* DATE: October 18, 2026
+*
+* REVISIONS: (Date and Description)
+*
+* DESIGNER: Karl Castillo (c)
+*
+* PROGRAMMER: Karl Castillo (c)
+*
+* INTERFACE: struct in6_addr ip6_convert(char *hostname)
+* hostname: the IPv6 address or host name that will be converted
+*
+* RETURN: struct in6_addr: converted hostname
+*
+* NOTES:
+* Exits like ip_convert does when the name cannot be resolved.
+*******************************************************************************/
+struct in6_addr ip6_convert(char *hostname)
+{
+        struct in6_addr addr;
+        struct addrinfo hints;
+        struct addrinfo *res;
+
+        if(inet_pton(AF_INET6, hostname, &addr) == 1) {
+                return addr;
+        }
+
+        memset(&hints, 0, sizeof(hints));
+        hints.ai_family = AF_INET6;
+        if(getaddrinfo(hostname, NULL, &hints, &res) != 0) {
+                fprintf(stderr, "Cannot resolve %s\n", hostname);
+                exit(3);
+        }
+        addr = ((struct sockaddr_in6*)res->ai_addr)->sin6_addr;
+        freeaddrinfo(res);
+
+        return addr;
+}
+
+/*******************************************************************************
+* FUNCTION: ip_map
+*
+* DATE: October 18, 2026
+*
+* REVISIONS: (Date and Description)
+*
+* DESIGNER: Karl Castillo (c)
+*
+* PROGRAMMER: Karl Castillo (c)
+*
+* INTERFACE: void ip_map(unsigned int ip, struct in6_addr *addr)
+* ip: an IPv4 address, in network order
+* addr: where its IPv4-mapped address is stored, ::ffff:a.b.c.d
+*
+* RETURN: void
+*******************************************************************************/
+void ip_map(unsigned int ip, struct in6_addr *addr)
+{
+        memset(addr, 0, 10);
+        addr->s6_addr[10] = 0xff;
+        addr->s6_addr[11] = 0xff;
+        memcpy(&addr->s6_addr[12], &ip, sizeof(ip));
+}
@@ -0,0 +1,35 @@
+/*******************************************************************************
+* HEADER FILE: covert.h
+*
+* PROGRAM: Covert
+*
+* FUNCTIONS:
+* unsigned int ip_convert(char *hostname);
+* struct in6_addr ip6_convert(char *hostname);
+* void ip_map(unsigned int ip, struct in6_addr *addr);
+*
+* DATE: October 18, 2026
+*
+* DESIGNER: Karl Castillo (c)
+*
+* PROGRAMMER: Karl Castillo (c)
+*
+* NOTES:
+* The header of libcovert, the library the client and the server are both
+* linked with. It holds the codec, the Internet checksum and the address
+* lookup, so another tool can encode or decode packets the same way by
+* linking libcovert.a or libcovert.so and including this file.
+*******************************************************************************/
+#ifndef COVERT_H
+#define COVERT_H
+
+#include <netinet/in.h>
+#include "cksum.h"
+#include "codec.h"
+
+/* PROTOTYPES */
+unsigned int ip_convert(char *hostname);
+struct in6_addr ip6_convert(char *hostname);
+void ip_map(unsigned int ip, struct in6_addr *addr);
+
+#endif
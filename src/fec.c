@@ -0,0 +1,773 @@
+/*******************************************************************************
+* SOURCE FILE: fec.c
+*
+* PROGRAM: Covert
+*
+* FUNCTIONS:
+* int fecInit(PFEC fec, char *arg, int bits);
+* void fecClose(PFEC fec);
+* void fecReport(PFEC fec, FILE *out);
+* void parityInit(PPARITY parity, PFEC fec);
+* int parityPush(PPARITY parity, unsigned int seq, unsigned long long word);
+* void parityReport(PPARITY parity, FILE *out);
+* int unfecInit(PUNFEC unfec, PFEC fec, int window);
+* int unfecData(PUNFEC unfec, unsigned int seq, unsigned long long word,
+*        int valid);
+* int unfecParity(PUNFEC unfec, unsigned int start, int index,
+*        unsigned long long word, int members, int final);
+* void unfecReset(PUNFEC unfec);
+* void unfecClose(PUNFEC unfec);
+* void unfecReport(PUNFEC unfec, FILE *out);
+* static PGROUP unfecGroup(PUNFEC unfec, unsigned int start);
+* static int unfecRebuild(PUNFEC unfec, PGROUP group);
+* static unsigned long long fecMul(PFEC fec, unsigned long long a,
+*        unsigned long long b);
+* static unsigned long long fecInverse(PFEC fec, unsigned long long a);
+*
+* DATE: October 18, 2026
+*
+* DESIGNER: Karl Castillo (c)
+*
+* PROGRAMMER: Karl Castillo (c)
+*
+* NOTES:
+* The packets of a transfer are cut into groups of k data packets, and every
+* group is followed by m parity packets. Any k of the k + m packets of a
+* group are enough to rebuild the whole group, so up to m losses per group
+* are repaired by the server without a round trip.
+*
+* The code is a systematic Reed-Solomon code with a Cauchy generator matrix,
+* worked over GF(2^bits) where bits is the payload width of the layout. Every
+* payload word is one symbol, so a parity word is exactly as wide as a data
+* word and travels in the same header fields. Parity j of a group is
+*
+*       p[j] = sum over i of d[i] / (x[j] + y[i]),  x[j] = j, y[i] = m + i
+*
+* and any square submatrix of a Cauchy matrix can be inverted, which is what
+* makes any k packets enough. This needs k + m <= 2^bits distinct elements.
+*
+* A group holds consecutive packets and never crosses a multiple of FEC_SPAN,
+* so the group of a packet follows from its sequence number alone and the
+* chunks of the parallel flows, which are FEC_SPAN packets long, hold whole
+* groups. The last group of a chunk or of the transfer may be short, so a
+* parity packet says how many members its group has. A parity packet carries
+* FEC_PARITY | j in the reserved bits of the TCP header, the sequence number
+* of the first member of its group in the acknowledgement number, and the
+* number of members in the high byte of the urgent pointer. The parity of
+* the last group also has PSH set and the valid bits of the last packet in
+* the low byte, so even a lost last packet can be rebuilt.
+*******************************************************************************/
+/* INCLUDES */
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include "fec.h"
+
+/* PROTOTYPES */
+static PGROUP unfecGroup(PUNFEC unfec, unsigned int start);
+static int unfecRebuild(PUNFEC unfec, PGROUP group);
+static unsigned long long fecMul(PFEC fec, unsigned long long a,
+        unsigned long long b);
+static unsigned long long fecInverse(PFEC fec, unsigned long long a);
+
+/* GLOBALS */
+/* the smallest irreducible polynomial of every degree, less its top term */
+static const unsigned long long polys[MAX_WIDTH] = {
+        0x1ULL, 0x3ULL, 0x3ULL, 0x3ULL,
+        0x5ULL, 0x3ULL, 0x3ULL, 0x1bULL,
+        0x3ULL, 0x9ULL, 0x5ULL, 0x9ULL,
+        0x1bULL, 0x21ULL, 0x3ULL, 0x2bULL,
+        0x9ULL, 0x9ULL, 0x27ULL, 0x9ULL,
+        0x5ULL, 0x3ULL, 0x21ULL, 0x1bULL,
+        0x9ULL, 0x1bULL, 0x27ULL, 0x3ULL,
+        0x5ULL, 0x3ULL, 0x9ULL, 0x8dULL,
+        0x4bULL, 0x1bULL, 0x5ULL, 0x35ULL,
+        0x3fULL, 0x63ULL, 0x11ULL, 0x39ULL,
+        0x9ULL, 0x27ULL, 0x59ULL, 0x21ULL,
+        0x1bULL, 0x3ULL, 0x21ULL, 0x2dULL,
+        0x71ULL, 0x1dULL, 0x4bULL, 0x9ULL,
+        0x47ULL, 0x7dULL, 0x47ULL, 0x95ULL,
+        0x11ULL, 0x63ULL, 0x7bULL, 0x3ULL,
+        0x27ULL, 0x69ULL, 0x3ULL, 0x1bULL
+};
+
+/*******************************************************************************
+* FUNCTION: fecInit
+*
+* DATE: October 18, 2026
+*
+* REVISIONS: (Date and Description)
+*
+* DESIGNER: Karl Castillo (c)
+*
+* PROGRAMMER: Karl Castillo (c)
+*
+* INTERFACE: int fecInit(PFEC fec, char *arg, int bits)
+* fec: the code to build
+* arg: the code as k:m, data and parity packets per group
+* bits: the payload bits per packet of the layout
+*
+* RETURN: int
+* 0: in success
+* -1: the code is invalid or the matrix could not be allocated
+*******************************************************************************/
+int fecInit(PFEC fec, char *arg, int bits)
+{
+        char *end;
+        int i;
+        int j;
+
+        memset(fec, 0, sizeof(FEC));
+
+        fec->data = (int)strtol(arg, &end, 10);
+        if(*end != ':') {
+                return -1;
+        }
+        fec->parity = (int)strtol(end + 1, &end, 10);
+        if(*end != '\0' || fec->data < 1 || fec->data > MAX_DATA ||
+                        fec->parity < 1 || fec->parity > MAX_PARITY ||
+                        bits < 1 || bits > MAX_WIDTH || (bits < 16 &&
+                        fec->data + fec->parity > (1 << bits))) {
+                return -1;
+        }
+        fec->bits = bits;
+        fec->poly = polys[bits - 1];
+
+        if((fec->coef = (unsigned long long*)malloc(fec->parity * fec->data *
+                        sizeof(unsigned long long))) == NULL) {
+                return -1;
+        }
+        for(j = 0; j < fec->parity; j++) {
+                for(i = 0; i < fec->data; i++) {
+                        fec->coef[j * fec->data + i] = fecInverse(fec,
+                                j ^ (fec->parity + i));
+                }
+        }
+
+        return 0;
+}
+
+/*******************************************************************************
+* FUNCTION: fecClose
+*
+* DATE: October 18, 2026
+*
+* REVISIONS: (Date and Description)
+*
+* DESIGNER: Karl Castillo (c)
+*
+* PROGRAMMER: Karl Castillo (c)
+*
+* INTERFACE: void fecClose(PFEC fec)
+* fec: the code
+*
+* RETURN: void
+*******************************************************************************/
+void fecClose(PFEC fec)
+{
+        free(fec->coef);
+        fec->coef = NULL;
+}
+
+/*******************************************************************************
+* FUNCTION: fecReport
+*
+* DATE: October 18, 2026
+*
+* REVISIONS: (Date and Description)
+*
+* DESIGNER: Karl Castillo (c)
+*
+* PROGRAMMER: Karl Castillo (c)
+*
+* INTERFACE: void fecReport(PFEC fec, FILE *out)
+* fec: the code, or NULL when there is none
+* out: where the report will be printed
+*
+* RETURN: void
+*******************************************************************************/
+void fecReport(PFEC fec, FILE *out)
+{
+        if(fec == NULL) {
+                fprintf(out, "FEC: off\n");
+                return;
+        }
+
+        fprintf(out, "FEC: %d data + %d parity packets per group (%.1f%% "
+                "overhead)\n", fec->data, fec->parity,
+                100.0 * fec->parity / fec->data);
+}
+
+/*******************************************************************************
+* FUNCTION: parityInit
+*
+* DATE: October 18, 2026
+*
+* REVISIONS: (Date and Description)
+*
+* DESIGNER: Karl Castillo (c)
+*
+* PROGRAMMER: Karl Castillo (c)
+*
+* INTERFACE: void parityInit(PPARITY parity, PFEC fec)
+* parity: the encoder to initialize
+* fec: the code
+*
+* RETURN: void
+*******************************************************************************/
+void parityInit(PPARITY parity, PFEC fec)
+{
+        memset(parity, 0, sizeof(PARITY));
+        parity->fec = fec;
+}
+
+/*******************************************************************************
+* FUNCTION: parityPush
+*
+* DATE: October 18, 2026
+*
+* REVISIONS: (Date and Description)
+*
+* DESIGNER: Karl Castillo (c)
+*
+* PROGRAMMER: Karl Castillo (c)
+*
+* INTERFACE: int parityPush(PPARITY parity, unsigned int seq,
+*       unsigned long long word)
+* parity: the encoder
+* seq: the sequence number of the data packet
+* word: the payload bits of the data packet
+*
+* RETURN: int
+* 1: the group is complete and its parity has to be sent
+* 0: otherwise
+*
+* NOTES:
+* Data packets must be pushed in order. The caller sends the parity of a
+* complete group, or of a short one at the end of the input, and clears
+* members so the next push starts a new group.
+*******************************************************************************/
+int parityPush(PPARITY parity, unsigned int seq, unsigned long long word)
+{
+        PFEC fec = parity->fec;
+        int j;
+
+        if(parity->members == 0) {
+                parity->start = seq;
+                memset(parity->words, 0, sizeof(parity->words));
+        }
+
+        for(j = 0; j < fec->parity; j++) {
+                parity->words[j] ^= fecMul(fec,
+                        fec->coef[j * fec->data + parity->members], word);
+        }
+        parity->members++;
+        parity->pushed++;
+
+        return parity->members == fec->data || (seq + 1) % FEC_SPAN == 0;
+}
+
+/*******************************************************************************
+* FUNCTION: parityReport
+*
+* DATE: October 18, 2026
+*
+* REVISIONS: (Date and Description)
+*
+* DESIGNER: Karl Castillo (c)
+*
+* PROGRAMMER: Karl Castillo (c)
+*
+* INTERFACE: void parityReport(PPARITY parity, FILE *out)
+* parity: the encoder
+* out: where the report will be printed
+*
+* RETURN: void
+*******************************************************************************/
+void parityReport(PPARITY parity, FILE *out)
+{
+        fprintf(out, "FEC: %lu parity packets for %lu data packets in %lu "
+                "groups\n", parity->sent, parity->pushed, parity->groups);
+}
+
+/*******************************************************************************
+* FUNCTION: unfecInit
+*
+* DATE: October 18, 2026
+*
+* REVISIONS: (Date and Description)
+*
+* DESIGNER: Karl Castillo (c)
+*
+* PROGRAMMER: Karl Castillo (c)
+*
+* INTERFACE: int unfecInit(PUNFEC unfec, PFEC fec, int window)
+* unfec: the decoder to initialize
+* fec: the code
+* window: the reassembly window the decoder works behind
+*
+* RETURN: int
+* 0: in success
+* -1: the groups could not be allocated
+*
+* NOTES:
+* The reassembler takes packets up to twice its window ahead, and a group
+* may start up to k packets behind the next packet it writes, so the ring
+* holds every group that can start in that range.
+*******************************************************************************/
+int unfecInit(PUNFEC unfec, PFEC fec, int window)
+{
+        int i;
+
+        memset(unfec, 0, sizeof(UNFEC));
+        unfec->fec = fec;
+        unfec->per_span = (FEC_SPAN + fec->data - 1) / fec->data;
+        unfec->count = (2 * window / FEC_SPAN + 3) * unfec->per_span;
+
+        unfec->groups = (PGROUP)calloc(unfec->count, sizeof(GROUP));
+        unfec->have = (unsigned char*)malloc(unfec->count * fec->data);
+        unfec->words = (unsigned long long*)malloc(unfec->count * fec->data *
+                sizeof(unsigned long long));
+        if(unfec->groups == NULL || unfec->have == NULL ||
+                        unfec->words == NULL) {
+                unfecClose(unfec);
+                return -1;
+        }
+
+        for(i = 0; i < unfec->count; i++) {
+                unfec->groups[i].have = unfec->have + i * fec->data;
+                unfec->groups[i].words = unfec->words + i * fec->data;
+        }
+
+        return 0;
+}
+
+/*******************************************************************************
+* FUNCTION: unfecData
+*
+* DATE: October 18, 2026
+*
+* REVISIONS: (Date and Description)
+*
+* DESIGNER: Karl Castillo (c)
+*
+* PROGRAMMER: Karl Castillo (c)
+*
+* INTERFACE: int unfecData(PUNFEC unfec, unsigned int seq,
+*       unsigned long long word, int valid)
+* unfec: the decoder
+* seq: the sequence number of the data packet
+* word: the payload bits of the data packet
+* valid: the valid bits of the last packet, -1 for any other packet
+*
+* RETURN: int
+* the number of data packets rebuilt, left in unfec->seqs, unfec->rebuilt
+* and unfec->valids
+*******************************************************************************/
+int unfecData(PUNFEC unfec, unsigned int seq, unsigned long long word,
+        int valid)
+{
+        unsigned int start;
+        PGROUP group;
+        int index;
+
+        index = (seq % FEC_SPAN) % unfec->fec->data;
+        start = seq - index;
+        group = unfecGroup(unfec, start);
+        if(group->done || group->have[index]) {
+                return 0;
+        }
+
+        group->have[index] = 1;
+        group->words[index] = word;
+        group->count++;
+        if(valid >= 0) {
+                group->final = valid;
+        }
+
+        return unfecRebuild(unfec, group);
+}
+
+/*******************************************************************************
+* FUNCTION: unfecParity
+*
+* DATE: October 18, 2026
+*
+* REVISIONS: (Date and Description)
+*
+* DESIGNER: Karl Castillo (c)
+*
+* PROGRAMMER: Karl Castillo (c)
+*
+* INTERFACE: int unfecParity(PUNFEC unfec, unsigned int start, int index,
+*       unsigned long long word, int members, int final)
+* unfec: the decoder
+* start: the sequence number of the first member of the group
+* index: which parity of the group the packet is
+* word: the parity
+* members: the data packets in the group
+* final: the valid bits of the last packet of the transfer when the group is
+*       the last one, -1 otherwise
+*
+* RETURN: int
+* the number of data packets rebuilt, left in unfec->seqs, unfec->rebuilt
+* and unfec->valids
+*
+* NOTES:
+* A parity packet that does not describe a group the client could have sent
+* is ignored.
+*******************************************************************************/
+int unfecParity(PUNFEC unfec, unsigned int start, int index,
+        unsigned long long word, int members, int final)
+{
+        PFEC fec = unfec->fec;
+        PGROUP group;
+
+        if(index >= fec->parity || members < 1 || members > fec->data ||
+                        (start % FEC_SPAN) % fec->data != 0 ||
+                        start % FEC_SPAN + members > FEC_SPAN) {
+                return 0;
+        }
+
+        group = unfecGroup(unfec, start);
+        if(group->done || (group->parities & (1 << index))) {
+                return 0;
+        }
+
+        group->parity[index] = word;
+        group->parities |= 1 << index;
+        group->members = members;
+        if(final >= 0) {
+                group->final = final;
+        }
+
+        return unfecRebuild(unfec, group);
+}
+
+/*******************************************************************************
+* FUNCTION: unfecReset
+*
+* DATE: October 18, 2026
+*
+* REVISIONS: (Date and Description)
+*
+* DESIGNER: Karl Castillo (c)
+*
+* PROGRAMMER: Karl Castillo (c)
+*
+* INTERFACE: void unfecReset(PUNFEC unfec)
+* unfec: the decoder
+*
+* RETURN: void
+*
+* NOTES:
+* Called at the end of every transfer so no group outlives it.
+*******************************************************************************/
+void unfecReset(PUNFEC unfec)
+{
+        PGROUP group;
+        int i;
+
+        for(i = 0; i < unfec->count; i++) {
+                group = &unfec->groups[i];
+                if(group->used && group->members > 0 && !group->done) {
+                        unfec->short_groups++;
+                }
+                group->used = 0;
+        }
+}
+
+/*******************************************************************************
+* FUNCTION: unfecClose
+*
+* DATE: October 18, 2026
+*
+* REVISIONS: (Date and Description)
+*
+* DESIGNER: Karl Castillo (c)
+*
+* PROGRAMMER: Karl Castillo (c)
+*
+* INTERFACE: void unfecClose(PUNFEC unfec)
+* unfec: the decoder
+*
+* RETURN: void
+*******************************************************************************/
+void unfecClose(PUNFEC unfec)
+{
+        free(unfec->groups);
+        free(unfec->have);
+        free(unfec->words);
+        unfec->groups = NULL;
+        unfec->have = NULL;
+        unfec->words = NULL;
+        unfec->count = 0;
+}
+
+/*******************************************************************************
+* FUNCTION: unfecReport
+*
+* DATE: October 18, 2026
+*
+* REVISIONS: (Date and Description)
+*
+* DESIGNER: Karl Castillo (c)
+*
+* PROGRAMMER: Karl Castillo (c)
+*
+* INTERFACE: void unfecReport(PUNFEC unfec, FILE *out)
+* unfec: the decoder
+* out: where the report will be printed
+*
+* RETURN: void
+*******************************************************************************/
+void unfecReport(PUNFEC unfec, FILE *out)
+{
+        fprintf(out, "FEC: %lu data packets rebuilt, %lu groups lost too "
+                "many\n", unfec->recovered, unfec->short_groups);
+}
+
+/*******************************************************************************
+* FUNCTION: unfecGroup
+*
+* DATE: October 18, 2026
+*
+* REVISIONS: (Date and Description)
+*
+* DESIGNER: Karl Castillo (c)
+*
+* PROGRAMMER: Karl Castillo (c)
+*
+* INTERFACE: static PGROUP unfecGroup(PUNFEC unfec, unsigned int start)
+* unfec: the decoder
+* start: the sequence number of the first member of the group
+*
+* RETURN: PGROUP
+* the group, emptied first if its slot held an older one
+*******************************************************************************/
+static PGROUP unfecGroup(PUNFEC unfec, unsigned int start)
+{
+        unsigned int number;
+        PGROUP group;
+
+        number = (start / FEC_SPAN) * unfec->per_span +
+                (start % FEC_SPAN) / unfec->fec->data;
+        group = &unfec->groups[number % unfec->count];
+
+        if(!group->used || group->start != start) {
+                if(group->used && group->members > 0 && !group->done) {
+                        unfec->short_groups++;
+                }
+                group->start = start;
+                group->used = 1;
+                group->members = 0;
+                group->final = -1;
+                group->count = 0;
+                group->parities = 0;
+                group->done = 0;
+                memset(group->have, 0, unfec->fec->data);
+        }
+
+        return group;
+}
+
+/*******************************************************************************
+* FUNCTION: unfecRebuild
+*
+* DATE: October 18, 2026
+*
+* REVISIONS: (Date and Description)
+*
+* DESIGNER: Karl Castillo (c)
+*
+* PROGRAMMER: Karl Castillo (c)
+*
+* INTERFACE: static int unfecRebuild(PUNFEC unfec, PGROUP group)
+* unfec: the decoder
+* group: the group that just gained a packet
+*
+* RETURN: int
+* the number of data packets rebuilt
+*
+* NOTES:
+* Once a group holds as many packets as it has members, the parity of the
+* missing members is what is left of the parity words after the members
+* that arrived are taken out. That leaves a square Cauchy system in the
+* missing members, solved by Gauss-Jordan elimination.
+*******************************************************************************/
+static int unfecRebuild(PUNFEC unfec, PGROUP group)
+{
+        PFEC fec = unfec->fec;
+        unsigned long long a[MAX_PARITY][MAX_PARITY];
+        unsigned long long b[MAX_PARITY];
+        unsigned long long t;
+        int lost[MAX_PARITY];
+        int rows[MAX_PARITY];
+        int missing;
+        int r;
+        int c;
+        int i;
+
+        if(group->members == 0) {
+                return 0;
+        }
+        missing = group->members - group->count;
+        if(missing <= 0) {
+                group->done = 1;
+                return 0;
+        }
+
+        for(r = 0, i = 0; i < fec->parity && r < missing; i++) {
+                if(group->parities & (1 << i)) {
+                        rows[r++] = i;
+                }
+        }
+        if(r < missing) {
+                return 0;
+        }
+        for(c = 0, i = 0; i < group->members; i++) {
+                if(!group->have[i]) {
+                        lost[c++] = i;
+                }
+        }
+
+        for(r = 0; r < missing; r++) {
+                b[r] = group->parity[rows[r]];
+                for(i = 0; i < group->members; i++) {
+                        if(group->have[i]) {
+                                b[r] ^= fecMul(fec, fec->coef[rows[r] *
+                                        fec->data + i], group->words[i]);
+                        }
+                }
+                for(c = 0; c < missing; c++) {
+                        a[r][c] = fec->coef[rows[r] * fec->data + lost[c]];
+                }
+        }
+
+        for(c = 0; c < missing; c++) {
+                for(r = c; r < missing && a[r][c] == 0; r++) {
+                }
+                if(r == missing) {
+                        return 0;
+                }
+                for(i = 0; i < missing; i++) {
+                        t = a[c][i];
+                        a[c][i] = a[r][i];
+                        a[r][i] = t;
+                }
+                t = b[c];
+                b[c] = b[r];
+                b[r] = t;
+
+                t = fecInverse(fec, a[c][c]);
+                for(i = 0; i < missing; i++) {
+                        a[c][i] = fecMul(fec, a[c][i], t);
+                }
+                b[c] = fecMul(fec, b[c], t);
+
+                for(r = 0; r < missing; r++) {
+                        if(r == c || (t = a[r][c]) == 0) {
+                                continue;
+                        }
+                        for(i = 0; i < missing; i++) {
+                                a[r][i] ^= fecMul(fec, a[c][i], t);
+                        }
+                        b[r] ^= fecMul(fec, b[c], t);
+                }
+        }
+
+        for(c = 0; c < missing; c++) {
+                group->have[lost[c]] = 1;
+                group->words[lost[c]] = b[c];
+                unfec->seqs[c] = group->start + lost[c];
+                unfec->rebuilt[c] = b[c];
+                unfec->valids[c] = lost[c] == group->members - 1 ?
+                        group->final : -1;
+        }
+        group->count = group->members;
+        group->done = 1;
+        unfec->recovered += missing;
+
+        return missing;
+}
+
+/*******************************************************************************
+* FUNCTION: fecMul
+*
+* DATE: October 18, 2026
+*
+* REVISIONS: (Date and Description)
+*
+* DESIGNER: Karl Castillo (c)
+*
+* PROGRAMMER: Karl Castillo (c)
+*
+* INTERFACE: static unsigned long long fecMul(PFEC fec, unsigned long long a,
+*       unsigned long long b)
+* fec: the code, for its field
+* a: a field element
+* b: a field element
+*
+* RETURN: unsigned long long
+* a * b in GF(2^bits)
+*
+* NOTES:
+* Shift and add, reducing a whenever it overflows the field.
+*******************************************************************************/
+static unsigned long long fecMul(PFEC fec, unsigned long long a,
+        unsigned long long b)
+{
+        unsigned long long top = 1ULL << (fec->bits - 1);
+        unsigned long long mask = top | (top - 1);
+        unsigned long long product = 0;
+        unsigned long long carry;
+
+        while(b != 0) {
+                if(b & 1) {
+                        product ^= a;
+                }
+                b >>= 1;
+                carry = a & top;
+                a = (a << 1) & mask;
+                if(carry) {
+                        a ^= fec->poly;
+                }
+        }
+
+        return product;
+}
+
+/*******************************************************************************
+* FUNCTION: fecInverse
+*
+* DATE: October 18, 2026
+*
+* REVISIONS: (Date and Description)
+*
+* DESIGNER: Karl Castillo (c)
+*
+* PROGRAMMER: Karl Castillo (c)
+*
+* INTERFACE: static unsigned long long fecInverse(PFEC fec,
+*       unsigned long long a)
+* fec: the code, for its field
+* a: a field element other than 0
+*
+* RETURN: unsigned long long
+* 1 / a in GF(2^bits)
+*
+* NOTES:
+* a^(2^bits - 2), built as the product of a^2, a^4, ... a^(2^(bits - 1)).
+*******************************************************************************/
+static unsigned long long fecInverse(PFEC fec, unsigned long long a)
+{
+        unsigned long long inverse = 1;
+        int i;
+
+        for(i = 1; i < fec->bits; i++) {
+                a = fecMul(fec, a, a);
+                inverse = fecMul(fec, inverse, a);
+        }
+
+        return inverse;
+}
@@ -0,0 +1,106 @@
+/*******************************************************************************
+* HEADER FILE: fec.h
+*
+* PROGRAM: Covert
+*
+* FUNCTIONS:
+* int fecInit(PFEC fec, char *arg, int bits);
+* void fecClose(PFEC fec);
+* void fecReport(PFEC fec, FILE *out);
+* void parityInit(PPARITY parity, PFEC fec);
+* int parityPush(PPARITY parity, unsigned int seq, unsigned long long word);
+* void parityReport(PPARITY parity, FILE *out);
+* int unfecInit(PUNFEC unfec, PFEC fec, int window);
+* int unfecData(PUNFEC unfec, unsigned int seq, unsigned long long word,
+*        int valid);
+* int unfecParity(PUNFEC unfec, unsigned int start, int index,
+*        unsigned long long word, int members, int final);
+* void unfecReset(PUNFEC unfec);
+* void unfecClose(PUNFEC unfec);
+* void unfecReport(PUNFEC unfec, FILE *out);
+*
+* DATE: October 18, 2026
+*
+* DESIGNER: Karl Castillo (c)
+*
+* PROGRAMMER: Karl Castillo (c)
+*
+* NOTES:
+* Forward error correction shared by the client and the server. Like the
+* layout, both sides must be given the same code.
+*******************************************************************************/
+#ifndef FEC_H
+#define FEC_H
+
+#include <stdio.h>
+
+/* DEFINES */
+#define FEC_SPAN        256     /* groups never cross a multiple of this seq */
+#define FEC_PARITY      0x8     /* TCP res1 of a parity packet, | its index */
+#define MAX_DATA        255     /* data packets in a group, fits urg_ptr */
+#define MAX_PARITY      8       /* parity packets in a group, fits res1 */
+#define MAX_WIDTH       64      /* widest word the code works on */
+
+/* STRUCTURES */
+typedef struct fec {
+        int data;                       /* data packets per group, k */
+        int parity;                     /* parity packets per group, m */
+        int bits;                       /* the word size, GF(2^bits) */
+        unsigned long long poly;        /* reduction polynomial less x^bits */
+        unsigned long long *coef;       /* parity x data Cauchy matrix */
+} FEC, *PFEC;
+
+typedef struct parity {
+        PFEC fec;                       /* the code */
+        unsigned int start;             /* seq of the first member */
+        int members;                    /* data packets in the group so far */
+        unsigned long long words[MAX_PARITY]; /* the parity of the group */
+        unsigned long pushed;           /* data packets pushed */
+        unsigned long groups;           /* groups sent */
+        unsigned long sent;             /* parity packets sent */
+} PARITY, *PPARITY;
+
+typedef struct group {
+        unsigned int start;             /* seq of the first member */
+        int used;                       /* the group holds anything */
+        int members;                    /* data packets, 0 until a parity */
+        int final;                      /* valid bits of the last, -1 none */
+        int count;                      /* data words held */
+        int parities;                   /* bit n set once parity n is held */
+        int done;                       /* every member was seen or rebuilt */
+        unsigned char *have;            /* which members are held */
+        unsigned long long *words;      /* the members */
+        unsigned long long parity[MAX_PARITY];
+} GROUP, *PGROUP;
+
+typedef struct unfec {
+        PFEC fec;                       /* the code */
+        int count;                      /* groups in the ring */
+        int per_span;                   /* groups starting in a FEC_SPAN */
+        PGROUP groups;                  /* indexed by group number % count */
+        unsigned char *have;            /* storage of every group */
+        unsigned long long *words;
+        unsigned int seqs[MAX_PARITY];  /* the packets last rebuilt */
+        unsigned long long rebuilt[MAX_PARITY];
+        int valids[MAX_PARITY];         /* -1, or valid bits of the last */
+        unsigned long recovered;        /* data packets rebuilt */
+        unsigned long short_groups;     /* groups that lost too many */
+} UNFEC, *PUNFEC;
+
+/* PROTOTYPES */
+int fecInit(PFEC fec, char *arg, int bits);
+void fecClose(PFEC fec);
+void fecReport(PFEC fec, FILE *out);
+void parityInit(PPARITY parity, PFEC fec);
+int parityPush(PPARITY parity, unsigned int seq, unsigned long long word);
+void parityReport(PPARITY parity, FILE *out);
+int unfecInit(PUNFEC unfec, PFEC fec, int window);
+int unfecData(PUNFEC unfec, unsigned int seq, unsigned long long word,
+        int valid);
+int unfecParity(PUNFEC unfec, unsigned int start, int index,
+        unsigned long long word, int members, int final);
+void unfecReset(PUNFEC unfec);
+void unfecClose(PUNFEC unfec);
+void unfecReport(PUNFEC unfec, FILE *out);
+
+#endif
@@ -0,0 +1,711 @@
+/*******************************************************************************
+* SOURCE FILE: feedback.c
+*
+* PROGRAM: Covert
+*
+* FUNCTIONS:
+* int reporterOpen(PREPORTER reporter, char *arg);
+* void reporterSend(PREPORTER reporter, const struct in6_addr *addr,
+*        PREPORT report);
+* void reporterClose(PREPORTER reporter);
+* void reporterReport(PREPORTER reporter, FILE *out);
+* int feedbackOpen(PFEEDBACK feedback, unsigned short port, int family,
+*        unsigned short sport, unsigned short dport);
+* void feedbackSent(PFEEDBACK feedback, unsigned int seq,
+*        unsigned long long word, int valid);
+* int feedbackRoom(PFEEDBACK feedback);
+* int feedbackWait(PFEEDBACK feedback, int block);
+* void feedbackClose(PFEEDBACK feedback);
+* void feedbackReport(PFEEDBACK feedback, FILE *out);
+* static int feedbackProcess(PFEEDBACK feedback, PREPORT report, int count,
+*        double now);
+* static double feedbackRto(PFEEDBACK feedback, int backoff);
+* static double feedbackNow(void);
+*
+* DATE: October 18, 2026
+*
+* DESIGNER: Karl Castillo (c)
+*
+* PROGRAMMER: Karl Castillo (c)
+*
+* NOTES:
+* A report carries the next packet the server is waiting for, which every
+* packet before it has been received, and a bitmap of the packets it holds
+* past that one. The server sends one for a session at most every FEED_MS
+* while packets arrive, and a few more once a transfer completes.
+*
+* The client keeps every packet in flight so it can be built again, and
+* allows at most a window of them past the next one the server waits for.
+* The window grows by one packet per window acknowledged and is halved when
+* a packet is reported missing, like the congestion window of TCP, so the
+* send rate settles at what the path can carry. It never grows past the
+* reassembly window of the server, which therefore never has to give up on
+* a packet.
+*
+* The packets of a single flow arrive in the order they were sent, so a
+* packet missing below one the server holds was lost if it was sent before
+* that one, even when that was a moment ago. Any other packet still missing
+* is sent again once the retransmit timeout has passed. When no report
+* arrives for that long a probe is sent instead of data: a packet the server
+* only answers with a report, so the client never sends a packet the server
+* has already written, which could be taken for the start of a new transfer.
+*
+* A lost packet with nothing sent after it leaves no hole to report, so
+* after two round trips without progress the newest packet is sent once
+* more, like the tail loss probe of TCP, well before the timeout.
+*
+* Reports go back over the family the client sent from. A host given to the
+* server is always IPv4.
+*******************************************************************************/
+/* INCLUDES */
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include <time.h>
+#include <unistd.h>
+#include <netdb.h>
+#include <poll.h>
+#include <sys/socket.h>
+#include <arpa/inet.h>
+#include "feedback.h"
+
+/* PROTOTYPES */
+static int feedbackProcess(PFEEDBACK feedback, PREPORT report, int count,
+        double now);
+static double feedbackRto(PFEEDBACK feedback, int backoff);
+static double feedbackNow(void);
+
+/*******************************************************************************
+* FUNCTION: reporterOpen
+*
+* DATE: October 18, 2026
+*
+* REVISIONS: (Date and Description)
+*
+* DESIGNER: Karl Castillo (c)
+*
+* PROGRAMMER: Karl Castillo (c)
+*
+* INTERFACE: int reporterOpen(PREPORTER reporter, char *arg)
+* reporter: the reporter to open
+* arg: where the reports go, host:port, or only the port to send them to the
+*       address every client sends from
+*
+* RETURN: int
+* 0: in success
+* -1: the address is invalid or the socket could not be opened
+*
+* NOTES:
+* The IPv6 socket is only needed for IPv6 clients, so a host without IPv6
+* can still open the reporter.
+*******************************************************************************/
+int reporterOpen(PREPORTER reporter, char *arg)
+{
+        struct hostent *host;
+        char name[256];
+        char *colon;
+        char *end;
+        long port;
+
+        memset(reporter, 0, sizeof(REPORTER));
+        reporter->sin.sin_family = AF_INET;
+
+        if((colon = strrchr(arg, ':')) != NULL) {
+                if(colon - arg >= (int)sizeof(name)) {
+                        return -1;
+                }
+                memcpy(name, arg, colon - arg);
+                name[colon - arg] = '\0';
+                if(inet_aton(name, &reporter->sin.sin_addr) == 0) {
+                        if((host = gethostbyname(name)) == NULL) {
+                                return -1;
+                        }
+                        memcpy(&reporter->sin.sin_addr, host->h_addr,
+                                sizeof(reporter->sin.sin_addr));
+                }
+                arg = colon + 1;
+        }
+
+        port = strtol(arg, &end, 10);
+        if(end == arg || *end != '\0' || port < 1 || port > 65535) {
+                return -1;
+        }
+        reporter->sin.sin_port = htons(port);
+
+        if((reporter->sock = socket(AF_INET, SOCK_DGRAM, 0)) < 0) {
+                return -1;
+        }
+        reporter->sock6 = socket(AF_INET6, SOCK_DGRAM, 0);
+
+        return 0;
+}
+
+/*******************************************************************************
+* FUNCTION: reporterSend
+*
+* DATE: October 18, 2026
+*
+* REVISIONS: (Date and Description)
+*
+* DESIGNER: Karl Castillo (c)
+*
+* PROGRAMMER: Karl Castillo (c)
+*
+* INTERFACE: void reporterSend(PREPORTER reporter,
+*       const struct in6_addr *addr, PREPORT report)
+* reporter: the open reporter
+* addr: the client, an IPv4 client as an IPv4-mapped address
+* report: the report, in network order
+*
+* RETURN: void
+*
+* NOTES:
+* Only the bytes of the bitmap that cover held packets are sent.
+*******************************************************************************/
+void reporterSend(PREPORTER reporter, const struct in6_addr *addr,
+        PREPORT report)
+{
+        struct sockaddr_in sin = reporter->sin;
+        struct sockaddr_in6 sin6;
+        struct sockaddr *to = (struct sockaddr*)&sin;
+        socklen_t to_len = sizeof(sin);
+        int sock = reporter->sock;
+        size_t size = sizeof(REPORT);
+
+        if(sin.sin_addr.s_addr == INADDR_ANY && IN6_IS_ADDR_V4MAPPED(addr)) {
+                memcpy(&sin.sin_addr, &addr->s6_addr[12],
+                        sizeof(sin.sin_addr));
+        } else if(sin.sin_addr.s_addr == INADDR_ANY) {
+                memset(&sin6, 0, sizeof(sin6));
+                sin6.sin6_family = AF_INET6;
+                sin6.sin6_port = sin.sin_port;
+                sin6.sin6_addr = *addr;
+                to = (struct sockaddr*)&sin6;
+                to_len = sizeof(sin6);
+                sock = reporter->sock6;
+        }
+        while(size > sizeof(REPORT) - sizeof(report->map) &&
+                        report->map[size - (sizeof(REPORT) -
+                        sizeof(report->map)) - 1] == 0) {
+                size--;
+        }
+
+        if(sendto(sock, report, size, MSG_DONTWAIT, to, to_len) < 0) {
+                reporter->errors++;
+        } else {
+                reporter->sent++;
+        }
+}
+
+/*******************************************************************************
+* FUNCTION: reporterClose
+*
+* DATE: October 18, 2026
+*
+* REVISIONS: (Date and Description)
+*
+* DESIGNER: Karl Castillo (c)
+*
+* PROGRAMMER: Karl Castillo (c)
+*
+* INTERFACE: void reporterClose(PREPORTER reporter)
+* reporter: the reporter
+*
+* RETURN: void
+*******************************************************************************/
+void reporterClose(PREPORTER reporter)
+{
+        close(reporter->sock);
+        if(reporter->sock6 >= 0) {
+                close(reporter->sock6);
+        }
+}
+
+/*******************************************************************************
+* FUNCTION: reporterReport
+*
+* DATE: October 18, 2026
+*
+* REVISIONS: (Date and Description)
+*
+* DESIGNER: Karl Castillo (c)
+*
+* PROGRAMMER: Karl Castillo (c)
+*
+* INTERFACE: void reporterReport(PREPORTER reporter, FILE *out)
+* reporter: the reporter
+* out: where the report will be printed
+*
+* RETURN: void
+*******************************************************************************/
+void reporterReport(PREPORTER reporter, FILE *out)
+{
+        fprintf(out, "Feedback: %lu reports sent, %lu errors\n",
+                reporter->sent, reporter->errors);
+}
+
+/*******************************************************************************
+* FUNCTION: feedbackOpen
+*
+* DATE: October 18, 2026
+*
+* REVISIONS: (Date and Description)
+*
+* DESIGNER: Karl Castillo (c)
+*
+* PROGRAMMER: Karl Castillo (c)
+*
+* INTERFACE: int feedbackOpen(PFEEDBACK feedback, unsigned short port,
+*       int family, unsigned short sport, unsigned short dport)
+* feedback: the feedback to open
+* port: the UDP port the reports arrive on
+* family: AF_INET or AF_INET6, the family the transfer is sent over
+* sport: the source port of the transfer
+* dport: the destination port of the transfer
+*
+* RETURN: int
+* 0: in success
+* -1: the socket could not be opened or the window allocated
+*******************************************************************************/
+int feedbackOpen(PFEEDBACK feedback, unsigned short port, int family,
+        unsigned short sport, unsigned short dport)
+{
+        struct sockaddr_in sin;
+        struct sockaddr_in6 sin6;
+        struct sockaddr *addr = (struct sockaddr*)&sin;
+        socklen_t addr_len = sizeof(sin);
+
+        memset(feedback, 0, sizeof(FEEDBACK));
+        feedback->sport = sport;
+        feedback->dport = dport;
+        feedback->limit = FEED_MAP;
+        feedback->cwnd = FEED_CWND;
+        feedback->peak = FEED_CWND;
+        feedback->ssthresh = FEED_MAP;
+        feedback->srtt = MIN_RTO;
+        feedback->heard = feedbackNow();
+
+        if((feedback->slots = (PSENT)calloc(FEED_MAP, sizeof(SENT))) == NULL) {
+                return -1;
+        }
+
+        memset(&sin, 0, sizeof(sin));
+        sin.sin_family = AF_INET;
+        sin.sin_port = htons(port);
+        if(family == AF_INET6) {
+                memset(&sin6, 0, sizeof(sin6));
+                sin6.sin6_family = AF_INET6;
+                sin6.sin6_port = htons(port);
+                sin6.sin6_addr = in6addr_any;
+                addr = (struct sockaddr*)&sin6;
+                addr_len = sizeof(sin6);
+        }
+        if((feedback->sock = socket(family, SOCK_DGRAM, 0)) < 0) {
+                free(feedback->slots);
+                return -1;
+        }
+        if(bind(feedback->sock, addr, addr_len) < 0) {
+                close(feedback->sock);
+                free(feedback->slots);
+                return -1;
+        }
+
+        return 0;
+}
+
+/*******************************************************************************
+* FUNCTION: feedbackSent
+*
+* DATE: October 18, 2026
+*
+* REVISIONS: (Date and Description)
+*
+* DESIGNER: Karl Castillo (c)
+*
+* PROGRAMMER: Karl Castillo (c)
+*
+* INTERFACE: void feedbackSent(PFEEDBACK feedback, unsigned int seq,
+*       unsigned long long word, int valid)
+* feedback: the feedback
+* seq: the sequence number of the new packet
+* word: its payload bits
+* valid: the payload bits of the last packet, -1 for any other packet
+*
+* RETURN: void
+*
+* NOTES:
+* Keeps the packet until the server has it. Must only be called while
+* feedbackRoom allows it.
+*******************************************************************************/
+void feedbackSent(PFEEDBACK feedback, unsigned int seq,
+        unsigned long long word, int valid)
+{
+        PSENT sent = &feedback->slots[seq % FEED_MAP];
+
+        sent->word = word;
+        sent->valid = valid;
+        sent->resent = 0;
+        sent->stamp = feedbackNow();
+
+        if(feedback->sent == feedback->acked) {
+                feedback->progress = sent->stamp;
+        }
+        feedback->sent = seq + 1;
+        if(valid >= 0) {
+                feedback->total = seq + 1;
+        }
+}
+
+/*******************************************************************************
+* FUNCTION: feedbackRoom
+*
+* DATE: October 18, 2026
+*
+* REVISIONS: (Date and Description)
+*
+* DESIGNER: Karl Castillo (c)
+*
+* PROGRAMMER: Karl Castillo (c)
+*
+* INTERFACE: int feedbackRoom(PFEEDBACK feedback)
+* feedback: the feedback
+*
+* RETURN: int: the number of new packets the window allows now
+*******************************************************************************/
+int feedbackRoom(PFEEDBACK feedback)
+{
+        int window = (int)feedback->cwnd;
+        int room;
+
+        if(window > feedback->limit) {
+                window = feedback->limit;
+        }
+        room = window - (int)(feedback->sent - feedback->acked);
+
+        return room > 0 ? room : 0;
+}
+
+/*******************************************************************************
+* FUNCTION: feedbackWait
+*
+* DATE: October 18, 2026
+*
+* REVISIONS: (Date and Description)
+*
+* DESIGNER: Karl Castillo (c)
+*
+* PROGRAMMER: Karl Castillo (c)
+*
+* INTERFACE: int feedbackWait(PFEEDBACK feedback, int block)
+* feedback: the feedback
+* block: wait for a report or the retransmit timeout, else only take the
+*       reports already queued
+*
+* RETURN: int
+* n: the number of packets to send again, in feedback->resend
+* -1: no report arrived for FEED_GIVEUP ms
+*
+* NOTES:
+* The packets listed are counted as sent again, so the caller must send
+* them, and a probe when feedback->probe is set.
+*******************************************************************************/
+int feedbackWait(PFEEDBACK feedback, int block)
+{
+        struct pollfd pfd;
+        REPORT report;
+        PSENT sent;
+        double now = feedbackNow();
+        double wait;
+        int count = 0;
+        int outstanding;
+
+        outstanding = feedback->sent != feedback->acked ||
+                (feedback->total != 0 && !feedback->done);
+
+        if(block) {
+                wait = !outstanding ? FEED_GIVEUP : feedback->progress - now +
+                        (feedback->tail ? feedbackRto(feedback, 1) :
+                        2 * feedback->srtt + 2 * FEED_MS);
+                pfd.fd = feedback->sock;
+                pfd.events = POLLIN;
+                poll(&pfd, 1, wait > 0 ? (int)wait + 1 : 0);
+                now = feedbackNow();
+        }
+
+        for(;;) {
+                memset(&report, 0, sizeof(report));
+                if(recv(feedback->sock, &report, sizeof(report), MSG_DONTWAIT) <
+                                (int)(sizeof(REPORT) - sizeof(report.map))) {
+                        break;
+                }
+                if(ntohl(report.magic) != FEED_MAGIC ||
+                                ntohs(report.sport) != feedback->sport ||
+                                ntohs(report.dport) != feedback->dport) {
+                        continue;
+                }
+                feedback->heard = now;
+                count = feedbackProcess(feedback, &report, count, now);
+        }
+
+        if(now - feedback->heard >= FEED_GIVEUP) {
+                return -1;
+        }
+
+        outstanding = feedback->sent != feedback->acked ||
+                (feedback->total != 0 && !feedback->done);
+        if(count == 0 && outstanding && !feedback->tail &&
+                        now - feedback->progress >= 2 * feedback->srtt +
+                        2 * FEED_MS) {
+                feedback->tail = 1;
+                sent = &feedback->slots[(feedback->sent - 1) % FEED_MAP];
+                if(feedback->sent != feedback->acked && sent->valid < 0) {
+                        sent->stamp = now;
+                        sent->resent = 1;
+                        feedback->resend[count++] = feedback->sent - 1;
+                        feedback->retransmits++;
+                } else {
+                        feedback->probe = 1;
+                }
+        } else if(count == 0 && outstanding &&
+                        now - feedback->progress >= feedbackRto(feedback, 1)) {
+                feedback->ssthresh = feedback->cwnd / 2 > MIN_CWND ?
+                        feedback->cwnd / 2 : MIN_CWND;
+                feedback->cwnd = MIN_CWND;
+                feedback->recover = feedback->sent;
+                if(feedbackRto(feedback, 1) < MAX_RTO) {
+                        feedback->backoff++;
+                }
+                feedback->progress = now;
+                feedback->probe = 1;
+                feedback->timeouts++;
+        }
+
+        return count;
+}
+
+/*******************************************************************************
+* FUNCTION: feedbackClose
+*
+* DATE: October 18, 2026
+*
+* REVISIONS: (Date and Description)
+*
+* DESIGNER: Karl Castillo (c)
+*
+* PROGRAMMER: Karl Castillo (c)
+*
+* INTERFACE: void feedbackClose(PFEEDBACK feedback)
+* feedback: the feedback
+*
+* RETURN: void
+*******************************************************************************/
+void feedbackClose(PFEEDBACK feedback)
+{
+        close(feedback->sock);
+        free(feedback->slots);
+        feedback->slots = NULL;
+}
+
+/*******************************************************************************
+* FUNCTION: feedbackReport
+*
+* DATE: October 18, 2026
+*
+* REVISIONS: (Date and Description)
+*
+* DESIGNER: Karl Castillo (c)
+*
+* PROGRAMMER: Karl Castillo (c)
+*
+* INTERFACE: void feedbackReport(PFEEDBACK feedback, FILE *out)
+* feedback: the feedback
+* out: where the report will be printed
+*
+* RETURN: void
+*******************************************************************************/
+void feedbackReport(PFEEDBACK feedback, FILE *out)
+{
+        fprintf(out, "Feedback: %lu reports, %lu packets sent again, %lu "
+                "window cuts, %lu timeouts, %s\n", feedback->reports,
+                feedback->retransmits, feedback->cuts, feedback->timeouts,
+                feedback->done ? "completed" : "not confirmed");
+        fprintf(out, "Window: %.0f packets at most, round trip %.2f ms\n",
+                feedback->peak, feedback->srtt);
+}
+
+/*******************************************************************************
+* FUNCTION: feedbackProcess
+*
+* DATE: October 18, 2026
+*
+* REVISIONS: (Date and Description)
+*
+* DESIGNER: Karl Castillo (c)
+*
+* PROGRAMMER: Karl Castillo (c)
+*
+* INTERFACE: static int feedbackProcess(PFEEDBACK feedback, PREPORT report,
+*       int count, double now)
+* feedback: the feedback
+* report: a report of our transfer, in network order
+* count: the packets already listed to be sent again
+* now: the current time in ms
+*
+* RETURN: int: the packets listed to be sent again, count included
+*
+* NOTES:
+* A packet listed is stamped as sent now, so the reports that follow do not
+* list it again before it had the time to arrive.
+*******************************************************************************/
+static int feedbackProcess(PFEEDBACK feedback, PREPORT report, int count,
+        double now)
+{
+        unsigned int next = ntohl(report->next);
+        unsigned int held = ntohl(report->held);
+        unsigned int window = ntohl(report->window);
+        unsigned int top = 0;
+        unsigned int n;
+        unsigned int seq;
+        unsigned int span;
+        PSENT sent;
+        double last = 0;
+        double rtt;
+        int lost = 0;
+
+        feedback->reports++;
+        feedback->limit = window < FEED_MAP ? (int)window : FEED_MAP;
+
+        if(feedback->total != 0 && next == 0 && held == 0 &&
+                        ntohl(report->length) == feedback->total) {
+                feedback->done = 1;
+                feedback->acked = feedback->sent;
+                return count;
+        }
+        if((int)(next - feedback->acked) < 0 ||
+                        (int)(next - feedback->sent) > 0) {
+                return count;
+        }
+
+        if(next != feedback->acked) {
+                sent = &feedback->slots[(next - 1) % FEED_MAP];
+                if(!sent->resent) {
+                        rtt = now - sent->stamp;
+                        feedback->srtt += (rtt - feedback->srtt) / 8;
+                }
+                if(feedback->cwnd < feedback->ssthresh) {
+                        feedback->cwnd += next - feedback->acked;
+                } else {
+                        feedback->cwnd += (next - feedback->acked) /
+                                feedback->cwnd;
+                }
+                if(feedback->cwnd > feedback->limit) {
+                        feedback->cwnd = feedback->limit;
+                }
+                if(feedback->cwnd > feedback->peak) {
+                        feedback->peak = feedback->cwnd;
+                }
+                feedback->acked = next;
+                feedback->progress = now;
+                feedback->backoff = 0;
+                feedback->tail = 0;
+        }
+
+        span = feedback->sent - next;
+        if(held > 0) {
+                for(n = span < FEED_MAP ? span : FEED_MAP; n > 0; n--) {
+                        if(report->map[(n - 1) / 8] & (1 << ((n - 1) % 8))) {
+                                top = n - 1;
+                                last = feedback->slots[(next + top) %
+                                        FEED_MAP].stamp;
+                                break;
+                        }
+                }
+        }
+
+        for(n = 0; n < span && count < FEED_MAP; n++) {
+                if(n < FEED_MAP && (report->map[n / 8] & (1 << (n % 8)))) {
+                        continue;
+                }
+                seq = next + n;
+                sent = &feedback->slots[seq % FEED_MAP];
+                if((n >= top || sent->stamp > last) &&
+                                now - sent->stamp < feedbackRto(feedback, 0)) {
+                        continue;
+                }
+                sent->stamp = now;
+                sent->resent = 1;
+                feedback->resend[count++] = seq;
+                feedback->retransmits++;
+                lost = 1;
+        }
+
+        if(lost && (int)(feedback->acked - feedback->recover) >= 0) {
+                feedback->ssthresh = feedback->cwnd / 2 > MIN_CWND ?
+                        feedback->cwnd / 2 : MIN_CWND;
+                feedback->cwnd = feedback->ssthresh;
+                feedback->recover = feedback->sent;
+                feedback->cuts++;
+        }
+
+        return count;
+}
+
+/*******************************************************************************
+* FUNCTION: feedbackRto
+*
+* DATE: October 18, 2026
+*
+* REVISIONS: (Date and Description)
+*
+* DESIGNER: Karl Castillo (c)
+*
+* PROGRAMMER: Karl Castillo (c)
+*
+* INTERFACE: static double feedbackRto(PFEEDBACK feedback, int backoff)
+* feedback: the feedback
+* backoff: double it for every timeout in a row
+*
+* RETURN: double: the retransmit timeout in ms
+*
+* NOTES:
+* Two round trips plus the time the server may hold a report. Only the timer
+* backs off; a packet is still taken for lost once the plain timeout has
+* passed, so the report a probe brings back gets it sent again.
+*******************************************************************************/
+static double feedbackRto(PFEEDBACK feedback, int backoff)
+{
+        double rto = 2 * feedback->srtt + 2 * FEED_MS;
+
+        if(rto < MIN_RTO) {
+                rto = MIN_RTO;
+        }
+        if(backoff) {
+                rto *= 1 << feedback->backoff;
+        }
+
+        return rto < MAX_RTO ? rto : MAX_RTO;
+}
+
+/*******************************************************************************
+* FUNCTION: feedbackNow
+*
+* DATE: October 18, 2026
+*
+* REVISIONS: (Date and Description)
+*
+* DESIGNER: Karl Castillo (c)
+*
+* PROGRAMMER: Karl Castillo (c)
+*
+* INTERFACE: static double feedbackNow(void)
+*
+* RETURN: double: the monotonic clock in ms
+*******************************************************************************/
+static double feedbackNow(void)
+{
+        struct timespec ts;
+
+        clock_gettime(CLOCK_MONOTONIC, &ts);
+
+        return ts.tv_sec * 1000.0 + ts.tv_nsec / 1000000.0;
+}
@@ -0,0 +1,121 @@
+/*******************************************************************************
+* HEADER FILE: feedback.h
+*
+* PROGRAM: Covert
+*
+* FUNCTIONS:
+* int reporterOpen(PREPORTER reporter, char *arg);
+* void reporterSend(PREPORTER reporter, const struct in6_addr *addr,
+*        PREPORT report);
+* void reporterClose(PREPORTER reporter);
+* void reporterReport(PREPORTER reporter, FILE *out);
+* int feedbackOpen(PFEEDBACK feedback, unsigned short port, int family,
+*        unsigned short sport, unsigned short dport);
+* void feedbackSent(PFEEDBACK feedback, unsigned int seq,
+*        unsigned long long word, int valid);
+* int feedbackRoom(PFEEDBACK feedback);
+* int feedbackWait(PFEEDBACK feedback, int block);
+* void feedbackClose(PFEEDBACK feedback);
+* void feedbackReport(PFEEDBACK feedback, FILE *out);
+*
+* DATE: October 18, 2026
+*
+* DESIGNER: Karl Castillo (c)
+*
+* PROGRAMMER: Karl Castillo (c)
+*
+* NOTES:
+* The optional feedback channel. The server reports what it has received to
+* the client over UDP, and the client keeps a window of packets in flight
+* and sends again only the packets that were reported missing.
+*******************************************************************************/
+#ifndef FEEDBACK_H
+#define FEEDBACK_H
+
+#include <stdio.h>
+#include <netinet/in.h>
+
+/* DEFINES */
+#define FEED_MAGIC      0x434f5654      /* "COVT" */
+#define FEED_MAP        4096    /* packets past the next one a report covers */
+#define FEED_PROBE      0x1     /* TCP res1 of a probe, asks for a report */
+#define FEED_MS         1       /* least time between reports of a session */
+#define FEED_REPEATS    8       /* reports sent for a completed transfer */
+#define FEED_POLL       64      /* new packets between looks at the reports */
+#define FEED_CWND       16      /* packets in flight at the start */
+#define MIN_CWND        2
+#define MIN_RTO         20      /* ms */
+#define MAX_RTO         1000    /* ms */
+#define FEED_GIVEUP     5000    /* ms without a report before giving up */
+
+/* STRUCTURES */
+typedef struct report {                 /* on the wire, network order */
+        unsigned int magic;
+        unsigned short sport;           /* port of the client's first flow */
+        unsigned short dport;           /* port the client sends to */
+        unsigned int window;            /* reassembly window of the server */
+        unsigned int transfers;         /* transfers completed */
+        unsigned int length;            /* packets in the last one completed */
+        unsigned int next;              /* every packet before it is in */
+        unsigned int held;              /* packets held past next */
+        unsigned char map[FEED_MAP / 8]; /* bit n set when next + n is held */
+} REPORT, *PREPORT;
+
+typedef struct reporter {
+        int sock;                       /* UDP socket the reports leave from */
+        int sock6;                      /* the same over IPv6, or -1 */
+        struct sockaddr_in sin;         /* where they go, 0.0.0.0 for the client */
+        unsigned long sent;             /* reports sent */
+        unsigned long errors;           /* reports the kernel refused */
+} REPORTER, *PREPORTER;
+
+typedef struct sent {
+        unsigned long long word;        /* the payload bits */
+        int valid;                      /* payload bits of the last, else -1 */
+        int resent;                     /* sent more than once */
+        double stamp;                   /* when it was last sent, in ms */
+} SENT, *PSENT;
+
+typedef struct feedback {
+        int sock;                       /* UDP socket the reports arrive on */
+        unsigned short sport;           /* our first flow, host order */
+        unsigned short dport;           /* where we send, host order */
+        PSENT slots;                    /* packets in flight, seq % FEED_MAP */
+        unsigned int acked;             /* every packet before it is in */
+        unsigned int sent;              /* the next new packet */
+        unsigned int total;             /* packets in the transfer, 0 unknown */
+        unsigned int recover;           /* no cut until acked passes it */
+        int done;                       /* the server completed the transfer */
+        int probe;                      /* a probe should be sent */
+        int limit;                      /* the most packets in flight */
+        double cwnd;                    /* packets allowed in flight */
+        double ssthresh;                /* where slow start ends */
+        double srtt;                    /* smoothed round trip time, ms */
+        int backoff;                    /* timeouts in a row */
+        int tail;                       /* the newest packet was sent again */
+        double progress;                /* last time acked moved, ms */
+        double heard;                   /* last time a report arrived, ms */
+        unsigned int resend[FEED_MAP];  /* the packets to send again */
+        unsigned long reports;          /* reports received */
+        unsigned long retransmits;      /* packets sent again */
+        unsigned long cuts;             /* times the window was halved */
+        unsigned long timeouts;         /* times a report did not come */
+        double peak;                    /* largest window reached */
+} FEEDBACK, *PFEEDBACK;
+
+/* PROTOTYPES */
+int reporterOpen(PREPORTER reporter, char *arg);
+void reporterSend(PREPORTER reporter, const struct in6_addr *addr,
+        PREPORT report);
+void reporterClose(PREPORTER reporter);
+void reporterReport(PREPORTER reporter, FILE *out);
+int feedbackOpen(PFEEDBACK feedback, unsigned short port, int family,
+        unsigned short sport, unsigned short dport);
+void feedbackSent(PFEEDBACK feedback, unsigned int seq,
+        unsigned long long word, int valid);
+int feedbackRoom(PFEEDBACK feedback);
+int feedbackWait(PFEEDBACK feedback, int block);
+void feedbackClose(PFEEDBACK feedback);
+void feedbackReport(PFEEDBACK feedback, FILE *out);
+
+#endif
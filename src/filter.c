@@ -0,0 +1,237 @@
+/*******************************************************************************
+* SOURCE FILE: filter.c
+*
+* PROGRAM: Covert
+*
+* FUNCTIONS:
+* int filterAttach(int sock, const struct in6_addr *source,
+*        unsigned short port);
+* int filterFanout(int sock, int group, int count);
+*
+* DATE: October 18, 2026
+*
+* DESIGNER: Karl Castillo (c)
+*
+* PROGRAMMER: Karl Castillo (c)
+*
+* NOTES:
+* A classic BPF program is attached to the capture socket so the kernel
+* throws away everything that is not one of our packets before it is queued.
+* The program runs on the packet starting at the IP header, which is what
+* both the raw socket and the SOCK_DGRAM packet socket see. It branches on
+* the IP version so the same program serves a dual-stack capture.
+*
+* A second program spreads the packets of a fanout group over the receive
+* workers of the server.
+*******************************************************************************/
+/* INCLUDES */
+#include <sys/socket.h>
+#include <arpa/inet.h>
+#include <netinet/in.h>
+#include <linux/filter.h>
+#include <linux/if_packet.h>
+#include "codec.h"
+#include "filter.h"
+
+/* DEFINES */
+#define V6              14      /* the IPv6 checks */
+#define TCP             25      /* the checks on the TCP header at X */
+#define DROP            30
+#define TO_V6(i)        (V6 - (i) - 1)
+#define TO_TCP(i)       (TCP - (i) - 1)
+#define TO_DROP(i)      (DROP - (i) - 1)
+
+/*******************************************************************************
+* FUNCTION: filterAttach
+*
+* DATE: October 18, 2026
+*
+* REVISIONS: (Date and Description)
+*
+* DESIGNER: Karl Castillo (c)
+*
+* PROGRAMMER: Karl Castillo (c)
+*
+* INTERFACE: int filterAttach(int sock, const struct in6_addr *source,
+*       unsigned short port)
+* sock: the capture socket
+* source: the address the data will be coming from, an IPv4 address as an
+*       IPv4-mapped one, or NULL for any
+* port: the port the data is sent to
+*
+* RETURN: int
+* 0: in success
+* -1: the filter could not be attached
+*
+* NOTES:
+* Accepts unfragmented TCP SYNs from source to port that were not sent by
+* this host. Both families have to carry TCP right after the fixed header:
+* an IPv4 packet with options is dropped, since the decoder reads the TCP
+* header at a fixed offset. Without a source the address tests become jumps to the
+* next instruction so the offsets stay the same, and a source of the other
+* family turns the first test of a branch into a jump to the drop.
+*******************************************************************************/
+int filterAttach(int sock, const struct in6_addr *source,
+        unsigned short port)
+{
+        struct sock_filter code[] = {
+                /* 0: not one of our own outgoing packets */
+                BPF_STMT(BPF_LD | BPF_W | BPF_ABS, SKF_AD_OFF + SKF_AD_PKTTYPE),
+                BPF_JUMP(BPF_JMP | BPF_JEQ | BPF_K, PACKET_OUTGOING,
+                        TO_DROP(1), 0),
+                /* 2: IPv4 without options or IPv6 */
+                BPF_STMT(BPF_LD | BPF_B | BPF_ABS, 0),
+                BPF_JUMP(BPF_JMP | BPF_JEQ | BPF_K, 0x45, 2, 0),
+                BPF_STMT(BPF_ALU | BPF_AND | BPF_K, 0xf0),
+                BPF_JUMP(BPF_JMP | BPF_JEQ | BPF_K, 0x60, TO_V6(5),
+                        TO_DROP(5)),
+                /* 6: TCP */
+                BPF_STMT(BPF_LD | BPF_B | BPF_ABS, 9),
+                BPF_JUMP(BPF_JMP | BPF_JEQ | BPF_K, IPPROTO_TCP, 0, TO_DROP(7)),
+                /* 8: from the source address */
+                BPF_STMT(BPF_LD | BPF_W | BPF_ABS, 12),
+                BPF_JUMP(BPF_JMP | BPF_JEQ | BPF_K, 0, 0, TO_DROP(9)),
+                /* 10: first fragment only */
+                BPF_STMT(BPF_LD | BPF_H | BPF_ABS, 6),
+                BPF_JUMP(BPF_JMP | BPF_JSET | BPF_K, 0x1fff, TO_DROP(11), 0),
+                /* 12: X = IPv4 header length */
+                BPF_STMT(BPF_LDX | BPF_IMM, 20),
+                BPF_JUMP(BPF_JMP | BPF_JA, TO_TCP(13), 0, 0),
+                /* 14: IPv6 carrying TCP */
+                BPF_STMT(BPF_LD | BPF_B | BPF_ABS, 6),
+                BPF_JUMP(BPF_JMP | BPF_JEQ | BPF_K, IPPROTO_TCP, 0,
+                        TO_DROP(15)),
+                /* 16: from the source address */
+                BPF_STMT(BPF_LD | BPF_W | BPF_ABS, 8),
+                BPF_JUMP(BPF_JMP | BPF_JEQ | BPF_K, 0, 0, TO_DROP(17)),
+                BPF_STMT(BPF_LD | BPF_W | BPF_ABS, 12),
+                BPF_JUMP(BPF_JMP | BPF_JEQ | BPF_K, 0, 0, TO_DROP(19)),
+                BPF_STMT(BPF_LD | BPF_W | BPF_ABS, 16),
+                BPF_JUMP(BPF_JMP | BPF_JEQ | BPF_K, 0, 0, TO_DROP(21)),
+                BPF_STMT(BPF_LD | BPF_W | BPF_ABS, 20),
+                BPF_JUMP(BPF_JMP | BPF_JEQ | BPF_K, 0, 0, TO_DROP(23)),
+                /* 24: X = IPv6 header length */
+                BPF_STMT(BPF_LDX | BPF_IMM, 40),
+                /* 25: to the destination port */
+                BPF_STMT(BPF_LD | BPF_H | BPF_IND, 2),
+                BPF_JUMP(BPF_JMP | BPF_JEQ | BPF_K, port, 0, TO_DROP(26)),
+                /* 27: with SYN set */
+                BPF_STMT(BPF_LD | BPF_B | BPF_IND, 13),
+                BPF_JUMP(BPF_JMP | BPF_JSET | BPF_K, 0x02, 0, TO_DROP(28)),
+                /* 29: accept */
+                BPF_STMT(BPF_RET | BPF_K, FILTER_SNAPLEN),
+                /* 30: drop */
+                BPF_STMT(BPF_RET | BPF_K, 0)
+        };
+        struct sock_fprog prog;
+        int i;
+
+        for(i = 0; i < 4; i++) {
+                if(source == NULL) {
+                        code[17 + 2 * i] = (struct sock_filter)BPF_JUMP(
+                                BPF_JMP | BPF_JA, 0, 0, 0);
+                } else {
+                        code[17 + 2 * i].k = ntohl(source->s6_addr32[i]);
+                }
+        }
+        if(source == NULL) {
+                code[9] = (struct sock_filter)BPF_JUMP(BPF_JMP | BPF_JA, 0, 0,
+                        0);
+        } else if(IN6_IS_ADDR_V4MAPPED(source)) {
+                code[9].k = ntohl(source->s6_addr32[3]);
+                code[17] = (struct sock_filter)BPF_JUMP(BPF_JMP | BPF_JA,
+                        TO_DROP(17), 0, 0);
+        } else {
+                code[9] = (struct sock_filter)BPF_JUMP(BPF_JMP | BPF_JA,
+                        TO_DROP(9), 0, 0);
+        }
+
+        prog.len = sizeof(code) / sizeof(code[0]);
+        prog.filter = code;
+
+        return setsockopt(sock, SOL_SOCKET, SO_ATTACH_FILTER, &prog,
+                sizeof(prog));
+}
+
+/*******************************************************************************
+* FUNCTION: filterFanout
+*
+* DATE: October 18, 2026
+*
+* REVISIONS: (Date and Description)
+*
+* DESIGNER: Karl Castillo (c)
+*
+* PROGRAMMER: Karl Castillo (c)
+*
+* INTERFACE: int filterFanout(int sock, int group, int count)
+* sock: a packet socket
+* group: the fanout group, the same for every worker
+* count: the number of sockets in the group
+*
+* RETURN: int
+* 0: in success
+* -1: the socket could not join the group or the program was refused
+*
+* NOTES:
+* The kernel's own hash mode hashes the whole 4-tuple, which would hand the
+* flows of a parallel client, each on its own source port, to different
+* workers. This program hashes the session key instead: the source address
+* and the port of the first flow, the source port less the flow taken from
+* the low bits of the TCP window. Every packet of a session goes to the same socket, and
+* different sessions spread over all of them. Packets that are not TCP run
+* off the end of the packet, which returns 0, and are dropped by the filter
+* of the first socket. An IPv6 session is hashed on the last word of its
+* source address.
+*******************************************************************************/
+int filterFanout(int sock, int group, int count)
+{
+        struct sock_filter code[] = {
+                /* 0: IPv6 or IPv4 */
+                BPF_STMT(BPF_LD | BPF_B | BPF_ABS, 0),
+                BPF_STMT(BPF_ALU | BPF_AND | BPF_K, 0xf0),
+                BPF_JUMP(BPF_JMP | BPF_JEQ | BPF_K, 0x60, 0, 3),
+                /* 3: X = IPv6 header length, A = end of the source */
+                BPF_STMT(BPF_LDX | BPF_IMM, 40),
+                BPF_STMT(BPF_LD | BPF_W | BPF_ABS, 20),
+                BPF_JUMP(BPF_JMP | BPF_JA, 2, 0, 0),
+                /* 6: X = IP header length, A = the source */
+                BPF_STMT(BPF_LDX | BPF_B | BPF_MSH, 0),
+                BPF_STMT(BPF_LD | BPF_W | BPF_ABS, 12),
+                /* 8: M[1] = the source word */
+                BPF_STMT(BPF_ST, 1),
+                /* 9: M[0] = source port */
+                BPF_STMT(BPF_LD | BPF_H | BPF_IND, 0),
+                BPF_STMT(BPF_ST, 0),
+                /* 11: A = flow */
+                BPF_STMT(BPF_LD | BPF_H | BPF_IND, 14),
+                BPF_STMT(BPF_ALU | BPF_AND | BPF_K, MAX_FLOWS - 1),
+                /* 13: X = port of the first flow */
+                BPF_STMT(BPF_MISC | BPF_TAX, 0),
+                BPF_STMT(BPF_LD | BPF_MEM, 0),
+                BPF_STMT(BPF_ALU | BPF_SUB | BPF_X, 0),
+                BPF_STMT(BPF_ALU | BPF_AND | BPF_K, 0xffff),
+                BPF_STMT(BPF_MISC | BPF_TAX, 0),
+                /* 18: mixed with the source address */
+                BPF_STMT(BPF_LD | BPF_MEM, 1),
+                BPF_STMT(BPF_ALU | BPF_XOR | BPF_X, 0),
+                BPF_STMT(BPF_ALU | BPF_MUL | BPF_K, 0x9e3779b1),
+                BPF_STMT(BPF_ALU | BPF_RSH | BPF_K, 16),
+                /* 22: the socket */
+                BPF_STMT(BPF_ALU | BPF_MOD | BPF_K, count),
+                BPF_STMT(BPF_RET | BPF_A, 0)
+        };
+        struct sock_fprog prog;
+        int fanout = (group & 0xffff) | (PACKET_FANOUT_CBPF << 16);
+
+        if(setsockopt(sock, SOL_PACKET, PACKET_FANOUT, &fanout,
+                        sizeof(fanout)) < 0) {
+                return -1;
+        }
+
+        prog.len = sizeof(code) / sizeof(code[0]);
+        prog.filter = code;
+
+        return setsockopt(sock, SOL_PACKET, PACKET_FANOUT_DATA, &prog,
+                sizeof(prog));
+}
@@ -0,0 +1,34 @@
+/*******************************************************************************
+* HEADER FILE: filter.h
+*
+* PROGRAM: Covert
+*
+* FUNCTIONS:
+* int filterAttach(int sock, const struct in6_addr *source,
+*        unsigned short port);
+* int filterFanout(int sock, int group, int count);
+*
+* DATE: October 18, 2026
+*
+* DESIGNER: Karl Castillo (c)
+*
+* PROGRAMMER: Karl Castillo (c)
+*
+* NOTES:
+* The in-kernel packet filter of the server capture, and the program that
+* spreads a fanout group over the receive workers.
+*******************************************************************************/
+#ifndef FILTER_H
+#define FILTER_H
+
+#include <netinet/in.h>
+
+/* DEFINES */
+#define FILTER_SNAPLEN  0xffff
+
+/* PROTOTYPES */
+int filterAttach(int sock, const struct in6_addr *source,
+        unsigned short port);
+int filterFanout(int sock, int group, int count);
+
+#endif
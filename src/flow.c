@@ -0,0 +1,302 @@
+/*******************************************************************************
+* SOURCE FILE: flow.c
+*
+* PROGRAM: Covert
+*
+* FUNCTIONS:
+* int flowRun(PFLOW flows, int count, PJOB job);
+* void flowReport(PFLOW flows, int count, FILE *out);
+* static void *flowMain(void *arg);
+* static unsigned long flowOldest(PJOB job);
+*
+* DATE: October 18, 2026
+*
+* DESIGNER: Karl Castillo (c)
+*
+* PROGRAMMER: Karl Castillo (c)
+*
+* NOTES:
+* The input is cut into chunks of CHUNK_PACKETS packets and every flow claims
+* the next unsent chunk until none are left. The input is mapped, so every
+* flow packs its chunks in place. Because a chunk holds a multiple
+* of 8 packets it always starts on a byte of the input, and its first packet
+* has a known sequence number, so the flows never have to talk to each other.
+* Claiming small chunks in turn keeps the flows close together in the
+* transfer, and a flow that gets more than MAX_SPREAD chunks ahead of the
+* slowest one waits for it. That keeps the reordering the server sees well
+* within its window even when the flows outnumber the CPUs.
+*
+* Only the flow that sends the last chunk sends the packet marked as the last
+* one. Its sequence number is still that of the last packet of the transfer,
+* so the server waits for everything before it.
+*
+* A chunk is FEC_SPAN packets long, so no FEC group crosses from one chunk to
+* the next and every flow sends the parity of the chunks it sent itself.
+*******************************************************************************/
+/* INCLUDES */
+#define _GNU_SOURCE
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include <sched.h>
+#include <unistd.h>
+#include <arpa/inet.h>
+#include "flow.h"
+
+/* PROTOTYPES */
+static void *flowMain(void *arg);
+static unsigned long flowOldest(PJOB job);
+
+/*******************************************************************************
+* FUNCTION: flowRun
+*
+* DATE: October 18, 2026
+*
+* REVISIONS: (Date and Description)
+*
+* DESIGNER: Karl Castillo (c)
+*
+* PROGRAMMER: Karl Castillo (c)
+*
+* INTERFACE: int flowRun(PFLOW flows, int count, PJOB job)
+* flows: the flows, each with its sender and template ready
+* count: the number of flows
+* job: the input, with data, size and layout filled in
+*
+* RETURN: int
+* 0: in success
+* -1: a worker could not be started
+*
+* NOTES:
+* Starts a worker per flow, pinned to CPU index modulo the number of CPUs,
+* and waits for all of them.
+*******************************************************************************/
+int flowRun(PFLOW flows, int count, PJOB job)
+{
+        long cpus = sysconf(_SC_NPROCESSORS_ONLN);
+        int started;
+        int result = 0;
+        int i;
+
+        if(cpus < 1) {
+                cpus = 1;
+        }
+
+        job->chunk_bytes = CHUNK_PACKETS / 8 * job->layout->bits;
+        job->chunks = (job->size + job->chunk_bytes - 1) / job->chunk_bytes;
+        if(job->chunks == 0) {
+                job->chunks = 1;
+        }
+        job->next = 0;
+        job->flows = flows;
+        job->count = count;
+        for(i = 0; i < count; i++) {
+                flows[i].current = ~0UL;
+        }
+
+        for(started = 0; started < count; started++) {
+                flows[started].index = started;
+                flows[started].cpu = started % cpus;
+                flows[started].job = job;
+                flows[started].chunks = 0;
+                if(pthread_create(&flows[started].thread, NULL, flowMain,
+                                &flows[started]) != 0) {
+                        result = -1;
+                        break;
+                }
+        }
+
+        for(i = 0; i < started; i++) {
+                pthread_join(flows[i].thread, NULL);
+        }
+
+        return result;
+}
+
+/*******************************************************************************
+* FUNCTION: flowReport
+*
+* DATE: October 18, 2026
+*
+* REVISIONS: (Date and Description)
+*
+* DESIGNER: Karl Castillo (c)
+*
+* PROGRAMMER: Karl Castillo (c)
+*
+* INTERFACE: void flowReport(PFLOW flows, int count, FILE *out)
+* flows: the flows
+* count: the number of flows
+* out: where the report will be printed
+*
+* RETURN: void
+*
+* NOTES:
+* The achieved rate is taken over the slowest flow, which is when the
+* transfer was done.
+*******************************************************************************/
+void flowReport(PFLOW flows, int count, FILE *out)
+{
+        struct timespec now;
+        unsigned long packets = 0;
+        unsigned long bytes = 0;
+        double elapsed;
+        int i;
+
+        clock_gettime(CLOCK_MONOTONIC, &now);
+        elapsed = (now.tv_sec - flows[0].pacer.start.tv_sec) +
+                (now.tv_nsec - flows[0].pacer.start.tv_nsec) / 1e9;
+        if(elapsed <= 0) {
+                elapsed = 1e-9;
+        }
+
+        for(i = 0; i < count; i++) {
+                fprintf(out, "Flow %d: port %d, CPU %d, %lu chunks, "
+                        "%lu packets, %lu batches, %lu errors\n", i,
+                        templatePort(&flows[i].template),
+                        flows[i].cpu, flows[i].chunks, flows[i].pacer.packets,
+                        flows[i].sender.batches, flows[i].sender.errors);
+                packets += flows[i].pacer.packets;
+                bytes += flows[i].pacer.bytes;
+        }
+
+        fprintf(out, "Sent %lu packets (%lu bytes) over %d flows in %.3f s\n",
+                packets, bytes, count, elapsed);
+        fprintf(out, "Achieved Rate: %.1f packets/s, %.1f bytes/s\n",
+                packets / elapsed, bytes / elapsed);
+}
+
+/*******************************************************************************
+* FUNCTION: flowMain
+*
+* DATE: October 18, 2026
+*
+* REVISIONS: (Date and Description)
+*
+* DESIGNER: Karl Castillo (c)
+*
+* PROGRAMMER: Karl Castillo (c)
+*
+* INTERFACE: static void *flowMain(void *arg)
+* arg: the flow
+*
+* RETURN: void *: NULL
+*
+* NOTES:
+* The worker of one flow. The chunk is packed straight out of the mapped
+* input, exactly like doEncode packs the whole of it, a batch of words at a
+* time.
+*******************************************************************************/
+static void *flowMain(void *arg)
+{
+        PFLOW flow = (PFLOW)arg;
+        PJOB job = flow->job;
+        PACKER packer;
+        cpu_set_t cpus;
+        const unsigned char *data;
+        unsigned long long word;
+        unsigned long long words[MAX_BATCH];
+        int pending;
+        int full;
+        unsigned long chunk;
+        unsigned long offset;
+        unsigned long length;
+        unsigned long seq;
+        unsigned long i;
+
+        CPU_ZERO(&cpus);
+        CPU_SET(flow->cpu, &cpus);
+        pthread_setaffinity_np(pthread_self(), sizeof(cpus), &cpus);
+        parityInit(&flow->parity, job->fec);
+
+        while((chunk = __atomic_fetch_add(&job->next, 1, __ATOMIC_RELAXED)) <
+                        job->chunks) {
+                __atomic_store_n(&flow->current, chunk, __ATOMIC_RELEASE);
+                while(chunk >= flowOldest(job) + MAX_SPREAD) {
+                        sched_yield();
+                }
+
+                offset = chunk * job->chunk_bytes;
+                length = job->size - offset;
+                if(length > job->chunk_bytes) {
+                        length = job->chunk_bytes;
+                }
+                data = job->data + offset;
+
+                seq = chunk * CHUNK_PACKETS;
+                pending = 0;
+                packerInit(&packer, job->layout->bits);
+                for(i = 0; i < length; i++) {
+                        if(packerPush(&packer, data[i], &word)) {
+                                words[pending++] = word;
+                                full = job->fec != NULL && parityPush(
+                                        &flow->parity, seq, word);
+                                seq++;
+                                if(full || pending == flow->sender.batch) {
+                                        templateBatch(&flow->template,
+                                                &flow->sender, seq - pending,
+                                                words, pending);
+                                        pending = 0;
+                                }
+                                if(full) {
+                                        templateParity(&flow->template,
+                                                &flow->sender, &flow->parity,
+                                                -1);
+                                }
+                        }
+                }
+                templateBatch(&flow->template, &flow->sender, seq - pending,
+                        words, pending);
+
+                if(chunk == job->chunks - 1) {
+                        i = packerFlush(&packer, &word);
+                        templateBuild(&flow->template,
+                                senderSlot(&flow->sender), seq, word, i);
+                        senderPush(&flow->sender);
+                        if(job->fec != NULL) {
+                                parityPush(&flow->parity, seq, word);
+                                templateParity(&flow->template, &flow->sender,
+                                        &flow->parity, i);
+                        }
+                }
+                flow->chunks++;
+        }
+        __atomic_store_n(&flow->current, ~0UL, __ATOMIC_RELEASE);
+
+        senderFlush(&flow->sender);
+
+        return NULL;
+}
+
+/*******************************************************************************
+* FUNCTION: flowOldest
+*
+* DATE: October 18, 2026
+*
+* REVISIONS: (Date and Description)
+*
+* DESIGNER: Karl Castillo (c)
+*
+* PROGRAMMER: Karl Castillo (c)
+*
+* INTERFACE: static unsigned long flowOldest(PJOB job)
+* job: the shared input
+*
+* RETURN: unsigned long: the oldest chunk still being sent
+*******************************************************************************/
+static unsigned long flowOldest(PJOB job)
+{
+        unsigned long oldest = ~0UL;
+        unsigned long current;
+        int i;
+
+        for(i = 0; i < job->count; i++) {
+                current = __atomic_load_n(&job->flows[i].current,
+                        __ATOMIC_ACQUIRE);
+                if(current < oldest) {
+                        oldest = current;
+                }
+        }
+
+        return oldest;
+}
@@ -0,0 +1,68 @@
+/*******************************************************************************
+* HEADER FILE: flow.h
+*
+* PROGRAM: Covert
+*
+* FUNCTIONS:
+* int flowRun(PFLOW flows, int count, PJOB job);
+* void flowReport(PFLOW flows, int count, FILE *out);
+*
+* DATE: October 18, 2026
+*
+* DESIGNER: Karl Castillo (c)
+*
+* PROGRAMMER: Karl Castillo (c)
+*
+* NOTES:
+* The parallel send mode of the client. Every flow is a thread with its own
+* socket, source port and CPU, and the flows share out the input in chunks.
+*******************************************************************************/
+#ifndef FLOW_H
+#define FLOW_H
+
+#include <stdio.h>
+#include <pthread.h>
+#include "fec.h"
+#include "pacer.h"
+#include "prng.h"
+#include "sender.h"
+#include "template.h"
+
+/* DEFINES */
+#define DEF_FLOWS       1
+#define CHUNK_PACKETS   FEC_SPAN /* packets per chunk, a multiple of 8 */
+#define MAX_SPREAD      8       /* chunks a flow may run ahead of the slowest */
+
+/* STRUCTURES */
+typedef struct job {
+        const unsigned char *data;      /* the mapped input */
+        unsigned long size;             /* bytes in the input */
+        PLAYOUT layout;                 /* the layout of every flow */
+        PFEC fec;                       /* the FEC code, or NULL */
+        unsigned long chunk_bytes;      /* bytes per chunk */
+        unsigned long chunks;           /* chunks in the input, at least 1 */
+        unsigned long next;             /* the next chunk to claim */
+        struct flow *flows;             /* every flow working on the input */
+        int count;                      /* the number of flows */
+} JOB, *PJOB;
+
+typedef struct flow {
+        pthread_t thread;               /* the worker */
+        int index;                      /* the flow number, from 0 */
+        int cpu;                        /* the CPU the worker runs on */
+        PJOB job;                       /* the shared input */
+        PACER pacer;                    /* this flow's share of the rate */
+        SENDER sender;                  /* this flow's own socket */
+        URING uring;                    /* the ring of the sender, or unused */
+        PRNG prng;                      /* this flow's own generator */
+        TEMPLATE template;              /* the headers of this flow */
+        PARITY parity;                  /* the FEC encoder of this flow */
+        unsigned long current;          /* the chunk being sent, or ~0 */
+        unsigned long chunks;           /* chunks sent by this flow */
+} FLOW, *PFLOW;
+
+/* PROTOTYPES */
+int flowRun(PFLOW flows, int count, PJOB job);
+void flowReport(PFLOW flows, int count, FILE *out);
+
+#endif
@@ -0,0 +1,426 @@
+/*******************************************************************************
+* SOURCE FILE: input.c
+*
+* PROGRAM: Covert
+*
+* FUNCTIONS:
+* int inputOpen(PINPUT input, char *name);
+* void inputCompress(PINPUT input, PLZ lz, int block);
+* int inputUring(PINPUT input, PURING ring);
+* long inputNext(PINPUT input, const unsigned char **data);
+* long inputGather(PINPUT input, unsigned char **data);
+* void inputClose(PINPUT input);
+* static long inputRead(PINPUT input, const unsigned char **data);
+* static void inputAhead(PINPUT input);
+*
+* DATE: October 18, 2026
+*
+* DESIGNER: Karl Castillo (c)
+*
+* PROGRAMMER: Karl Castillo (c)
+*
+* NOTES:
+* A mapped file is read by the encoder in place, and MADV_SEQUENTIAL tells
+* the kernel to read ahead aggressively and drop pages behind us. Streams
+* are read INPUT_CHUNK bytes at a time into a buffer that is reused, so
+* the encoder sees the same interface either way.
+*
+* With a compression stage attached, what is read is cut into blocks and
+* the encoder is handed their frames instead.
+*
+* Given an io_uring, a stream is read into two halves of the buffer: while
+* the encoder works on one, the next chunk is already being read into the
+* other.
+*******************************************************************************/
+/* INCLUDES */
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include <stdint.h>
+#include <errno.h>
+#include <fcntl.h>
+#include <unistd.h>
+#include <sys/mman.h>
+#include <sys/stat.h>
+#include "input.h"
+
+/* PROTOTYPES */
+static long inputRead(PINPUT input, const unsigned char **data);
+static void inputAhead(PINPUT input);
+
+/*******************************************************************************
+* FUNCTION: inputOpen
+*
+* DATE: October 18, 2026
+*
+* REVISIONS: (Date and Description)
+*
+* DESIGNER: Karl Castillo (c)
+*
+* PROGRAMMER: Karl Castillo (c)
+*
+* INTERFACE: int inputOpen(PINPUT input, char *name)
+* input: the input to open
+* name: the file to read, or - for stdin
+*
+* RETURN: int
+* 0: in success
+* -1: the input could not be opened
+*
+* NOTES:
+* An empty regular file is treated as mapped with nothing in it, since a
+* zero length mapping is not allowed.
+*******************************************************************************/
+int inputOpen(PINPUT input, char *name)
+{
+        struct stat st;
+
+        memset(input, 0, sizeof(INPUT));
+
+        if(strcmp(name, INPUT_STDIN) == 0) {
+                input->fd = STDIN_FILENO;
+        } else if((input->fd = open(name, O_RDONLY)) < 0) {
+                return -1;
+        }
+
+        if(fstat(input->fd, &st) == 0 && S_ISREG(st.st_mode)) {
+                input->size = st.st_size;
+                if(input->size == 0) {
+                        input->mapped = 1;
+                        return 0;
+                }
+
+                input->data = mmap(NULL, input->size, PROT_READ, MAP_PRIVATE,
+                        input->fd, 0);
+                if(input->data != MAP_FAILED) {
+                        madvise(input->data, input->size, MADV_SEQUENTIAL);
+                        input->mapped = 1;
+                        return 0;
+                }
+        }
+
+        input->size = INPUT_CHUNK;
+        if((input->data = (unsigned char*)malloc(input->size)) == NULL) {
+                if(input->fd != STDIN_FILENO) {
+                        close(input->fd);
+                }
+                return -1;
+        }
+
+        return 0;
+}
+
+/*******************************************************************************
+* FUNCTION: inputCompress
+*
+* DATE: October 18, 2026
+*
+* REVISIONS: (Date and Description)
+*
+* DESIGNER: Karl Castillo (c)
+*
+* PROGRAMMER: Karl Castillo (c)
+*
+* INTERFACE: void inputCompress(PINPUT input, PLZ lz, int block)
+* input: the open input
+* lz: the initialized compressor
+* block: the bytes compressed as one frame, at most LZ_BLOCK
+*
+* RETURN: void
+*
+* NOTES:
+* A lost packet costs the server the frames it falls in, so the block is
+* what one loss can cost. Larger blocks compress better.
+*******************************************************************************/
+void inputCompress(PINPUT input, PLZ lz, int block)
+{
+        input->lz = lz;
+        input->block = block;
+}
+
+/*******************************************************************************
+* FUNCTION: inputUring
+*
+* DATE: October 18, 2026
+*
+* REVISIONS: (Date and Description)
+*
+* DESIGNER: Karl Castillo (c)
+*
+* PROGRAMMER: Karl Castillo (c)
+*
+* INTERFACE: int inputUring(PINPUT input, PURING ring)
+* input: an open input nothing was read from yet
+* ring: the ring the reads go through, open until the input is closed
+*
+* RETURN: int
+* 0: in success, or the input is a mapped file that needs no reads
+* -1: the buffer could not be doubled
+*******************************************************************************/
+int inputUring(PINPUT input, PURING ring)
+{
+        unsigned char *grown;
+
+        if(input->mapped) {
+                return 0;
+        }
+
+        if((grown = (unsigned char*)realloc(input->data,
+                        INPUT_CHUNK * 2)) == NULL) {
+                return -1;
+        }
+        input->data = grown;
+        input->size = INPUT_CHUNK;
+        input->uring = ring;
+
+        return 0;
+}
+
+/*******************************************************************************
+* FUNCTION: inputNext
+*
+* DATE: October 18, 2026
+*
+* REVISIONS: (Date and Description)
+*
+* DESIGNER: Karl Castillo (c)
+*
+* PROGRAMMER: Karl Castillo (c)
+*
+* INTERFACE: long inputNext(PINPUT input, const unsigned char **data)
+* input: the input
+* data: where a pointer to the next bytes will be stored
+*
+* RETURN: long
+* > 0: the number of bytes at *data
+* 0: the end of the input
+* -1: the input could not be read
+*
+* NOTES:
+* A mapped file comes out in one piece. The bytes of a stream, and every
+* frame of a compressed input, are only valid until the next call.
+*******************************************************************************/
+long inputNext(PINPUT input, const unsigned char **data)
+{
+        long length;
+
+        if(input->lz == NULL) {
+                return inputRead(input, data);
+        }
+
+        if(input->left == 0 &&
+                        (input->left = inputRead(input, &input->span)) <= 0) {
+                length = input->left;
+                input->left = 0;
+                return length;
+        }
+
+        length = input->left < input->block ? input->left : input->block;
+        *data = input->lz->frame;
+        input->span += length;
+        input->left -= length;
+
+        return lzFrame(input->lz, input->span - length, length);
+}
+
+/*******************************************************************************
+* FUNCTION: inputGather
+*
+* DATE: October 18, 2026
+*
+* REVISIONS: (Date and Description)
+*
+* DESIGNER: Karl Castillo (c)
+*
+* PROGRAMMER: Karl Castillo (c)
+*
+* INTERFACE: long inputGather(PINPUT input, unsigned char **data)
+* input: the input
+* data: where a pointer to the gathered bytes will be stored
+*
+* RETURN: long
+* the number of bytes at *data, which the caller frees
+* -1: the input could not be read or the memory allocated
+*
+* NOTES:
+* Collects everything inputNext hands out into one buffer, for the parallel
+* flows that need the whole transfer in memory up front.
+*******************************************************************************/
+long inputGather(PINPUT input, unsigned char **data)
+{
+        const unsigned char *next;
+        unsigned char *buffer = NULL;
+        unsigned char *grown;
+        size_t capacity = 0;
+        size_t size = 0;
+        long length;
+
+        while((length = inputNext(input, &next)) > 0) {
+                if(size + length > capacity) {
+                        capacity = capacity * 2 > size + length ?
+                                capacity * 2 : size + length;
+                        if((grown = (unsigned char*)realloc(buffer,
+                                        capacity)) == NULL) {
+                                free(buffer);
+                                return -1;
+                        }
+                        buffer = grown;
+                }
+                memcpy(buffer + size, next, length);
+                size += length;
+        }
+        if(length < 0) {
+                free(buffer);
+                return -1;
+        }
+
+        *data = buffer;
+
+        return (long)size;
+}
+
+/*******************************************************************************
+* FUNCTION: inputClose
+*
+* DATE: October 18, 2026
+*
+* REVISIONS: (Date and Description)
+*
+* DESIGNER: Karl Castillo (c)
+*
+* PROGRAMMER: Karl Castillo (c)
+*
+* INTERFACE: void inputClose(PINPUT input)
+* input: the input
+*
+* RETURN: void
+*******************************************************************************/
+void inputClose(PINPUT input)
+{
+        if(input->mapped) {
+                if(input->size > 0) {
+                        munmap(input->data, input->size);
+                }
+        } else {
+                if(input->ahead.pending > 0) {
+                        uringWait(input->uring, &input->ahead);
+                }
+                free(input->data);
+        }
+
+        if(input->fd != STDIN_FILENO) {
+                close(input->fd);
+        }
+}
+
+/*******************************************************************************
+* FUNCTION: inputRead
+*
+* DATE: October 18, 2026
+*
+* REVISIONS: (Date and Description)
+*
+* DESIGNER: Karl Castillo (c)
+*
+* PROGRAMMER: Karl Castillo (c)
+*
+* INTERFACE: static long inputRead(PINPUT input,
+*       const unsigned char **data)
+* input: the input
+* data: where a pointer to the next bytes will be stored
+*
+* RETURN: long
+* > 0: the number of bytes at *data
+* 0: the end of the input
+* -1: the input could not be read
+*
+* NOTES:
+* A mapped file comes out in one piece. The bytes of a stream are only
+* valid until the next call. Reading ahead, the chunk handed out is the one
+* read during the last call, and the next is started before returning it.
+*******************************************************************************/
+static long inputRead(PINPUT input, const unsigned char **data)
+{
+        ssize_t n;
+        int res;
+
+        if(input->mapped) {
+                if(input->done) {
+                        return 0;
+                }
+                input->done = 1;
+                input->bytes = input->size;
+                *data = input->data;
+                return (long)input->size;
+        }
+
+        if(input->uring != NULL) {
+                if(input->done) {
+                        return 0;
+                }
+                if(input->ahead.pending == 0 && input->bytes == 0) {
+                        inputAhead(input);
+                }
+                if((res = uringWait(input->uring, &input->ahead)) < 0) {
+                        errno = input->ahead.pending > 0 ? errno : -res;
+                        return -1;
+                }
+                if(res == 0) {
+                        input->done = 1;
+                        return 0;
+                }
+                input->bytes += res;
+                *data = input->data + input->half * INPUT_CHUNK;
+                input->half ^= 1;
+                inputAhead(input);
+                return (long)res;
+        }
+
+        do {
+                n = read(input->fd, input->data, input->size);
+        } while(n < 0 && errno == EINTR);
+
+        if(n > 0) {
+                input->bytes += n;
+                *data = input->data;
+        }
+
+        return (long)n;
+}
+
+/*******************************************************************************
+* FUNCTION: inputAhead
+*
+* DATE: October 18, 2026
+*
+* REVISIONS: (Date and Description)
+*
+* DESIGNER: Karl Castillo (c)
+*
+* PROGRAMMER: Karl Castillo (c)
+*
+* INTERFACE: static void inputAhead(PINPUT input)
+* input: the input
+*
+* RETURN: void
+*
+* NOTES:
+* Starts reading the next chunk into the free half of the buffer. The
+* offset of -1 reads from the current position so pipes work too.
+*******************************************************************************/
+static void inputAhead(PINPUT input)
+{
+        struct io_uring_sqe *sqe;
+
+        if((sqe = uringGet(input->uring, &input->ahead)) == NULL) {
+                input->ahead.res = -EBUSY;
+                return;
+        }
+        sqe->opcode = IORING_OP_READ;
+        sqe->fd = input->fd;
+        sqe->addr = (unsigned long long)(uintptr_t)(input->data +
+                input->half * INPUT_CHUNK);
+        sqe->len = INPUT_CHUNK;
+        sqe->off = (unsigned long long)-1;
+        uringEnter(input->uring, 0, 0);
+}
@@ -0,0 +1,61 @@
+/*******************************************************************************
+* HEADER FILE: input.h
+*
+* PROGRAM: Covert
+*
+* FUNCTIONS:
+* int inputOpen(PINPUT input, char *name);
+* void inputCompress(PINPUT input, PLZ lz, int block);
+* int inputUring(PINPUT input, PURING ring);
+* long inputNext(PINPUT input, const unsigned char **data);
+* long inputGather(PINPUT input, unsigned char **data);
+* void inputClose(PINPUT input);
+*
+* DATE: October 18, 2026
+*
+* DESIGNER: Karl Castillo (c)
+*
+* PROGRAMMER: Karl Castillo (c)
+*
+* NOTES:
+* The input of the client. A regular file is mapped and handed out whole;
+* stdin, pipes and anything else that cannot be mapped are read in large
+* chunks, ahead of the encoder when an io_uring is given.
+*******************************************************************************/
+#ifndef INPUT_H
+#define INPUT_H
+
+#include <stddef.h>
+#include "lz.h"
+#include "uring.h"
+
+/* DEFINES */
+#define INPUT_STDIN     "-"
+#define INPUT_CHUNK     (1024 * 1024)   /* bytes per read when streaming */
+
+/* STRUCTURES */
+typedef struct input {
+        int fd;                         /* the input */
+        int mapped;                     /* the input is a mapped file */
+        unsigned char *data;            /* the mapping or the read buffer */
+        size_t size;                    /* bytes mapped, or the buffer size */
+        int done;                       /* the whole input was handed out */
+        unsigned long bytes;            /* bytes read from the input */
+        PLZ lz;                         /* the compression stage, or NULL */
+        int block;                      /* bytes compressed as one frame */
+        const unsigned char *span;      /* read bytes not yet compressed */
+        long left;                      /* the bytes at span */
+        PURING uring;                   /* reads ahead through it, or NULL */
+        URINGOP ahead;                  /* the read in flight */
+        int half;                       /* the half of data it fills */
+} INPUT, *PINPUT;
+
+/* PROTOTYPES */
+int inputOpen(PINPUT input, char *name);
+void inputCompress(PINPUT input, PLZ lz, int block);
+int inputUring(PINPUT input, PURING ring);
+long inputNext(PINPUT input, const unsigned char **data);
+long inputGather(PINPUT input, unsigned char **data);
+void inputClose(PINPUT input);
+
+#endif
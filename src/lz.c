@@ -0,0 +1,829 @@
+/*******************************************************************************
+* SOURCE FILE: lz.c
+*
+* PROGRAM: Covert
+*
+* FUNCTIONS:
+* int lzInit(PLZ lz);
+* int lzFrame(PLZ lz, const unsigned char *data, int length);
+* void lzClose(PLZ lz);
+* void lzReport(PLZ lz, int bits, FILE *out);
+* int unlzInit(PUNLZ unlz);
+* int unlzPush(PUNLZ unlz, const unsigned char *data, int length, int *used);
+* void unlzReset(PUNLZ unlz);
+* void unlzClose(PUNLZ unlz);
+* void unlzReport(PUNLZ unlz, FILE *out);
+* static int lzEncode(PLZ lz, const unsigned char *src, int length,
+*        unsigned char *dst);
+* static int lzDecode(const unsigned char *src, int length, unsigned char *dst,
+*        int capacity);
+* static int lzSequence(unsigned char *dst, int op, const unsigned char *literals,
+*        int count, int offset, int match);
+* static int lzLength(unsigned char *dst, int op, int length);
+* static unsigned int lzRead32(const unsigned char *p);
+* static unsigned int lzCheck(const unsigned char *data, int length);
+* static int unlzHeader(PUNLZ unlz);
+* static void unlzHunt(PUNLZ unlz, int from);
+*
+* DATE: October 18, 2026
+*
+* DESIGNER: Karl Castillo (c)
+*
+* PROGRAMMER: Karl Castillo (c)
+*
+* NOTES:
+* Every payload byte costs a whole packet share, so the client can squeeze
+* its input before encoding it. The compressor is a single pass LZ77 in the
+* manner of LZ4: one hash table lookup per position, no entropy coding, so it
+* runs far faster than the link can carry its output.
+*
+* The input is cut into blocks of at most LZ_BLOCK bytes and every block is
+* sent as a frame behind an 8 byte header, all little endian: the LZ_SYNC
+* word, a Fletcher-16 check of the rest of the frame, and the length of the
+* body with LZ_STORED set when the block did not compress and is sent as is.
+* A compressed body is a run of sequences:
+*
+*       token | literal length bytes | literals | offset | match length bytes
+*
+* The high nibble of the token is the number of literals and the low nibble
+* the match length less LZ_MINMATCH. A nibble of 15 is followed by bytes that
+* are added to it until one is not 255. The offset is 2 bytes, little endian.
+* The last sequence of a body has literals only and ends the body.
+*
+* Frames never depend on each other. A lost packet is written as zeros, so a
+* frame it lands in fails its check and is dropped, and when it lands in a
+* header the boundaries are lost as well. Either way the server looks for
+* the next sync word that starts a frame whose check holds, and carries on
+* from there. The frames dropped and the bytes skipped are reported.
+*******************************************************************************/
+/* INCLUDES */
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include <time.h>
+#include "lz.h"
+
+/* DEFINES */
+#define LZ_HASH(v)      (((v) * 2654435761U) >> (32 - LZ_HASH_BITS))
+#define LZ_FRAME_MAX    (LZ_HEADER + LZ_BOUND(LZ_BLOCK))
+#define LZ_CHECKED      4       /* the check covers the frame from here */
+#define LZ_FLETCHER_RUN 5802    /* bytes summed before the sums overflow */
+
+/* PROTOTYPES */
+static int lzEncode(PLZ lz, const unsigned char *src, int length,
+        unsigned char *dst);
+static int lzDecode(const unsigned char *src, int length, unsigned char *dst,
+        int capacity);
+static int lzSequence(unsigned char *dst, int op, const unsigned char *literals,
+        int count, int offset, int match);
+static int lzLength(unsigned char *dst, int op, int length);
+static unsigned int lzRead32(const unsigned char *p);
+static unsigned int lzCheck(const unsigned char *data, int length);
+static int unlzHeader(PUNLZ unlz);
+static void unlzHunt(PUNLZ unlz, int from);
+
+/*******************************************************************************
+* FUNCTION: lzInit
+*
+* DATE: October 18, 2026
+*
+* REVISIONS: (Date and Description)
+*
+* DESIGNER: Karl Castillo (c)
+*
+* PROGRAMMER: Karl Castillo (c)
+*
+* INTERFACE: int lzInit(PLZ lz)
+* lz: the compressor to initialize
+*
+* RETURN: int
+* 0: in success
+* -1: the frame buffer could not be allocated
+*******************************************************************************/
+int lzInit(PLZ lz)
+{
+        memset(lz, 0, sizeof(LZ));
+
+        if((lz->frame = (unsigned char*)malloc(LZ_FRAME_MAX)) == NULL) {
+                return -1;
+        }
+
+        return 0;
+}
+
+/*******************************************************************************
+* FUNCTION: lzFrame
+*
+* DATE: October 18, 2026
+*
+* REVISIONS: (Date and Description)
+*
+* DESIGNER: Karl Castillo (c)
+*
+* PROGRAMMER: Karl Castillo (c)
+*
+* INTERFACE: int lzFrame(PLZ lz, const unsigned char *data, int length)
+* lz: the compressor
+* data: the block to compress
+* length: the bytes in the block, at most LZ_BLOCK
+*
+* RETURN: int
+* the length of the frame left in lz->frame
+*
+* NOTES:
+* A block that does not get smaller is stored, so a frame is never more than
+* LZ_HEADER bytes longer than its block.
+*******************************************************************************/
+int lzFrame(PLZ lz, const unsigned char *data, int length)
+{
+        struct timespec start;
+        struct timespec end;
+        unsigned int header;
+        unsigned int check;
+        int size;
+
+        clock_gettime(CLOCK_THREAD_CPUTIME_ID, &start);
+
+        size = lzEncode(lz, data, length, lz->frame + LZ_HEADER);
+        header = size;
+        if(size >= length) {
+                memcpy(lz->frame + LZ_HEADER, data, length);
+                size = length;
+                header = size | LZ_STORED;
+                lz->stored++;
+        }
+
+        lz->frame[0] = LZ_SYNC & 0xff;
+        lz->frame[1] = LZ_SYNC >> 8;
+        lz->frame[4] = header;
+        lz->frame[5] = header >> 8;
+        lz->frame[6] = header >> 16;
+        lz->frame[7] = header >> 24;
+        check = lzCheck(lz->frame + LZ_CHECKED, LZ_HEADER - LZ_CHECKED + size);
+        lz->frame[2] = check;
+        lz->frame[3] = check >> 8;
+
+        clock_gettime(CLOCK_THREAD_CPUTIME_ID, &end);
+        lz->seconds += (end.tv_sec - start.tv_sec) +
+                (end.tv_nsec - start.tv_nsec) / 1e9;
+
+        lz->in += length;
+        lz->out += LZ_HEADER + size;
+        lz->frames++;
+
+        return LZ_HEADER + size;
+}
+
+/*******************************************************************************
+* FUNCTION: lzClose
+*
+* DATE: October 18, 2026
+*
+* REVISIONS: (Date and Description)
+*
+* DESIGNER: Karl Castillo (c)
+*
+* PROGRAMMER: Karl Castillo (c)
+*
+* INTERFACE: void lzClose(PLZ lz)
+* lz: the compressor
+*
+* RETURN: void
+*******************************************************************************/
+void lzClose(PLZ lz)
+{
+        free(lz->frame);
+        lz->frame = NULL;
+}
+
+/*******************************************************************************
+* FUNCTION: lzReport
+*
+* DATE: October 18, 2026
+*
+* REVISIONS: (Date and Description)
+*
+* DESIGNER: Karl Castillo (c)
+*
+* PROGRAMMER: Karl Castillo (c)
+*
+* INTERFACE: void lzReport(PLZ lz, int bits, FILE *out)
+* lz: the compressor
+* bits: the payload bits per packet of the layout
+* out: where the report will be printed
+*
+* RETURN: void
+*
+* NOTES:
+* The packets saved are weighed against the CPU time spent compressing, so
+* it is easy to see when the stage is not worth it.
+*******************************************************************************/
+void lzReport(PLZ lz, int bits, FILE *out)
+{
+        long saved;
+
+        saved = (long)((lz->in * 8) / bits) - (long)((lz->out * 8) / bits);
+
+        fprintf(out, "Compression: %lu bytes to %lu bytes in %lu frames "
+                "(ratio %.3f), %lu stored\n", lz->in, lz->out, lz->frames,
+                lz->out > 0 ? (double)lz->in / lz->out : 0.0, lz->stored);
+        fprintf(out, "Compression Cost: %.3f ms CPU (%.1f MB/s), %ld packets "
+                "saved\n", lz->seconds * 1000, lz->seconds > 0 ?
+                lz->in / lz->seconds / 1e6 : 0.0, saved);
+}
+
+/*******************************************************************************
+* FUNCTION: unlzInit
+*
+* DATE: October 18, 2026
+*
+* REVISIONS: (Date and Description)
+*
+* DESIGNER: Karl Castillo (c)
+*
+* PROGRAMMER: Karl Castillo (c)
+*
+* INTERFACE: int unlzInit(PUNLZ unlz)
+* unlz: the decompressor to initialize
+*
+* RETURN: int
+* 0: in success
+* -1: the buffers could not be allocated
+*******************************************************************************/
+int unlzInit(PUNLZ unlz)
+{
+        memset(unlz, 0, sizeof(UNLZ));
+
+        if((unlz->frame = (unsigned char*)malloc(LZ_FRAME_MAX)) == NULL) {
+                return -1;
+        }
+        if((unlz->raw = (unsigned char*)malloc(LZ_BLOCK)) == NULL) {
+                free(unlz->frame);
+                return -1;
+        }
+        unlzReset(unlz);
+
+        return 0;
+}
+
+/*******************************************************************************
+* FUNCTION: unlzPush
+*
+* DATE: October 18, 2026
+*
+* REVISIONS: (Date and Description)
+*
+* DESIGNER: Karl Castillo (c)
+*
+* PROGRAMMER: Karl Castillo (c)
+*
+* INTERFACE: int unlzPush(PUNLZ unlz, const unsigned char *data, int length,
+*       int *used)
+* unlz: the decompressor
+* data: the next bytes of the stream
+* length: the number of bytes at data
+* used: where the number of bytes taken from data will be stored
+*
+* RETURN: int
+* > 0: a frame was completed and this many bytes are at unlz->data
+* 0: more bytes are needed
+* -1: a frame was completed but was damaged
+*
+* NOTES:
+* Bytes are only taken up to the end of the current frame, so the caller
+* keeps pushing the rest until everything is used. A call may take no bytes
+* at all when the frame is already in the buffer, left there by a search
+* for the sync word.
+*******************************************************************************/
+int unlzPush(PUNLZ unlz, const unsigned char *data, int length, int *used)
+{
+        int size;
+        int take;
+
+        take = unlz->need - unlz->have;
+        if(take < 0) {
+                take = 0;
+        } else if(take > length) {
+                take = length;
+        }
+        unlz->in += take;
+        memcpy(unlz->frame + unlz->have, data, take);
+        unlz->have += take;
+        *used = take;
+
+        while(unlz->have >= unlz->need) {
+                if(unlz->need == LZ_HEADER) {
+                        if(unlzHeader(unlz) < 0) {
+                                unlzHunt(unlz, 1);
+                        }
+                        continue;
+                }
+
+                size = unlz->need - LZ_HEADER;
+                if(lzCheck(unlz->frame + LZ_CHECKED,
+                                unlz->need - LZ_CHECKED) !=
+                                (unsigned int)(unlz->frame[2] |
+                                unlz->frame[3] << 8)) {
+                        unlz->errors++;
+                        unlzHunt(unlz, 1);
+                        return -1;
+                }
+
+                if(unlz->frame[7] & (LZ_STORED >> 24)) {
+                        memcpy(unlz->raw, unlz->frame + LZ_HEADER, size);
+                } else if((size = lzDecode(unlz->frame + LZ_HEADER, size,
+                                unlz->raw, LZ_BLOCK)) < 0) {
+                        unlz->errors++;
+                        unlzHunt(unlz, 1);
+                        return -1;
+                }
+                unlz->data = unlz->raw;
+
+                /* keep what a search pulled in past the end of the frame */
+                unlz->have -= unlz->need;
+                memmove(unlz->frame, unlz->frame + unlz->need, unlz->have);
+                unlz->need = LZ_HEADER;
+
+                unlz->out += size;
+                unlz->frames++;
+
+                return size;
+        }
+
+        return 0;
+}
+
+/*******************************************************************************
+* FUNCTION: unlzReset
+*
+* DATE: October 18, 2026
+*
+* REVISIONS: (Date and Description)
+*
+* DESIGNER: Karl Castillo (c)
+*
+* PROGRAMMER: Karl Castillo (c)
+*
+* INTERFACE: void unlzReset(PUNLZ unlz)
+* unlz: the decompressor
+*
+* RETURN: void
+*
+* NOTES:
+* Called at the end of every transfer. A frame still being collected was cut
+* short and is counted as an error, and its bytes as skipped.
+*******************************************************************************/
+void unlzReset(PUNLZ unlz)
+{
+        if(unlz->have > 0) {
+                unlz->errors++;
+                unlz->skipped += unlz->have;
+        }
+        unlz->have = 0;
+        unlz->need = LZ_HEADER;
+}
+
+/*******************************************************************************
+* FUNCTION: unlzClose
+*
+* DATE: October 18, 2026
+*
+* REVISIONS: (Date and Description)
+*
+* DESIGNER: Karl Castillo (c)
+*
+* PROGRAMMER: Karl Castillo (c)
+*
+* INTERFACE: void unlzClose(PUNLZ unlz)
+* unlz: the decompressor
+*
+* RETURN: void
+*******************************************************************************/
+void unlzClose(PUNLZ unlz)
+{
+        free(unlz->frame);
+        free(unlz->raw);
+        unlz->frame = NULL;
+        unlz->raw = NULL;
+}
+
+/*******************************************************************************
+* FUNCTION: unlzReport
+*
+* DATE: October 18, 2026
+*
+* REVISIONS: (Date and Description)
+*
+* DESIGNER: Karl Castillo (c)
+*
+* PROGRAMMER: Karl Castillo (c)
+*
+* INTERFACE: void unlzReport(PUNLZ unlz, FILE *out)
+* unlz: the decompressor
+* out: where the report will be printed
+*
+* RETURN: void
+*******************************************************************************/
+void unlzReport(PUNLZ unlz, FILE *out)
+{
+        fprintf(out, "Decompression: %lu bytes to %lu bytes in %lu frames "
+                "(ratio %.3f), %lu errors, %lu bytes skipped\n", unlz->in,
+                unlz->out, unlz->frames, unlz->in > 0 ?
+                (double)unlz->out / unlz->in : 0.0, unlz->errors,
+                unlz->skipped);
+}
+
+/*******************************************************************************
+* FUNCTION: lzEncode
+*
+* DATE: October 18, 2026
+*
+* REVISIONS: (Date and Description)
+*
+* DESIGNER: Karl Castillo (c)
+*
+* PROGRAMMER: Karl Castillo (c)
+*
+* INTERFACE: static int lzEncode(PLZ lz, const unsigned char *src, int length,
+*       unsigned char *dst)
+* lz: the compressor, for its hash table
+* src: the block
+* length: the bytes in the block
+* dst: where the body is built, LZ_BOUND(length) bytes
+*
+* RETURN: int
+* the length of the body
+*
+* NOTES:
+* The table keeps the last position of every hash of 4 bytes. A candidate is
+* checked against the bytes, so stale entries from an earlier block only
+* cost a compare. The longer a run of literals gets, the further each miss
+* skips ahead, so data that does not compress is crossed quickly.
+*******************************************************************************/
+static int lzEncode(PLZ lz, const unsigned char *src, int length,
+        unsigned char *dst)
+{
+        unsigned int value;
+        unsigned int hash;
+        int anchor = 0;
+        int op = 0;
+        int i = 0;
+        int candidate;
+        int match;
+
+        while(i + LZ_MINMATCH <= length) {
+                value = lzRead32(src + i);
+                hash = LZ_HASH(value);
+                candidate = lz->table[hash];
+                lz->table[hash] = i;
+
+                if(candidate >= i || i - candidate > LZ_MAXOFFSET ||
+                                lzRead32(src + candidate) != value) {
+                        i += 1 + ((i - anchor) >> 6);
+                        continue;
+                }
+
+                while(i > anchor && candidate > 0 &&
+                                src[i - 1] == src[candidate - 1]) {
+                        i--;
+                        candidate--;
+                }
+                match = LZ_MINMATCH;
+                while(i + match < length &&
+                                src[i + match] == src[candidate + match]) {
+                        match++;
+                }
+
+                op = lzSequence(dst, op, src + anchor, i - anchor,
+                        i - candidate, match);
+                i += match;
+                anchor = i;
+        }
+
+        return lzSequence(dst, op, src + anchor, length - anchor, 0, 0);
+}
+
+/*******************************************************************************
+* FUNCTION: lzDecode
+*
+* DATE: October 18, 2026
+*
+* REVISIONS: (Date and Description)
+*
+* DESIGNER: Karl Castillo (c)
+*
+* PROGRAMMER: Karl Castillo (c)
+*
+* INTERFACE: static int lzDecode(const unsigned char *src, int length,
+*       unsigned char *dst, int capacity)
+* src: the body of a frame
+* length: the bytes in the body
+* dst: where the block is rebuilt
+* capacity: the bytes available at dst
+*
+* RETURN: int
+* the length of the block
+* -1: the body is damaged
+*
+* NOTES:
+* Every length and offset is checked before it is used, since a body may
+* have been hit by lost packets.
+*******************************************************************************/
+static int lzDecode(const unsigned char *src, int length, unsigned char *dst,
+        int capacity)
+{
+        int ip = 0;
+        int op = 0;
+        int token;
+        int count;
+        int offset;
+        int b;
+
+        while(ip < length) {
+                token = src[ip++];
+
+                count = token >> 4;
+                if(count == 15) {
+                        do {
+                                if(ip >= length) {
+                                        return -1;
+                                }
+                                b = src[ip++];
+                                count += b;
+                        } while(b == 255);
+                }
+                if(count > length - ip || count > capacity - op) {
+                        return -1;
+                }
+                memcpy(dst + op, src + ip, count);
+                ip += count;
+                op += count;
+
+                if(ip == length) {
+                        break;
+                }
+
+                if(length - ip < 2) {
+                        return -1;
+                }
+                offset = src[ip] | (src[ip + 1] << 8);
+                ip += 2;
+                if(offset == 0 || offset > op) {
+                        return -1;
+                }
+
+                count = token & 15;
+                if(count == 15) {
+                        do {
+                                if(ip >= length) {
+                                        return -1;
+                                }
+                                b = src[ip++];
+                                count += b;
+                        } while(b == 255);
+                }
+                count += LZ_MINMATCH;
+                if(count > capacity - op) {
+                        return -1;
+                }
+
+                /* the match may overlap what it produces */
+                while(count-- > 0) {
+                        dst[op] = dst[op - offset];
+                        op++;
+                }
+        }
+
+        return op;
+}
+
+/*******************************************************************************
+* FUNCTION: lzSequence
+*
+* DATE: October 18, 2026
+*
+* REVISIONS: (Date and Description)
+*
+* DESIGNER: Karl Castillo (c)
+*
+* PROGRAMMER: Karl Castillo (c)
+*
+* INTERFACE: static int lzSequence(unsigned char *dst, int op,
+*       const unsigned char *literals, int count, int offset, int match)
+* dst: the body being built
+* op: where the sequence goes in dst
+* literals: the bytes that had no match
+* count: the number of literals
+* offset: how far back the match starts, 0 for the last sequence
+* match: the length of the match
+*
+* RETURN: int
+* the position after the sequence
+*******************************************************************************/
+static int lzSequence(unsigned char *dst, int op, const unsigned char *literals,
+        int count, int offset, int match)
+{
+        int token;
+
+        token = op++;
+        dst[token] = (count < 15 ? count : 15) << 4;
+        if(count >= 15) {
+                op = lzLength(dst, op, count - 15);
+        }
+        memcpy(dst + op, literals, count);
+        op += count;
+
+        if(offset == 0) {
+                return op;
+        }
+
+        dst[op++] = offset;
+        dst[op++] = offset >> 8;
+
+        match -= LZ_MINMATCH;
+        dst[token] |= match < 15 ? match : 15;
+        if(match >= 15) {
+                op = lzLength(dst, op, match - 15);
+        }
+
+        return op;
+}
+
+/*******************************************************************************
+* FUNCTION: lzLength
+*
+* DATE: October 18, 2026
+*
+* REVISIONS: (Date and Description)
+*
+* DESIGNER: Karl Castillo (c)
+*
+* PROGRAMMER: Karl Castillo (c)
+*
+* INTERFACE: static int lzLength(unsigned char *dst, int op, int length)
+* dst: the body being built
+* op: where the bytes go in dst
+* length: what is left of a length after its nibble
+*
+* RETURN: int
+* the position after the length bytes
+*******************************************************************************/
+static int lzLength(unsigned char *dst, int op, int length)
+{
+        while(length >= 255) {
+                dst[op++] = 255;
+                length -= 255;
+        }
+        dst[op++] = length;
+
+        return op;
+}
+
+/*******************************************************************************
+* FUNCTION: lzRead32
+*
+* DATE: October 18, 2026
+*
+* REVISIONS: (Date and Description)
+*
+* DESIGNER: Karl Castillo (c)
+*
+* PROGRAMMER: Karl Castillo (c)
+*
+* INTERFACE: static unsigned int lzRead32(const unsigned char *p)
+* p: the bytes
+*
+* RETURN: unsigned int
+* 4 bytes as a word, in whatever order the host keeps them
+*******************************************************************************/
+static unsigned int lzRead32(const unsigned char *p)
+{
+        unsigned int value;
+
+        memcpy(&value, p, sizeof(value));
+
+        return value;
+}
+
+/*******************************************************************************
+* FUNCTION: lzCheck
+*
+* DATE: October 18, 2026
+*
+* REVISIONS: (Date and Description)
+*
+* DESIGNER: Karl Castillo (c)
+*
+* PROGRAMMER: Karl Castillo (c)
+*
+* INTERFACE: static unsigned int lzCheck(const unsigned char *data,
+*       int length)
+* data: the bytes to check
+* length: the number of bytes at data
+*
+* RETURN: unsigned int
+* the Fletcher-16 of the bytes
+*
+* NOTES:
+* The sums are only reduced every LZ_FLETCHER_RUN bytes, as far as they can
+* go without overflowing.
+*******************************************************************************/
+static unsigned int lzCheck(const unsigned char *data, int length)
+{
+        unsigned int a = 0;
+        unsigned int b = 0;
+        int run;
+
+        while(length > 0) {
+                run = length < LZ_FLETCHER_RUN ? length : LZ_FLETCHER_RUN;
+                length -= run;
+                while(run-- > 0) {
+                        a += *data++;
+                        b += a;
+                }
+                a %= 255;
+                b %= 255;
+        }
+
+        return b << 8 | a;
+}
+
+/*******************************************************************************
+* FUNCTION: unlzHeader
+*
+* DATE: October 18, 2026
+*
+* REVISIONS: (Date and Description)
+*
+* DESIGNER: Karl Castillo (c)
+*
+* PROGRAMMER: Karl Castillo (c)
+*
+* INTERFACE: static int unlzHeader(PUNLZ unlz)
+* unlz: the decompressor, with a whole header collected
+*
+* RETURN: int
+* 0: the header is sound and need is the length of its frame
+* -1: there is no frame header here
+*******************************************************************************/
+static int unlzHeader(PUNLZ unlz)
+{
+        unsigned int header;
+        int size;
+
+        if((unlz->frame[0] | unlz->frame[1] << 8) != LZ_SYNC) {
+                return -1;
+        }
+
+        header = unlz->frame[4] | (unlz->frame[5] << 8) |
+                (unlz->frame[6] << 16) | ((unsigned int)unlz->frame[7] << 24);
+        size = header & ~LZ_STORED;
+        if(size > LZ_BOUND(LZ_BLOCK) || ((header & LZ_STORED) &&
+                        size > LZ_BLOCK)) {
+                return -1;
+        }
+        unlz->need = LZ_HEADER + size;
+
+        return 0;
+}
+
+/*******************************************************************************
+* FUNCTION: unlzHunt
+*
+* DATE: October 18, 2026
+*
+* REVISIONS: (Date and Description)
+*
+* DESIGNER: Karl Castillo (c)
+*
+* PROGRAMMER: Karl Castillo (c)
+*
+* INTERFACE: static void unlzHunt(PUNLZ unlz, int from)
+* unlz: the decompressor
+* from: where in the collected bytes to start looking
+*
+* RETURN: void
+*
+* NOTES:
+* The frame boundaries are lost. The collected bytes are searched for the
+* sync word, and whatever comes before it is skipped, so a damaged frame is
+* searched as well and a real header inside it is not missed. The search
+* goes on with the next bytes pushed when there is none.
+*******************************************************************************/
+static void unlzHunt(PUNLZ unlz, int from)
+{
+        int k;
+
+        for(k = from; k < unlz->have; k++) {
+                if(unlz->frame[k] == (LZ_SYNC & 0xff) && (k + 1 ==
+                                unlz->have || unlz->frame[k + 1] ==
+                                LZ_SYNC >> 8)) {
+                        break;
+                }
+        }
+
+        unlz->skipped += k;
+        unlz->have -= k;
+        memmove(unlz->frame, unlz->frame + k, unlz->have);
+        unlz->need = LZ_HEADER;
+}
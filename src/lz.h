@@ -0,0 +1,78 @@
+/*******************************************************************************
+* HEADER FILE: lz.h
+*
+* PROGRAM: Covert
+*
+* FUNCTIONS:
+* int lzInit(PLZ lz);
+* int lzFrame(PLZ lz, const unsigned char *data, int length);
+* void lzClose(PLZ lz);
+* void lzReport(PLZ lz, int bits, FILE *out);
+* int unlzInit(PUNLZ unlz);
+* int unlzPush(PUNLZ unlz, const unsigned char *data, int length, int *used);
+* void unlzReset(PUNLZ unlz);
+* void unlzClose(PUNLZ unlz);
+* void unlzReport(PUNLZ unlz, FILE *out);
+*
+* DATE: October 18, 2026
+*
+* DESIGNER: Karl Castillo (c)
+*
+* PROGRAMMER: Karl Castillo (c)
+*
+* NOTES:
+* The compression stage shared by the client and the server. Like the
+* layout, both sides must be told whether it is used.
+*******************************************************************************/
+#ifndef LZ_H
+#define LZ_H
+
+#include <stdio.h>
+
+/* DEFINES */
+#define LZ_BLOCK        65536   /* most bytes compressed as one frame */
+#define LZ_SMALL        4096    /* the frame when a loss is not repaired */
+#define LZ_HEADER       8       /* sync word, check, length and stored flag */
+#define LZ_SYNC         0x3ac5  /* starts every frame, never zero */
+#define LZ_STORED       0x80000000U
+#define LZ_MINMATCH     4       /* shortest match worth a sequence */
+#define LZ_MAXOFFSET    65535
+#define LZ_HASH_BITS    14
+#define LZ_BOUND(n)     ((n) + (n) / 255 + 16)
+
+/* STRUCTURES */
+typedef struct lz {
+        unsigned short table[1 << LZ_HASH_BITS]; /* last position of a hash */
+        unsigned char *frame;           /* the frame being built */
+        unsigned long in;               /* bytes compressed */
+        unsigned long out;              /* bytes of frames built */
+        unsigned long frames;           /* frames built */
+        unsigned long stored;           /* frames that did not compress */
+        double seconds;                 /* CPU time spent compressing */
+} LZ, *PLZ;
+
+typedef struct unlz {
+        unsigned char *frame;           /* the frame being collected */
+        unsigned char *raw;             /* a decompressed frame */
+        const unsigned char *data;      /* the bytes of the last frame */
+        int have;                       /* bytes of the frame collected */
+        int need;                       /* frame bytes expected */
+        unsigned long in;               /* bytes of frames pushed */
+        unsigned long out;              /* bytes decompressed */
+        unsigned long frames;           /* frames decompressed */
+        unsigned long errors;           /* frames that could not be */
+        unsigned long skipped;          /* bytes thrown away */
+} UNLZ, *PUNLZ;
+
+/* PROTOTYPES */
+int lzInit(PLZ lz);
+int lzFrame(PLZ lz, const unsigned char *data, int length);
+void lzClose(PLZ lz);
+void lzReport(PLZ lz, int bits, FILE *out);
+int unlzInit(PUNLZ unlz);
+int unlzPush(PUNLZ unlz, const unsigned char *data, int length, int *used);
+void unlzReset(PUNLZ unlz);
+void unlzClose(PUNLZ unlz);
+void unlzReport(PUNLZ unlz, FILE *out);
+
+#endif
@@ -0,0 +1,324 @@
+/*******************************************************************************
+* SOURCE FILE: pacer.c
+*
+* PROGRAM: Covert
+*
+* FUNCTIONS:
+* int pacerParse(char *arg, double *rate, int *unit);
+* void pacerInit(PPACER pacer, double rate, int unit);
+* void pacerWait(PPACER pacer, unsigned int packets, unsigned int bytes);
+* int pacerDue(PPACER pacer, unsigned int packets, unsigned int bytes,
+*        struct timespec *deadline);
+* void pacerReport(PPACER pacer, FILE *out);
+*
+* DATE: October 18, 2026
+*
+* DESIGNER: Karl Castillo (c)
+*
+* PROGRAMMER: Karl Castillo (c)
+*
+* NOTES:
+* A token bucket driven by the monotonic clock. Tokens accrue at the target
+* rate up to a small burst, every send takes its cost out of the bucket and a
+* send that overdraws it sleeps until the absolute time at which the debt is
+* paid back. Sleeping to absolute deadlines keeps the rate from drifting no
+* matter how late the scheduler wakes us up.
+*******************************************************************************/
+/* INCLUDES */
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include <errno.h>
+#include <time.h>
+#include "pacer.h"
+
+/* PROTOTYPES */
+static double tsDiff(struct timespec *a, struct timespec *b);
+static void tsAdd(struct timespec *ts, double seconds);
+
+/*******************************************************************************
+* FUNCTION: pacerParse
+*
+* DATE: October 18, 2026
+*
+* REVISIONS: (Date and Description)
+*
+* DESIGNER: Karl Castillo (c)
+*
+* PROGRAMMER: Karl Castillo (c)
+*
+* INTERFACE: int pacerParse(char *arg, double *rate, int *unit)
+* arg: the rate as given on the command line, ex. 500, 20kp, 1.5Mb or 0
+* rate: where the parsed rate will be stored
+* unit: where the parsed unit will be stored
+*
+* RETURN: int
+* 0: in success
+* -1: the rate could not be parsed
+*
+* NOTES:
+* The number may be followed by a k or M multiplier and by a unit, p for
+* packets per second (the default) or b for bytes per second. A rate of 0
+* turns pacing off.
+*******************************************************************************/
+int pacerParse(char *arg, double *rate, int *unit)
+{
+        char *end;
+
+        *rate = strtod(arg, &end);
+        if(end == arg || *rate < 0) {
+                return -1;
+        }
+
+        if(*end == 'k' || *end == 'K') {
+                *rate *= 1000.0;
+                end++;
+        } else if(*end == 'M') {
+                *rate *= 1000000.0;
+                end++;
+        }
+
+        if(*end == '\0' || strcmp(end, "p") == 0 || strcmp(end, "pps") == 0) {
+                *unit = PACE_PACKETS;
+        } else if(strcmp(end, "b") == 0 || strcmp(end, "B") == 0 ||
+                        strcmp(end, "Bps") == 0) {
+                *unit = PACE_BYTES;
+        } else {
+                return -1;
+        }
+
+        if(*rate == 0) {
+                *unit = PACE_NONE;
+        }
+
+        return 0;
+}
+
+/*******************************************************************************
+* FUNCTION: pacerInit
+*
+* DATE: October 18, 2026
+*
+* REVISIONS: (Date and Description)
+*
+* DESIGNER: Karl Castillo (c)
+*
+* PROGRAMMER: Karl Castillo (c)
+*
+* INTERFACE: void pacerInit(PPACER pacer, double rate, int unit)
+* pacer: the pacer to initialize
+* rate: the target rate in units per second
+* unit: PACE_NONE, PACE_PACKETS or PACE_BYTES
+*
+* RETURN: void
+*
+* NOTES:
+* The bucket starts full so the first packet leaves right away.
+*******************************************************************************/
+void pacerInit(PPACER pacer, double rate, int unit)
+{
+        memset(pacer, 0, sizeof(PACER));
+
+        pacer->unit = unit;
+        pacer->rate = rate;
+        pacer->burst = rate * PACE_BURST;
+        if(pacer->burst < 1) {
+                pacer->burst = 1;
+        }
+        pacer->tokens = pacer->burst;
+
+        clock_gettime(CLOCK_MONOTONIC, &pacer->start);
+        pacer->last = pacer->start;
+}
+
+/*******************************************************************************
+* FUNCTION: pacerWait
+*
+* DATE: October 18, 2026
+*
+* REVISIONS: (Date and Description)
+*
+* DESIGNER: Karl Castillo (c)
+*
+* PROGRAMMER: Karl Castillo (c)
+*
+* INTERFACE: void pacerWait(PPACER pacer, unsigned int packets, unsigned int
+*       bytes)
+* pacer: the pacer
+* packets: the number of packets about to be sent
+* bytes: the number of bytes about to be sent
+*
+* RETURN: void
+*
+* NOTES:
+* Blocks until the given packets may be sent at the target rate. A batch may
+* cost more than the burst; it is sent at once and the pacer then waits the
+* whole batch off before returning.
+*******************************************************************************/
+void pacerWait(PPACER pacer, unsigned int packets, unsigned int bytes)
+{
+        struct timespec deadline;
+
+        if(pacerDue(pacer, packets, bytes, &deadline)) {
+                while(clock_nanosleep(CLOCK_MONOTONIC, TIMER_ABSTIME,
+                                &deadline, NULL) == EINTR)
+                        ;
+        }
+}
+
+/*******************************************************************************
+* FUNCTION: pacerDue
+*
+* DATE: October 18, 2026
+*
+* REVISIONS: (Date and Description)
+*
+* DESIGNER: Karl Castillo (c)
+*
+* PROGRAMMER: Karl Castillo (c)
+*
+* INTERFACE: int pacerDue(PPACER pacer, unsigned int packets,
+*       unsigned int bytes, struct timespec *deadline)
+* pacer: the pacer
+* packets: the number of packets about to be sent
+* bytes: the number of bytes about to be sent
+* deadline: where the time they may leave at is stored, on the monotonic
+*       clock
+*
+* RETURN: int
+* 1: the packets must wait until the deadline
+* 0: they may leave now
+*
+* NOTES:
+* The accounting half of pacerWait, for a caller that waits some other way,
+* such as a timeout on an io_uring. The bucket is settled as if the caller
+* had already waited.
+*******************************************************************************/
+int pacerDue(PPACER pacer, unsigned int packets, unsigned int bytes,
+        struct timespec *deadline)
+{
+        struct timespec now;
+
+        pacer->packets += packets;
+        pacer->bytes += bytes;
+
+        if(pacer->unit == PACE_NONE) {
+                return 0;
+        }
+
+        clock_gettime(CLOCK_MONOTONIC, &now);
+        pacer->tokens += tsDiff(&now, &pacer->last) * pacer->rate;
+        if(pacer->tokens > pacer->burst) {
+                pacer->tokens = pacer->burst;
+        }
+        pacer->last = now;
+
+        pacer->tokens -= (pacer->unit == PACE_PACKETS) ? packets : bytes;
+        if(pacer->tokens >= 0) {
+                return 0;
+        }
+
+        *deadline = now;
+        tsAdd(deadline, -pacer->tokens / pacer->rate);
+
+        pacer->tokens = 0;
+        pacer->last = *deadline;
+
+        return 1;
+}
+
+/*******************************************************************************
+* FUNCTION: pacerReport
+*
+* DATE: October 18, 2026
+*
+* REVISIONS: (Date and Description)
+*
+* DESIGNER: Karl Castillo (c)
+*
+* PROGRAMMER: Karl Castillo (c)
+*
+* INTERFACE: void pacerReport(PPACER pacer, FILE *out)
+* pacer: the pacer
+* out: where the report will be printed
+*
+* RETURN: void
+*
+* NOTES:
+* Prints the achieved rate next to the target rate.
+*******************************************************************************/
+void pacerReport(PPACER pacer, FILE *out)
+{
+        struct timespec now;
+        double elapsed;
+
+        clock_gettime(CLOCK_MONOTONIC, &now);
+        elapsed = tsDiff(&now, &pacer->start);
+        if(elapsed <= 0) {
+                elapsed = 1e-9;
+        }
+
+        fprintf(out, "Sent %lu packets (%lu bytes) in %.3f s\n",
+                pacer->packets, pacer->bytes, elapsed);
+        fprintf(out, "Achieved Rate: %.1f packets/s, %.1f bytes/s\n",
+                pacer->packets / elapsed, pacer->bytes / elapsed);
+
+        if(pacer->unit == PACE_PACKETS) {
+                fprintf(out, "Target Rate: %.1f packets/s\n", pacer->rate);
+        } else if(pacer->unit == PACE_BYTES) {
+                fprintf(out, "Target Rate: %.1f bytes/s\n", pacer->rate);
+        } else {
+                fprintf(out, "Target Rate: unpaced\n");
+        }
+}
+
+/*******************************************************************************
+* FUNCTION: tsDiff
+*
+* DATE: October 18, 2026
+*
+* REVISIONS: (Date and Description)
+*
+* DESIGNER: Karl Castillo (c)
+*
+* PROGRAMMER: Karl Castillo (c)
+*
+* INTERFACE: static double tsDiff(struct timespec *a, struct timespec *b)
+* a: the later time
+* b: the earlier time
+*
+* RETURN: double: a - b in seconds
+*******************************************************************************/
+static double tsDiff(struct timespec *a, struct timespec *b)
+{
+        return (a->tv_sec - b->tv_sec) + (a->tv_nsec - b->tv_nsec) / 1e9;
+}
+
+/*******************************************************************************
+* FUNCTION: tsAdd
+*
+* DATE: October 18, 2026
+*
+* REVISIONS: (Date and Description)
+*
+* DESIGNER: Karl Castillo (c)
+*
+* PROGRAMMER: Karl Castillo (c)
+*
+* INTERFACE: static void tsAdd(struct timespec *ts, double seconds)
+* ts: the time to move forward
+* seconds: how far to move it
+*
+* RETURN: void
+*******************************************************************************/
+static void tsAdd(struct timespec *ts, double seconds)
+{
+        long sec = (long)seconds;
+
+        ts->tv_sec += sec;
+        ts->tv_nsec += (long)((seconds - sec) * 1e9);
+        if(ts->tv_nsec >= 1000000000L) {
+                ts->tv_sec++;
+                ts->tv_nsec -= 1000000000L;
+        }
+}
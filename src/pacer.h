@@ -0,0 +1,55 @@
+/*******************************************************************************
+* HEADER FILE: pacer.h
+*
+* PROGRAM: Covert
+*
+* FUNCTIONS:
+* int pacerParse(char *arg, double *rate, int *unit);
+* void pacerInit(PPACER pacer, double rate, int unit);
+* void pacerWait(PPACER pacer, unsigned int packets, unsigned int bytes);
+* int pacerDue(PPACER pacer, unsigned int packets, unsigned int bytes,
+*        struct timespec *deadline);
+* void pacerReport(PPACER pacer, FILE *out);
+*
+* DATE: October 18, 2026
+*
+* DESIGNER: Karl Castillo (c)
+*
+* PROGRAMMER: Karl Castillo (c)
+*
+* NOTES:
+* The token bucket pacer used by the client to control its send rate.
+*******************************************************************************/
+#ifndef PACER_H
+#define PACER_H
+
+#include <stdio.h>
+#include <time.h>
+
+/* DEFINES */
+#define PACE_NONE       0       /* unpaced, send as fast as possible */
+#define PACE_PACKETS    1       /* rate is in packets per second */
+#define PACE_BYTES      2       /* rate is in bytes per second */
+#define PACE_BURST      0.01    /* bucket depth in seconds of traffic */
+
+/* STRUCTURES */
+typedef struct pacer {
+        int unit;               /* PACE_NONE, PACE_PACKETS or PACE_BYTES */
+        double rate;            /* target rate in units per second */
+        double burst;           /* maximum number of tokens in the bucket */
+        double tokens;          /* may go negative while paying off a debt */
+        struct timespec last;   /* time of the last refill */
+        struct timespec start;  /* time of the first packet */
+        unsigned long packets;  /* packets sent through the pacer */
+        unsigned long bytes;    /* bytes sent through the pacer */
+} PACER, *PPACER;
+
+/* PROTOTYPES */
+int pacerParse(char *arg, double *rate, int *unit);
+void pacerInit(PPACER pacer, double rate, int unit);
+void pacerWait(PPACER pacer, unsigned int packets, unsigned int bytes);
+int pacerDue(PPACER pacer, unsigned int packets, unsigned int bytes,
+        struct timespec *deadline);
+void pacerReport(PPACER pacer, FILE *out);
+
+#endif
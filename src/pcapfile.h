@@ -0,0 +1,55 @@
+/*******************************************************************************
+* HEADER FILE: pcapfile.h
+*
+* PROGRAM: Covert
+*
+* FUNCTIONS:
+* none
+*
+* DATE: October 18, 2026
+*
+* DESIGNER: Karl Castillo (c)
+*
+* PROGRAMMER: Karl Castillo (c)
+*
+* NOTES:
+* The classic pcap file format, written by the client and read by the
+* server. Every field is in the byte order of the machine that wrote the
+* file; the magic number tells the reader whether it has to swap them.
+*******************************************************************************/
+#ifndef PCAPFILE_H
+#define PCAPFILE_H
+
+/* DEFINES */
+#define PCAP_MAGIC      0xa1b2c3d4      /* timestamps in microseconds */
+#define PCAP_MAGIC_NS   0xa1b23c4d      /* timestamps in nanoseconds */
+#define PCAP_MAJOR      2
+#define PCAP_MINOR      4
+#define PCAP_SNAPLEN    65535
+#define LINKTYPE_ETHERNET 1
+#define LINKTYPE_RAW    101             /* starts at the IP header */
+#define LINKTYPE_SLL    113             /* Linux cooked, tcpdump -i any */
+#define LINKTYPE_IPV4   228
+#define LINKTYPE_IPV6   229
+#define LINKTYPE_SLL2   276
+#define SLL_OUTGOING    4               /* packet type of our own packets */
+
+/* STRUCTURES */
+typedef struct pcaphdr {
+        unsigned int magic;
+        unsigned short major;
+        unsigned short minor;
+        int thiszone;                   /* always 0 */
+        unsigned int sigfigs;           /* always 0 */
+        unsigned int snaplen;           /* longest record kept */
+        unsigned int linktype;          /* what a record starts with */
+} PCAPHDR, *PPCAPHDR;
+
+typedef struct pcaprec {
+        unsigned int sec;
+        unsigned int usec;              /* or nanoseconds, see the magic */
+        unsigned int caplen;            /* bytes of the packet in the file */
+        unsigned int len;               /* bytes of the packet on the wire */
+} PCAPREC, *PPCAPREC;
+
+#endif
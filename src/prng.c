@@ -0,0 +1,72 @@
+/*******************************************************************************
+* SOURCE FILE: prng.c
+*
+* PROGRAM: Covert
+*
+* FUNCTIONS:
+* void prngSeed(PPRNG prng, unsigned long long seed);
+*
+* DATE: October 18, 2026
+*
+* DESIGNER: Karl Castillo (c)
+*
+* PROGRAMMER: Karl Castillo (c)
+*
+* NOTES:
+* Seeding of the per-session generator. The generator itself is inline in
+* prng.h.
+*******************************************************************************/
+/* INCLUDES */
+#include <stdio.h>
+#include <time.h>
+#include <unistd.h>
+#include "prng.h"
+
+/*******************************************************************************
+* FUNCTION: prngSeed
+*
+* DATE: October 18, 2026
+*
+* REVISIONS: (Date and Description)
+*
+* DESIGNER: Karl Castillo (c)
+*
+* PROGRAMMER: Karl Castillo (c)
+*
+* INTERFACE: void prngSeed(PPRNG prng, unsigned long long seed)
+* prng: the generator to seed
+* seed: the seed, 0 to seed from /dev/urandom
+*
+* RETURN: void
+*
+* NOTES:
+* The seed is run through splitmix64 so that small or similar seeds still
+* start far apart. When /dev/urandom cannot be read the clock and the pid are
+* used instead.
+*******************************************************************************/
+void prngSeed(PPRNG prng, unsigned long long seed)
+{
+        struct timespec now;
+        FILE *urandom;
+
+        if(seed == 0) {
+                if((urandom = fopen("/dev/urandom", "rb")) != NULL) {
+                        if(fread(&seed, sizeof(seed), 1, urandom) != 1) {
+                                seed = 0;
+                        }
+                        fclose(urandom);
+                }
+                if(seed == 0) {
+                        clock_gettime(CLOCK_MONOTONIC, &now);
+                        seed = ((unsigned long long)now.tv_sec << 32) ^
+                                now.tv_nsec ^ getpid();
+                }
+        }
+
+        seed += 0x9e3779b97f4a7c15ULL;
+        seed = (seed ^ (seed >> 30)) * 0xbf58476d1ce4e5b9ULL;
+        seed = (seed ^ (seed >> 27)) * 0x94d049bb133111ebULL;
+        seed ^= seed >> 31;
+
+        prng->state = (seed == 0) ? 0x9e3779b97f4a7c15ULL : seed;
+}
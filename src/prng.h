@@ -0,0 +1,60 @@
+/*******************************************************************************
+* HEADER FILE: prng.h
+*
+* PROGRAM: Covert
+*
+* FUNCTIONS:
+* void prngSeed(PPRNG prng, unsigned long long seed);
+* static inline unsigned int prngNext(PPRNG prng);
+*
+* DATE: October 18, 2026
+*
+* DESIGNER: Karl Castillo (c)
+*
+* PROGRAMMER: Karl Castillo (c)
+*
+* NOTES:
+* A xorshift64* generator. It is seeded once per session and is cheap enough
+* to be called for every packet, unlike srand and rand.
+*******************************************************************************/
+#ifndef PRNG_H
+#define PRNG_H
+
+/* STRUCTURES */
+typedef struct prng {
+        unsigned long long state;       /* never zero */
+} PRNG, *PPRNG;
+
+/* PROTOTYPES */
+void prngSeed(PPRNG prng, unsigned long long seed);
+
+/*******************************************************************************
+* FUNCTION: prngNext
+*
+* DATE: October 18, 2026
+*
+* REVISIONS: (Date and Description)
+*
+* DESIGNER: Karl Castillo (c)
+*
+* PROGRAMMER: Karl Castillo (c)
+*
+* INTERFACE: static inline unsigned int prngNext(PPRNG prng)
+* prng: the generator
+*
+* RETURN: unsigned int: the next 32 random bits
+*
+* NOTES:
+* The high half of the multiplied state is returned; its low bits are the
+* weakest of xorshift64*.
+*******************************************************************************/
+static inline unsigned int prngNext(PPRNG prng)
+{
+        prng->state ^= prng->state >> 12;
+        prng->state ^= prng->state << 25;
+        prng->state ^= prng->state >> 27;
+
+        return (unsigned int)((prng->state * 2685821657736338717ULL) >> 32);
+}
+
+#endif
@@ -0,0 +1,713 @@
+/*******************************************************************************
+* SOURCE FILE: reasm.c
+*
+* PROGRAM: Covert
+*
+* FUNCTIONS:
+* int reasmInit(PREASM reasm, int bits, int window, PWRITER writer);
+* int reasmPush(PREASM reasm, unsigned int seq, unsigned long long word,
+*        int valid, int transfer, long long stamp);
+* int reasmParity(PREASM reasm, unsigned int start, int index,
+*        unsigned long long word, int members, int final, int transfer,
+*        long long stamp);
+* int reasmHeld(PREASM reasm, unsigned char *map, int span);
+* void reasmClose(PREASM reasm);
+* void reasmReport(PREASM reasm, FILE *out);
+* static int reasmStale(PREASM reasm, int transfer, int restart,
+*        long long stamp);
+* static int reasmPlace(PREASM reasm, unsigned int seq,
+*        unsigned long long word, int valid, long long stamp);
+* static int reasmRebuilt(PREASM reasm, int count, long long stamp);
+* static int reasmDrain(PREASM reasm);
+* static void reasmWrite(PREASM reasm, unsigned long long word, int valid);
+* static void reasmLose(PREASM reasm);
+* static void reasmOutput(PREASM reasm, const unsigned char *data, int length);
+* static void reasmReset(PREASM reasm);
+*
+* DATE: October 18, 2026
+*
+* DESIGNER: Karl Castillo (c)
+*
+* PROGRAMMER: Karl Castillo (c)
+*
+* NOTES:
+* Packets are held in a sliding window of slots indexed by their sequence
+* number. Whenever the next packet in order is present, it and every packet
+* following it without a gap are unpacked and written. Since the payload is
+* a bit stream every packet has a fixed offset in the output, so a packet
+* that is still missing when the window has to move on is written as zeros
+* rather than dropped; the bytes after it stay where they belong.
+*
+* The last packet of a transfer says how many of its bits are payload. Once
+* it has been written the next transfer starts again at sequence 0. Every
+* packet also carries the id of its run, so the stragglers of the transfer
+* just done cannot be taken for the start of the next one: its id is dropped
+* for a while after it ends. A new run that drew the same id is recognised
+* by its packet 0 arriving while nothing of a new transfer is held.
+*
+* With FEC every packet is also handed to the decoder, and the packets it
+* rebuilds from parity are placed as if they had arrived, long before the
+* window would give up on them.
+*
+* Every packet keeps the time it arrived, and the time from then to when it
+* is written goes into the latency histogram. The clock is read once for a
+* run of packets written together, as the run starts, so it is not paid for
+* every packet. A rebuilt packet arrives with the packet that completed its
+* group.
+*******************************************************************************/
+/* INCLUDES */
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include "reasm.h"
+
+/* PROTOTYPES */
+static int reasmStale(PREASM reasm, int transfer, int restart,
+        long long stamp);
+static int reasmPlace(PREASM reasm, unsigned int seq,
+        unsigned long long word, int valid, long long stamp);
+static int reasmRebuilt(PREASM reasm, int count, long long stamp);
+static int reasmDrain(PREASM reasm);
+static void reasmWrite(PREASM reasm, unsigned long long word, int valid);
+static void reasmLose(PREASM reasm);
+static void reasmOutput(PREASM reasm, const unsigned char *data, int length);
+static void reasmReset(PREASM reasm);
+
+/*******************************************************************************
+* FUNCTION: reasmInit
+*
+* DATE: October 18, 2026
+*
+* REVISIONS: (Date and Description)
+*
+* DESIGNER: Karl Castillo (c)
+*
+* PROGRAMMER: Karl Castillo (c)
+*
+* INTERFACE: int reasmInit(PREASM reasm, int bits, int window,
+*       PWRITER writer)
+* reasm: the reassembler to initialize
+* bits: the payload bits per packet of the layout
+* window: the number of packets that can be held out of order
+* writer: where the payload will be written
+*
+* RETURN: int
+* 0: in success
+* -1: the window could not be allocated
+*******************************************************************************/
+int reasmInit(PREASM reasm, int bits, int window, PWRITER writer)
+{
+        memset(reasm, 0, sizeof(REASM));
+        reasm->bits = bits;
+        reasm->window = window;
+        reasm->writer = writer;
+        reasm->stale = -1;
+
+        if((reasm->slots = (PSLOT)malloc(window * sizeof(SLOT))) == NULL) {
+                return -1;
+        }
+        reasmReset(reasm);
+
+        return 0;
+}
+
+/*******************************************************************************
+* FUNCTION: reasmPush
+*
+* DATE: October 18, 2026
+*
+* REVISIONS: (Date and Description)
+*
+* DESIGNER: Karl Castillo (c)
+*
+* PROGRAMMER: Karl Castillo (c)
+*
+* INTERFACE: int reasmPush(PREASM reasm, unsigned int seq,
+*       unsigned long long word, int valid, int transfer, long long stamp)
+* reasm: the reassembler
+* seq: the sequence number of the packet
+* word: the payload bits of the packet
+* valid: the payload bits of the last packet, -1 for any other packet
+* transfer: the id of the run that sent the packet
+* stamp: when the packet arrived, ns
+*
+* RETURN: int
+* 1: the transfer is complete
+* 0: otherwise
+*******************************************************************************/
+int reasmPush(PREASM reasm, unsigned int seq, unsigned long long word,
+        int valid, int transfer, long long stamp)
+{
+        int rebuilt = 0;
+
+        reasm->packets++;
+
+        if(reasmStale(reasm, transfer, seq == 0, stamp)) {
+                if(reasm->stats != NULL) {
+                        reasm->stats->stale++;
+                }
+                return 0;
+        }
+
+        if(reasm->unfec != NULL &&
+                        seq - reasm->next < 2 * (unsigned int)reasm->window) {
+                rebuilt = unfecData(reasm->unfec, seq, word, valid);
+        }
+
+        return reasmPlace(reasm, seq, word, valid, stamp) ||
+                reasmRebuilt(reasm, rebuilt, stamp);
+}
+
+/*******************************************************************************
+* FUNCTION: reasmParity
+*
+* DATE: October 18, 2026
+*
+* REVISIONS: (Date and Description)
+*
+* DESIGNER: Karl Castillo (c)
+*
+* PROGRAMMER: Karl Castillo (c)
+*
+* INTERFACE: int reasmParity(PREASM reasm, unsigned int start, int index,
+*       unsigned long long word, int members, int final, int transfer,
+*       long long stamp)
+* reasm: the reassembler
+* start: the sequence number of the first member of the group
+* index: which parity of the group the packet is
+* word: the parity
+* members: the data packets in the group
+* final: the valid bits of the last packet when the group is the last one,
+*       -1 otherwise
+* transfer: the id of the run that sent the parity packet
+* stamp: when the parity packet arrived, ns
+*
+* RETURN: int
+* 1: the transfer is complete
+* 0: otherwise
+*
+* NOTES:
+* Parity of a group that has already been written is of no use, and could
+* only push a live group out of the decoder, so it is dropped. So is the
+* parity of a transfer already done: the parity of the last group is sent
+* after the final packet and often arrives once the transfer is written,
+* when it would otherwise be taken for the start of a new one.
+*******************************************************************************/
+int reasmParity(PREASM reasm, unsigned int start, int index,
+        unsigned long long word, int members, int final, int transfer,
+        long long stamp)
+{
+        reasm->parities++;
+
+        if(reasm->unfec == NULL || reasmStale(reasm, transfer, 0, stamp) ||
+                        (int)(start + members - reasm->next) <= 0 ||
+                        (int)(start - reasm->next) >= 2 * reasm->window) {
+                return 0;
+        }
+
+        return reasmRebuilt(reasm, unfecParity(reasm->unfec, start, index,
+                word, members, final), stamp);
+}
+
+/*******************************************************************************
+* FUNCTION: reasmStale
+*
+* DATE: October 18, 2026
+*
+* REVISIONS: (Date and Description)
+*
+* DESIGNER: Karl Castillo (c)
+*
+* PROGRAMMER: Karl Castillo (c)
+*
+* INTERFACE: static int reasmStale(PREASM reasm, int transfer, int restart,
+*       long long stamp)
+* reasm: the reassembler
+* transfer: the id of the run that sent the packet
+* restart: the packet is packet 0 of a transfer
+* stamp: when the packet arrived, ns
+*
+* RETURN: int
+* 1: the packet belongs to the transfer already done and was dropped
+* 0: otherwise, and transfer is now the id of the transfer
+*
+* NOTES:
+* A new run draws the id of the one before it once in TRANSFER_IDS - 1. Its
+* packet 0, arriving while nothing of a new transfer is held, is taken for
+* the start of the new run and ends the linger: packet 0 of the old transfer
+* went out first of all and is not expected to turn up after its end. The
+* packets of that run that arrive before its packet 0 are discarded, not
+* held: they are written as zeros and counted as lost like any other.
+*******************************************************************************/
+static int reasmStale(PREASM reasm, int transfer, int restart,
+        long long stamp)
+{
+        if(transfer == reasm->stale && stamp - reasm->until < 0) {
+                if(!restart || reasm->high != 0) {
+                        reasm->stales++;
+                        return 1;
+                }
+                reasm->stale = -1;
+        }
+        reasm->transfer = transfer;
+
+        return 0;
+}
+
+/*******************************************************************************
+* FUNCTION: reasmPlace
+*
+* DATE: October 18, 2026
+*
+* REVISIONS: (Date and Description)
+*
+* DESIGNER: Karl Castillo (c)
+*
+* PROGRAMMER: Karl Castillo (c)
+*
+* INTERFACE: static int reasmPlace(PREASM reasm, unsigned int seq,
+*       unsigned long long word, int valid, long long stamp)
+* reasm: the reassembler
+* seq: the sequence number of the packet
+* word: the payload bits of the packet
+* valid: the payload bits of the last packet, -1 for any other packet
+* stamp: when the packet arrived, ns
+*
+* RETURN: int
+* 1: the transfer is complete
+* 0: otherwise
+*
+* NOTES:
+* A packet beyond the end of the window pushes the window forward, and the
+* packets it leaves behind are written whether they arrived or not. The
+* packets held past a gap written that way are drained right after, not one
+* per packet that arrives. A packet more than a window beyond that is a
+* straggler from an earlier transfer and is dropped.
+*******************************************************************************/
+static int reasmPlace(PREASM reasm, unsigned int seq,
+        unsigned long long word, int valid, long long stamp)
+{
+        PSLOT slot;
+        long long now = 0;
+
+        if((int)(seq - reasm->next) < 0) {
+                reasm->duplicates++;
+                return 0;
+        }
+        if(seq - reasm->next >= 2 * (unsigned int)reasm->window) {
+                reasm->strays++;
+                return 0;
+        }
+
+        while(seq - reasm->next >= (unsigned int)reasm->window) {
+                slot = &reasm->slots[reasm->next % reasm->window];
+                if(slot->valid < 0 || slot->seq != reasm->next) {
+                        reasmLose(reasm);
+                } else {
+                        reasmWrite(reasm, slot->word, slot->valid);
+                        slot->valid = -1;
+                        if(reasm->stats != NULL) {
+                                if(now == 0) {
+                                        now = statsClock();
+                                }
+                                histAdd(&reasm->stats->latency,
+                                        now - slot->stamp);
+                        }
+                }
+                reasm->next++;
+        }
+
+        slot = &reasm->slots[seq % reasm->window];
+        if(slot->valid >= 0 && slot->seq == seq) {
+                reasm->duplicates++;
+                return 0;
+        }
+
+        slot->word = word;
+        slot->seq = seq;
+        slot->stamp = stamp;
+        if(reasm->high == 0) {
+                reasm->started = stamp;
+        }
+        if((int)(seq + 1 - reasm->high) > 0) {
+                reasm->high = seq + 1;
+        }
+        slot->final = (valid >= 0);
+        slot->valid = slot->final ? valid : reasm->bits;
+        if(slot->final) {
+                reasm->ended = 1;
+                reasm->last = seq;
+        }
+
+        if(seq != reasm->next) {
+                reasm->reordered++;
+        }
+
+        return reasmDrain(reasm);
+}
+
+/*******************************************************************************
+* FUNCTION: reasmHeld
+*
+* DATE: October 18, 2026
+*
+* REVISIONS: (Date and Description)
+*
+* DESIGNER: Karl Castillo (c)
+*
+* PROGRAMMER: Karl Castillo (c)
+*
+* INTERFACE: int reasmHeld(PREASM reasm, unsigned char *map, int span)
+* reasm: the reassembler
+* map: where bit n is set when packet next + n is held, span bits long and
+*       cleared by the caller
+* span: the packets past next to look at
+*
+* RETURN: int: the number of packets held past next
+*******************************************************************************/
+int reasmHeld(PREASM reasm, unsigned char *map, int span)
+{
+        PSLOT slot;
+        int held = 0;
+        int n;
+
+        if(span > reasm->window) {
+                span = reasm->window;
+        }
+        if((int)(reasm->high - reasm->next) < span) {
+                span = (int)(reasm->high - reasm->next);
+        }
+
+        for(n = 1; n < span; n++) {
+                slot = &reasm->slots[(reasm->next + n) % reasm->window];
+                if(slot->valid >= 0 && slot->seq == reasm->next + n) {
+                        map[n / 8] |= 1 << (n % 8);
+                        held++;
+                }
+        }
+
+        return held;
+}
+
+/*******************************************************************************
+* FUNCTION: reasmClose
+*
+* DATE: October 18, 2026
+*
+* REVISIONS: (Date and Description)
+*
+* DESIGNER: Karl Castillo (c)
+*
+* PROGRAMMER: Karl Castillo (c)
+*
+* INTERFACE: void reasmClose(PREASM reasm)
+* reasm: the reassembler
+*
+* RETURN: void
+*
+* NOTES:
+* When the last packet of the transfer has arrived, the gaps still open are
+* written as zeros so the file has its full length. Otherwise the packets
+* held behind the first gap are lost and the output ends there; every packet
+* up to the highest one seen is counted as lost.
+*******************************************************************************/
+void reasmClose(PREASM reasm)
+{
+        PSLOT slot;
+        unsigned int left = reasm->high - reasm->next;
+
+        if(!reasm->ended && (int)left > 0) {
+                reasm->lost += left;
+                if(reasm->stats != NULL) {
+                        reasm->stats->lost += left;
+                }
+        }
+        while(reasm->ended) {
+                slot = &reasm->slots[reasm->next % reasm->window];
+                if(slot->valid < 0 || slot->seq != reasm->next) {
+                        reasmLose(reasm);
+                        reasm->next++;
+                } else {
+                        reasmDrain(reasm);
+                }
+        }
+        writerFlush(reasm->writer);
+        free(reasm->slots);
+        reasm->slots = NULL;
+}
+
+/*******************************************************************************
+* FUNCTION: reasmReport
+*
+* DATE: October 18, 2026
+*
+* REVISIONS: (Date and Description)
+*
+* DESIGNER: Karl Castillo (c)
+*
+* PROGRAMMER: Karl Castillo (c)
+*
+* INTERFACE: void reasmReport(PREASM reasm, FILE *out)
+* reasm: the reassembler
+* out: where the report will be printed
+*
+* RETURN: void
+*******************************************************************************/
+void reasmReport(PREASM reasm, FILE *out)
+{
+        fprintf(out, "Reassembled %lu bytes in %lu transfers from %lu packets"
+                " and %lu parity packets\n", reasm->bytes, reasm->transfers,
+                reasm->packets, reasm->parities);
+        fprintf(out, "Reordered: %lu, Duplicates: %lu, Lost: %lu, "
+                "Strays: %lu, Stale: %lu\n", reasm->reordered,
+                reasm->duplicates, reasm->lost, reasm->strays, reasm->stales);
+        if(reasm->lost > 0) {
+                fprintf(out, "Warning: %lu packets were lost, the output has "
+                        "gaps\n", reasm->lost);
+        }
+}
+
+/*******************************************************************************
+* FUNCTION: reasmRebuilt
+*
+* DATE: October 18, 2026
+*
+* REVISIONS: (Date and Description)
+*
+* DESIGNER: Karl Castillo (c)
+*
+* PROGRAMMER: Karl Castillo (c)
+*
+* INTERFACE: static int reasmRebuilt(PREASM reasm, int count,
+*       long long stamp)
+* reasm: the reassembler
+* count: the number of packets the decoder just rebuilt
+* stamp: when the packet that completed them arrived, ns
+*
+* RETURN: int
+* 1: the transfer is complete
+* 0: otherwise
+*******************************************************************************/
+static int reasmRebuilt(PREASM reasm, int count, long long stamp)
+{
+        PUNFEC unfec = reasm->unfec;
+        int i;
+
+        for(i = 0; i < count; i++) {
+                if(reasmPlace(reasm, unfec->seqs[i], unfec->rebuilt[i],
+                                unfec->valids[i], stamp)) {
+                        return 1;
+                }
+        }
+
+        return 0;
+}
+
+/*******************************************************************************
+* FUNCTION: reasmDrain
+*
+* DATE: October 18, 2026
+*
+* REVISIONS: (Date and Description)
+*
+* DESIGNER: Karl Castillo (c)
+*
+* PROGRAMMER: Karl Castillo (c)
+*
+* INTERFACE: static int reasmDrain(PREASM reasm)
+* reasm: the reassembler
+*
+* RETURN: int
+* 1: the last packet of the transfer was written
+* 0: otherwise
+*
+* NOTES:
+* Once the last packet is written its id becomes stale. It lingers for
+* LINGER_MS, or for LINGER_PACKETS times the average gap between the packets
+* of the transfer when that is longer, so that the parity sent after the
+* last packet of a slow transfer is covered too. Every packet of that id is
+* discarded while it lingers, and a data packet is counted as stale in the
+* statistics since it is either a late duplicate or data of a new run lost
+* to the collision.
+*******************************************************************************/
+static int reasmDrain(PREASM reasm)
+{
+        PSLOT slot = &reasm->slots[reasm->next % reasm->window];
+        long long linger;
+        long long now = 0;
+
+        while(slot->valid >= 0 && slot->seq == reasm->next) {
+                reasmWrite(reasm, slot->word, slot->valid);
+                slot->valid = -1;
+                reasm->next++;
+                if(reasm->stats != NULL) {
+                        if(now == 0) {
+                                now = statsClock();
+                        }
+                        histAdd(&reasm->stats->latency, now - slot->stamp);
+                }
+
+                if(slot->final) {
+                        writerFlush(reasm->writer);
+                        reasm->transfers++;
+                        reasm->length = reasm->next;
+                        linger = (slot->stamp - reasm->started) /
+                                reasm->length * LINGER_PACKETS;
+                        if(linger < LINGER_MS * 1000000LL) {
+                                linger = LINGER_MS * 1000000LL;
+                        }
+                        reasm->stale = reasm->transfer;
+                        reasm->until = slot->stamp + linger;
+                        reasmReset(reasm);
+                        return 1;
+                }
+                slot = &reasm->slots[reasm->next % reasm->window];
+        }
+
+        return 0;
+}
+
+/*******************************************************************************
+* FUNCTION: reasmWrite
+*
+* DATE: October 18, 2026
+*
+* REVISIONS: (Date and Description)
+*
+* DESIGNER: Karl Castillo (c)
+*
+* PROGRAMMER: Karl Castillo (c)
+*
+* INTERFACE: static void reasmWrite(PREASM reasm, unsigned long long word,
+*       int valid)
+* reasm: the reassembler
+* word: the payload bits of the next packet in order
+* valid: how many of the bits are payload
+*
+* RETURN: void
+*
+* NOTES:
+* When the transfer is compressed the bytes go through the decompression
+* stage first, and only whole frames reach the writer.
+*******************************************************************************/
+static void reasmWrite(PREASM reasm, unsigned long long word, int valid)
+{
+        unsigned char bytes[16];
+        int count;
+        int size;
+        int used;
+        int i;
+
+        count = unpackerPush(&reasm->packer, word, valid, bytes);
+        reasm->bytes += count;
+
+        if(reasm->unlz == NULL) {
+                reasmOutput(reasm, bytes, count);
+                return;
+        }
+
+        for(i = 0; i < count; i += used) {
+                size = unlzPush(reasm->unlz, bytes + i, count - i, &used);
+                if(size > 0) {
+                        reasmOutput(reasm, reasm->unlz->data, size);
+                }
+        }
+}
+
+/*******************************************************************************
+* FUNCTION: reasmLose
+*
+* DATE: October 18, 2026
+*
+* REVISIONS: (Date and Description)
+*
+* DESIGNER: Karl Castillo (c)
+*
+* PROGRAMMER: Karl Castillo (c)
+*
+* INTERFACE: static void reasmLose(PREASM reasm)
+* reasm: the reassembler
+*
+* RETURN: void
+*
+* NOTES:
+* Writes the next packet as zeros since it never arrived, and counts it in
+* the statistics too so the loss shows while the server runs.
+*******************************************************************************/
+static void reasmLose(PREASM reasm)
+{
+        reasm->lost++;
+        if(reasm->stats != NULL) {
+                reasm->stats->lost++;
+        }
+        reasmWrite(reasm, 0, reasm->bits);
+}
+
+/*******************************************************************************
+* FUNCTION: reasmOutput
+*
+* DATE: October 18, 2026
+*
+* REVISIONS: (Date and Description)
+*
+* DESIGNER: Karl Castillo (c)
+*
+* PROGRAMMER: Karl Castillo (c)
+*
+* INTERFACE: static void reasmOutput(PREASM reasm, const unsigned char *data,
+*       int length)
+* reasm: the reassembler
+* data: the bytes of the transfer
+* length: the number of bytes at data
+*
+* RETURN: void
+*******************************************************************************/
+static void reasmOutput(PREASM reasm, const unsigned char *data, int length)
+{
+        int i;
+
+        if(reasm->echo) {
+                for(i = 0; i < length; i++) {
+                        printf("Receiving data: %c\n", data[i]);
+                }
+        }
+        writerWrite(reasm->writer, data, length);
+}
+
+/*******************************************************************************
+* FUNCTION: reasmReset
+*
+* DATE: October 18, 2026
+*
+* REVISIONS: (Date and Description)
+*
+* DESIGNER: Karl Castillo (c)
+*
+* PROGRAMMER: Karl Castillo (c)
+*
+* INTERFACE: static void reasmReset(PREASM reasm)
+* reasm: the reassembler
+*
+* RETURN: void
+*
+* NOTES:
+* Empties the window for a transfer starting at sequence 0.
+*******************************************************************************/
+static void reasmReset(PREASM reasm)
+{
+        int i;
+
+        for(i = 0; i < reasm->window; i++) {
+                reasm->slots[i].valid = -1;
+        }
+        reasm->next = 0;
+        reasm->high = 0;
+        reasm->ended = 0;
+        packerInit(&reasm->packer, reasm->bits);
+        if(reasm->unlz != NULL) {
+                unlzReset(reasm->unlz);
+        }
+        if(reasm->unfec != NULL) {
+                unfecReset(reasm->unfec);
+        }
+}
@@ -0,0 +1,98 @@
+/*******************************************************************************
+* HEADER FILE: reasm.h
+*
+* PROGRAM: Covert
+*
+* FUNCTIONS:
+* int reasmInit(PREASM reasm, int bits, int window, PWRITER writer);
+* int reasmPush(PREASM reasm, unsigned int seq, unsigned long long word,
+*        int valid, int transfer, long long stamp);
+* int reasmParity(PREASM reasm, unsigned int start, int index,
+*        unsigned long long word, int members, int final, int transfer,
+*        long long stamp);
+* int reasmHeld(PREASM reasm, unsigned char *map, int span);
+* void reasmClose(PREASM reasm);
+* void reasmReport(PREASM reasm, FILE *out);
+*
+* DATE: October 18, 2026
+*
+* DESIGNER: Karl Castillo (c)
+*
+* PROGRAMMER: Karl Castillo (c)
+*
+* NOTES:
+* The reassembler of the server. Every packet carries its sequence number in
+* the TCP acknowledgement number and is put back in order before its payload
+* is written.
+*******************************************************************************/
+#ifndef REASM_H
+#define REASM_H
+
+#include <stdio.h>
+#include "codec.h"
+#include "fec.h"
+#include "lz.h"
+#include "stats.h"
+#include "writer.h"
+
+/* DEFINES */
+#define DEF_WINDOW      4096    /* packets held while waiting for a gap */
+#define MAX_WINDOW      (1 << 20)
+#define LINGER_MS       2000    /* the id of a finished transfer is dropped
+                                   for at least this long */
+#define LINGER_PACKETS  16      /* or for this many of its packet times */
+
+/* STRUCTURES */
+typedef struct slot {
+        unsigned long long word;        /* the payload bits */
+        unsigned int seq;               /* the packet in the slot */
+        int valid;                      /* payload bits, -1 when empty */
+        int final;                      /* last packet of the transfer */
+        long long stamp;                /* when it arrived, ns */
+} SLOT, *PSLOT;
+
+typedef struct reasm {
+        int bits;                       /* payload bits per packet */
+        int window;                     /* slots in the window */
+        PSLOT slots;                    /* indexed by seq % window */
+        unsigned int next;              /* the next packet to write */
+        int ended;                      /* the last packet is held */
+        unsigned int last;              /* the seq of the last packet */
+        unsigned int length;            /* packets in the last transfer done */
+        unsigned int high;              /* one past the highest packet held */
+        int transfer;                   /* the id of the transfer */
+        int stale;                      /* the id of the last one done, -1
+                                           before the first or once reused */
+        long long started;              /* when the transfer began, ns */
+        long long until;                /* the stale id is dropped until, ns */
+        PACKER packer;                  /* unpacks the words in order */
+        PWRITER writer;                 /* where the payload is written */
+        PUNLZ unlz;                     /* decompresses it first, or NULL */
+        PUNFEC unfec;                   /* rebuilds lost packets, or NULL */
+        int echo;                       /* print every byte written */
+        PSTATS stats;                   /* takes the latency and the loss, or
+                                           NULL */
+        unsigned long packets;          /* packets pushed */
+        unsigned long parities;         /* parity packets pushed */
+        unsigned long duplicates;       /* packets already written or held */
+        unsigned long reordered;        /* packets that arrived early */
+        unsigned long lost;             /* packets written as zeros, or never
+                                           written when the session closed */
+        unsigned long strays;           /* packets too far ahead */
+        unsigned long stales;           /* packets of a transfer already done */
+        unsigned long bytes;            /* bytes written */
+        unsigned long transfers;        /* transfers completed */
+} REASM, *PREASM;
+
+/* PROTOTYPES */
+int reasmInit(PREASM reasm, int bits, int window, PWRITER writer);
+int reasmPush(PREASM reasm, unsigned int seq, unsigned long long word,
+        int valid, int transfer, long long stamp);
+int reasmParity(PREASM reasm, unsigned int start, int index,
+        unsigned long long word, int members, int final, int transfer,
+        long long stamp);
+int reasmHeld(PREASM reasm, unsigned char *map, int span);
+void reasmClose(PREASM reasm);
+void reasmReport(PREASM reasm, FILE *out);
+
+#endif
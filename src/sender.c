@@ -0,0 +1,1066 @@
+/*******************************************************************************
+* SOURCE FILE: sender.c
+*
+* PROGRAM: Covert
+*
+* FUNCTIONS:
+* int senderOpen(PSENDER sender, struct sockaddr *dest, int batch,
+*        PPACER pacer);
+* int senderOpenRing(PSENDER sender, char *ifname, unsigned char *mac,
+*        int family, int batch, PPACER pacer);
+* int senderPcapCreate(char *path);
+* int senderOpenPcap(PSENDER sender, int fd, int family, int batch,
+*        PPACER pacer);
+* int senderOpenUring(PSENDER sender, struct sockaddr *dest, int batch,
+*        PPACER pacer, PURING ring);
+* int senderParseMac(char *arg, unsigned char *mac);
+* void *senderSlot(PSENDER sender);
+* void *senderSlots(PSENDER sender, int *count, size_t *stride);
+* void senderPush(PSENDER sender);
+* void senderFlush(PSENDER sender);
+* void senderClose(PSENDER sender);
+* void senderReport(PSENDER sender, FILE *out);
+* static struct tpacket2_hdr *senderFrame(PSENDER sender, int frame);
+* static void senderWrite(PSENDER sender);
+* static void senderSubmit(PSENDER sender);
+* static int senderAgain(int res);
+* static int senderUnsent(PSENDER sender);
+* static void senderBackoff(PSENDER sender, int err);
+*
+* DATE: October 18, 2026
+*
+* DESIGNER: Karl Castillo (c)
+*
+* PROGRAMMER: Karl Castillo (c)
+*
+* NOTES:
+* The packets, message headers and vectors are carved out of a single
+* cache-aligned arena when the sender is opened so that the send loop never
+* allocates. A batch of one falls back
+* to a plain sendto.
+*
+* The ring sender skips the sendmmsg path altogether. Packets are built
+* directly in the frames of a PACKET_TX_RING shared with the kernel and a
+* single send kicks the kernel to transmit every frame queued since the last
+* flush. The packets leave through a packet socket, so the interface and the
+* next hop MAC address have to be given.
+*
+* The pcap sender goes through the same pacing and batching but appends each
+* batch to a pcap file as raw IP records, so the packet stream can be kept,
+* looked at, or decoded later by the server without root or a network.
+*
+* The io_uring sender keeps the raw socket and the batch of senderOpen but
+* queues the pacing wait and every send of a batch as one linked chain, so a
+* batch costs a single system call.
+*
+* IPv6 packets go through an AF_INET6 raw socket with IPPROTO_RAW, which
+* sends the header we built as it is, the same as IP_HDRINCL does for IPv4.
+* A pcap file of LINKTYPE_RAW holds either family.
+*******************************************************************************/
+/* INCLUDES */
+#define _GNU_SOURCE
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include <stdint.h>
+#include <errno.h>
+#include <unistd.h>
+#include <fcntl.h>
+#include <poll.h>
+#include <time.h>
+#include <net/if.h>
+#include <sys/mman.h>
+#include <sys/socket.h>
+#include <arpa/inet.h>
+#include <linux/if_ether.h>
+#include "sender.h"
+
+/* DEFINES */
+#define TX_DATA         (TPACKET2_HDRLEN - sizeof(struct sockaddr_ll))
+#define TX_PER_BLOCK    (TX_BLOCK / TX_FRAME)
+#define ALIGN_LINE(n)   (((n) + CACHE_LINE - 1) & ~(size_t)(CACHE_LINE - 1))
+#define SEND_WAIT_MS    10      /* longest wait for room in the socket */
+#define SEND_BACKOFF_NS 50000   /* pause when the device queue is full */
+
+/* PROTOTYPES */
+static struct tpacket2_hdr *senderFrame(PSENDER sender, int frame);
+static void senderWrite(PSENDER sender);
+static void senderSubmit(PSENDER sender);
+static int senderAgain(int res);
+static int senderUnsent(PSENDER sender);
+static void senderBackoff(PSENDER sender, int err);
+
+/*******************************************************************************
+* FUNCTION: senderOpen
+*
+* DATE: October 18, 2026
+*
+* REVISIONS: (Date and Description)
+*
+* DESIGNER: Karl Castillo (c)
+*
+* PROGRAMMER: Karl Castillo (c)
+*
+* INTERFACE: int senderOpen(PSENDER sender, struct sockaddr *dest, int batch,
+*       PPACER pacer)
+* sender: the sender to open
+* dest: where the data will be sent to, a sockaddr_in or a sockaddr_in6
+* batch: the number of packets sent per flush
+* pacer: the pacer that controls the send rate
+*
+* RETURN: int
+* 0: in success
+* -1: the socket or the arena could not be created
+*
+* NOTES:
+* Creates the raw socket and preallocates the batch. Every part of the arena
+* starts on its own cache line. The family of dest decides whether the
+* packets are IPv4 or IPv6.
+*******************************************************************************/
+int senderOpen(PSENDER sender, struct sockaddr *dest, int batch,
+        PPACER pacer)
+{
+        size_t packets_size;
+        size_t msgs_size;
+        size_t iovs_size;
+        int i;
+
+        memset(sender, 0, sizeof(SENDER));
+        sender->mode = SENDER_RAW;
+
+        if(dest->sa_family == AF_INET6) {
+                sender->size = sizeof(SENDHDR6);
+                sender->to_len = sizeof(struct sockaddr_in6);
+        } else {
+                sender->size = sizeof(SENDHDR);
+                sender->to_len = sizeof(struct sockaddr_in);
+        }
+        memcpy(&sender->to, dest, sender->to_len);
+
+        if((sender->sock = socket(dest->sa_family, SOCK_RAW,
+                        IPPROTO_RAW)) < 0) {
+                return -1;
+        }
+
+        sender->batch = batch;
+        sender->pacer = pacer;
+
+        packets_size = ALIGN_LINE((size_t)batch * sender->size);
+        msgs_size = ALIGN_LINE(batch * sizeof(struct mmsghdr));
+        iovs_size = ALIGN_LINE(batch * sizeof(struct iovec));
+        if(posix_memalign(&sender->arena, CACHE_LINE,
+                        packets_size + msgs_size + iovs_size) != 0) {
+                sender->arena = NULL;
+                close(sender->sock);
+                return -1;
+        }
+        memset(sender->arena, 0, packets_size + msgs_size + iovs_size);
+
+        sender->packets = (unsigned char*)sender->arena;
+        sender->msgs = (struct mmsghdr*)((char*)sender->arena + packets_size);
+        sender->iovs = (struct iovec*)((char*)sender->arena + packets_size +
+                msgs_size);
+
+        for(i = 0; i < batch; i++) {
+                sender->iovs[i].iov_base = sender->packets +
+                        (size_t)i * sender->size;
+                sender->iovs[i].iov_len = sender->size;
+                sender->msgs[i].msg_hdr.msg_name = &sender->to;
+                sender->msgs[i].msg_hdr.msg_namelen = sender->to_len;
+                sender->msgs[i].msg_hdr.msg_iov = &sender->iovs[i];
+                sender->msgs[i].msg_hdr.msg_iovlen = 1;
+        }
+
+        return 0;
+}
+
+/*******************************************************************************
+* FUNCTION: senderOpenRing
+*
+* DATE: October 18, 2026
+*
+* REVISIONS: (Date and Description)
+*
+* DESIGNER: Karl Castillo (c)
+*
+* PROGRAMMER: Karl Castillo (c)
+*
+* INTERFACE: int senderOpenRing(PSENDER sender, char *ifname, unsigned char
+*       *mac, int family, int batch, PPACER pacer)
+* sender: the sender to open
+* ifname: the interface the packets leave through
+* mac: the 6 byte MAC address of the next hop
+* family: AF_INET or AF_INET6, the packets that will be sent
+* batch: the number of packets sent per flush
+* pacer: the pacer that controls the send rate
+*
+* RETURN: int
+* 0: in success
+* -1: the socket or the ring could not be set up
+*
+* NOTES:
+* The ring holds at least four batches so that new packets can be built while
+* the kernel is still sending the previous ones.
+* Packets injected on the loopback interface this way are dropped as martians
+* by the routing code, so use a real or veth interface.
+*******************************************************************************/
+int senderOpenRing(PSENDER sender, char *ifname, unsigned char *mac,
+        int family, int batch, PPACER pacer)
+{
+        struct tpacket_req req;
+        int version = TPACKET_V2;
+        int protocol = (family == AF_INET6) ? ETH_P_IPV6 : ETH_P_IP;
+
+        memset(sender, 0, sizeof(SENDER));
+        sender->mode = SENDER_RING;
+        sender->size = (family == AF_INET6) ? sizeof(SENDHDR6) :
+                sizeof(SENDHDR);
+
+        if((sender->sock = socket(AF_PACKET, SOCK_DGRAM,
+                        htons(protocol))) < 0) {
+                return -1;
+        }
+
+        sender->sll.sll_family = AF_PACKET;
+        sender->sll.sll_protocol = htons(protocol);
+        sender->sll.sll_halen = ETH_ALEN;
+        memcpy(sender->sll.sll_addr, mac, ETH_ALEN);
+        if((sender->sll.sll_ifindex = if_nametoindex(ifname)) == 0) {
+                close(sender->sock);
+                return -1;
+        }
+
+        if(setsockopt(sender->sock, SOL_PACKET, PACKET_VERSION, &version,
+                        sizeof(version)) < 0) {
+                close(sender->sock);
+                return -1;
+        }
+
+        sender->frames = batch * 4;
+        if(sender->frames < MIN_TX_FRAMES) {
+                sender->frames = MIN_TX_FRAMES;
+        }
+        sender->frames = (sender->frames + TX_PER_BLOCK - 1) / TX_PER_BLOCK *
+                TX_PER_BLOCK;
+
+        memset(&req, 0, sizeof(req));
+        req.tp_block_size = TX_BLOCK;
+        req.tp_frame_size = TX_FRAME;
+        req.tp_block_nr = sender->frames / TX_PER_BLOCK;
+        req.tp_frame_nr = sender->frames;
+
+        if(setsockopt(sender->sock, SOL_PACKET, PACKET_TX_RING, &req,
+                        sizeof(req)) < 0) {
+                close(sender->sock);
+                return -1;
+        }
+
+        sender->ring_size = (size_t)TX_BLOCK * req.tp_block_nr;
+        if((sender->ring = mmap(NULL, sender->ring_size, PROT_READ | PROT_WRITE,
+                        MAP_SHARED, sender->sock, 0)) == MAP_FAILED) {
+                sender->ring = NULL;
+                close(sender->sock);
+                return -1;
+        }
+
+        sender->batch = batch;
+        sender->pacer = pacer;
+
+        return 0;
+}
+
+/*******************************************************************************
+* FUNCTION: senderPcapCreate
+*
+* DATE: October 18, 2026
+*
+* REVISIONS: (Date and Description)
+*
+* DESIGNER: Karl Castillo (c)
+*
+* PROGRAMMER: Karl Castillo (c)
+*
+* INTERFACE: int senderPcapCreate(char *path)
+* path: the pcap file to create, replaced when it exists
+*
+* RETURN: int: the open file, -1 when it could not be created
+*
+* NOTES:
+* Writes the file header. The file is opened for appending so that the
+* senders of a parallel client can share it: each flush is a single write,
+* which the kernel never interleaves with another on a regular file.
+*******************************************************************************/
+int senderPcapCreate(char *path)
+{
+        PCAPHDR hdr;
+        int fd;
+
+        if((fd = open(path, O_WRONLY | O_CREAT | O_TRUNC | O_APPEND,
+                        0644)) < 0) {
+                return -1;
+        }
+
+        memset(&hdr, 0, sizeof(hdr));
+        hdr.magic = PCAP_MAGIC;
+        hdr.major = PCAP_MAJOR;
+        hdr.minor = PCAP_MINOR;
+        hdr.snaplen = PCAP_SNAPLEN;
+        hdr.linktype = LINKTYPE_RAW;
+
+        if(write(fd, &hdr, sizeof(hdr)) != sizeof(hdr)) {
+                close(fd);
+                return -1;
+        }
+
+        return fd;
+}
+
+/*******************************************************************************
+* FUNCTION: senderOpenPcap
+*
+* DATE: October 18, 2026
+*
+* REVISIONS: (Date and Description)
+*
+* DESIGNER: Karl Castillo (c)
+*
+* PROGRAMMER: Karl Castillo (c)
+*
+* INTERFACE: int senderOpenPcap(PSENDER sender, int fd, int family,
+*       int batch, PPACER pacer)
+* sender: the sender to open
+* fd: a pcap file from senderPcapCreate
+* family: AF_INET or AF_INET6, the packets that will be written
+* batch: the number of packets written per flush
+* pacer: the pacer that controls the send rate
+*
+* RETURN: int
+* 0: in success
+* -1: the arena could not be allocated
+*
+* NOTES:
+* The sender keeps its own copy of the file descriptor, so the caller may
+* close fd once every sender is open.
+*******************************************************************************/
+int senderOpenPcap(PSENDER sender, int fd, int family, int batch,
+        PPACER pacer)
+{
+        size_t packets_size;
+
+        memset(sender, 0, sizeof(SENDER));
+        sender->mode = SENDER_PCAP;
+        sender->size = (family == AF_INET6) ? sizeof(SENDHDR6) :
+                sizeof(SENDHDR);
+
+        if((sender->sock = dup(fd)) < 0) {
+                return -1;
+        }
+
+        sender->batch = batch;
+        sender->pacer = pacer;
+
+        packets_size = ALIGN_LINE((size_t)batch * sender->size);
+        if(posix_memalign(&sender->arena, CACHE_LINE, packets_size +
+                        batch * (sizeof(PCAPREC) + sender->size)) != 0) {
+                sender->arena = NULL;
+                close(sender->sock);
+                return -1;
+        }
+
+        sender->packets = (unsigned char*)sender->arena;
+        sender->records = (unsigned char*)sender->arena + packets_size;
+        memset(sender->packets, 0, packets_size);
+
+        return 0;
+}
+
+/*******************************************************************************
+* FUNCTION: senderOpenUring
+*
+* DATE: October 18, 2026
+*
+* REVISIONS: (Date and Description)
+*
+* DESIGNER: Karl Castillo (c)
+*
+* PROGRAMMER: Karl Castillo (c)
+*
+* INTERFACE: int senderOpenUring(PSENDER sender, struct sockaddr *dest,
+*       int batch, PPACER pacer, PURING ring)
+* sender: the sender to open
+* dest: where the data will be sent to, a sockaddr_in or a sockaddr_in6
+* batch: the number of packets sent per flush
+* pacer: the pacer that controls the send rate
+* ring: an open ring with room for a batch and URING_SPARE more entries
+*
+* RETURN: int
+* 0: in success
+* -1: the socket or the operations could not be set up, or the ring refused
+*       the socket
+*
+* NOTES:
+* The socket is registered as the only fixed file of the ring so that the
+* kernel does not look it up again for every packet.
+*******************************************************************************/
+int senderOpenUring(PSENDER sender, struct sockaddr *dest, int batch,
+        PPACER pacer, PURING ring)
+{
+        if(senderOpen(sender, dest, batch, pacer) < 0) {
+                return -1;
+        }
+        sender->mode = SENDER_URING;
+        sender->uring = ring;
+
+        if((sender->ops = (PURINGOP)calloc(batch, sizeof(URINGOP))) == NULL ||
+                        uringRegister(ring, IORING_REGISTER_FILES,
+                        &sender->sock, 1) < 0) {
+                free(sender->ops);
+                free(sender->arena);
+                close(sender->sock);
+                return -1;
+        }
+
+        return 0;
+}
+
+/*******************************************************************************
+* FUNCTION: senderParseMac
+*
+* DATE: October 18, 2026
+*
+* REVISIONS: (Date and Description)
+*
+* DESIGNER: Karl Castillo (c)
+*
+* PROGRAMMER: Karl Castillo (c)
+*
+* INTERFACE: int senderParseMac(char *arg, unsigned char *mac)
+* arg: the MAC address as given on the command line, ex. 02:fc:00:00:00:01
+* mac: where the 6 bytes of the address will be stored
+*
+* RETURN: int
+* 0: in success
+* -1: the address could not be parsed
+*******************************************************************************/
+int senderParseMac(char *arg, unsigned char *mac)
+{
+        if(sscanf(arg, "%hhx:%hhx:%hhx:%hhx:%hhx:%hhx", &mac[0], &mac[1],
+                        &mac[2], &mac[3], &mac[4], &mac[5]) != 6) {
+                return -1;
+        }
+        return 0;
+}
+
+/*******************************************************************************
+* FUNCTION: senderSlot
+*
+* DATE: October 18, 2026
+*
+* REVISIONS: (Date and Description)
+*
+* DESIGNER: Karl Castillo (c)
+*
+* PROGRAMMER: Karl Castillo (c)
+*
+* INTERFACE: void *senderSlot(PSENDER sender)
+* sender: the sender
+*
+* RETURN: void *: the packet to build next, a SENDHDR or a SENDHDR6
+*
+* NOTES:
+* The packet only becomes part of the batch once it is pushed. On a ring the
+* slot is the next frame, and we wait for the kernel to be done with it.
+*******************************************************************************/
+void *senderSlot(PSENDER sender)
+{
+        size_t stride;
+        int count = 1;
+
+        return senderSlots(sender, &count, &stride);
+}
+
+/*******************************************************************************
+* FUNCTION: senderSlots
+*
+* DATE: October 18, 2026
+*
+* REVISIONS: (Date and Description)
+*
+* DESIGNER: Karl Castillo (c)
+*
+* PROGRAMMER: Karl Castillo (c)
+*
+* INTERFACE: void *senderSlots(PSENDER sender, int *count, size_t *stride)
+* sender: the sender
+* count: the packets wanted, cut down to the slots that follow each other
+* stride: where the bytes from one slot to the next will be stored, the
+*       size of a packet or of a ring frame
+*
+* RETURN: void *: the first packet to build
+*
+* NOTES:
+* The slots run to the end of the batch, and on a ring to the end of the
+* ring as well, so that a run of packets can be encoded in one go. Every
+* frame of the run is waited for, and each packet is pushed in order once
+* it is built.
+*******************************************************************************/
+void *senderSlots(PSENDER sender, int *count, size_t *stride)
+{
+        struct tpacket2_hdr *hdr;
+        struct pollfd pfd;
+        int i;
+
+        if(*count > sender->batch - sender->count) {
+                *count = sender->batch - sender->count;
+        }
+
+        if(sender->mode != SENDER_RING) {
+                *stride = sender->size;
+                return sender->packets + (size_t)sender->count * sender->size;
+        }
+
+        if(*count > sender->frames - sender->frame) {
+                *count = sender->frames - sender->frame;
+        }
+        for(i = 0; i < *count; i++) {
+                hdr = senderFrame(sender, sender->frame + i);
+                while(hdr->tp_status != TP_STATUS_AVAILABLE) {
+                        if(hdr->tp_status == TP_STATUS_WRONG_FORMAT) {
+                                sender->errors++;
+                                hdr->tp_status = TP_STATUS_AVAILABLE;
+                                break;
+                        }
+                        pfd.fd = sender->sock;
+                        pfd.events = POLLOUT;
+                        pfd.revents = 0;
+                        poll(&pfd, 1, -1);
+                }
+        }
+        *stride = TX_FRAME;
+
+        return (unsigned char*)senderFrame(sender, sender->frame) + TX_DATA;
+}
+
+/*******************************************************************************
+* FUNCTION: senderPush
+*
+* DATE: October 18, 2026
+*
+* REVISIONS: (Date and Description)
+*
+* DESIGNER: Karl Castillo (c)
+*
+* PROGRAMMER: Karl Castillo (c)
+*
+* INTERFACE: void senderPush(PSENDER sender)
+* sender: the sender
+*
+* RETURN: void
+*
+* NOTES:
+* Adds the packet built in the current slot to the batch, flushing the batch
+* once it is full.
+*******************************************************************************/
+void senderPush(PSENDER sender)
+{
+        struct tpacket2_hdr *hdr;
+
+        if(sender->mode == SENDER_RING) {
+                hdr = senderFrame(sender, sender->frame);
+                hdr->tp_len = sender->size;
+                hdr->tp_status = TP_STATUS_SEND_REQUEST;
+                sender->frame = (sender->frame + 1) % sender->frames;
+        }
+
+        if(++sender->count == sender->batch) {
+                senderFlush(sender);
+        }
+}
+
+/*******************************************************************************
+* FUNCTION: senderFlush
+*
+* DATE: October 18, 2026
+*
+* REVISIONS: (Date and Description)
+*
+* DESIGNER: Karl Castillo (c)
+*
+* PROGRAMMER: Karl Castillo (c)
+*
+* INTERFACE: void senderFlush(PSENDER sender)
+* sender: the sender
+*
+* RETURN: void
+*
+* NOTES:
+* Waits on the pacer for the whole batch and then hands it to the kernel.
+* When the kernel only takes part of the batch, the rest is sent again. A
+* packet the kernel refuses outright is counted as an error and skipped, but
+* a full socket buffer or device queue only means waiting: every path backs
+* off the same way before it sends again, rather than spinning. On a
+* ring the batch is already in place and one blocking send transmits it, and
+* a pcap sender writes it to the file instead. An io_uring sender leaves the
+* wait to the ring along with the sends.
+*******************************************************************************/
+void senderFlush(PSENDER sender)
+{
+        int sent = 0;
+        int calls = 0;
+        int n;
+
+        if(sender->count == 0) {
+                return;
+        }
+
+        if(sender->mode == SENDER_URING) {
+                senderSubmit(sender);
+                sender->count = 0;
+                return;
+        }
+
+        pacerWait(sender->pacer, sender->count,
+                sender->count * sender->size);
+        sender->batches++;
+
+        if(sender->mode == SENDER_RING) {
+                while(sendto(sender->sock, NULL, 0, 0,
+                                (struct sockaddr*)&sender->sll,
+                                sizeof(sender->sll)) < 0) {
+                        if(errno != EINTR && errno != EAGAIN &&
+                                        errno != ENOBUFS) {
+                                sender->errors += sender->count;
+                                break;
+                        }
+                        sender->retries++;
+                        senderBackoff(sender, errno);
+                }
+                sender->count = 0;
+                return;
+        }
+
+        if(sender->mode == SENDER_PCAP) {
+                senderWrite(sender);
+                sender->count = 0;
+                return;
+        }
+
+        if(sender->batch == 1) {
+                while(sendto(sender->sock, sender->packets, sender->size, 0,
+                                (struct sockaddr*)&sender->to,
+                                sender->to_len) < 0) {
+                        if(errno != EINTR && errno != EAGAIN &&
+                                        errno != ENOBUFS) {
+                                sender->errors++;
+                                break;
+                        }
+                        sender->retries++;
+                        senderBackoff(sender, errno);
+                }
+                sender->count = 0;
+                return;
+        }
+
+        while(sent < sender->count) {
+                if(calls++ > 0) {
+                        sender->retries++;
+                }
+
+                n = sendmmsg(sender->sock, &sender->msgs[sent],
+                        sender->count - sent, 0);
+                if(n < 0) {
+                        if(errno == EINTR || errno == EAGAIN ||
+                                        errno == ENOBUFS) {
+                                senderBackoff(sender, errno);
+                                continue;
+                        }
+                        sender->errors++;
+                        n = 1;
+                }
+                sent += n;
+        }
+
+        if(calls > 1) {
+                sender->partial++;
+        }
+
+        sender->count = 0;
+}
+
+/*******************************************************************************
+* FUNCTION: senderClose
+*
+* DATE: October 18, 2026
+*
+* REVISIONS: (Date and Description)
+*
+* DESIGNER: Karl Castillo (c)
+*
+* PROGRAMMER: Karl Castillo (c)
+*
+* INTERFACE: void senderClose(PSENDER sender)
+* sender: the sender
+*
+* RETURN: void
+*
+* NOTES:
+* Flushes what is left in the batch and releases the sender.
+*******************************************************************************/
+void senderClose(PSENDER sender)
+{
+        senderFlush(sender);
+
+        if(sender->ring != NULL) {
+                munmap(sender->ring, sender->ring_size);
+        }
+        close(sender->sock);
+        free(sender->arena);
+        free(sender->ops);
+}
+
+/*******************************************************************************
+* FUNCTION: senderReport
+*
+* DATE: October 18, 2026
+*
+* REVISIONS: (Date and Description)
+*
+* DESIGNER: Karl Castillo (c)
+*
+* PROGRAMMER: Karl Castillo (c)
+*
+* INTERFACE: void senderReport(PSENDER sender, FILE *out)
+* sender: the sender
+* out: where the report will be printed
+*
+* RETURN: void
+*******************************************************************************/
+void senderReport(PSENDER sender, FILE *out)
+{
+        if(sender->mode == SENDER_RING) {
+                fprintf(out, "Transmit Ring: %d frames\n", sender->frames);
+        } else if(sender->mode == SENDER_PCAP) {
+                fprintf(out, "Pcap: %lu bytes written\n", sender->written);
+        } else if(sender->mode == SENDER_URING) {
+                fprintf(out, "Transmit: io_uring, linked sends\n");
+        }
+        fprintf(out, "Batches: %lu (batch size %d)\n", sender->batches,
+                sender->batch);
+        fprintf(out, "Partial Batches: %lu, Retries: %lu, Errors: %lu\n",
+                sender->partial, sender->retries, sender->errors);
+}
+
+/*******************************************************************************
+* FUNCTION: senderFrame
+*
+* DATE: October 18, 2026
+*
+* REVISIONS: (Date and Description)
+*
+* DESIGNER: Karl Castillo (c)
+*
+* PROGRAMMER: Karl Castillo (c)
+*
+* INTERFACE: static struct tpacket2_hdr *senderFrame(PSENDER sender, int frame)
+* sender: the sender
+* frame: the index of the frame in the ring
+*
+* RETURN: struct tpacket2_hdr *: the header of the frame
+*******************************************************************************/
+static struct tpacket2_hdr *senderFrame(PSENDER sender, int frame)
+{
+        return (struct tpacket2_hdr*)(sender->ring + (size_t)frame * TX_FRAME);
+}
+
+/*******************************************************************************
+* FUNCTION: senderWrite
+*
+* DATE: October 18, 2026
+*
+* REVISIONS: (Date and Description)
+*
+* DESIGNER: Karl Castillo (c)
+*
+* PROGRAMMER: Karl Castillo (c)
+*
+* INTERFACE: static void senderWrite(PSENDER sender)
+* sender: the sender
+*
+* RETURN: void
+*
+* NOTES:
+* Every packet of the batch gets a record header stamped with the time of the
+* flush, and the whole batch goes to the file in one write. A short write is
+* finished with more writes; a failed one loses the batch.
+*******************************************************************************/
+static void senderWrite(PSENDER sender)
+{
+        struct timespec now;
+        PCAPREC rec;
+        unsigned char *cursor = sender->records;
+        size_t size;
+        size_t done = 0;
+        ssize_t n;
+        int i;
+
+        clock_gettime(CLOCK_REALTIME, &now);
+        rec.sec = now.tv_sec;
+        rec.usec = now.tv_nsec / 1000;
+        rec.caplen = sender->size;
+        rec.len = sender->size;
+
+        for(i = 0; i < sender->count; i++) {
+                memcpy(cursor, &rec, sizeof(rec));
+                memcpy(cursor + sizeof(rec), sender->packets +
+                        (size_t)i * sender->size, sender->size);
+                cursor += sizeof(rec) + sender->size;
+        }
+        size = cursor - sender->records;
+
+        while(done < size) {
+                if((n = write(sender->sock, sender->records + done,
+                                size - done)) < 0) {
+                        if(errno == EINTR) {
+                                continue;
+                        }
+                        sender->errors += sender->count;
+                        return;
+                }
+                if((done += n) < size) {
+                        sender->retries++;
+                }
+        }
+        sender->written += size;
+}
+
+/*******************************************************************************
+* FUNCTION: senderSubmit
+*
+* DATE: October 18, 2026
+*
+* REVISIONS: (Date and Description)
+*
+* DESIGNER: Karl Castillo (c)
+*
+* PROGRAMMER: Karl Castillo (c)
+*
+* INTERFACE: static void senderSubmit(PSENDER sender)
+* sender: the sender
+*
+* RETURN: void
+*
+* NOTES:
+* The batch goes out as one chain of linked requests: the pacing timeout when
+* the pacer wants a wait, then a sendmsg per packet. The timeout is flagged
+* IORING_TIMEOUT_ETIME_SUCCESS so that expiring starts the sends instead of
+* cancelling them. A single io_uring_enter submits the chain and waits for
+* it, which takes the place of both the sleep and the sendmmsg.
+*
+* When the submission ring has no room for the timeout, completions are
+* waited for until it does, as outputQueue does, so a batch never goes out
+* unpaced.
+*
+* A failed send cancels the rest of the chain. The packets the kernel had no
+* room for and those cancelled are chained again, as with a partial
+* sendmmsg, once senderBackoff has waited on the worst failure of the pass:
+* a full device queue before a full socket buffer. A packet refused outright
+* is counted as an error. If the ring itself fails, every packet of the
+* batch not yet sent is.
+*******************************************************************************/
+static void senderSubmit(PSENDER sender)
+{
+        struct io_uring_sqe *sqe;
+        struct io_uring_sqe *last;
+        struct timespec deadline;
+        int wait;
+        int calls = 0;
+        int left = sender->count;
+        int err = 0;
+        int i;
+
+        wait = pacerDue(sender->pacer, sender->count,
+                sender->count * sender->size, &deadline);
+        sender->batches++;
+
+        for(i = 0; i < sender->count; i++) {
+                sender->ops[i].res = -EAGAIN;
+        }
+
+        while(left > 0) {
+                if(calls++ > 0) {
+                        sender->retries++;
+                        senderBackoff(sender, err);
+                }
+
+                while(wait && (sqe = uringGet(sender->uring,
+                                &sender->pace)) == NULL) {
+                        if(uringEnter(sender->uring, 1, -1) < 0 &&
+                                        errno != EINTR) {
+                                sender->errors += senderUnsent(sender);
+                                return;
+                        }
+                }
+                if(wait) {
+                        sender->deadline.tv_sec = deadline.tv_sec;
+                        sender->deadline.tv_nsec = deadline.tv_nsec;
+                        sqe->opcode = IORING_OP_TIMEOUT;
+                        sqe->fd = -1;
+                        sqe->addr = (unsigned long long)(uintptr_t)
+                                &sender->deadline;
+                        sqe->len = 1;
+                        sqe->timeout_flags = IORING_TIMEOUT_ABS |
+                                IORING_TIMEOUT_ETIME_SUCCESS;
+                        sqe->flags = IOSQE_IO_LINK;
+                }
+                wait = 0;
+
+                last = NULL;
+                for(i = 0; i < sender->count; i++) {
+                        if(!senderAgain(sender->ops[i].res) ||
+                                        (sqe = uringGet(sender->uring,
+                                        &sender->ops[i])) == NULL) {
+                                continue;
+                        }
+                        sqe->opcode = IORING_OP_SENDMSG;
+                        sqe->fd = 0;
+                        sqe->flags = IOSQE_FIXED_FILE | IOSQE_IO_LINK;
+                        sqe->addr = (unsigned long long)(uintptr_t)
+                                &sender->msgs[i].msg_hdr;
+                        sqe->len = 1;
+                        last = sqe;
+                }
+                if(last != NULL) {
+                        last->flags &= ~IOSQE_IO_LINK;
+                }
+
+                if(uringWait(sender->uring, &sender->pace) < 0 &&
+                                sender->pace.pending > 0) {
+                        sender->errors += senderUnsent(sender);
+                        return;
+                }
+                left = 0;
+                err = 0;
+                for(i = 0; i < sender->count; i++) {
+                        if(uringWait(sender->uring, &sender->ops[i]) < 0 &&
+                                        sender->ops[i].pending > 0) {
+                                sender->errors += senderUnsent(sender);
+                                return;
+                        }
+                        if(senderAgain(sender->ops[i].res)) {
+                                left++;
+                                if(sender->ops[i].res == -ENOBUFS) {
+                                        err = ENOBUFS;
+                                } else if(sender->ops[i].res == -EAGAIN &&
+                                                err != ENOBUFS) {
+                                        err = EAGAIN;
+                                }
+                        } else if(sender->ops[i].res < 0) {
+                                /* cleared so that senderUnsent does not
+                                   count it again */
+                                sender->errors++;
+                                sender->ops[i].res = 0;
+                        }
+                }
+        }
+
+        if(calls > 1) {
+                sender->partial++;
+        }
+}
+
+/*******************************************************************************
+* FUNCTION: senderAgain
+*
+* DATE: October 18, 2026
+*
+* REVISIONS: (Date and Description)
+*
+* DESIGNER: Karl Castillo (c)
+*
+* PROGRAMMER: Karl Castillo (c)
+*
+* INTERFACE: static int senderAgain(int res)
+* res: the result of a send on the ring
+*
+* RETURN: int
+* 1: the packet should be sent again
+* 0: it was sent or refused
+*******************************************************************************/
+static int senderAgain(int res)
+{
+        return res == -EAGAIN || res == -ENOBUFS || res == -EINTR ||
+                res == -ECANCELED;
+}
+
+/*******************************************************************************
+* FUNCTION: senderUnsent
+*
+* DATE: October 18, 2026
+*
+* REVISIONS: (Date and Description)
+*
+* DESIGNER: Karl Castillo (c)
+*
+* PROGRAMMER: Karl Castillo (c)
+*
+* INTERFACE: static int senderUnsent(PSENDER sender)
+* sender: the sender, with a batch on the ring
+*
+* RETURN: int: the packets of the batch that have not been sent
+*
+* NOTES:
+* Counts the packets whose result is still negative, those never sent or
+* still waiting to be sent again.
+*******************************************************************************/
+static int senderUnsent(PSENDER sender)
+{
+        int unsent = 0;
+        int i;
+
+        for(i = 0; i < sender->count; i++) {
+                if(sender->ops[i].res < 0) {
+                        unsent++;
+                }
+        }
+
+        return unsent;
+}
+
+/*******************************************************************************
+* FUNCTION: senderBackoff
+*
+* DATE: October 18, 2026
+*
+* REVISIONS: (Date and Description)
+*
+* DESIGNER: Karl Castillo (c)
+*
+* PROGRAMMER: Karl Castillo (c)
+*
+* INTERFACE: static void senderBackoff(PSENDER sender, int err)
+* sender: the sender
+* err: why the last send failed
+*
+* RETURN: void
+*
+* NOTES:
+* A full socket buffer (EAGAIN) is waited out with poll, at most
+* SEND_WAIT_MS. A full device queue (ENOBUFS) is not something poll reports,
+* since the socket itself still has room, so the sender pauses briefly
+* instead. An interrupted send is simply tried again.
+*******************************************************************************/
+static void senderBackoff(PSENDER sender, int err)
+{
+        struct pollfd pfd;
+        struct timespec pause;
+
+        if(err == EAGAIN) {
+                pfd.fd = sender->sock;
+                pfd.events = POLLOUT;
+                poll(&pfd, 1, SEND_WAIT_MS);
+        } else if(err == ENOBUFS) {
+                pause.tv_sec = 0;
+                pause.tv_nsec = SEND_BACKOFF_NS;
+                nanosleep(&pause, NULL);
+        }
+}
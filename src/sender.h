@@ -0,0 +1,130 @@
+/*******************************************************************************
+* HEADER FILE: sender.h
+*
+* PROGRAM: Covert
+*
+* FUNCTIONS:
+* int senderOpen(PSENDER sender, struct sockaddr *dest, int batch,
+*        PPACER pacer);
+* int senderOpenRing(PSENDER sender, char *ifname, unsigned char *mac,
+*        int family, int batch, PPACER pacer);
+* int senderPcapCreate(char *path);
+* int senderOpenPcap(PSENDER sender, int fd, int family, int batch,
+*        PPACER pacer);
+* int senderOpenUring(PSENDER sender, struct sockaddr *dest, int batch,
+*        PPACER pacer, PURING ring);
+* int senderParseMac(char *arg, unsigned char *mac);
+* void *senderSlot(PSENDER sender);
+* void *senderSlots(PSENDER sender, int *count, size_t *stride);
+* void senderPush(PSENDER sender);
+* void senderFlush(PSENDER sender);
+* void senderClose(PSENDER sender);
+* void senderReport(PSENDER sender, FILE *out);
+*
+* DATE: October 18, 2026
+*
+* DESIGNER: Karl Castillo (c)
+*
+* PROGRAMMER: Karl Castillo (c)
+*
+* NOTES:
+* The transmit path of the client. Packets are built in place in a batch of
+* prebuilt slots and flushed to the raw socket with a single sendmmsg, or
+* built straight into the frames of a memory-mapped PACKET_TX_RING. The same
+* batches can also be written to a pcap file instead of the network, or
+* sent through an io_uring together with their pacing timeout.
+*
+* A sender carries either IPv4 or IPv6 packets, as the family it was opened
+* with says; size is the length of one of its packets.
+*******************************************************************************/
+#ifndef SENDER_H
+#define SENDER_H
+
+#include <stdio.h>
+#include <netinet/in.h>
+#include <netinet/tcp.h>
+#include <sys/socket.h>
+#include <netinet/ip6.h>
+#include <linux/ip.h>
+#include <linux/if_packet.h>
+#include "pacer.h"
+#include "pcapfile.h"
+#include "uring.h"
+
+/* DEFINES */
+#define DEF_BATCH       1
+#define MAX_BATCH       1024
+#define SENDER_RAW      1
+#define SENDER_RING     2
+#define SENDER_PCAP     3
+#define SENDER_URING    4
+#define URING_SPARE     8       /* ring entries beyond a batch of sends */
+#define TX_FRAME        128
+#define TX_BLOCK        4096
+#define MIN_TX_FRAMES   256
+#define CACHE_LINE      64
+
+/* STRUCTURES */
+typedef struct sendhdr {
+        struct iphdr ip;
+        struct tcphdr tcp;
+} SENDHDR, *PSENDHDR;
+
+typedef struct sendhdr6 {
+        struct ip6_hdr ip6;
+        struct tcphdr tcp;
+} SENDHDR6, *PSENDHDR6;
+
+typedef struct sender {
+        int mode;               /* SENDER_RAW, SENDER_RING, SENDER_PCAP or
+                                   SENDER_URING */
+        int sock;               /* raw socket, packet socket or pcap file */
+        int batch;              /* packets per flush */
+        int count;              /* packets waiting in the batch */
+        int size;               /* bytes per packet, SENDHDR or SENDHDR6 */
+        void *arena;            /* packets, messages and vectors */
+        unsigned char *packets; /* the batch of packets */
+        struct mmsghdr *msgs;   /* one message per packet */
+        struct iovec *iovs;     /* one vector per packet */
+        union {
+                struct sockaddr_in sin;
+                struct sockaddr_in6 sin6;
+        } to;                   /* where every packet is sent */
+        socklen_t to_len;       /* the length of the address in to */
+        PPACER pacer;           /* paces every flush */
+        unsigned long batches;  /* number of flushes */
+        unsigned long partial;  /* flushes the kernel only partly accepted */
+        unsigned long retries;  /* extra sendmmsg calls to finish a flush */
+        unsigned long errors;   /* packets the kernel refused */
+        unsigned char *ring;    /* the mapped transmit ring */
+        size_t ring_size;       /* bytes mapped */
+        int frames;             /* frames in the ring */
+        int frame;              /* the frame the next packet goes in */
+        struct sockaddr_ll sll; /* the interface and next hop of the ring */
+        unsigned char *records; /* the batch as pcap records */
+        unsigned long written;  /* bytes written to the pcap file */
+        PURING uring;           /* the ring the batches go through */
+        PURINGOP ops;           /* one send per packet of the batch */
+        URINGOP pace;           /* the pacing timeout */
+        struct __kernel_timespec deadline; /* when the batch may leave */
+} SENDER, *PSENDER;
+
+/* PROTOTYPES */
+int senderOpen(PSENDER sender, struct sockaddr *dest, int batch,
+        PPACER pacer);
+int senderOpenRing(PSENDER sender, char *ifname, unsigned char *mac,
+        int family, int batch, PPACER pacer);
+int senderPcapCreate(char *path);
+int senderOpenPcap(PSENDER sender, int fd, int family, int batch,
+        PPACER pacer);
+int senderOpenUring(PSENDER sender, struct sockaddr *dest, int batch,
+        PPACER pacer, PURING ring);
+int senderParseMac(char *arg, unsigned char *mac);
+void *senderSlot(PSENDER sender);
+void *senderSlots(PSENDER sender, int *count, size_t *stride);
+void senderPush(PSENDER sender);
+void senderFlush(PSENDER sender);
+void senderClose(PSENDER sender);
+void senderReport(PSENDER sender, FILE *out);
+
+#endif
@@ -4,7 +4,12 @@
 * PROGRAM: Covert
 *
 * FUNCTIONS:
-* void doDecoding(unsigned short port, char* file_name, int type);
+* void doDecoding(const struct in6_addr *source, unsigned short port,
+*        PSESSIONS sessions, PLAYOUT layout, PLAYOUT layout6, PCAPTURE capture,
+*        int flush_ms);
+* void doStats(void *context, int due);
+* void *doWorker(void *arg);
+* void stopDecoding(int sig);
 *
 * DATE: September 13, 2012
 *
@@ -19,35 +24,74 @@
 * gcc -W -Wall -o server server.c
 *******************************************************************************/
 /* INCLUDES */
+#define _GNU_SOURCE
 #include <stdio.h>
 #include <stdlib.h>
+#include <errno.h>
 #include <signal.h>
 #include <string.h>
+#include <time.h>
 #include <unistd.h>
+#include <pthread.h>
+#include <sched.h>
 #include <netdb.h>
 #include <netinet/in.h>
 #include <netinet/tcp.h>
 #include <sys/socket.h>
 #include <arpa/inet.h>
 #include <linux/ip.h>
+#include "capture.h"
+#include "covert.h"
+#include "fec.h"
+#include "feedback.h"
+#include "filter.h"
+#include "reasm.h"
+#include "session.h"
+#include "stats.h"
+#include "uring.h"
+#include "writer.h"
 
 /* DEFINES */
 #define VERSION         "1.0"
-#define TOS             1
-#define TTL             2
 #define DEF_PORT        8000
 #define DEF_FIL         "secret2.txt"
+#define MAX_WORKERS     64
+#define URING_CQES      (MAX_RBATCH * 8) /* room for every capture buffer */
 
 /* STRUCTURES */
-typedef struct recvdhr {
-        struct iphdr ip;
-        struct tcphdr tcp;
-        char buffer[10000];
-} RECVHDR, *PRECVHDR;
+typedef struct worker {
+        pthread_t thread;               /* the receive thread */
+        int index;                      /* its place in the pool */
+        int cpu;                        /* the CPU it is pinned to */
+        const struct in6_addr *source;  /* where the data comes from, or NULL */
+        unsigned short port;            /* the port the data is sent to */
+        PLAYOUT layout;                 /* the fields that carry the payload */
+        PLAYOUT layout6;                /* the same over IPv6 */
+        int flush_ms;                   /* longest partial blocks are held */
+        CAPTURE capture;                /* its socket in the fanout group */
+        SESSIONS sessions;              /* the sessions hashed to it */
+        STATS stats;                    /* its batch clock and latency */
+        REPORTER reporter;              /* its own feedback socket */
+} WORKER, *PWORKER;
+
+typedef struct pool {
+        PWORKER workers;                /* the receive workers */
+        int count;                      /* the number of workers */
+        int numbers;                    /* sessions opened by all of them */
+        POUTPUT output;                 /* the stage they all feed */
+        PSTATS stats;                   /* whose interval and rate are shown */
+} POOL, *PPOOL;
 
 /* PROTOTYPES */
-void doDecoding(unsigned int source, unsigned short port, char* file_name, int type);
-unsigned int ip_convert(char *hostname);
+void doDecoding(const struct in6_addr *source, unsigned short port,
+        PSESSIONS sessions, PLAYOUT layout, PLAYOUT layout6, PCAPTURE capture,
+        int flush_ms);
+void doStats(void *context, int due);
+void *doWorker(void *arg);
+void stopDecoding(int sig);
+
+/* GLOBALS */
+static volatile sig_atomic_t running = 1;
 
 /*******************************************************************************
 * FUNCTION: main
@@ -55,6 +99,7 @@ unsigned int ip_convert(char *hostname);
 * DATE: September 13, 2012
 *
 * REVISIONS: (Date and Description)
+* October 18, 2026: Captures IPv6 as well with -6, and takes an IPv6 source.
 *
 * DESIGNER: Karl Castillo (c)
 *
@@ -68,62 +113,476 @@ unsigned int ip_convert(char *hostname);
 * RETURN: int
 * 0: in success
 * 1: not running in root error
-* 2: no decoding type chosen
+* 2: no or invalid decoding layout chosen
+* 3: invalid batch size
+* 4: cannot open the capture
+* 5: invalid reassembly window
+* 6: invalid idle timeout
+* 7: invalid output settings
+* 8: invalid FEC code
+* 9: invalid feedback address, or feedback while reading a pcap file
+* 10: invalid statistics interval
+* 11: invalid number of workers, workers while reading a pcap file or with
+*       io_uring, or a worker could not be started
+* 12: an IPv6 source without -6
 *
 * NOTES:
 * A generic main function where the command line arguments are parsed, and the
 * proper preparations are made.
+*
+* With more than one worker every worker opens a ring of its own and joins
+* one fanout group, so the kernel spreads the sessions over them. Each worker
+* decodes on its own CPU with its own sessions and hands the output to the
+* writer thread through a lane of its own. The statistics of all the workers
+* are shown together by a monitor thread.
+*
+* With io_uring a single worker receives through a multishot request and
+* writes its blocks through the same ring, so one wait serves both.
+*
+* With -6 the capture takes IPv6 packets as well, and each family is decoded
+* with the fields of the layout its header has: the type of service and the
+* time to live are the traffic class and the hop limit, while the
+* identification is IPv4 only and the flow label IPv6 only. A pcap file is
+* always read for both.
 *******************************************************************************/
 int main(int argc, char* argv[])
 {
-	unsigned int source_ip = 0;
+        struct in6_addr source_addr;
+        const struct in6_addr *source_ip = NULL;
         unsigned short port = DEF_PORT;
-        int encoding_type = 0;
         int option = 0;
-        char* encoding_name;
-        char* source_name;
+        char* encoding_name = NULL;
+        char* source_name = "any";
         char file_name[80] = DEF_FIL;
+        int batch = DEF_RBATCH;
+        int rcvbuf = DEF_RCVBUF;
+        int mode = CAPTURE_SOCK;
+        int ring_blocks = DEF_RING_BLOCKS;
+        int ring_kb = DEF_RING_KB;
+        int huge = 0;
+        int window = DEF_WINDOW;
+        int idle = DEF_IDLE;
+        int block_kb = DEF_BLOCK_KB;
+        int flush_ms = DEF_FLUSH_MS;
+        int threaded = 0;
+        int verbose = 0;
+        int compressed = 0;
+        char *fec_name = NULL;
+        FEC fec;
+        PFEC code = NULL;
+        char *feedback_name = NULL;
+        char *pcap_name = NULL;
+        int interval = 0;
+        int workers = 1;
+        int use_uring = 0;
+        URING uring;
+        int group = getpid() & 0xffff;
+        long cpus = sysconf(_SC_NPROCESSORS_ONLN);
+        int started;
+        int i;
+        PWORKER worker;
+        POOL pool;
+        STATS stats;
+        OUTPUT output;
+        LAYOUT layout;
+        LAYOUT layout6;
+        int dual = 0;
+        int have4;
+        int have6;
         
-        if(getuid() != 0) {
-                perror("\nYou must run this in root!\n");
-                return 1;
-        }
-        
-        while((option = getopt(argc, argv, ":S:s:f:utl")) != -1) {
+        while((option = getopt(argc, argv, ":S:s:f:b:B:Rn:k:HW:i:o:F:E:A:r:I:j:avzL:utlU6")) != -1) {
                 switch(option) {
-                case 'S': /* source IP */
+                case 'S': /* source IP, IPv4 or IPv6 */
                 	source_name = optarg;
-                	source_ip = ip_convert(optarg);
+                        if(inet_pton(AF_INET6, optarg, &source_addr) != 1) {
+                                ip_map(ip_convert(optarg), &source_addr);
+                        }
+                        source_ip = &source_addr;
                         break;
-                case 's': /* source port */
+                case '6': /* dual-stack capture */
+                        dual = 1;
+                        break;
+                case 's': /* port the data is sent to */
                         port = atoi(optarg);
                         break;
                 case 'f': /* file name */
                         strncpy(file_name, optarg, 79);
                         break;
+                case 'b': /* receive batch size */
+                        batch = atoi(optarg);
+                        break;
+                case 'B': /* socket receive buffer */
+                        rcvbuf = atoi(optarg);
+                        break;
+                case 'R': /* memory-mapped ring capture */
+                        mode = CAPTURE_RING;
+                        break;
+                case 'n': /* ring block count */
+                        ring_blocks = atoi(optarg);
+                        break;
+                case 'k': /* ring block size in KB */
+                        ring_kb = atoi(optarg);
+                        break;
+                case 'H': /* huge page backed ring */
+                        huge = 1;
+                        break;
+                case 'W': /* reassembly window */
+                        window = atoi(optarg);
+                        break;
+                case 'i': /* session idle timeout */
+                        idle = atoi(optarg);
+                        break;
+                case 'o': /* output block size in KB */
+                        block_kb = atoi(optarg);
+                        break;
+                case 'F': /* output flush interval in ms */
+                        flush_ms = atoi(optarg);
+                        break;
+                case 'a': /* write from a thread */
+                        threaded = 1;
+                        break;
+                case 'v': /* echo every byte */
+                        verbose = 1;
+                        break;
+                case 'E': /* FEC code, k:m */
+                        fec_name = optarg;
+                        break;
+                case 'A': /* report to the client, [host:]port */
+                        feedback_name = optarg;
+                        break;
+                case 'r': /* decode a pcap file */
+                        pcap_name = optarg;
+                        mode = CAPTURE_PCAP;
+                        break;
+                case 'I': /* seconds between statistics summaries */
+                        interval = atoi(optarg);
+                        break;
+                case 'j': /* receive workers */
+                        workers = atoi(optarg);
+                        break;
+                case 'U': /* receive and write through io_uring */
+                        use_uring = 1;
+                        break;
+                case 'z': /* the transfers are compressed */
+                        compressed = 1;
+                        break;
                 case 't': /* TOS */
-                        encoding_type = TOS;
-                        encoding_name = "TOS";
+                        encoding_name = "tos";
                         break;
                 case 'l': /* TTL */
-                        encoding_type = TTL;
-                        encoding_name = "TTL";
+                        encoding_name = "ttl";
+                        break;
+                case 'L': /* multi-field layout */
+                        encoding_name = optarg;
                         break;
                 }
         }
         
-        if(encoding_type == 0) {
-                printf("Please select an encoding type (-u or -w)\n");
+        if(getuid() != 0 && mode != CAPTURE_PCAP) {
+                perror("\nYou must run this in root!\n");
+                return 1;
+        }
+        
+        if(encoding_name == NULL) {
+                printf("Please select an encoding type (-t, -l or -L)\n");
+                return 2;
+        }
+        
+        if(layoutParse(encoding_name, &layout) < 0) {
+                printf("Invalid layout %s\n", encoding_name);
                 return 2;
         }
         
+        if(mode == CAPTURE_PCAP) { /* a file may hold either family */
+                dual = 1;
+        }
+        layout6 = layout;
+        have4 = layoutFamily(&layout, AF_INET) == 0;
+        have6 = dual && layoutFamily(&layout6, AF_INET6) == 0;
+        if(!have4 && !have6) {
+                printf("Layout %s is only carried over IPv6, capture it "
+                        "with -6\n", encoding_name);
+                return 2;
+        }
+        
+        if(source_ip != NULL && !IN6_IS_ADDR_V4MAPPED(source_ip) && !dual) {
+                printf("An IPv6 source is only captured with -6\n");
+                return 12;
+        }
+        
+        if(batch < 1 || batch > MAX_RBATCH) {
+                printf("Batch size must be between 1 and %d\n", MAX_RBATCH);
+                return 3;
+        }
+        
+        if(window < 1 || window > MAX_WINDOW) {
+                printf("Window must be between 1 and %d\n", MAX_WINDOW);
+                return 5;
+        }
+        
+        if(idle < 1) {
+                printf("Idle timeout must be at least 1 second\n");
+                return 6;
+        }
+        
+        if(block_kb < 1 || flush_ms < 1) {
+                printf("Output block size and flush interval must be "
+                        "positive\n");
+                return 7;
+        }
+        
+        if(fec_name != NULL) {
+                if(fecInit(&fec, fec_name, layout.bits) < 0) {
+                        printf("Invalid FEC code %s, k:m with k from 1 to %d "
+                                "and m from 1 to %d\n", fec_name, MAX_DATA,
+                                MAX_PARITY);
+                        return 8;
+                }
+                code = &fec;
+        }
+        
+        if(interval < 0) {
+                printf("Statistics interval must not be negative\n");
+                return 10;
+        }
+        
+        if(workers < 1 || workers > MAX_WORKERS) {
+                printf("Workers must be between 1 and %d\n", MAX_WORKERS);
+                return 11;
+        }
+        
+        if(workers > 1 && mode == CAPTURE_PCAP) {
+                printf("A pcap file is read by one worker\n");
+                return 11;
+        }
+        
+        if(workers > 1 && use_uring) {
+                printf("io_uring is driven by one worker\n");
+                return 11;
+        }
+        
+        if(use_uring && mode == CAPTURE_SOCK) {
+                mode = CAPTURE_URING;
+        }
+        
+        if(workers > 1) { /* fanout needs packet sockets */
+                mode = CAPTURE_RING;
+                threaded = 1;
+        }
+        
+        if(feedback_name != NULL && mode == CAPTURE_PCAP) {
+                printf("Feedback cannot be sent while reading a pcap file\n");
+                return 9;
+        }
+        
+        if((pool.workers = (PWORKER)calloc(workers, sizeof(WORKER))) == NULL) {
+                perror("Cannot allocate the workers");
+                return 11;
+        }
+        pool.count = workers;
+        pool.numbers = 0;
+        pool.output = &output;
+        if(cpus < 1) {
+                cpus = 1;
+        }
+        
+        for(i = 0; i < workers; i++) {
+                worker = &pool.workers[i];
+                worker->index = i;
+                worker->cpu = i % cpus;
+                worker->source = source_ip;
+                worker->port = port;
+                worker->layout = have4 ? &layout : NULL;
+                worker->layout6 = have6 ? &layout6 : NULL;
+                worker->flush_ms = flush_ms;
+                if(feedback_name != NULL && reporterOpen(&worker->reporter,
+                                feedback_name) < 0) {
+                        printf("Invalid feedback address %s, [host:]port\n",
+                                feedback_name);
+                        return 9;
+                }
+        }
+        
         printf("Covert Data Transfer using TCP Version %s (Server)\n", VERSION);
         printf("Karl Castillo (c)\n\n");
         printf("Source IP: %s\n", source_name);
+        printf("Port: %d\n", port);
         printf("File Name: %s\n", file_name);
-        printf("Encoding: %s\n\n", encoding_name);
+        layoutReport(have4 ? &layout : &layout6, stdout);
+        printf("Families: %s\n", have4 && have6 ? "IPv4 and IPv6" :
+                have4 ? "IPv4" : "IPv6");
+        printf("Reassembly Window: %d packets\n", window);
+        printf("Compression: %s\n", compressed ? "on" : "off");
+        fecReport(code, stdout);
+        printf("Feedback: %s\n", feedback_name != NULL ? feedback_name : "off");
+        printf("Session Idle Timeout: %d s\n", idle);
+        printf("Output: %d KB blocks, flushed every %d ms, %s\n", block_kb,
+                flush_ms, threaded ? "writer thread" : use_uring ? "io_uring" :
+                "inline");
+        if(interval > 0) {
+                printf("Statistics: every %d s and on SIGUSR1\n", interval);
+        } else {
+                printf("Statistics: on SIGUSR1\n");
+        }
+        if(workers > 1) {
+                printf("Workers: %d, fanout group %d, an output lane each\n",
+                        workers, group);
+        }
+        
+        if(use_uring && uringOpen(&uring, DEF_BLOCKS * 2, URING_CQES) < 0) {
+                perror("Cannot set up io_uring");
+                return 4;
+        }
+        
+        for(i = 0; i < workers; i++) {
+                worker = &pool.workers[i];
+                if(mode == CAPTURE_URING) {
+                        if(captureOpenUring(&worker->capture, batch, rcvbuf,
+                                        dual, &uring) < 0) {
+                                perror("Cannot open the io_uring capture");
+                                return 4;
+                        }
+                } else if(mode == CAPTURE_PCAP) {
+                        if(captureOpenPcap(&worker->capture, pcap_name,
+                                        batch) < 0) {
+                                perror("Cannot open the pcap file");
+                                return 4;
+                        }
+                } else if(mode == CAPTURE_RING) {
+                        if(captureOpenRing(&worker->capture, batch,
+                                        ring_blocks, ring_kb * 1024,
+                                        huge, dual) < 0) {
+                                perror("Cannot open capture ring");
+                                return 4;
+                        }
+                } else {
+                        if(captureOpen(&worker->capture, batch, rcvbuf,
+                                        dual) < 0) {
+                                perror("Cannot open socket");
+                                return 4;
+                        }
+                }
+                
+                if(mode != CAPTURE_PCAP && filterAttach(worker->capture.sock,
+                                source_ip, port) < 0) {
+                        perror("Cannot attach filter");
+                        return 4;
+                }
+                
+                if(workers > 1 && filterFanout(worker->capture.sock, group,
+                                workers) < 0) {
+                        perror("Cannot join the fanout group");
+                        return 4;
+                }
+        }
+        
+        worker = &pool.workers[0];
+        if(mode == CAPTURE_PCAP) {
+                printf("Capture: pcap file %s\n\n", pcap_name);
+        } else if(mode == CAPTURE_RING) {
+                printf("Capture: ring, %d x %d KB blocks%s\n\n",
+                        worker->capture.blocks,
+                        worker->capture.block_size / 1024,
+                        workers > 1 ? " per worker" : "");
+        } else if(mode == CAPTURE_URING) {
+                printf("Capture: io_uring, %d buffers, %d byte receive "
+                        "buffer\n\n", worker->capture.bufs.count,
+                        worker->capture.rcvbuf);
+        } else {
+                printf("Capture: socket, %d byte receive buffer\n\n",
+                        worker->capture.rcvbuf);
+        }
+        
+        if(outputInit(&output, block_kb * 1024, DEF_BLOCKS, threaded,
+                        workers > 1 ? workers : 0) < 0) {
+                perror("Cannot start writer thread");
+                return 7;
+        }
+        if(use_uring && !threaded && outputUring(&output, &uring) < 0) {
+                perror("Cannot allocate the output blocks");
+                return 7;
+        }
         
-        doDecoding(source_ip, port, file_name, encoding_type);
+        for(i = 0; i < workers; i++) {
+                worker = &pool.workers[i];
+                sessionsInit(&worker->sessions, file_name, layout.bits, window,
+                        idle, &output, verbose);
+                worker->sessions.compressed = compressed;
+                worker->sessions.fec = code;
+                worker->sessions.lane = outputLane(&output, i);
+                worker->sessions.numbers = &pool.numbers;
+                statsInit(&worker->stats, 0);
+                worker->sessions.stats = &worker->stats;
+                if(feedback_name != NULL) {
+                        worker->sessions.reporter = &worker->reporter;
+                }
+        }
+        
+        if(workers == 1) {
+                statsInit(&worker->stats, interval);
+                worker->stats.dump = doStats;
+                worker->stats.context = &pool;
+                pool.stats = &worker->stats;
+                doDecoding(source_ip, port, &worker->sessions,
+                        worker->layout, worker->layout6, &worker->capture,
+                        flush_ms);
+        } else {
+                statsInit(&stats, interval);
+                pool.stats = &stats;
+                if(statsStart(&stats, doStats, &pool) < 0) {
+                        perror("Cannot start the statistics");
+                }
+                for(started = 0; started < workers; started++) {
+                        if(pthread_create(&pool.workers[started].thread, NULL,
+                                        doWorker,
+                                        &pool.workers[started]) != 0) {
+                                perror("Cannot start a worker");
+                                running = 0;
+                                break;
+                        }
+                }
+                for(i = 0; i < started; i++) {
+                        pthread_join(pool.workers[i].thread, NULL);
+                }
+                statsStop(&stats);
+                if(started < workers) {
+                        return 11;
+                }
+        }
+        
+        memset(&stats.latency, 0, sizeof(HIST));
+        stats.lost = 0;
+        stats.stale = 0;
+        for(i = 0; i < workers; i++) {
+                worker = &pool.workers[i];
+                if(workers > 1) {
+                        printf("Worker %d, CPU %d:\n", i, worker->cpu);
+                }
+                captureReport(&worker->capture, stdout);
+                sessionsReport(&worker->sessions, stdout);
+                histMerge(&stats.latency, &worker->stats.latency);
+                stats.lost += worker->stats.lost;
+                stats.stale += worker->stats.stale;
+                captureClose(&worker->capture);
+        }
+        histReport(&stats.latency, "Latency", stdout);
+        printf("Loss: %lu packets lost, %lu dropped as those of a transfer "
+                "already done\n", stats.lost, stats.stale);
+        
+        outputClose(&output);
+        outputReport(&output, stdout);
+        if(use_uring) {
+                uringReport(&uring, stdout);
+                uringClose(&uring);
+        }
+        for(i = 0; i < workers && feedback_name != NULL; i++) {
+                reporterReport(&pool.workers[i].reporter, stdout);
+                reporterClose(&pool.workers[i].reporter);
+        }
+        if(code != NULL) {
+                fecClose(code);
+        }
+        free(pool.workers);
         
         return 0;
 }
@@ -134,67 +593,249 @@ int main(int argc, char* argv[])
 * DATE: September 13, 2012
 *
 * REVISIONS: (Date and Description)
+* October 18, 2026: One socket is kept open for the whole run and drained in
+*       batches with recvmmsg.
+* October 18, 2026: The capture is opened by the caller so either backend can
+*       be used.
+* October 18, 2026: Only packets sent to port are decoded; the kernel filter
+*       normally drops the others before we see them.
+* October 18, 2026: The payload is unpacked from the fields of a layout.
+* October 18, 2026: Packets are put back in order by their sequence number
+*       before they are written.
+* October 18, 2026: Packets of a parallel client are counted per flow.
+* October 18, 2026: Packets are handed to the session of their client, and
+*       any client is accepted when no source is given.
+* October 18, 2026: The output goes through the buffered output stage and
+*       the bytes are only echoed in verbose mode.
+* October 18, 2026: Parity packets are handed to the FEC decoder of the
+*       session.
+* October 18, 2026: Sessions are reported back to their clients, and probes
+*       are answered with a report.
+* October 18, 2026: Decoding stops at the end of a pcap capture.
+* October 18, 2026: Packets are counted as filtered or decoded, carry their
+*       arrival time to the reassembler, and statistics are shown when due.
+* October 18, 2026: Runs in every receive worker. The statistics are shown
+*       through the dump set by the caller, which also reports the capture.
+* October 18, 2026: The payload of a whole batch is decoded at once by the
+*       kernels of the layout.
+* October 18, 2026: IPv6 packets are decoded with a layout of their own, and
+*       clients are keyed by IPv6 address.
 *
 * DESIGNER: Karl Castillo (c)
 *
 * PROGRAMMER: Karl Castillo (c)
 *
-* INTERFACE: void doDecoding(unsigned short port, char* file_name, int type)
-* port: the port where the data will be coming from
-* file_name: the name of the output file where the data will be written in
-* type: the type of encoding
-*       1: TOS
-*       2: TTL
+* INTERFACE: void doDecoding(const struct in6_addr *source,
+*       unsigned short port, PSESSIONS sessions, PLAYOUT layout,
+*       PLAYOUT layout6, PCAPTURE capture, int flush_ms)
+* source: the address the data will be coming from, an IPv4 address as an
+*       IPv4-mapped one, NULL for any
+* port: the port where the data is sent to
+* sessions: the session table, with the output file pattern
+* layout: the header fields that carry the payload, NULL to ignore IPv4
+* layout6: the same fields over IPv6, NULL to ignore IPv6
+* capture: the open capture the packets are read from
+* flush_ms: the longest partly filled output blocks are held
 *
 * RETURN: void
 *
 * NOTES:
 * DoDecoding is where the server reads from the socket and properly decodes
-* the packet for writing in the file. The data might be stored in the TOS field,
-* or TTL.
+* the packet for writing in the file. The data might be stored in any of the
+* fields of the layout. The acknowledgement number of a packet is its place in
+* the transfer, so packets may arrive in any order. The packet marked as the
+* last of a transfer says how many of its bits are payload, and the next
+* packet starts a new transfer.
+*
+* A parallel client sends from several source ports at once. The low bits of
+* the TCP window of a packet say which of its flows sent it; all flows number
+* their packets in the same transfer, so they merge in the reassembler. The
+* bits above are the id of the run, which tells the reassembler a late packet
+* of the transfer it just finished from the start of the next one.
+*
+* Every client has a session of its own, keyed by its address, the port of
+* its first flow and the destination port. The capture wakes up regularly so
+* that idle sessions are closed and partly filled output blocks are flushed
+* even when nothing arrives. With feedback it wakes up every FEED_MS so the
+* reports leave on time. A capture read from a pcap file ends with the file,
+* and the sessions are closed as when the server is stopped.
+*
+* The statistics are looked at after every batch when this loop shows them.
+* A signal asking for them interrupts the wait for packets, so they are shown
+* at once. Workers leave that to the monitor thread and only keep their
+* counters.
+*
+* The payload of every packet in a batch is taken out before any of them is
+* looked at. The IPv4 packets are gathered at the front of the batch and the
+* IPv6 ones at the back, so each family is decoded by its own kernels in one
+* pass. The kernels take the TCP header to follow a fixed IP header, so an
+* IPv4 packet with options is left out with those too short to hold the
+* headers or of a family that is not decoded, and filtered as before.
 *******************************************************************************/
-void doDecoding(unsigned int source, unsigned short port, char* file_name, int type)
+void doDecoding(const struct in6_addr *source, unsigned short port,
+        PSESSIONS sessions, PLAYOUT layout, PLAYOUT layout6, PCAPTURE capture,
+        int flush_ms)
 {
-        PRECVHDR recvhdr = (PRECVHDR)malloc(sizeof(RECVHDR));
-        FILE *file;
-        int sock;
+        unsigned char *ip;
+        struct tcphdr *tcp;
+        struct in6_addr saddr;
+        PSESSION session;
+        PSTATS stats = sessions->stats;
+        const void *packets[MAX_RBATCH];
+        unsigned long long words[MAX_RBATCH];
+        int slots[MAX_RBATCH];
+        int n4;
+        int n6;
+        unsigned long long word;
+        long long stamp;
+        struct timespec now;
+        time_t expired = 0;
+        long long flushed = 0;
+        long long ms;
+        unsigned short sport;
+        int flow;
+        int transfer;
+        int valid;
+        int done;
+        int due;
+        struct sigaction sa;
+        int n;
+        int i;
         
-        if((file = fopen(file_name, "wb")) == NULL) {
-                fprintf(stderr, "Cannot open %s", file_name);
-                exit(1);
-        }
+        memset(&sa, 0, sizeof(sa));
+        sa.sa_handler = stopDecoding;
+        sigaction(SIGINT, &sa, NULL);
+        sigaction(SIGTERM, &sa, NULL);
         
+        captureTimeout(capture, sessions->reporter != NULL ? FEED_MS :
+                flush_ms < 1000 ? flush_ms : 1000);
         
-        while(1) {
-                if((sock = socket(AF_INET, SOCK_RAW, 6)) < 0) {
-                        perror("Cannot open socket");
-                        exit(2);
+        while(running && !capture->ended) {
+                if((n = captureNext(capture)) < 0) {
+                        if(errno != EINTR) {
+                                perror("Cannot read socket");
+                                break;
+                        }
+                        n = 0;
                 }
                 
-                read(sock, recvhdr, 9999);
+                clock_gettime(CLOCK_MONOTONIC, &now);
+                stats->now = statsClock();
+                if(now.tv_sec != expired) {
+                        sessionsExpire(sessions, now.tv_sec);
+                        expired = now.tv_sec;
+                }
+                ms = now.tv_sec * 1000LL + now.tv_nsec / 1000000;
+                if(ms - flushed >= flush_ms) {
+                        sessionsFlush(sessions);
+                        flushed = ms;
+                }
+                
+                n4 = 0;
+                n6 = n;
+                for(i = 0; i < n; i++) {
+                        ip = (unsigned char*)capture->frames[i];
+                        if(layout != NULL && capture->lens[i] >= 40 &&
+                                        ip[0] == 0x45) {
+                                slots[i] = n4;
+                                packets[n4++] = ip;
+                        } else if(layout6 != NULL && capture->lens[i] >= 60 &&
+                                        (ip[0] >> 4) == 6) {
+                                slots[i] = --n6;
+                                packets[n6] = ip;
+                        } else {
+                                slots[i] = -1;
+                        }
+                }
+                if(n4 > 0) {
+                        layoutDecode(layout, packets, words, n4);
+                }
+                if(n6 < n) {
+                        layoutDecode(layout6, packets + n6, words + n6,
+                                n - n6);
+                }
                 
-                if(recvhdr->tcp.syn == 1 && recvhdr->ip.saddr == source) {
-		        if(type == TOS) { /* data in TOS field */
-		                printf("Receiving data: %c\n", recvhdr->ip.tos);
-		                fprintf(file, "%c", recvhdr->ip.tos);
-		                fflush(file);
-		        } else if(type == TTL) { /* data found in TTL */
-		                printf("Receiving data: %c\n", 
-		                        (char)(recvhdr->ip.ttl - 64));
-		                fprintf(file, "%c", (char)(recvhdr->ip.ttl - 64));
-		                fflush(file);
-		 	}
-                }
-                close(sock);
-        }
-        free(recvhdr);
-        fclose(file);
+                for(i = 0; i < n; i++) {
+                        if(slots[i] < 0) {
+                                sessions->filtered++;
+                                continue;
+                        }
+                        ip = (unsigned char*)capture->frames[i];
+                        if((ip[0] >> 4) == 6) {
+                                tcp = (struct tcphdr*)(ip + 40);
+                                memcpy(&saddr, ip + 8, sizeof(saddr));
+                        } else {
+                                tcp = (struct tcphdr*)(ip + 20);
+                                ip_map(((struct iphdr*)ip)->saddr, &saddr);
+                        }
+                        
+                        if(tcp->syn == 1 && (source == NULL ||
+                                        IN6_ARE_ADDR_EQUAL(&saddr, source)) &&
+                                        tcp->dest == htons(port)) {
+                                sport = ntohs(tcp->source);
+                                flow = ntohs(tcp->window) & (MAX_FLOWS - 1);
+                                transfer = ntohs(tcp->window) >> FLOW_BITS;
+                                
+                                if((session = sessionFind(sessions, &saddr,
+                                                sport - flow, port,
+                                                now.tv_sec)) == NULL) {
+                                        sessions->filtered++;
+                                        continue;
+                                }
+                                session->packets++;
+                                session->flows |= 1ULL << flow;
+                                session->dirty = 1;
+                                
+                                if(tcp->res1 == FEED_PROBE) {
+                                        continue;
+                                }
+                                
+                                sessions->decoded++;
+                                stamp = capture->stamps[i] != 0 ?
+                                        capture->stamps[i] : stats->now;
+                                word = words[slots[i]];
+                                valid = -1;
+                                if(tcp->psh) { /* end of transfer */
+                                        valid = ntohs(tcp->urg_ptr) & 0xff;
+                                        if(valid >= sessions->bits) {
+                                                valid = sessions->bits - 1;
+                                        }
+                                }
+                                
+                                if(tcp->res1 & FEC_PARITY) {
+                                        done = reasmParity(&session->reasm,
+                                                ntohl(tcp->ack_seq),
+                                                tcp->res1 & ~FEC_PARITY, word,
+                                                ntohs(tcp->urg_ptr) >> 8,
+                                                valid, transfer, stamp);
+                                } else {
+                                        done = reasmPush(&session->reasm,
+                                                ntohl(tcp->ack_seq), word,
+                                                valid, transfer, stamp);
+                                }
+                                if(done) {
+                                        session->repeats = FEED_REPEATS;
+                                }
+                        } else {
+                                sessions->filtered++;
+                        }
+                }
+                
+                if(sessions->reporter != NULL) {
+                        sessionsFeedback(sessions, ms, n < capture->batch);
+                }
+                
+                if(stats->dump != NULL && (due = statsDue(stats)) != 0) {
+                        stats->dump(stats->context, due);
+                }
+        }
+        sessionsClose(sessions);
 }
 
 /*******************************************************************************
-* FUNCTION: ip_convert
+* FUNCTION: doStats
 *
-* DATE: September 13, 2012
+* DATE: October 18, 2026
 *
 * REVISIONS: (Date and Description)
 *
@@ -202,25 +843,144 @@ void doDecoding(unsigned int source, unsigned short port, char* file_name, int t
 *
 * PROGRAMMER: Karl Castillo (c)
 *
-* INTERFACE: unsigned int ip_convert(char *hostname)
-* hostname: the ip address that will be converted
+* INTERFACE: void doStats(void *context, int due)
+* context: the pool of workers
+* due: STATS_LINE for the one-line summary, STATS_JSON for the JSON dump
 *
-* RETURN: unsigned int: converted hostname
+* RETURN: void
 *
 * NOTES:
-* Converts a hostname to the proper format for the socket
+* The rate and the batch fill are those since the last time the statistics
+* were shown; everything else counts from the start. Packets are filtered
+* when they are not for us, and decoded when they reach a session. Bytes are
+* counted once they are written to the output files. Lost packets are those
+* written as zeros or never written, and stale ones those dropped as packets
+* of a transfer already done; either means missing data.
+*
+* With several workers this runs in the monitor thread while they keep
+* counting, so a summary may be a packet or two behind.
 *******************************************************************************/
-unsigned int ip_convert(char *hostname)
+void doStats(void *context, int due)
 {
-        static struct in_addr inaddr;
-        struct hostent *host;
+        PPOOL pool = (PPOOL)context;
+        PSTATS stats = pool->stats;
+        PWORKER worker;
+        HIST latency;
+        double uptime = statsNow() - stats->started;
+        unsigned long received = 0;
+        unsigned long batches = 0;
+        unsigned long filtered = 0;
+        unsigned long decoded = 0;
+        unsigned long lost = 0;
+        unsigned long stale = 0;
+        unsigned int drops = 0;
+        int active = 0;
+        int i;
         
-        if((inaddr.s_addr = inet_addr(hostname)) == 0) {
-                if((host = gethostbyname(hostname)) == NULL) {
-                        fprintf(stderr, "Cannot resolve %s\n", hostname);
-                        exit(3);
-                }
-                bcopy(host->h_addr, (char*)&inaddr.s_addr, host->h_length);
+        memset(&latency, 0, sizeof(HIST));
+        for(i = 0; i < pool->count; i++) {
+                worker = &pool->workers[i];
+                received += worker->capture.received;
+                batches += worker->capture.batches;
+                filtered += worker->sessions.filtered;
+                decoded += worker->sessions.decoded;
+                drops += captureDrops(&worker->capture);
+                active += worker->sessions.active;
+                lost += worker->stats.lost;
+                stale += worker->stats.stale;
+                histMerge(&latency, &worker->stats.latency);
         }
-        return inaddr.s_addr;
+        
+        statsMark(stats, received, batches, due);
+        
+        if(due & STATS_LINE) {
+                printf("Stats: %.1f s, %lu received (%.0f/s, %.1f of %d per "
+                        "batch), %lu filtered, %lu decoded, %lu bytes written, "
+                        "%u dropped, %lu lost, %lu stale, latency p50 %.0f us "
+                        "p99 %.0f us\n", uptime, received, stats->rate,
+                        stats->fill, pool->workers[0].capture.batch, filtered,
+                        decoded, pool->output->bytes, drops, lost, stale,
+                        histPercentile(&latency, 0.5),
+                        histPercentile(&latency, 0.99));
+        }
+        
+        if(due & STATS_JSON) {
+                printf("{\"side\":\"server\",\"uptime_s\":%.3f,"
+                        "\"workers\":%d,\"received\":%lu,\"batches\":%lu,"
+                        "\"batch_size\":%d,\"batch_fill\":%.2f,"
+                        "\"rate_pps\":%.0f,\"filtered\":%lu,"
+                        "\"decoded\":%lu,\"bytes_written\":%lu,"
+                        "\"write_errors\":%lu,\"dropped\":%u,\"lost\":%lu,"
+                        "\"stale\":%lu,\"sessions\":%d,\"latency_us\":",
+                        uptime, pool->count, received, batches,
+                        pool->workers[0].capture.batch, stats->fill,
+                        stats->rate, filtered, decoded, pool->output->bytes,
+                        pool->output->errors, drops, lost, stale, active);
+                histJson(&latency, stdout);
+                printf("}\n");
+        }
+        
+        fflush(stdout);
+}
+
+/*******************************************************************************
+* FUNCTION: doWorker
+*
+* DATE: October 18, 2026
+*
+* REVISIONS: (Date and Description)
+*
+* DESIGNER: Karl Castillo (c)
+*
+* PROGRAMMER: Karl Castillo (c)
+*
+* INTERFACE: void *doWorker(void *arg)
+* arg: the worker
+*
+* RETURN: void *: NULL
+*
+* NOTES:
+* A receive worker, pinned to its CPU like the flows of the client. It
+* decodes what the fanout group hands its socket until the server stops.
+*******************************************************************************/
+void *doWorker(void *arg)
+{
+        PWORKER worker = (PWORKER)arg;
+        cpu_set_t cpus;
+        
+        CPU_ZERO(&cpus);
+        CPU_SET(worker->cpu, &cpus);
+        pthread_setaffinity_np(pthread_self(), sizeof(cpus), &cpus);
+        
+        doDecoding(worker->source, worker->port, &worker->sessions,
+                worker->layout, worker->layout6, &worker->capture,
+                worker->flush_ms);
+        
+        return NULL;
+}
+
+/*******************************************************************************
+* FUNCTION: stopDecoding
+*
+* DATE: October 18, 2026
+*
+* REVISIONS: (Date and Description)
+*
+* DESIGNER: Karl Castillo (c)
+*
+* PROGRAMMER: Karl Castillo (c)
+*
+* INTERFACE: void stopDecoding(int sig)
+* sig: the signal that was caught
+*
+* RETURN: void
+*
+* NOTES:
+* Lets the receive loop finish so the capture statistics are reported and the
+* output file is closed.
+*******************************************************************************/
+void stopDecoding(int sig)
+{
+        (void)sig;
+        running = 0;
 }
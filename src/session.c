@@ -0,0 +1,534 @@
+/*******************************************************************************
+* SOURCE FILE: session.c
+*
+* PROGRAM: Covert
+*
+* FUNCTIONS:
+* int sessionsInit(PSESSIONS sessions, char *pattern, int bits, int window,
+*        int idle, POUTPUT output, int verbose);
+* PSESSION sessionFind(PSESSIONS sessions, const struct in6_addr *addr,
+*        unsigned short sport, unsigned short dport, time_t now);
+* void sessionsExpire(PSESSIONS sessions, time_t now);
+* void sessionsFlush(PSESSIONS sessions);
+* void sessionsFeedback(PSESSIONS sessions, long long ms, int now);
+* void sessionsClose(PSESSIONS sessions);
+* void sessionsReport(PSESSIONS sessions, FILE *out);
+* static unsigned int sessionHash(const struct in6_addr *addr,
+*        unsigned short sport, unsigned short dport);
+* static void sessionName(PSESSIONS sessions, PSESSION session);
+* static void sessionFree(PSESSIONS sessions, PSESSION session);
+*
+* DATE: October 18, 2026
+*
+* DESIGNER: Karl Castillo (c)
+*
+* PROGRAMMER: Karl Castillo (c)
+*
+* NOTES:
+* Sessions live in a chained hash table. A session is opened by the first
+* packet of a client and closed once it has been quiet for the idle timeout;
+* transfers that follow each other from the same client before then are
+* written one after the other to the same file.
+*
+* The output file is named after the pattern given with -f:
+*       %a the client address, %p its port, %d the destination port and
+*       %n the number of the session
+* A pattern without any of these names the first session's file and the
+* session number is appended for the others. An IPv4 client is keyed by its
+* IPv4-mapped address but always shown in IPv4 form.
+*
+* With feedback every session that received packets is reported to its
+* client, at most every FEED_MS while packets keep coming and right away once
+* the capture has caught up, since that is when a client may be waiting for
+* the report. A completed transfer is reported a few more times in case a
+* report is lost on the way.
+*******************************************************************************/
+/* INCLUDES */
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include <arpa/inet.h>
+#include "session.h"
+
+/* PROTOTYPES */
+static unsigned int sessionHash(const struct in6_addr *addr,
+        unsigned short sport, unsigned short dport);
+static void sessionName(PSESSIONS sessions, PSESSION session);
+static void sessionFree(PSESSIONS sessions, PSESSION session);
+
+/*******************************************************************************
+* FUNCTION: sessionsInit
+*
+* DATE: October 18, 2026
+*
+* REVISIONS: (Date and Description)
+*
+* DESIGNER: Karl Castillo (c)
+*
+* PROGRAMMER: Karl Castillo (c)
+*
+* INTERFACE: int sessionsInit(PSESSIONS sessions, char *pattern, int bits,
+*       int window, int idle, POUTPUT output, int verbose)
+* sessions: the table to initialize
+* pattern: names the output file of every session
+* bits: the payload bits per packet of the layout
+* window: the reassembly window of every session
+* idle: seconds a session may be quiet before it is closed
+* output: the stage that writes the output files
+* verbose: echo every byte received
+*
+* RETURN: int: 0
+*******************************************************************************/
+int sessionsInit(PSESSIONS sessions, char *pattern, int bits, int window,
+        int idle, POUTPUT output, int verbose)
+{
+        memset(sessions, 0, sizeof(SESSIONS));
+        sessions->pattern = pattern;
+        sessions->bits = bits;
+        sessions->window = window;
+        sessions->idle = idle;
+        sessions->output = output;
+        sessions->verbose = verbose;
+
+        return 0;
+}
+
+/*******************************************************************************
+* FUNCTION: sessionFind
+*
+* DATE: October 18, 2026
+*
+* REVISIONS: (Date and Description)
+*
+* DESIGNER: Karl Castillo (c)
+*
+* PROGRAMMER: Karl Castillo (c)
+*
+* INTERFACE: PSESSION sessionFind(PSESSIONS sessions,
+*       const struct in6_addr *addr, unsigned short sport,
+*       unsigned short dport, time_t now)
+* sessions: the table
+* addr: the client address, an IPv4 client as an IPv4-mapped address
+* sport: the port of the client's first flow
+* dport: the port the client sends to
+* now: the current time in seconds
+*
+* RETURN: PSESSION: the session, NULL if a new one could not be opened
+*
+* NOTES:
+* Opens the session when it is not in the table yet. Sessions are numbered
+* from the counter shared by the receive workers when there is one.
+*******************************************************************************/
+PSESSION sessionFind(PSESSIONS sessions, const struct in6_addr *addr,
+        unsigned short sport, unsigned short dport, time_t now)
+{
+        unsigned int bucket = sessionHash(addr, sport, dport);
+        PSESSION session;
+
+        for(session = sessions->buckets[bucket]; session != NULL;
+                        session = session->next) {
+                if(IN6_ARE_ADDR_EQUAL(&session->addr, addr) &&
+                                session->sport == sport &&
+                                session->dport == dport) {
+                        session->last = now;
+                        return session;
+                }
+        }
+
+        if((session = (PSESSION)calloc(1, sizeof(SESSION))) == NULL) {
+                return NULL;
+        }
+        session->addr = *addr;
+        if(IN6_IS_ADDR_V4MAPPED(addr)) {
+                inet_ntop(AF_INET, &addr->s6_addr[12], session->host,
+                        sizeof(session->host));
+        } else {
+                inet_ntop(AF_INET6, addr, session->host,
+                        sizeof(session->host));
+        }
+        session->sport = sport;
+        session->dport = dport;
+        session->number = sessions->numbers != NULL ?
+                __atomic_fetch_add(sessions->numbers, 1, __ATOMIC_RELAXED) :
+                (int)sessions->opened;
+        session->last = now;
+        sessionName(sessions, session);
+
+        if(writerOpen(&session->writer, sessions->output, session->name) < 0) {
+                fprintf(stderr, "Cannot open %s\n", session->name);
+                free(session);
+                return NULL;
+        }
+        session->writer.lane = sessions->lane;
+        if(reasmInit(&session->reasm, sessions->bits, sessions->window,
+                        &session->writer) < 0) {
+                writerClose(&session->writer);
+                free(session);
+                return NULL;
+        }
+        session->reasm.echo = sessions->verbose;
+        session->reasm.stats = sessions->stats;
+        if(sessions->compressed) {
+                if(unlzInit(&session->unlz) < 0) {
+                        reasmClose(&session->reasm);
+                        writerClose(&session->writer);
+                        free(session);
+                        return NULL;
+                }
+                session->reasm.unlz = &session->unlz;
+        }
+        if(sessions->fec != NULL) {
+                if(unfecInit(&session->unfec, sessions->fec,
+                                sessions->window) < 0) {
+                        if(session->reasm.unlz != NULL) {
+                                unlzClose(&session->unlz);
+                        }
+                        reasmClose(&session->reasm);
+                        writerClose(&session->writer);
+                        free(session);
+                        return NULL;
+                }
+                session->reasm.unfec = &session->unfec;
+        }
+
+        session->next = sessions->buckets[bucket];
+        sessions->buckets[bucket] = session;
+        sessions->opened++;
+        if(++sessions->active > sessions->peak) {
+                sessions->peak = sessions->active;
+        }
+
+        printf("Session %d: %s:%d -> %d, writing %s\n", session->number,
+                session->host, sport, dport,
+                session->name);
+
+        return session;
+}
+
+/*******************************************************************************
+* FUNCTION: sessionsExpire
+*
+* DATE: October 18, 2026
+*
+* REVISIONS: (Date and Description)
+*
+* DESIGNER: Karl Castillo (c)
+*
+* PROGRAMMER: Karl Castillo (c)
+*
+* INTERFACE: void sessionsExpire(PSESSIONS sessions, time_t now)
+* sessions: the table
+* now: the current time in seconds
+*
+* RETURN: void
+*
+* NOTES:
+* Walks the whole table, so it is meant to be called about once a second.
+*******************************************************************************/
+void sessionsExpire(PSESSIONS sessions, time_t now)
+{
+        PSESSION *link;
+        PSESSION session;
+        int i;
+
+        for(i = 0; i < SESSION_BUCKETS; i++) {
+                link = &sessions->buckets[i];
+                while((session = *link) != NULL) {
+                        if(now - session->last >= sessions->idle) {
+                                *link = session->next;
+                                sessions->expired++;
+                                sessionFree(sessions, session);
+                        } else {
+                                link = &session->next;
+                        }
+                }
+        }
+}
+
+/*******************************************************************************
+* FUNCTION: sessionsFlush
+*
+* DATE: October 18, 2026
+*
+* REVISIONS: (Date and Description)
+*
+* DESIGNER: Karl Castillo (c)
+*
+* PROGRAMMER: Karl Castillo (c)
+*
+* INTERFACE: void sessionsFlush(PSESSIONS sessions)
+* sessions: the table
+*
+* RETURN: void
+*
+* NOTES:
+* Hands every partly filled block to the output stage, so a slow transfer
+* still reaches the disk regularly.
+*******************************************************************************/
+void sessionsFlush(PSESSIONS sessions)
+{
+        PSESSION session;
+        int i;
+
+        for(i = 0; i < SESSION_BUCKETS; i++) {
+                for(session = sessions->buckets[i]; session != NULL;
+                                session = session->next) {
+                        writerFlush(&session->writer);
+                }
+        }
+}
+
+/*******************************************************************************
+* FUNCTION: sessionsFeedback
+*
+* DATE: October 18, 2026
+*
+* REVISIONS: (Date and Description)
+*
+* DESIGNER: Karl Castillo (c)
+*
+* PROGRAMMER: Karl Castillo (c)
+*
+* INTERFACE: void sessionsFeedback(PSESSIONS sessions, long long ms,
+*       int now)
+* sessions: the table, with its reporter
+* ms: the current time in ms
+* now: report the sessions that received packets without waiting FEED_MS
+*
+* RETURN: void
+*******************************************************************************/
+void sessionsFeedback(PSESSIONS sessions, long long ms, int now)
+{
+        PSESSION session;
+        PREASM reasm;
+        REPORT report;
+        int i;
+
+        for(i = 0; i < SESSION_BUCKETS; i++) {
+                for(session = sessions->buckets[i]; session != NULL;
+                                session = session->next) {
+                        if(session->dirty ? !now &&
+                                        ms - session->reported < FEED_MS :
+                                        session->repeats == 0 ||
+                                        ms - session->reported < FEED_MS) {
+                                continue;
+                        }
+                        if(!session->dirty) {
+                                session->repeats--;
+                        }
+                        session->dirty = 0;
+                        session->reported = ms;
+
+                        reasm = &session->reasm;
+                        memset(&report, 0, sizeof(report));
+                        report.magic = htonl(FEED_MAGIC);
+                        report.sport = htons(session->sport);
+                        report.dport = htons(session->dport);
+                        report.window = htonl(reasm->window);
+                        report.transfers = htonl(reasm->transfers);
+                        report.length = htonl(reasm->length);
+                        report.next = htonl(reasm->next);
+                        report.held = htonl(reasmHeld(reasm, report.map,
+                                FEED_MAP));
+                        reporterSend(sessions->reporter, &session->addr,
+                                &report);
+                }
+        }
+}
+
+/*******************************************************************************
+* FUNCTION: sessionsClose
+*
+* DATE: October 18, 2026
+*
+* REVISIONS: (Date and Description)
+*
+* DESIGNER: Karl Castillo (c)
+*
+* PROGRAMMER: Karl Castillo (c)
+*
+* INTERFACE: void sessionsClose(PSESSIONS sessions)
+* sessions: the table
+*
+* RETURN: void
+*******************************************************************************/
+void sessionsClose(PSESSIONS sessions)
+{
+        PSESSION session;
+        int i;
+
+        for(i = 0; i < SESSION_BUCKETS; i++) {
+                while((session = sessions->buckets[i]) != NULL) {
+                        sessions->buckets[i] = session->next;
+                        sessionFree(sessions, session);
+                }
+        }
+}
+
+/*******************************************************************************
+* FUNCTION: sessionsReport
+*
+* DATE: October 18, 2026
+*
+* REVISIONS: (Date and Description)
+*
+* DESIGNER: Karl Castillo (c)
+*
+* PROGRAMMER: Karl Castillo (c)
+*
+* INTERFACE: void sessionsReport(PSESSIONS sessions, FILE *out)
+* sessions: the table
+* out: where the report will be printed
+*
+* RETURN: void
+*******************************************************************************/
+void sessionsReport(PSESSIONS sessions, FILE *out)
+{
+        fprintf(out, "Sessions: %lu opened, %lu expired, %d at most at once\n",
+                sessions->opened, sessions->expired, sessions->peak);
+}
+
+/*******************************************************************************
+* FUNCTION: sessionHash
+*
+* DATE: October 18, 2026
+*
+* REVISIONS: (Date and Description)
+*
+* DESIGNER: Karl Castillo (c)
+*
+* PROGRAMMER: Karl Castillo (c)
+*
+* INTERFACE: static unsigned int sessionHash(const struct in6_addr *addr,
+*       unsigned short sport, unsigned short dport)
+* addr: the client address
+* sport: the port of the client's first flow
+* dport: the port the client sends to
+*
+* RETURN: unsigned int: the bucket of the session
+*******************************************************************************/
+static unsigned int sessionHash(const struct in6_addr *addr,
+        unsigned short sport, unsigned short dport)
+{
+        unsigned int h = addr->s6_addr32[0] ^ addr->s6_addr32[1] ^
+                addr->s6_addr32[2] ^ addr->s6_addr32[3] ^
+                ((unsigned int)sport << 16 | dport);
+
+        h ^= h >> 16;
+        h *= 0x45d9f3b;
+        h ^= h >> 16;
+
+        return h & (SESSION_BUCKETS - 1);
+}
+
+/*******************************************************************************
+* FUNCTION: sessionName
+*
+* DATE: October 18, 2026
+*
+* REVISIONS: (Date and Description)
+*
+* DESIGNER: Karl Castillo (c)
+*
+* PROGRAMMER: Karl Castillo (c)
+*
+* INTERFACE: static void sessionName(PSESSIONS sessions, PSESSION session)
+* sessions: the table
+* session: the session to name
+*
+* RETURN: void
+*******************************************************************************/
+static void sessionName(PSESSIONS sessions, PSESSION session)
+{
+        char *name = session->name;
+        char *end = session->name + SESSION_NAME - 1;
+        char *p;
+        int expanded = 0;
+
+        for(p = sessions->pattern; *p != '\0' && name < end; p++) {
+                if(*p != '%' || p[1] == '\0') {
+                        *name++ = *p;
+                        continue;
+                }
+
+                expanded = 1;
+                switch(*++p) {
+                case 'a':
+                        name += snprintf(name, end - name + 1, "%s",
+                                session->host);
+                        break;
+                case 'p':
+                        name += snprintf(name, end - name + 1, "%d",
+                                session->sport);
+                        break;
+                case 'd':
+                        name += snprintf(name, end - name + 1, "%d",
+                                session->dport);
+                        break;
+                case 'n':
+                        name += snprintf(name, end - name + 1, "%d",
+                                session->number);
+                        break;
+                default:
+                        *name++ = *p;
+                        break;
+                }
+        }
+        if(name > end) {
+                name = end;
+        }
+        *name = '\0';
+
+        if(!expanded && session->number > 0) {
+                snprintf(name, end - name + 1, ".%d", session->number);
+        }
+}
+
+/*******************************************************************************
+* FUNCTION: sessionFree
+*
+* DATE: October 18, 2026
+*
+* REVISIONS: (Date and Description)
+*
+* DESIGNER: Karl Castillo (c)
+*
+* PROGRAMMER: Karl Castillo (c)
+*
+* INTERFACE: static void sessionFree(PSESSIONS sessions, PSESSION session)
+* sessions: the table
+* session: the session, already unlinked from the table
+*
+* RETURN: void
+*
+* NOTES:
+* Reports the session before it goes away.
+*******************************************************************************/
+static void sessionFree(PSESSIONS sessions, PSESSION session)
+{
+        int flows = 0;
+        int i;
+
+        for(i = 0; i < 64; i++) {
+                flows += (session->flows >> i) & 1;
+        }
+
+        reasmClose(&session->reasm);
+        writerClose(&session->writer);
+
+        printf("Session %d: %s:%d -> %d closed, %lu packets in %d flows\n",
+                session->number, session->host, session->sport,
+                session->dport, session->packets, flows);
+        reasmReport(&session->reasm, stdout);
+        if(session->reasm.unfec != NULL) {
+                unfecReport(&session->unfec, stdout);
+                unfecClose(&session->unfec);
+        }
+        if(session->reasm.unlz != NULL) {
+                unlzReport(&session->unlz, stdout);
+                unlzClose(&session->unlz);
+        }
+
+        sessions->active--;
+        free(session);
+}
@@ -0,0 +1,98 @@
+/*******************************************************************************
+* HEADER FILE: session.h
+*
+* PROGRAM: Covert
+*
+* FUNCTIONS:
+* int sessionsInit(PSESSIONS sessions, char *pattern, int bits, int window,
+*        int idle, POUTPUT output, int verbose);
+* PSESSION sessionFind(PSESSIONS sessions, const struct in6_addr *addr,
+*        unsigned short sport, unsigned short dport, time_t now);
+* void sessionsExpire(PSESSIONS sessions, time_t now);
+* void sessionsFlush(PSESSIONS sessions);
+* void sessionsFeedback(PSESSIONS sessions, long long ms, int now);
+* void sessionsClose(PSESSIONS sessions);
+* void sessionsReport(PSESSIONS sessions, FILE *out);
+*
+* DATE: October 18, 2026
+*
+* DESIGNER: Karl Castillo (c)
+*
+* PROGRAMMER: Karl Castillo (c)
+*
+* NOTES:
+* The session table of the server. Every client transfer has its own
+* reassembler and output file, found by source address, source port and
+* destination port.
+*******************************************************************************/
+#ifndef SESSION_H
+#define SESSION_H
+
+#include <stdio.h>
+#include <time.h>
+#include <netinet/in.h>
+#include "feedback.h"
+#include "reasm.h"
+#include "writer.h"
+
+/* DEFINES */
+#define SESSION_BUCKETS 1024    /* a power of 2 */
+#define DEF_IDLE        30      /* seconds before a quiet session is closed */
+#define SESSION_NAME    256
+
+/* STRUCTURES */
+typedef struct session {
+        struct in6_addr addr;           /* the client, IPv4 as IPv4-mapped */
+        char host[INET6_ADDRSTRLEN];    /* the client as text */
+        unsigned short sport;           /* port of its first flow, host order */
+        unsigned short dport;           /* port it sends to, host order */
+        int number;                     /* sessions opened before this one */
+        char name[SESSION_NAME];        /* the output file */
+        WRITER writer;                  /* buffers the output file */
+        REASM reasm;                    /* puts the packets back in order */
+        UNLZ unlz;                      /* decompresses the transfers */
+        UNFEC unfec;                    /* rebuilds lost packets */
+        time_t last;                    /* when the last packet arrived */
+        int dirty;                      /* packets arrived since the report */
+        int repeats;                    /* reports left of a completed transfer */
+        long long reported;             /* when the last report left, in ms */
+        unsigned long packets;          /* packets received */
+        unsigned long long flows;       /* bit n set once flow n was seen */
+        struct session *next;           /* the next session in the bucket */
+} SESSION, *PSESSION;
+
+typedef struct sessions {
+        PSESSION buckets[SESSION_BUCKETS];
+        char *pattern;                  /* names the output files */
+        int bits;                       /* payload bits per packet */
+        int window;                     /* reassembly window of a session */
+        int idle;                       /* seconds before a session expires */
+        POUTPUT output;                 /* writes the files of every session */
+        int verbose;                    /* echo every byte received */
+        int compressed;                 /* the transfers are compressed */
+        PFEC fec;                       /* the FEC code, or NULL */
+        PREPORTER reporter;             /* sends the feedback, or NULL */
+        PSTATS stats;                   /* takes the latency, or NULL */
+        PLANE lane;                     /* output lane of a worker, or NULL */
+        int *numbers;                   /* numbers the sessions of every
+                                           worker, or NULL */
+        int active;                     /* sessions open */
+        int peak;                       /* most sessions open at once */
+        unsigned long opened;           /* sessions opened */
+        unsigned long expired;          /* sessions closed for being idle */
+        unsigned long filtered;         /* packets that were not for us */
+        unsigned long decoded;          /* packets handed to a session */
+} SESSIONS, *PSESSIONS;
+
+/* PROTOTYPES */
+int sessionsInit(PSESSIONS sessions, char *pattern, int bits, int window,
+        int idle, POUTPUT output, int verbose);
+PSESSION sessionFind(PSESSIONS sessions, const struct in6_addr *addr,
+        unsigned short sport, unsigned short dport, time_t now);
+void sessionsExpire(PSESSIONS sessions, time_t now);
+void sessionsFlush(PSESSIONS sessions);
+void sessionsFeedback(PSESSIONS sessions, long long ms, int now);
+void sessionsClose(PSESSIONS sessions);
+void sessionsReport(PSESSIONS sessions, FILE *out);
+
+#endif
@@ -0,0 +1,531 @@
+/*******************************************************************************
+* SOURCE FILE: stats.c
+*
+* PROGRAM: Covert
+*
+* FUNCTIONS:
+* void statsInit(PSTATS stats, int interval);
+* int statsDue(PSTATS stats);
+* void statsMark(PSTATS stats, unsigned long packets, unsigned long batches,
+*        int due);
+* int statsStart(PSTATS stats, void (*dump)(void *context, int due),
+*        void *context);
+* void statsStop(PSTATS stats);
+* double statsNow(void);
+* long long statsClock(void);
+* void histAdd(PHIST hist, long long ns);
+* void histMerge(PHIST into, PHIST from);
+* double histPercentile(PHIST hist, double p);
+* void histJson(PHIST hist, FILE *out);
+* void histReport(PHIST hist, char *name, FILE *out);
+* static void statsSignal(int sig);
+* static void *statsMain(void *arg);
+*
+* DATE: October 18, 2026
+*
+* DESIGNER: Karl Castillo (c)
+*
+* PROGRAMMER: Karl Castillo (c)
+*
+* NOTES:
+* SIGUSR1 only raises a flag; the statistics are printed by whoever next
+* calls statsDue, outside of the signal handler. The server does so after
+* every batch it reads. The client sends from one or more threads that never
+* stop to look, so it starts a monitor thread that polls instead. The
+* counters the monitor reads are written by the send loops without a lock;
+* a summary may be a packet or two behind, which is fine for watching.
+*
+* The latency histogram has a bucket per power of two microseconds, so it
+* costs one increment per value and still spans from under a microsecond to
+* over half an hour.
+*******************************************************************************/
+/* INCLUDES */
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include <signal.h>
+#include <time.h>
+#include "stats.h"
+
+/* PROTOTYPES */
+static void statsSignal(int sig);
+static void *statsMain(void *arg);
+
+/* GLOBALS */
+static volatile sig_atomic_t requested = 0;
+
+/*******************************************************************************
+* FUNCTION: statsInit
+*
+* DATE: October 18, 2026
+*
+* REVISIONS: (Date and Description)
+*
+* DESIGNER: Karl Castillo (c)
+*
+* PROGRAMMER: Karl Castillo (c)
+*
+* INTERFACE: void statsInit(PSTATS stats, int interval)
+* stats: the statistics
+* interval: seconds between one-line summaries, 0 for none
+*
+* RETURN: void
+*
+* NOTES:
+* Also catches SIGUSR1 for the JSON dump. SA_RESTART keeps the signal from
+* failing the blocking calls of the send loops; the calls that wait with a
+* timeout still return early, which is how the server notices it at once.
+*******************************************************************************/
+void statsInit(PSTATS stats, int interval)
+{
+        struct sigaction sa;
+
+        memset(stats, 0, sizeof(STATS));
+        stats->interval = interval;
+        stats->started = statsNow();
+        stats->last = stats->started;
+        stats->now = statsClock();
+
+        memset(&sa, 0, sizeof(sa));
+        sa.sa_handler = statsSignal;
+        sa.sa_flags = SA_RESTART;
+        sigaction(SIGUSR1, &sa, NULL);
+}
+
+/*******************************************************************************
+* FUNCTION: statsDue
+*
+* DATE: October 18, 2026
+*
+* REVISIONS: (Date and Description)
+*
+* DESIGNER: Karl Castillo (c)
+*
+* PROGRAMMER: Karl Castillo (c)
+*
+* INTERFACE: int statsDue(PSTATS stats)
+* stats: the statistics
+*
+* RETURN: int: STATS_LINE and STATS_JSON as due, 0 for nothing
+*
+* NOTES:
+* A JSON request is only returned once.
+*******************************************************************************/
+int statsDue(PSTATS stats)
+{
+        int due = 0;
+
+        if(requested) {
+                requested = 0;
+                due |= STATS_JSON;
+        }
+        if(stats->interval > 0 &&
+                        statsNow() - stats->last >= stats->interval) {
+                due |= STATS_LINE;
+        }
+
+        return due;
+}
+
+/*******************************************************************************
+* FUNCTION: statsMark
+*
+* DATE: October 18, 2026
+*
+* REVISIONS: (Date and Description)
+*
+* DESIGNER: Karl Castillo (c)
+*
+* PROGRAMMER: Karl Castillo (c)
+*
+* INTERFACE: void statsMark(PSTATS stats, unsigned long packets,
+*       unsigned long batches, int due)
+* stats: the statistics
+* packets: the packets handled so far
+* batches: the batches they came in so far
+* due: what is about to be shown, from statsDue
+*
+* RETURN: void
+*
+* NOTES:
+* Works out the rate and the batch fill since the previous mark. Only a
+* one-line summary starts the next interval, so a JSON dump in between does
+* not shift the summaries.
+*******************************************************************************/
+void statsMark(PSTATS stats, unsigned long packets, unsigned long batches,
+        int due)
+{
+        double now = statsNow();
+
+        stats->rate = now > stats->last ?
+                (packets - stats->packets) / (now - stats->last) : 0;
+        stats->fill = batches > stats->batches ?
+                (double)(packets - stats->packets) /
+                (batches - stats->batches) : 0;
+
+        if(!(due & STATS_LINE)) {
+                return;
+        }
+        stats->last = now;
+        stats->packets = packets;
+        stats->batches = batches;
+}
+
+/*******************************************************************************
+* FUNCTION: statsStart
+*
+* DATE: October 18, 2026
+*
+* REVISIONS: (Date and Description)
+*
+* DESIGNER: Karl Castillo (c)
+*
+* PROGRAMMER: Karl Castillo (c)
+*
+* INTERFACE: int statsStart(PSTATS stats, void (*dump)(void *context,
+*       int due), void *context)
+* stats: the statistics
+* dump: prints what is due, called from the monitor thread
+* context: handed to dump
+*
+* RETURN: int
+* 0: in success
+* -1: the thread could not be started
+*******************************************************************************/
+int statsStart(PSTATS stats, void (*dump)(void *context, int due),
+        void *context)
+{
+        stats->dump = dump;
+        stats->context = context;
+        stats->stop = 0;
+
+        if(pthread_create(&stats->thread, NULL, statsMain, stats) != 0) {
+                return -1;
+        }
+        stats->running = 1;
+
+        return 0;
+}
+
+/*******************************************************************************
+* FUNCTION: statsStop
+*
+* DATE: October 18, 2026
+*
+* REVISIONS: (Date and Description)
+*
+* DESIGNER: Karl Castillo (c)
+*
+* PROGRAMMER: Karl Castillo (c)
+*
+* INTERFACE: void statsStop(PSTATS stats)
+* stats: the statistics
+*
+* RETURN: void
+*******************************************************************************/
+void statsStop(PSTATS stats)
+{
+        if(!stats->running) {
+                return;
+        }
+
+        stats->stop = 1;
+        pthread_join(stats->thread, NULL);
+        stats->running = 0;
+}
+
+/*******************************************************************************
+* FUNCTION: statsNow
+*
+* DATE: October 18, 2026
+*
+* REVISIONS: (Date and Description)
+*
+* DESIGNER: Karl Castillo (c)
+*
+* PROGRAMMER: Karl Castillo (c)
+*
+* INTERFACE: double statsNow(void)
+*
+* RETURN: double: the monotonic clock in seconds
+*******************************************************************************/
+double statsNow(void)
+{
+        struct timespec now;
+
+        clock_gettime(CLOCK_MONOTONIC, &now);
+        return now.tv_sec + now.tv_nsec / 1e9;
+}
+
+/*******************************************************************************
+* FUNCTION: statsClock
+*
+* DATE: October 18, 2026
+*
+* REVISIONS: (Date and Description)
+*
+* DESIGNER: Karl Castillo (c)
+*
+* PROGRAMMER: Karl Castillo (c)
+*
+* INTERFACE: long long statsClock(void)
+*
+* RETURN: long long: the wall clock in nanoseconds
+*
+* NOTES:
+* The kernel stamps received packets with the wall clock, so latencies are
+* measured against it rather than the monotonic clock.
+*******************************************************************************/
+long long statsClock(void)
+{
+        struct timespec now;
+
+        clock_gettime(CLOCK_REALTIME, &now);
+        return now.tv_sec * 1000000000LL + now.tv_nsec;
+}
+
+/*******************************************************************************
+* FUNCTION: histAdd
+*
+* DATE: October 18, 2026
+*
+* REVISIONS: (Date and Description)
+*
+* DESIGNER: Karl Castillo (c)
+*
+* PROGRAMMER: Karl Castillo (c)
+*
+* INTERFACE: void histAdd(PHIST hist, long long ns)
+* hist: the histogram
+* ns: the value, in nanoseconds
+*
+* RETURN: void
+*
+* NOTES:
+* A negative value, when the wall clock was stepped back, counts as 0.
+*******************************************************************************/
+void histAdd(PHIST hist, long long ns)
+{
+        unsigned long long us;
+        int bucket = 0;
+
+        if(ns < 0) {
+                ns = 0;
+        }
+
+        for(us = ns / 1000; us > 0 && bucket < HIST_BUCKETS - 1; us >>= 1) {
+                bucket++;
+        }
+
+        hist->counts[bucket]++;
+        hist->samples++;
+        hist->sum += ns / 1000.0;
+        if(ns / 1000.0 > hist->max) {
+                hist->max = ns / 1000.0;
+        }
+}
+
+/*******************************************************************************
+* FUNCTION: histMerge
+*
+* DATE: October 18, 2026
+*
+* REVISIONS: (Date and Description)
+*
+* DESIGNER: Karl Castillo (c)
+*
+* PROGRAMMER: Karl Castillo (c)
+*
+* INTERFACE: void histMerge(PHIST into, PHIST from)
+* into: the histogram the values are added to
+* from: the histogram they are taken from, left as it is
+*
+* RETURN: void
+*
+* NOTES:
+* Used to show the workers of the server as one.
+*******************************************************************************/
+void histMerge(PHIST into, PHIST from)
+{
+        int i;
+
+        for(i = 0; i < HIST_BUCKETS; i++) {
+                into->counts[i] += from->counts[i];
+        }
+        into->samples += from->samples;
+        into->sum += from->sum;
+        if(from->max > into->max) {
+                into->max = from->max;
+        }
+}
+
+/*******************************************************************************
+* FUNCTION: histPercentile
+*
+* DATE: October 18, 2026
+*
+* REVISIONS: (Date and Description)
+*
+* DESIGNER: Karl Castillo (c)
+*
+* PROGRAMMER: Karl Castillo (c)
+*
+* INTERFACE: double histPercentile(PHIST hist, double p)
+* hist: the histogram
+* p: the fraction of the values, from 0 to 1
+*
+* RETURN: double: the value in microseconds that a fraction p of the values
+*       are under, rounded up to the bucket's bound; 0 when there are none
+*******************************************************************************/
+double histPercentile(PHIST hist, double p)
+{
+        unsigned long seen = 0;
+        double bound = 1;
+        int i;
+
+        if(hist->samples == 0) {
+                return 0;
+        }
+
+        for(i = 0; i < HIST_BUCKETS; i++, bound *= 2) {
+                seen += hist->counts[i];
+                if(seen >= p * hist->samples) {
+                        break;
+                }
+        }
+
+        return bound < hist->max ? bound : hist->max;
+}
+
+/*******************************************************************************
+* FUNCTION: histJson
+*
+* DATE: October 18, 2026
+*
+* REVISIONS: (Date and Description)
+*
+* DESIGNER: Karl Castillo (c)
+*
+* PROGRAMMER: Karl Castillo (c)
+*
+* INTERFACE: void histJson(PHIST hist, FILE *out)
+* hist: the histogram
+* out: where the JSON object will be printed
+*
+* RETURN: void
+*
+* NOTES:
+* Only the buckets that hold values are listed, each as its upper bound in
+* microseconds and its count.
+*******************************************************************************/
+void histJson(PHIST hist, FILE *out)
+{
+        double bound = 1;
+        int first = 1;
+        int i;
+
+        fprintf(out, "{\"samples\":%lu,\"mean_us\":%.1f,\"max_us\":%.1f,"
+                "\"p50_us\":%.0f,\"p90_us\":%.0f,\"p99_us\":%.0f,"
+                "\"buckets\":[", hist->samples, hist->samples > 0 ?
+                hist->sum / hist->samples : 0.0, hist->max,
+                histPercentile(hist, 0.5), histPercentile(hist, 0.9),
+                histPercentile(hist, 0.99));
+
+        for(i = 0; i < HIST_BUCKETS; i++, bound *= 2) {
+                if(hist->counts[i] == 0) {
+                        continue;
+                }
+                fprintf(out, "%s[%.0f,%lu]", first ? "" : ",", bound,
+                        hist->counts[i]);
+                first = 0;
+        }
+
+        fprintf(out, "]}");
+}
+
+/*******************************************************************************
+* FUNCTION: histReport
+*
+* DATE: October 18, 2026
+*
+* REVISIONS: (Date and Description)
+*
+* DESIGNER: Karl Castillo (c)
+*
+* PROGRAMMER: Karl Castillo (c)
+*
+* INTERFACE: void histReport(PHIST hist, char *name, FILE *out)
+* hist: the histogram
+* name: what the values are
+* out: where the report will be printed
+*
+* RETURN: void
+*******************************************************************************/
+void histReport(PHIST hist, char *name, FILE *out)
+{
+        fprintf(out, "%s: %lu samples, mean %.1f us, p50 %.0f us, "
+                "p99 %.0f us, max %.1f us\n", name, hist->samples,
+                hist->samples > 0 ? hist->sum / hist->samples : 0.0,
+                histPercentile(hist, 0.5), histPercentile(hist, 0.99),
+                hist->max);
+}
+
+/*******************************************************************************
+* FUNCTION: statsSignal
+*
+* DATE: October 18, 2026
+*
+* REVISIONS: (Date and Description)
+*
+* DESIGNER: Karl Castillo (c)
+*
+* PROGRAMMER: Karl Castillo (c)
+*
+* INTERFACE: static void statsSignal(int sig)
+* sig: the signal that was caught
+*
+* RETURN: void
+*******************************************************************************/
+static void statsSignal(int sig)
+{
+        (void)sig;
+        requested = 1;
+}
+
+/*******************************************************************************
+* FUNCTION: statsMain
+*
+* DATE: October 18, 2026
+*
+* REVISIONS: (Date and Description)
+*
+* DESIGNER: Karl Castillo (c)
+*
+* PROGRAMMER: Karl Castillo (c)
+*
+* INTERFACE: static void *statsMain(void *arg)
+* arg: the statistics
+*
+* RETURN: void *: NULL
+*
+* NOTES:
+* The monitor thread of the client.
+*******************************************************************************/
+static void *statsMain(void *arg)
+{
+        PSTATS stats = (PSTATS)arg;
+        struct timespec pause;
+        int due;
+
+        pause.tv_sec = 0;
+        pause.tv_nsec = STATS_POLL_MS * 1000000L;
+
+        while(!stats->stop) {
+                nanosleep(&pause, NULL);
+                if((due = statsDue(stats)) != 0) {
+                        stats->dump(stats->context, due);
+                }
+        }
+
+        return NULL;
+}
@@ -0,0 +1,89 @@
+/*******************************************************************************
+* HEADER FILE: stats.h
+*
+* PROGRAM: Covert
+*
+* FUNCTIONS:
+* void statsInit(PSTATS stats, int interval);
+* int statsDue(PSTATS stats);
+* void statsMark(PSTATS stats, unsigned long packets, unsigned long batches,
+*        int due);
+* int statsStart(PSTATS stats, void (*dump)(void *context, int due),
+*        void *context);
+* void statsStop(PSTATS stats);
+* double statsNow(void);
+* long long statsClock(void);
+* void histAdd(PHIST hist, long long ns);
+* void histMerge(PHIST into, PHIST from);
+* double histPercentile(PHIST hist, double p);
+* void histJson(PHIST hist, FILE *out);
+* void histReport(PHIST hist, char *name, FILE *out);
+*
+* DATE: October 18, 2026
+*
+* DESIGNER: Karl Castillo (c)
+*
+* PROGRAMMER: Karl Castillo (c)
+*
+* NOTES:
+* Runtime statistics shared by the client and the server. Each side keeps its
+* own counters; this is what decides when they are shown, the rate between
+* two summaries, and the latency histogram of the server.
+*******************************************************************************/
+#ifndef STATS_H
+#define STATS_H
+
+#include <stdio.h>
+#include <pthread.h>
+
+/* DEFINES */
+#define STATS_LINE      0x1     /* a one-line summary is due */
+#define STATS_JSON      0x2     /* a JSON dump was asked for with SIGUSR1 */
+#define STATS_POLL_MS   50      /* how often the monitor thread looks */
+#define HIST_BUCKETS    32      /* bucket n holds [2^(n-1), 2^n) us */
+
+/* STRUCTURES */
+typedef struct hist {
+        unsigned long counts[HIST_BUCKETS];
+        unsigned long samples;          /* values added */
+        double sum;                     /* of every value, us */
+        double max;                     /* largest value, us */
+} HIST, *PHIST;
+
+typedef struct stats {
+        int interval;                   /* seconds between summaries, 0 none */
+        double started;                 /* when the statistics began, s */
+        double last;                    /* when the last mark was made, s */
+        unsigned long packets;          /* packets at the last mark */
+        unsigned long batches;          /* batches at the last mark */
+        double rate;                    /* packets/s between the last marks */
+        double fill;                    /* packets per batch between them */
+        long long now;                  /* the clock of the batch, ns */
+        HIST latency;                   /* arrival to write, server only */
+        unsigned long lost;             /* packets lost, server only */
+        unsigned long stale;            /* data packets dropped as those of
+                                           a transfer already done */
+        pthread_t thread;               /* the monitor thread, client only */
+        int running;                    /* the monitor thread was started */
+        volatile int stop;              /* the monitor thread should exit */
+        void (*dump)(void *context, int due); /* shows the statistics */
+        void *context;                  /* handed to dump */
+} STATS, *PSTATS;
+
+/* PROTOTYPES */
+void statsInit(PSTATS stats, int interval);
+int statsDue(PSTATS stats);
+void statsMark(PSTATS stats, unsigned long packets, unsigned long batches,
+        int due);
+int statsStart(PSTATS stats, void (*dump)(void *context, int due),
+        void *context);
+void statsStop(PSTATS stats);
+double statsNow(void);
+long long statsClock(void);
+void histAdd(PHIST hist, long long ns);
+void histMerge(PHIST into, PHIST from);
+double histPercentile(PHIST hist, double p);
+void histJson(PHIST hist, FILE *out);
+void histReport(PHIST hist, char *name, FILE *out);
+
+#endif
@@ -0,0 +1,645 @@
+/*******************************************************************************
+* SOURCE FILE: template.c
+*
+* PROGRAM: Covert
+*
+* FUNCTIONS:
+* void templateInit(PTEMPLATE template, struct iphdr ip, struct tcphdr tcp,
+*        PLAYOUT layout, PPRNG prng, int check_every);
+* void templateInit6(PTEMPLATE template, struct ip6_hdr ip6,
+*        struct tcphdr tcp, PLAYOUT layout, PPRNG prng, int check_every);
+* void templateBuild(PTEMPLATE template, void *packet, unsigned int seq,
+*        unsigned long long word, int final);
+* void templateBatch(PTEMPLATE template, PSENDER sender, unsigned int seq,
+*        const unsigned long long *words, int count);
+* void templateParity(PTEMPLATE template, PSENDER sender, PPARITY parity,
+*        int final);
+* void templateProbe(PTEMPLATE template, void *packet);
+* void templateChecksum(PSENDHDR sendhdr);
+* void templateChecksum6(PSENDHDR6 sendhdr);
+* unsigned short templatePort(PTEMPLATE template);
+* void templateReport(PTEMPLATE template, FILE *out);
+* static void templateBase(PTEMPLATE template, unsigned int ip_mask,
+*        unsigned int tcp_mask);
+* static void templateCopy(PTEMPLATE template, void *packet,
+*        unsigned int seq);
+* static void templatePatch(PTEMPLATE template, void *packet);
+* static void templateFull(PTEMPLATE template, void *packet);
+*
+* DATE: October 18, 2026
+*
+* DESIGNER: Karl Castillo (c)
+*
+* PROGRAMMER: Karl Castillo (c)
+*
+* NOTES:
+* The headers of a session are built and checksummed once. Every packet is a
+* copy of the template with the layout fields patched in, and both checksums
+* are updated for the patched words only, as in RFC 1624 eqn. 3:
+*
+*       HC' = ~(~HC + ~m + m')
+*
+* ~HC and the ~m of every word the layout may change are constant for the
+* session, so they are summed once into a base and each packet only adds its
+* new words and folds.
+*
+* The IP identification and TCP sequence number are drawn fresh for every
+* packet unless the layout uses them, so they get patched the same way. The
+* acknowledgement number is always patched: it frames the packet with its
+* position in the transfer.
+*
+* Runs of data packets are built in the slots of the sender that follow each
+* other, so the layout encodes a whole run with one call.
+*
+* Parity packets and probes are rare next to data packets, so like the last
+* packet they simply get full checksums.
+*
+* An IPv6 header has no checksum and no identification. The TCP checksum
+* covers the IPv6 pseudo header of RFC 8200 instead, which is constant for
+* the session, so it is patched the same way.
+*******************************************************************************/
+/* INCLUDES */
+#include <stdio.h>
+#include <string.h>
+#include <strings.h>
+#include <arpa/inet.h>
+#include "cksum.h"
+#include "template.h"
+
+/* DEFINES */
+#define TCP_OF(t, p)    ((struct tcphdr*)((unsigned char*)(p) + (t)->size - \
+                                sizeof(struct tcphdr)))
+
+/* PROTOTYPES */
+static void templateBase(PTEMPLATE template, unsigned int ip_mask,
+        unsigned int tcp_mask);
+static void templateCopy(PTEMPLATE template, void *packet,
+        unsigned int seq);
+static void templatePatch(PTEMPLATE template, void *packet);
+static void templateFull(PTEMPLATE template, void *packet);
+
+/*******************************************************************************
+* FUNCTION: templateInit
+*
+* DATE: October 18, 2026
+*
+* REVISIONS: (Date and Description)
+*
+* DESIGNER: Karl Castillo (c)
+*
+* PROGRAMMER: Karl Castillo (c)
+*
+* INTERFACE: void templateInit(PTEMPLATE template, struct iphdr ip,
+*       struct tcphdr tcp, PLAYOUT layout, PPRNG prng, int check_every)
+* template: the template to build
+* ip: the IP header of the session
+* tcp: the TCP header of the session
+* layout: the header fields that carry the payload
+* prng: the generator of the session
+* check_every: compare every n-th packet against a full checksum, 0 for never
+*
+* RETURN: void
+*******************************************************************************/
+void templateInit(PTEMPLATE template, struct iphdr ip, struct tcphdr tcp,
+        PLAYOUT layout, PPRNG prng, int check_every)
+{
+        unsigned int ip_mask;
+        unsigned int tcp_mask;
+
+        memset(template, 0, sizeof(TEMPLATE));
+        template->packet.v4.ip = ip;
+        template->packet.v4.tcp = tcp;
+        template->size = sizeof(SENDHDR);
+        template->layout = layout;
+        template->prng = prng;
+        template->check_every = check_every;
+
+        templateChecksum(&template->packet.v4);
+        layoutWords(layout, &ip_mask, &tcp_mask);
+
+        if(!layoutHas(layout, FIELD_ID)) {
+                template->random_id = 1;
+                ip_mask |= 1 << IP_ID_WORD;
+        }
+        templateBase(template, ip_mask, tcp_mask);
+}
+
+/*******************************************************************************
+* FUNCTION: templateInit6
+*
+* DATE: October 18, 2026
+*
+* REVISIONS: (Date and Description)
+*
+* DESIGNER: Karl Castillo (c)
+*
+* PROGRAMMER: Karl Castillo (c)
+*
+* INTERFACE: void templateInit6(PTEMPLATE template, struct ip6_hdr ip6,
+*       struct tcphdr tcp, PLAYOUT layout, PPRNG prng, int check_every)
+* template: the template to build
+* ip6: the IPv6 header of the session
+* tcp: the TCP header of the session
+* layout: the header fields that carry the payload, over IPv6
+* prng: the generator of the session
+* check_every: compare every n-th packet against a full checksum, 0 for never
+*
+* RETURN: void
+*******************************************************************************/
+void templateInit6(PTEMPLATE template, struct ip6_hdr ip6,
+        struct tcphdr tcp, PLAYOUT layout, PPRNG prng, int check_every)
+{
+        unsigned int ip_mask;
+        unsigned int tcp_mask;
+
+        memset(template, 0, sizeof(TEMPLATE));
+        template->packet.v6.ip6 = ip6;
+        template->packet.v6.tcp = tcp;
+        template->size = sizeof(SENDHDR6);
+        template->layout = layout;
+        template->prng = prng;
+        template->check_every = check_every;
+
+        templateChecksum6(&template->packet.v6);
+        layoutWords(layout, &ip_mask, &tcp_mask);
+        templateBase(template, 0, tcp_mask);
+}
+
+/*******************************************************************************
+* FUNCTION: templateBuild
+*
+* DATE: October 18, 2026
+*
+* REVISIONS: (Date and Description)
+*
+* DESIGNER: Karl Castillo (c)
+*
+* PROGRAMMER: Karl Castillo (c)
+*
+* INTERFACE: void templateBuild(PTEMPLATE template, void *packet,
+*       unsigned int seq, unsigned long long word, int final)
+* template: the template
+* packet: where the packet is built, a SENDHDR or a SENDHDR6
+* seq: the position of the packet in the transfer
+* word: the payload bits of the packet
+* final: the number of valid bits in the last packet, -1 for any other packet
+*
+* RETURN: void
+*
+* NOTES:
+* The last packet has PSH set and its urgent pointer holds the number of
+* valid bits. It is only sent once, so it simply gets full checksums.
+*******************************************************************************/
+void templateBuild(PTEMPLATE template, void *packet, unsigned int seq,
+        unsigned long long word, int final)
+{
+        struct tcphdr *tcp = TCP_OF(template, packet);
+
+        templateCopy(template, packet, seq);
+        layoutEncode(template->layout, &word, packet, template->size, 1);
+
+        if(final >= 0) {
+                template->built++;
+                tcp->psh = 1;
+                tcp->urg_ptr = htons(final);
+                templateFull(template, packet);
+                return;
+        }
+
+        templatePatch(template, packet);
+}
+
+/*******************************************************************************
+* FUNCTION: templateBatch
+*
+* DATE: October 18, 2026
+*
+* REVISIONS: (Date and Description)
+*
+* DESIGNER: Karl Castillo (c)
+*
+* PROGRAMMER: Karl Castillo (c)
+*
+* INTERFACE: void templateBatch(PTEMPLATE template, PSENDER sender,
+*       unsigned int seq, const unsigned long long *words, int count)
+* template: the template
+* sender: the sender the packets are built in and pushed to
+* seq: the position of the first packet in the transfer
+* words: the payload bits of each packet
+* count: the number of packets, none of them the last one
+*
+* RETURN: void
+*
+* NOTES:
+* Takes the slots left in the batch of the sender as one run and encodes the
+* layout fields of the whole run with a single layoutEncode; a run only
+* breaks where a flush or the end of a ring comes between.
+*******************************************************************************/
+void templateBatch(PTEMPLATE template, PSENDER sender, unsigned int seq,
+        const unsigned long long *words, int count)
+{
+        unsigned char *packets;
+        size_t stride;
+        int n;
+        int i;
+
+        while(count > 0) {
+                n = count;
+                packets = (unsigned char*)senderSlots(sender, &n, &stride);
+                for(i = 0; i < n; i++) {
+                        templateCopy(template, packets + i * stride, seq + i);
+                }
+                layoutEncode(template->layout, words, packets, stride, n);
+                for(i = 0; i < n; i++) {
+                        templatePatch(template, packets + i * stride);
+                        senderPush(sender);
+                }
+                seq += n;
+                words += n;
+                count -= n;
+        }
+}
+
+/*******************************************************************************
+* FUNCTION: templateParity
+*
+* DATE: October 18, 2026
+*
+* REVISIONS: (Date and Description)
+*
+* DESIGNER: Karl Castillo (c)
+*
+* PROGRAMMER: Karl Castillo (c)
+*
+* INTERFACE: void templateParity(PTEMPLATE template, PSENDER sender,
+*       PPARITY parity, int final)
+* template: the template
+* sender: the sender the parity packets are built in and sent through
+* parity: the encoder holding a complete or last group
+* final: the number of valid bits in the last packet when the group is the
+*       last one, -1 otherwise
+*
+* RETURN: void
+*
+* NOTES:
+* Sends the parity packets of the group and starts a new one. They are
+* framed as described in fec.c.
+*******************************************************************************/
+void templateParity(PTEMPLATE template, PSENDER sender, PPARITY parity,
+        int final)
+{
+        void *packet;
+        struct tcphdr *tcp;
+        int j;
+
+        for(j = 0; j < parity->fec->parity; j++) {
+                packet = senderSlot(sender);
+                tcp = TCP_OF(template, packet);
+                templateCopy(template, packet, parity->start);
+                layoutEncode(template->layout, &parity->words[j], packet,
+                        template->size, 1);
+                tcp->res1 = FEC_PARITY | j;
+                tcp->urg_ptr = htons(parity->members << 8 |
+                        (final >= 0 ? final : 0));
+                tcp->psh = final >= 0;
+                templateFull(template, packet);
+                senderPush(sender);
+        }
+
+        parity->members = 0;
+        parity->groups++;
+        parity->sent += parity->fec->parity;
+}
+
+/*******************************************************************************
+* FUNCTION: templateProbe
+*
+* DATE: October 18, 2026
+*
+* REVISIONS: (Date and Description)
+*
+* DESIGNER: Karl Castillo (c)
+*
+* PROGRAMMER: Karl Castillo (c)
+*
+* INTERFACE: void templateProbe(PTEMPLATE template, void *packet)
+* template: the template
+* packet: where the probe is built
+*
+* RETURN: void
+*
+* NOTES:
+* A probe carries no payload; the server only answers it with a report.
+*******************************************************************************/
+void templateProbe(PTEMPLATE template, void *packet)
+{
+        unsigned long long word = 0;
+
+        templateCopy(template, packet, 0);
+        layoutEncode(template->layout, &word, packet, template->size, 1);
+        TCP_OF(template, packet)->res1 = FEED_PROBE;
+        templateFull(template, packet);
+}
+
+/*******************************************************************************
+* FUNCTION: templateChecksum
+*
+* DATE: October 18, 2026
+*
+* REVISIONS: (Date and Description)
+*
+* DESIGNER: Karl Castillo (c)
+*
+* PROGRAMMER: Karl Castillo (c)
+*
+* INTERFACE: void templateChecksum(PSENDHDR sendhdr)
+* sendhdr: the packet
+*
+* RETURN: void
+*
+* NOTES:
+* Computes both checksums from scratch, the TCP one over the pseudo header.
+*******************************************************************************/
+void templateChecksum(PSENDHDR sendhdr)
+{
+        PSEUDOHDR pseudohdr;
+
+        sendhdr->ip.check = 0;
+        sendhdr->ip.check = in_cksum((unsigned short*)&sendhdr->ip, 20);
+
+        pseudohdr.source_address = sendhdr->ip.saddr;
+        pseudohdr.dest_address = sendhdr->ip.daddr;
+        pseudohdr.placeholder = 0;
+        pseudohdr.protocol = IPPROTO_TCP;
+        pseudohdr.tcp_length = htons(20);
+
+        sendhdr->tcp.check = 0;
+        bcopy((char*)&sendhdr->tcp, (char*)&pseudohdr.tcp, 20);
+
+        sendhdr->tcp.check = in_cksum((unsigned short*)&pseudohdr, 32);
+}
+
+/*******************************************************************************
+* FUNCTION: templateChecksum6
+*
+* DATE: October 18, 2026
+*
+* REVISIONS: (Date and Description)
+*
+* DESIGNER: Karl Castillo (c)
+*
+* PROGRAMMER: Karl Castillo (c)
+*
+* INTERFACE: void templateChecksum6(PSENDHDR6 sendhdr)
+* sendhdr: the packet
+*
+* RETURN: void
+*
+* NOTES:
+* Computes the TCP checksum from scratch over the IPv6 pseudo header: both
+* addresses, the 32-bit TCP length and the next header.
+*******************************************************************************/
+void templateChecksum6(PSENDHDR6 sendhdr)
+{
+        PSEUDOHDR6 pseudohdr;
+
+        memset(&pseudohdr, 0, sizeof(pseudohdr));
+        pseudohdr.source_address = sendhdr->ip6.ip6_src;
+        pseudohdr.dest_address = sendhdr->ip6.ip6_dst;
+        pseudohdr.tcp_length = htonl(sizeof(struct tcphdr));
+        pseudohdr.next_header = IPPROTO_TCP;
+
+        sendhdr->tcp.check = 0;
+        pseudohdr.tcp = sendhdr->tcp;
+
+        sendhdr->tcp.check = in_cksum((unsigned short*)&pseudohdr,
+                sizeof(pseudohdr));
+}
+
+/*******************************************************************************
+* FUNCTION: templatePort
+*
+* DATE: October 18, 2026
+*
+* REVISIONS: (Date and Description)
+*
+* DESIGNER: Karl Castillo (c)
+*
+* PROGRAMMER: Karl Castillo (c)
+*
+* INTERFACE: unsigned short templatePort(PTEMPLATE template)
+* template: the template
+*
+* RETURN: unsigned short: the source port of the session
+*******************************************************************************/
+unsigned short templatePort(PTEMPLATE template)
+{
+        return ntohs(TCP_OF(template, &template->packet)->source);
+}
+
+/*******************************************************************************
+* FUNCTION: templateReport
+*
+* DATE: October 18, 2026
+*
+* REVISIONS: (Date and Description)
+*
+* DESIGNER: Karl Castillo (c)
+*
+* PROGRAMMER: Karl Castillo (c)
+*
+* INTERFACE: void templateReport(PTEMPLATE template, FILE *out)
+* template: the template
+* out: where the report will be printed
+*
+* RETURN: void
+*******************************************************************************/
+void templateReport(PTEMPLATE template, FILE *out)
+{
+        if(template->check_every > 0) {
+                fprintf(out, "Checksum Self-Check: %lu packets checked, "
+                        "%lu mismatches\n", template->checked,
+                        template->mismatches);
+        }
+}
+
+/*******************************************************************************
+* FUNCTION: templateBase
+*
+* DATE: October 18, 2026
+*
+* REVISIONS: (Date and Description)
+*
+* DESIGNER: Karl Castillo (c)
+*
+* PROGRAMMER: Karl Castillo (c)
+*
+* INTERFACE: static void templateBase(PTEMPLATE template,
+*       unsigned int ip_mask, unsigned int tcp_mask)
+* template: the template, with its checksums computed
+* ip_mask: the IP header words that change per packet
+* tcp_mask: the TCP header words that change per packet
+*
+* RETURN: void
+*
+* NOTES:
+* Adds the words drawn or patched for every packet to the masks, and sums the
+* constant part of both checksums into the bases.
+*******************************************************************************/
+static void templateBase(PTEMPLATE template, unsigned int ip_mask,
+        unsigned int tcp_mask)
+{
+        struct tcphdr *tcp = TCP_OF(template, &template->packet);
+        unsigned short *words;
+        int i;
+
+        if(!layoutHas(template->layout, FIELD_SEQ)) {
+                template->random_seq = 1;
+                tcp_mask |= (1 << TCP_SEQ_WORD) | (1 << (TCP_SEQ_WORD + 1));
+        }
+        tcp_mask |= (1 << TCP_ACK_WORD) | (1 << (TCP_ACK_WORD + 1));
+
+        words = (unsigned short*)&template->packet.v4.ip;
+        template->ip_base = (unsigned short)~template->packet.v4.ip.check;
+        for(i = 0; i < HDR_WORDS; i++) {
+                if(ip_mask & (1 << i)) {
+                        template->ip_words[template->ip_count++] = i;
+                        template->ip_base += (unsigned short)~words[i];
+                }
+        }
+
+        words = (unsigned short*)tcp;
+        template->tcp_base = (unsigned short)~tcp->check;
+        for(i = 0; i < HDR_WORDS; i++) {
+                if(tcp_mask & (1 << i)) {
+                        template->tcp_words[template->tcp_count++] = i;
+                        template->tcp_base += (unsigned short)~words[i];
+                }
+        }
+}
+
+/*******************************************************************************
+* FUNCTION: templateCopy
+*
+* DATE: October 18, 2026
+*
+* REVISIONS: (Date and Description)
+*
+* DESIGNER: Karl Castillo (c)
+*
+* PROGRAMMER: Karl Castillo (c)
+*
+* INTERFACE: static void templateCopy(PTEMPLATE template, void *packet,
+*       unsigned int seq)
+* template: the template
+* packet: where the packet is built
+* seq: the acknowledgement number of the packet
+*
+* RETURN: void
+*
+* NOTES:
+* Copies the template and patches in everything but the layout fields and
+* the checksums; the caller encodes the fields, for one packet or a run.
+*******************************************************************************/
+static void templateCopy(PTEMPLATE template, void *packet,
+        unsigned int seq)
+{
+        struct tcphdr *tcp = TCP_OF(template, packet);
+
+        memcpy(packet, &template->packet, template->size);
+        tcp->ack_seq = htonl(seq);
+        if(template->random_id) {
+                ((PSENDHDR)packet)->ip.id =
+                        (unsigned short)prngNext(template->prng);
+        }
+        if(template->random_seq) {
+                tcp->seq = prngNext(template->prng);
+        }
+}
+
+/*******************************************************************************
+* FUNCTION: templatePatch
+*
+* DATE: October 18, 2026
+*
+* REVISIONS: (Date and Description)
+*
+* DESIGNER: Karl Castillo (c)
+*
+* PROGRAMMER: Karl Castillo (c)
+*
+* INTERFACE: static void templatePatch(PTEMPLATE template, void *packet)
+* template: the template
+* packet: a data packet built from the template, its fields encoded
+*
+* RETURN: void
+*
+* NOTES:
+* Updates both checksums for the patched words only, and verifies every
+* check_every-th packet against full checksums.
+*******************************************************************************/
+static void templatePatch(PTEMPLATE template, void *packet)
+{
+        SENDHDR6 check;
+        struct tcphdr *tcp = TCP_OF(template, packet);
+        unsigned short *words;
+        unsigned int sum;
+        int i;
+
+        template->built++;
+
+        if(template->size == sizeof(SENDHDR)) {
+                words = (unsigned short*)packet;
+                sum = template->ip_base;
+                for(i = 0; i < template->ip_count; i++) {
+                        sum += words[template->ip_words[i]];
+                }
+                ((PSENDHDR)packet)->ip.check = cksumFold(sum);
+        }
+
+        words = (unsigned short*)tcp;
+        sum = template->tcp_base;
+        for(i = 0; i < template->tcp_count; i++) {
+                sum += words[template->tcp_words[i]];
+        }
+        tcp->check = cksumFold(sum);
+
+        if(template->check_every > 0 &&
+                        template->built % template->check_every == 0) {
+                memcpy(&check, packet, template->size);
+                templateFull(template, &check);
+                template->checked++;
+                if(memcmp(&check, packet, template->size) != 0) {
+                        template->mismatches++;
+                }
+        }
+}
+
+/*******************************************************************************
+* FUNCTION: templateFull
+*
+* DATE: October 18, 2026
+*
+* REVISIONS: (Date and Description)
+*
+* DESIGNER: Karl Castillo (c)
+*
+* PROGRAMMER: Karl Castillo (c)
+*
+* INTERFACE: static void templateFull(PTEMPLATE template, void *packet)
+* template: the template
+* packet: a packet built from the template
+*
+* RETURN: void
+*
+* NOTES:
+* Computes the checksums of the packet from scratch for its family.
+*******************************************************************************/
+static void templateFull(PTEMPLATE template, void *packet)
+{
+        if(template->size == sizeof(SENDHDR6)) {
+                templateChecksum6((PSENDHDR6)packet);
+        } else {
+                templateChecksum((PSENDHDR)packet);
+        }
+}
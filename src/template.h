@@ -0,0 +1,107 @@
+/*******************************************************************************
+* HEADER FILE: template.h
+*
+* PROGRAM: Covert
+*
+* FUNCTIONS:
+* void templateInit(PTEMPLATE template, struct iphdr ip, struct tcphdr tcp,
+*        PLAYOUT layout, PPRNG prng, int check_every);
+* void templateInit6(PTEMPLATE template, struct ip6_hdr ip6,
+*        struct tcphdr tcp, PLAYOUT layout, PPRNG prng, int check_every);
+* void templateBuild(PTEMPLATE template, void *packet, unsigned int seq,
+*        unsigned long long word, int final);
+* void templateBatch(PTEMPLATE template, PSENDER sender, unsigned int seq,
+*        const unsigned long long *words, int count);
+* void templateParity(PTEMPLATE template, PSENDER sender, PPARITY parity,
+*        int final);
+* void templateProbe(PTEMPLATE template, void *packet);
+* void templateChecksum(PSENDHDR sendhdr);
+* void templateChecksum6(PSENDHDR6 sendhdr);
+* unsigned short templatePort(PTEMPLATE template);
+* void templateReport(PTEMPLATE template, FILE *out);
+*
+* DATE: October 18, 2026
+*
+* DESIGNER: Karl Castillo (c)
+*
+* PROGRAMMER: Karl Castillo (c)
+*
+* NOTES:
+* The per-session packet template of the client. A template holds either an
+* IPv4 or an IPv6 packet; size tells which.
+*******************************************************************************/
+#ifndef TEMPLATE_H
+#define TEMPLATE_H
+
+#include <stdio.h>
+#include "codec.h"
+#include "fec.h"
+#include "feedback.h"
+#include "prng.h"
+#include "sender.h"
+
+/* DEFINES */
+#define HDR_WORDS       10      /* 16-bit words in a 20 byte header */
+#define IP_ID_WORD      2       /* the identification in the IP header */
+#define TCP_SEQ_WORD    2       /* the sequence number in the TCP header */
+#define TCP_ACK_WORD    4       /* the acknowledgement number, our framing */
+
+/* STRUCTURES */
+typedef struct pseudo_header {
+      unsigned int source_address;
+      unsigned int dest_address;
+      unsigned char placeholder;
+      unsigned char protocol;
+      unsigned short tcp_length;
+      struct tcphdr tcp;
+} PSEUDOHDR, *PPSEUDOHDR;
+
+typedef struct pseudo_header6 {
+        struct in6_addr source_address;
+        struct in6_addr dest_address;
+        unsigned int tcp_length;
+        unsigned char zero[3];
+        unsigned char next_header;
+        struct tcphdr tcp;
+} PSEUDOHDR6, *PPSEUDOHDR6;
+
+typedef struct template {
+        union {
+                SENDHDR v4;
+                SENDHDR6 v6;
+        } packet;                       /* the headers with checksums */
+        int size;                       /* bytes in the packet */
+        PLAYOUT layout;                 /* the fields patched per packet */
+        PPRNG prng;                     /* randomizes the free id and seq */
+        int random_id;                  /* the id is not part of the layout */
+        int random_seq;                 /* the seq is not part of the layout */
+        int ip_words[HDR_WORDS];        /* IP header words the layout changes */
+        int ip_count;
+        int tcp_words[HDR_WORDS];       /* TCP header words the layout changes */
+        int tcp_count;
+        unsigned int ip_base;           /* ~check + sum of ~old words */
+        unsigned int tcp_base;
+        int check_every;                /* verify every n-th packet, 0 never */
+        unsigned long built;            /* packets built from the template */
+        unsigned long checked;          /* packets verified */
+        unsigned long mismatches;       /* verified packets that were wrong */
+} TEMPLATE, *PTEMPLATE;
+
+/* PROTOTYPES */
+void templateInit(PTEMPLATE template, struct iphdr ip, struct tcphdr tcp,
+        PLAYOUT layout, PPRNG prng, int check_every);
+void templateInit6(PTEMPLATE template, struct ip6_hdr ip6,
+        struct tcphdr tcp, PLAYOUT layout, PPRNG prng, int check_every);
+void templateBuild(PTEMPLATE template, void *packet, unsigned int seq,
+        unsigned long long word, int final);
+void templateBatch(PTEMPLATE template, PSENDER sender, unsigned int seq,
+        const unsigned long long *words, int count);
+void templateParity(PTEMPLATE template, PSENDER sender, PPARITY parity,
+        int final);
+void templateProbe(PTEMPLATE template, void *packet);
+void templateChecksum(PSENDHDR sendhdr);
+void templateChecksum6(PSENDHDR6 sendhdr);
+unsigned short templatePort(PTEMPLATE template);
+void templateReport(PTEMPLATE template, FILE *out);
+
+#endif
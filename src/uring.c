@@ -0,0 +1,616 @@
+/*******************************************************************************
+* SOURCE FILE: uring.c
+*
+* PROGRAM: Covert
+*
+* FUNCTIONS:
+* int uringOpen(PURING ring, unsigned int entries, unsigned int cq_entries);
+* struct io_uring_sqe *uringGet(PURING ring, PURINGOP op);
+* int uringEnter(PURING ring, unsigned int wait, int timeout_ms);
+* int uringWait(PURING ring, PURINGOP op);
+* int uringRegister(PURING ring, unsigned int opcode, void *arg,
+*        unsigned int count);
+* int uringBuffers(PURING ring, PURINGBUFS bufs, int group, int count,
+*        int size);
+* void uringRecycle(PURINGBUFS bufs, int id);
+* void uringPublish(PURINGBUFS bufs);
+* void uringBuffersFree(PURING ring, PURINGBUFS bufs);
+* void uringClose(PURING ring);
+* void uringReport(PURING ring, FILE *out);
+* static int uringReap(PURING ring);
+*
+* DATE: October 18, 2026
+*
+* DESIGNER: Karl Castillo (c)
+*
+* PROGRAMMER: Karl Castillo (c)
+*
+* NOTES:
+* The rings are set up with io_uring_setup and mapped by hand, so nothing
+* beyond the kernel headers is needed. Entries are prepared in the shared
+* submission ring and only handed to the kernel by uringEnter, which also
+* waits for completions; a whole batch of requests and the wait for them
+* cost one system call.
+*
+* The kernel writes completions into the completion ring and we read them
+* back in order. The user data of every request is its operation, which
+* counts the completions still expected: a multishot request keeps its
+* operation pending until a completion comes without IORING_CQE_F_MORE.
+*
+* A ring is not thread safe; it belongs to the thread that submits on it.
+*******************************************************************************/
+/* INCLUDES */
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include <stdint.h>
+#include <errno.h>
+#include <unistd.h>
+#include <sys/mman.h>
+#include <sys/syscall.h>
+#include "uring.h"
+
+/* PROTOTYPES */
+static int uringReap(PURING ring);
+
+/*******************************************************************************
+* FUNCTION: uringOpen
+*
+* DATE: October 18, 2026
+*
+* REVISIONS: (Date and Description)
+*
+* DESIGNER: Karl Castillo (c)
+*
+* PROGRAMMER: Karl Castillo (c)
+*
+* INTERFACE: int uringOpen(PURING ring, unsigned int entries,
+*       unsigned int cq_entries)
+* ring: the ring to open
+* entries: the most requests prepared before they are submitted
+* cq_entries: the most completions waiting to be reaped, 0 for twice entries
+*
+* RETURN: int
+* 0: in success
+* -1: the ring could not be set up or mapped, or the kernel is too old
+*
+* NOTES:
+* Both rings are mapped at once, which needs IORING_FEAT_SINGLE_MMAP, and
+* timed waits need IORING_FEAT_EXT_ARG; a kernel without them is refused
+* with ENOSYS. Every slot of the submission array points at the entry of the
+* same index, once and for all.
+*******************************************************************************/
+int uringOpen(PURING ring, unsigned int entries, unsigned int cq_entries)
+{
+        struct io_uring_params params;
+        unsigned int *array;
+        size_t sq_size;
+        size_t cq_size;
+        unsigned int i;
+
+        memset(ring, 0, sizeof(URING));
+        memset(&params, 0, sizeof(params));
+        ring->fd = -1;
+
+        if(cq_entries > 0) {
+                params.flags |= IORING_SETUP_CQSIZE;
+                params.cq_entries = cq_entries;
+        }
+
+        if((ring->fd = syscall(__NR_io_uring_setup, entries, &params)) < 0) {
+                return -1;
+        }
+
+        if(!(params.features & IORING_FEAT_SINGLE_MMAP) ||
+                        !(params.features & IORING_FEAT_EXT_ARG)) {
+                close(ring->fd);
+                ring->fd = -1;
+                errno = ENOSYS;
+                return -1;
+        }
+
+        sq_size = params.sq_off.array + params.sq_entries *
+                sizeof(unsigned int);
+        cq_size = params.cq_off.cqes + params.cq_entries *
+                sizeof(struct io_uring_cqe);
+        ring->rings_size = sq_size > cq_size ? sq_size : cq_size;
+        ring->rings = mmap(NULL, ring->rings_size, PROT_READ | PROT_WRITE,
+                MAP_SHARED | MAP_POPULATE, ring->fd, IORING_OFF_SQ_RING);
+        if(ring->rings == MAP_FAILED) {
+                close(ring->fd);
+                ring->fd = -1;
+                return -1;
+        }
+
+        ring->sqes_size = params.sq_entries * sizeof(struct io_uring_sqe);
+        ring->sqes = (struct io_uring_sqe*)mmap(NULL, ring->sqes_size,
+                PROT_READ | PROT_WRITE, MAP_SHARED | MAP_POPULATE, ring->fd,
+                IORING_OFF_SQES);
+        if(ring->sqes == MAP_FAILED) {
+                munmap(ring->rings, ring->rings_size);
+                close(ring->fd);
+                ring->fd = -1;
+                return -1;
+        }
+
+        ring->sq_head = (unsigned int*)((char*)ring->rings +
+                params.sq_off.head);
+        ring->sq_tail = (unsigned int*)((char*)ring->rings +
+                params.sq_off.tail);
+        ring->sq_mask = *(unsigned int*)((char*)ring->rings +
+                params.sq_off.ring_mask);
+        ring->sq_entries = params.sq_entries;
+        ring->cq_head = (unsigned int*)((char*)ring->rings +
+                params.cq_off.head);
+        ring->cq_tail = (unsigned int*)((char*)ring->rings +
+                params.cq_off.tail);
+        ring->cq_mask = *(unsigned int*)((char*)ring->rings +
+                params.cq_off.ring_mask);
+        ring->cqes = (struct io_uring_cqe*)((char*)ring->rings +
+                params.cq_off.cqes);
+
+        array = (unsigned int*)((char*)ring->rings + params.sq_off.array);
+        for(i = 0; i < params.sq_entries; i++) {
+                array[i] = i;
+        }
+        ring->tail = *ring->sq_tail;
+
+        return 0;
+}
+
+/*******************************************************************************
+* FUNCTION: uringGet
+*
+* DATE: October 18, 2026
+*
+* REVISIONS: (Date and Description)
+*
+* DESIGNER: Karl Castillo (c)
+*
+* PROGRAMMER: Karl Castillo (c)
+*
+* INTERFACE: struct io_uring_sqe *uringGet(PURING ring, PURINGOP op)
+* ring: the ring
+* op: the operation the request completes, or NULL to ignore its completion
+*
+* RETURN: struct io_uring_sqe *: a cleared entry to fill in, or NULL when the
+*       ring is full and cannot be submitted
+*
+* NOTES:
+* When every entry is prepared the ring is submitted first to make room.
+*******************************************************************************/
+struct io_uring_sqe *uringGet(PURING ring, PURINGOP op)
+{
+        struct io_uring_sqe *sqe;
+
+        if(ring->tail - __atomic_load_n(ring->sq_head, __ATOMIC_ACQUIRE) >=
+                        ring->sq_entries) {
+                if(uringEnter(ring, 0, 0) < 0 || ring->tail -
+                                __atomic_load_n(ring->sq_head,
+                                __ATOMIC_ACQUIRE) >= ring->sq_entries) {
+                        return NULL;
+                }
+        }
+
+        sqe = &ring->sqes[ring->tail & ring->sq_mask];
+        memset(sqe, 0, sizeof(struct io_uring_sqe));
+        sqe->user_data = (unsigned long long)(uintptr_t)op;
+        ring->tail++;
+        ring->queued++;
+        if(op != NULL) {
+                op->pending++;
+        }
+
+        return sqe;
+}
+
+/*******************************************************************************
+* FUNCTION: uringEnter
+*
+* DATE: October 18, 2026
+*
+* REVISIONS: (Date and Description)
+*
+* DESIGNER: Karl Castillo (c)
+*
+* PROGRAMMER: Karl Castillo (c)
+*
+* INTERFACE: int uringEnter(PURING ring, unsigned int wait, int timeout_ms)
+* ring: the ring
+* wait: the completions to wait for, 0 to only submit
+* timeout_ms: the longest wait, -1 for ever
+*
+* RETURN: int
+* >= 0: the completions reaped
+* -1: the call failed, errno is EINTR when a signal cut the wait short
+*
+* NOTES:
+* Submits every prepared entry and waits in the same call. The wait ends
+* early when completions are already there to be reaped; a wait that times
+* out is not an error.
+*******************************************************************************/
+int uringEnter(PURING ring, unsigned int wait, int timeout_ms)
+{
+        struct io_uring_getevents_arg arg;
+        struct __kernel_timespec ts;
+        unsigned int flags = 0;
+        void *argp = NULL;
+        size_t argsz = 0;
+        long n;
+
+        __atomic_store_n(ring->sq_tail, ring->tail, __ATOMIC_RELEASE);
+
+        if(wait > 0 && __atomic_load_n(ring->cq_tail, __ATOMIC_ACQUIRE) !=
+                        *ring->cq_head) {
+                wait = 0;
+        }
+        if(ring->queued == 0 && wait == 0) {
+                return uringReap(ring);
+        }
+
+        if(wait > 0) {
+                flags |= IORING_ENTER_GETEVENTS;
+                if(timeout_ms >= 0) {
+                        memset(&arg, 0, sizeof(arg));
+                        ts.tv_sec = timeout_ms / 1000;
+                        ts.tv_nsec = (timeout_ms % 1000) * 1000000LL;
+                        arg.ts = (unsigned long long)(uintptr_t)&ts;
+                        argp = &arg;
+                        argsz = sizeof(arg);
+                        flags |= IORING_ENTER_EXT_ARG;
+                }
+        }
+
+        n = syscall(__NR_io_uring_enter, ring->fd, ring->queued, wait, flags,
+                argp, argsz);
+        ring->enters++;
+        if(n > 0) {
+                ring->submitted += n;
+                ring->queued -= n;
+        }
+        if(n < 0 && errno != ETIME) {
+                if(errno == EINTR) {
+                        uringReap(ring);
+                        errno = EINTR;
+                }
+                return -1;
+        }
+
+        return uringReap(ring);
+}
+
+/*******************************************************************************
+* FUNCTION: uringWait
+*
+* DATE: October 18, 2026
+*
+* REVISIONS: (Date and Description)
+*
+* DESIGNER: Karl Castillo (c)
+*
+* PROGRAMMER: Karl Castillo (c)
+*
+* INTERFACE: int uringWait(PURING ring, PURINGOP op)
+* ring: the ring
+* op: the operation to wait for
+*
+* RETURN: int
+* the result of its last completion
+* -1: the ring failed
+*
+* NOTES:
+* Other completions reaped on the way go to their own operations. Signals
+* do not end the wait.
+*******************************************************************************/
+int uringWait(PURING ring, PURINGOP op)
+{
+        while(op->pending > 0) {
+                if(uringEnter(ring, 1, -1) < 0 && errno != EINTR) {
+                        return -1;
+                }
+        }
+
+        return op->res;
+}
+
+/*******************************************************************************
+* FUNCTION: uringRegister
+*
+* DATE: October 18, 2026
+*
+* REVISIONS: (Date and Description)
+*
+* DESIGNER: Karl Castillo (c)
+*
+* PROGRAMMER: Karl Castillo (c)
+*
+* INTERFACE: int uringRegister(PURING ring, unsigned int opcode, void *arg,
+*       unsigned int count)
+* ring: the ring
+* opcode: what is registered, ex. IORING_REGISTER_FILES
+* arg: the files, buffers or structure to register
+* count: the number of them
+*
+* RETURN: int
+* 0: in success
+* -1: the kernel refused
+*******************************************************************************/
+int uringRegister(PURING ring, unsigned int opcode, void *arg,
+        unsigned int count)
+{
+        return syscall(__NR_io_uring_register, ring->fd, opcode, arg, count) <
+                0 ? -1 : 0;
+}
+
+/*******************************************************************************
+* FUNCTION: uringBuffers
+*
+* DATE: October 18, 2026
+*
+* REVISIONS: (Date and Description)
+*
+* DESIGNER: Karl Castillo (c)
+*
+* PROGRAMMER: Karl Castillo (c)
+*
+* INTERFACE: int uringBuffers(PURING ring, PURINGBUFS bufs, int group,
+*       int count, int size)
+* ring: the ring
+* bufs: the buffers to set up
+* group: the buffer group requests select from
+* count: the number of buffers, a power of 2
+* size: bytes per buffer
+*
+* RETURN: int
+* 0: in success
+* -1: the memory could not be allocated or the ring was refused
+*
+* NOTES:
+* Registers a ring of provided buffers, so a request with
+* IOSQE_BUFFER_SELECT takes a buffer only when its data arrives, and hands
+* every buffer to the kernel.
+*******************************************************************************/
+int uringBuffers(PURING ring, PURINGBUFS bufs, int group, int count,
+        int size)
+{
+        struct io_uring_buf_reg reg;
+        size_t ring_size = count * sizeof(struct io_uring_buf);
+        long page = sysconf(_SC_PAGESIZE);
+        int i;
+
+        memset(bufs, 0, sizeof(URINGBUFS));
+        bufs->group = group;
+        bufs->count = count;
+        bufs->size = size;
+
+        if(posix_memalign((void**)&bufs->ring, page, ring_size) != 0) {
+                bufs->ring = NULL;
+                return -1;
+        }
+        memset(bufs->ring, 0, ring_size);
+        if((bufs->base = (unsigned char*)malloc((size_t)count * size)) ==
+                        NULL) {
+                free(bufs->ring);
+                bufs->ring = NULL;
+                return -1;
+        }
+
+        memset(&reg, 0, sizeof(reg));
+        reg.ring_addr = (unsigned long long)(uintptr_t)bufs->ring;
+        reg.ring_entries = count;
+        reg.bgid = group;
+        if(uringRegister(ring, IORING_REGISTER_PBUF_RING, &reg, 1) < 0) {
+                free(bufs->base);
+                free(bufs->ring);
+                bufs->base = NULL;
+                bufs->ring = NULL;
+                return -1;
+        }
+
+        for(i = 0; i < count; i++) {
+                uringRecycle(bufs, i);
+        }
+        uringPublish(bufs);
+
+        return 0;
+}
+
+/*******************************************************************************
+* FUNCTION: uringRecycle
+*
+* DATE: October 18, 2026
+*
+* REVISIONS: (Date and Description)
+*
+* DESIGNER: Karl Castillo (c)
+*
+* PROGRAMMER: Karl Castillo (c)
+*
+* INTERFACE: void uringRecycle(PURINGBUFS bufs, int id)
+* bufs: the buffers
+* id: the buffer to give back
+*
+* RETURN: void
+*
+* NOTES:
+* The kernel only sees the buffer after uringPublish, so a batch of them
+* costs one store.
+*******************************************************************************/
+void uringRecycle(PURINGBUFS bufs, int id)
+{
+        struct io_uring_buf *buf;
+
+        buf = &bufs->ring->bufs[bufs->tail & (bufs->count - 1)];
+        buf->addr = (unsigned long long)(uintptr_t)(bufs->base +
+                (size_t)id * bufs->size);
+        buf->len = bufs->size;
+        buf->bid = id;
+        bufs->tail++;
+}
+
+/*******************************************************************************
+* FUNCTION: uringPublish
+*
+* DATE: October 18, 2026
+*
+* REVISIONS: (Date and Description)
+*
+* DESIGNER: Karl Castillo (c)
+*
+* PROGRAMMER: Karl Castillo (c)
+*
+* INTERFACE: void uringPublish(PURINGBUFS bufs)
+* bufs: the buffers
+*
+* RETURN: void
+*******************************************************************************/
+void uringPublish(PURINGBUFS bufs)
+{
+        __atomic_store_n(&bufs->ring->tail, bufs->tail, __ATOMIC_RELEASE);
+}
+
+/*******************************************************************************
+* FUNCTION: uringBuffersFree
+*
+* DATE: October 18, 2026
+*
+* REVISIONS: (Date and Description)
+*
+* DESIGNER: Karl Castillo (c)
+*
+* PROGRAMMER: Karl Castillo (c)
+*
+* INTERFACE: void uringBuffersFree(PURING ring, PURINGBUFS bufs)
+* ring: the ring
+* bufs: the buffers
+*
+* RETURN: void
+*******************************************************************************/
+void uringBuffersFree(PURING ring, PURINGBUFS bufs)
+{
+        struct io_uring_buf_reg reg;
+
+        if(bufs->ring == NULL) {
+                return;
+        }
+
+        memset(&reg, 0, sizeof(reg));
+        reg.bgid = bufs->group;
+        uringRegister(ring, IORING_UNREGISTER_PBUF_RING, &reg, 1);
+        free(bufs->base);
+        free(bufs->ring);
+        bufs->base = NULL;
+        bufs->ring = NULL;
+}
+
+/*******************************************************************************
+* FUNCTION: uringClose
+*
+* DATE: October 18, 2026
+*
+* REVISIONS: (Date and Description)
+*
+* DESIGNER: Karl Castillo (c)
+*
+* PROGRAMMER: Karl Castillo (c)
+*
+* INTERFACE: void uringClose(PURING ring)
+* ring: the ring
+*
+* RETURN: void
+*
+* NOTES:
+* Requests still in flight are cancelled by the kernel when the ring goes.
+*******************************************************************************/
+void uringClose(PURING ring)
+{
+        if(ring->fd < 0) {
+                return;
+        }
+
+        munmap(ring->sqes, ring->sqes_size);
+        munmap(ring->rings, ring->rings_size);
+        close(ring->fd);
+        ring->fd = -1;
+}
+
+/*******************************************************************************
+* FUNCTION: uringReport
+*
+* DATE: October 18, 2026
+*
+* REVISIONS: (Date and Description)
+*
+* DESIGNER: Karl Castillo (c)
+*
+* PROGRAMMER: Karl Castillo (c)
+*
+* INTERFACE: void uringReport(PURING ring, FILE *out)
+* ring: the ring
+* out: where the report will be printed
+*
+* RETURN: void
+*******************************************************************************/
+void uringReport(PURING ring, FILE *out)
+{
+        fprintf(out, "io_uring: %lu requests and %lu completions in %lu "
+                "calls (%.1f per call)\n", ring->submitted, ring->completed,
+                ring->enters, ring->enters > 0 ?
+                (double)(ring->submitted + ring->completed) / ring->enters :
+                0.0);
+}
+
+/*******************************************************************************
+* FUNCTION: uringReap
+*
+* DATE: October 18, 2026
+*
+* REVISIONS: (Date and Description)
+*
+* DESIGNER: Karl Castillo (c)
+*
+* PROGRAMMER: Karl Castillo (c)
+*
+* INTERFACE: static int uringReap(PURING ring)
+* ring: the ring
+*
+* RETURN: int: the completions reaped
+*
+* NOTES:
+* The head is moved past a completion before its handler runs, so a handler
+* may submit and reap again without seeing the same completion twice.
+*******************************************************************************/
+static int uringReap(PURING ring)
+{
+        struct io_uring_cqe *cqe;
+        PURINGOP op;
+        unsigned int head = *ring->cq_head;
+        unsigned int flags;
+        int reaped = 0;
+        int res;
+
+        while(head != __atomic_load_n(ring->cq_tail, __ATOMIC_ACQUIRE)) {
+                cqe = &ring->cqes[head & ring->cq_mask];
+                op = (PURINGOP)(uintptr_t)cqe->user_data;
+                res = cqe->res;
+                flags = cqe->flags;
+                __atomic_store_n(ring->cq_head, ++head, __ATOMIC_RELEASE);
+                ring->completed++;
+                reaped++;
+
+                if(op == NULL) {
+                        continue;
+                }
+                if(!(flags & IORING_CQE_F_MORE)) {
+                        op->pending--;
+                }
+                op->res = res;
+                op->flags = flags;
+                if(op->complete != NULL) {
+                        op->complete(op, res, flags);
+                }
+                head = *ring->cq_head;
+        }
+
+        return reaped;
+}
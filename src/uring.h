@@ -0,0 +1,97 @@
+/*******************************************************************************
+* HEADER FILE: uring.h
+*
+* PROGRAM: Covert
+*
+* FUNCTIONS:
+* int uringOpen(PURING ring, unsigned int entries, unsigned int cq_entries);
+* struct io_uring_sqe *uringGet(PURING ring, PURINGOP op);
+* int uringEnter(PURING ring, unsigned int wait, int timeout_ms);
+* int uringWait(PURING ring, PURINGOP op);
+* int uringRegister(PURING ring, unsigned int opcode, void *arg,
+*        unsigned int count);
+* int uringBuffers(PURING ring, PURINGBUFS bufs, int group, int count,
+*        int size);
+* void uringRecycle(PURINGBUFS bufs, int id);
+* void uringPublish(PURINGBUFS bufs);
+* void uringBuffersFree(PURING ring, PURINGBUFS bufs);
+* void uringClose(PURING ring);
+* void uringReport(PURING ring, FILE *out);
+*
+* DATE: October 18, 2026
+*
+* DESIGNER: Karl Castillo (c)
+*
+* PROGRAMMER: Karl Castillo (c)
+*
+* NOTES:
+* A small io_uring event loop on the raw system calls. Every request points
+* at an operation of its owner; reaping a completion stores the result in
+* the operation and calls its handler, so the sender, the input, the capture
+* and the output can all share one ring from one thread.
+*******************************************************************************/
+#ifndef URING_H
+#define URING_H
+
+#include <stdio.h>
+#include <stddef.h>
+#include <linux/io_uring.h>
+
+/* DEFINES */
+#define URING_MIN_BUFS  256     /* least buffers given to a multishot recv */
+
+/* STRUCTURES */
+typedef struct uringop {
+        void (*complete)(struct uringop *op, int res, unsigned int flags);
+        void *owner;                    /* handed to complete through op */
+        int res;                        /* the result of the last completion */
+        unsigned int flags;             /* and its flags */
+        int pending;                    /* completions still expected */
+} URINGOP, *PURINGOP;
+
+typedef struct uringbufs {
+        struct io_uring_buf_ring *ring; /* shared with the kernel */
+        unsigned char *base;            /* the buffers, size bytes each */
+        int group;                      /* the buffer group id */
+        int count;                      /* buffers, a power of 2 */
+        int size;                       /* bytes per buffer */
+        unsigned short tail;            /* the next free entry */
+} URINGBUFS, *PURINGBUFS;
+
+typedef struct uring {
+        int fd;                         /* the ring, or -1 */
+        void *rings;                    /* the mapped submission and */
+        size_t rings_size;              /*      completion rings */
+        struct io_uring_sqe *sqes;      /* the mapped submission entries */
+        size_t sqes_size;
+        unsigned int *sq_head;          /* moved by the kernel */
+        unsigned int *sq_tail;          /* moved by us */
+        unsigned int sq_mask;
+        unsigned int sq_entries;
+        unsigned int *cq_head;          /* moved by us */
+        unsigned int *cq_tail;          /* moved by the kernel */
+        unsigned int cq_mask;
+        struct io_uring_cqe *cqes;
+        unsigned int tail;              /* entries prepared so far */
+        unsigned int queued;            /* entries not submitted yet */
+        unsigned long enters;           /* io_uring_enter calls */
+        unsigned long submitted;        /* entries the kernel took */
+        unsigned long completed;        /* completions reaped */
+} URING, *PURING;
+
+/* PROTOTYPES */
+int uringOpen(PURING ring, unsigned int entries, unsigned int cq_entries);
+struct io_uring_sqe *uringGet(PURING ring, PURINGOP op);
+int uringEnter(PURING ring, unsigned int wait, int timeout_ms);
+int uringWait(PURING ring, PURINGOP op);
+int uringRegister(PURING ring, unsigned int opcode, void *arg,
+        unsigned int count);
+int uringBuffers(PURING ring, PURINGBUFS bufs, int group, int count,
+        int size);
+void uringRecycle(PURINGBUFS bufs, int id);
+void uringPublish(PURINGBUFS bufs);
+void uringBuffersFree(PURING ring, PURINGBUFS bufs);
+void uringClose(PURING ring);
+void uringReport(PURING ring, FILE *out);
+
+#endif
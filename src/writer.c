@@ -0,0 +1,1011 @@
+/*******************************************************************************
+* SOURCE FILE: writer.c
+*
+* PROGRAM: Covert
+*
+* FUNCTIONS:
+* int outputInit(POUTPUT output, int block_size, int blocks, int threaded,
+*        int lanes);
+* void outputClose(POUTPUT output);
+* void outputReport(POUTPUT output, FILE *out);
+* PLANE outputLane(POUTPUT output, int index);
+* int outputUring(POUTPUT output, PURING ring);
+* int writerOpen(PWRITER writer, POUTPUT output, char *name);
+* void writerWrite(PWRITER writer, const unsigned char *data, int length);
+* void writerFlush(PWRITER writer);
+* void writerClose(PWRITER writer);
+* static PBLOCK outputGet(POUTPUT output, PLANE lane);
+* static void outputPut(POUTPUT output, PBLOCK block);
+* static void outputSubmit(POUTPUT output, PLANE lane, PBLOCK block);
+* static void outputWrite(POUTPUT output, PBLOCK block);
+* static void outputQueue(POUTPUT output, PBLOCK block);
+* static void outputDone(PURINGOP op, int res, unsigned int flags);
+* static void outputIdle(POUTPUT output);
+* static void *outputMain(void *arg);
+* static void outputLanes(POUTPUT output);
+* static void laneGive(PBLOCK *ring, unsigned long *tail, int size,
+*        PBLOCK block);
+* static PBLOCK laneTake(PBLOCK *ring, unsigned long *head,
+*        unsigned long *tail, int size);
+*
+* DATE: October 18, 2026
+*
+* DESIGNER: Karl Castillo (c)
+*
+* PROGRAMMER: Karl Castillo (c)
+*
+* NOTES:
+* One output stage is shared by every writer. A writer fills a block and
+* hands it to the stage when it is full or flushed; the block knows its file
+* and offset so blocks of different files can be written in any order. The
+* number of blocks is bounded, so a disk that cannot keep up eventually
+* stalls the receive loop instead of eating all the memory.
+*
+* Without a thread the stage writes each block as soon as it is handed over,
+* which is still one system call per block instead of per byte.
+*
+* A stage with lanes serves several receive workers. Each worker fills and
+* recycles its blocks through its own lane, so the workers never contend for
+* the lock; the writer thread polls the lanes and sleeps a little longer
+* every time it finds them all empty.
+*
+* An inline stage can hand its writes to an io_uring instead. Every block is
+* allocated up front and registered with the ring so the kernel does not map
+* the pages again for every write; a completion gives the block back. Since
+* the writes of a file can complete in any order, the files are only closed
+* once no write is in flight.
+*******************************************************************************/
+/* INCLUDES */
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include <stdint.h>
+#include <errno.h>
+#include <fcntl.h>
+#include <unistd.h>
+#include <sched.h>
+#include <time.h>
+#include <sys/uio.h>
+#include "writer.h"
+
+/* PROTOTYPES */
+static PBLOCK outputGet(POUTPUT output, PLANE lane);
+static void outputPut(POUTPUT output, PBLOCK block);
+static void outputSubmit(POUTPUT output, PLANE lane, PBLOCK block);
+static void outputWrite(POUTPUT output, PBLOCK block);
+static void outputQueue(POUTPUT output, PBLOCK block);
+static void outputDone(PURINGOP op, int res, unsigned int flags);
+static void outputIdle(POUTPUT output);
+static void *outputMain(void *arg);
+static void outputLanes(POUTPUT output);
+static void laneGive(PBLOCK *ring, unsigned long *tail, int size,
+        PBLOCK block);
+static PBLOCK laneTake(PBLOCK *ring, unsigned long *head,
+        unsigned long *tail, int size);
+
+/*******************************************************************************
+* FUNCTION: outputInit
+*
+* DATE: October 18, 2026
+*
+* REVISIONS: (Date and Description)
+*
+* DESIGNER: Karl Castillo (c)
+*
+* PROGRAMMER: Karl Castillo (c)
+*
+* INTERFACE: int outputInit(POUTPUT output, int block_size, int blocks,
+*       int threaded, int lanes)
+* output: the stage to initialize
+* block_size: bytes collected before a write
+* blocks: the most blocks queued or being filled at once, per lane if any
+* threaded: write from a thread of its own
+* lanes: the number of receive workers with a lane of their own, or 0
+*
+* RETURN: int
+* 0: in success
+* -1: the lanes could not be allocated or the thread could not be started
+*
+* NOTES:
+* Lanes are always emptied by the writer thread.
+*******************************************************************************/
+int outputInit(POUTPUT output, int block_size, int blocks, int threaded,
+        int lanes)
+{
+        int i;
+
+        memset(output, 0, sizeof(OUTPUT));
+        output->block_size = block_size;
+        output->blocks = blocks;
+        output->threaded = threaded || lanes > 0;
+
+        pthread_mutex_init(&output->lock, NULL);
+        pthread_cond_init(&output->queued, NULL);
+        pthread_cond_init(&output->freed, NULL);
+
+        if(lanes > 0) {
+                if((output->lanes = (PLANE)calloc(lanes, sizeof(LANE))) ==
+                                NULL) {
+                        return -1;
+                }
+                output->lane_count = lanes;
+                for(i = 0; i < lanes; i++) {
+                        output->lanes[i].size = blocks;
+                        output->lanes[i].queued = (PBLOCK*)calloc(blocks,
+                                sizeof(PBLOCK));
+                        output->lanes[i].spent = (PBLOCK*)calloc(blocks,
+                                sizeof(PBLOCK));
+                        if(output->lanes[i].queued == NULL ||
+                                        output->lanes[i].spent == NULL) {
+                                return -1;
+                        }
+                }
+        }
+
+        if(output->threaded && pthread_create(&output->thread, NULL,
+                        outputMain, output) != 0) {
+                return -1;
+        }
+
+        return 0;
+}
+
+/*******************************************************************************
+* FUNCTION: outputClose
+*
+* DATE: October 18, 2026
+*
+* REVISIONS: (Date and Description)
+*
+* DESIGNER: Karl Castillo (c)
+*
+* PROGRAMMER: Karl Castillo (c)
+*
+* INTERFACE: void outputClose(POUTPUT output)
+* output: the stage
+*
+* RETURN: void
+*
+* NOTES:
+* Every writer must be closed first. The thread writes what is still queued
+* before it exits, and the ring writes in flight are waited for.
+*******************************************************************************/
+void outputClose(POUTPUT output)
+{
+        PLANE lane;
+        PBLOCK block;
+        int i;
+
+        if(output->threaded) {
+                pthread_mutex_lock(&output->lock);
+                __atomic_store_n(&output->stop, 1, __ATOMIC_RELEASE);
+                pthread_cond_signal(&output->queued);
+                pthread_mutex_unlock(&output->lock);
+                pthread_join(output->thread, NULL);
+        }
+
+        if(output->uring != NULL) {
+                while(output->inflight > 0) {
+                        uringEnter(output->uring, 1, -1);
+                }
+                outputIdle(output);
+                if(output->fixed) {
+                        uringRegister(output->uring,
+                                IORING_UNREGISTER_BUFFERS, NULL, 0);
+                }
+                output->free = NULL;
+                free(output->arena);
+        }
+
+        while((block = output->free) != NULL) {
+                output->free = block->next;
+                free(block);
+        }
+
+        for(i = 0; i < output->lane_count; i++) {
+                lane = &output->lanes[i];
+                while((block = laneTake(lane->spent, &lane->spent_head,
+                                &lane->spent_tail, lane->size)) != NULL) {
+                        free(block);
+                }
+                free(lane->queued);
+                free(lane->spent);
+        }
+        free(output->lanes);
+
+        pthread_cond_destroy(&output->freed);
+        pthread_cond_destroy(&output->queued);
+        pthread_mutex_destroy(&output->lock);
+}
+
+/*******************************************************************************
+* FUNCTION: outputReport
+*
+* DATE: October 18, 2026
+*
+* REVISIONS: (Date and Description)
+*
+* DESIGNER: Karl Castillo (c)
+*
+* PROGRAMMER: Karl Castillo (c)
+*
+* INTERFACE: void outputReport(POUTPUT output, FILE *out)
+* output: the stage
+* out: where the report will be printed
+*
+* RETURN: void
+*
+* NOTES:
+* The stalls of the lanes are added to those of the shared queue.
+*******************************************************************************/
+void outputReport(POUTPUT output, FILE *out)
+{
+        unsigned long stalls = output->stalls;
+        int i;
+
+        for(i = 0; i < output->lane_count; i++) {
+                stalls += output->lanes[i].stalls;
+        }
+
+        fprintf(out, "Output: %lu bytes in %lu writes (%d KB blocks, %s",
+                output->bytes, output->writes, output->block_size / 1024,
+                output->threaded ? "writer thread" : output->uring == NULL ?
+                "inline" : output->fixed ? "io_uring, registered" :
+                "io_uring");
+        if(output->lane_count > 0) {
+                fprintf(out, ", %d lanes", output->lane_count);
+        }
+        fprintf(out, "), %lu stalls, %lu errors\n", stalls, output->errors);
+}
+
+/*******************************************************************************
+* FUNCTION: outputLane
+*
+* DATE: October 18, 2026
+*
+* REVISIONS: (Date and Description)
+*
+* DESIGNER: Karl Castillo (c)
+*
+* PROGRAMMER: Karl Castillo (c)
+*
+* INTERFACE: PLANE outputLane(POUTPUT output, int index)
+* output: the stage
+* index: the worker
+*
+* RETURN: PLANE: the lane of the worker, or NULL without lanes
+*
+* NOTES:
+* A lane must only be used by one worker.
+*******************************************************************************/
+PLANE outputLane(POUTPUT output, int index)
+{
+        if(index < 0 || index >= output->lane_count) {
+                return NULL;
+        }
+
+        return &output->lanes[index];
+}
+
+/*******************************************************************************
+* FUNCTION: outputUring
+*
+* DATE: October 18, 2026
+*
+* REVISIONS: (Date and Description)
+*
+* DESIGNER: Karl Castillo (c)
+*
+* PROGRAMMER: Karl Castillo (c)
+*
+* INTERFACE: int outputUring(POUTPUT output, PURING ring)
+* output: an inline stage without lanes that no block was taken from
+* ring: the ring the blocks are written through, open until the stage is
+*       closed
+*
+* RETURN: int
+* 0: in success
+* -1: the stage is threaded or the blocks could not be allocated
+*
+* NOTES:
+* When the ring refuses to register the blocks, as it may when the locked
+* memory limit is low, they are written with plain ring writes instead.
+*******************************************************************************/
+int outputUring(POUTPUT output, PURING ring)
+{
+        struct iovec *iovs;
+        PBLOCK block;
+        size_t stride = (sizeof(BLOCK) + output->block_size + 63) & ~63UL;
+        int i;
+
+        if(output->threaded) {
+                errno = EINVAL;
+                return -1;
+        }
+
+        if((output->arena = (PBLOCK)malloc(stride * output->blocks)) ==
+                        NULL || (iovs = (struct iovec*)calloc(output->blocks,
+                        sizeof(struct iovec))) == NULL) {
+                free(output->arena);
+                output->arena = NULL;
+                return -1;
+        }
+
+        for(i = output->blocks - 1; i >= 0; i--) {
+                block = (PBLOCK)((unsigned char*)output->arena + stride * i);
+                memset(block, 0, sizeof(BLOCK));
+                block->data = (unsigned char*)(block + 1);
+                block->output = output;
+                block->op.owner = block;
+                block->op.complete = outputDone;
+                block->index = i;
+                block->next = output->free;
+                output->free = block;
+                iovs[i].iov_base = block->data;
+                iovs[i].iov_len = output->block_size;
+        }
+        output->allocated = output->blocks;
+        output->uring = ring;
+        output->fixed = uringRegister(ring, IORING_REGISTER_BUFFERS, iovs,
+                output->blocks) == 0;
+        free(iovs);
+
+        return 0;
+}
+
+/*******************************************************************************
+* FUNCTION: writerOpen
+*
+* DATE: October 18, 2026
+*
+* REVISIONS: (Date and Description)
+*
+* DESIGNER: Karl Castillo (c)
+*
+* PROGRAMMER: Karl Castillo (c)
+*
+* INTERFACE: int writerOpen(PWRITER writer, POUTPUT output, char *name)
+* writer: the writer to open
+* output: the stage the writer feeds
+* name: the output file, truncated if it exists
+*
+* RETURN: int
+* 0: in success
+* -1: the file could not be opened
+*******************************************************************************/
+int writerOpen(PWRITER writer, POUTPUT output, char *name)
+{
+        memset(writer, 0, sizeof(WRITER));
+        writer->output = output;
+
+        if((writer->fd = open(name, O_WRONLY | O_CREAT | O_TRUNC, 0644)) < 0) {
+                return -1;
+        }
+
+        return 0;
+}
+
+/*******************************************************************************
+* FUNCTION: writerWrite
+*
+* DATE: October 18, 2026
+*
+* REVISIONS: (Date and Description)
+*
+* DESIGNER: Karl Castillo (c)
+*
+* PROGRAMMER: Karl Castillo (c)
+*
+* INTERFACE: void writerWrite(PWRITER writer, const unsigned char *data,
+*       int length)
+* writer: the writer
+* data: the bytes to append to the file
+* length: the number of bytes
+*
+* RETURN: void
+*******************************************************************************/
+void writerWrite(PWRITER writer, const unsigned char *data, int length)
+{
+        int room;
+
+        while(length > 0) {
+                if(writer->block == NULL) {
+                        writer->block = outputGet(writer->output,
+                                writer->lane);
+                        writer->block->fd = writer->fd;
+                        writer->block->offset = writer->offset;
+                }
+
+                room = writer->output->block_size - writer->block->length;
+                if(room > length) {
+                        room = length;
+                }
+                memcpy(writer->block->data + writer->block->length, data, room);
+                writer->block->length += room;
+                writer->offset += room;
+                data += room;
+                length -= room;
+
+                if(writer->block->length == writer->output->block_size) {
+                        writerFlush(writer);
+                }
+        }
+}
+
+/*******************************************************************************
+* FUNCTION: writerFlush
+*
+* DATE: October 18, 2026
+*
+* REVISIONS: (Date and Description)
+*
+* DESIGNER: Karl Castillo (c)
+*
+* PROGRAMMER: Karl Castillo (c)
+*
+* INTERFACE: void writerFlush(PWRITER writer)
+* writer: the writer
+*
+* RETURN: void
+*
+* NOTES:
+* Hands the block being filled to the stage, full or not.
+*******************************************************************************/
+void writerFlush(PWRITER writer)
+{
+        if(writer->block != NULL && writer->block->length > 0) {
+                outputSubmit(writer->output, writer->lane, writer->block);
+                writer->block = NULL;
+        }
+}
+
+/*******************************************************************************
+* FUNCTION: writerClose
+*
+* DATE: October 18, 2026
+*
+* REVISIONS: (Date and Description)
+*
+* DESIGNER: Karl Castillo (c)
+*
+* PROGRAMMER: Karl Castillo (c)
+*
+* INTERFACE: void writerClose(PWRITER writer)
+* writer: the writer
+*
+* RETURN: void
+*
+* NOTES:
+* The file is closed by the stage after its last block has been written.
+*******************************************************************************/
+void writerClose(PWRITER writer)
+{
+        if(writer->block == NULL) {
+                writer->block = outputGet(writer->output, writer->lane);
+                writer->block->fd = writer->fd;
+                writer->block->offset = writer->offset;
+        }
+        writer->block->close = 1;
+        outputSubmit(writer->output, writer->lane, writer->block);
+        writer->block = NULL;
+}
+
+/*******************************************************************************
+* FUNCTION: outputGet
+*
+* DATE: October 18, 2026
+*
+* REVISIONS: (Date and Description)
+*
+* DESIGNER: Karl Castillo (c)
+*
+* PROGRAMMER: Karl Castillo (c)
+*
+* INTERFACE: static PBLOCK outputGet(POUTPUT output, PLANE lane)
+* output: the stage
+* lane: the lane of the caller, or NULL
+*
+* RETURN: PBLOCK: an empty block
+*
+* NOTES:
+* Blocks are allocated as needed up to the limit, then recycled. When all of
+* them are queued the caller waits for the thread to write one. A lane has
+* its own limit and its worker yields until a block comes back, and a ring
+* stage waits on the ring for a write to complete.
+*******************************************************************************/
+static PBLOCK outputGet(POUTPUT output, PLANE lane)
+{
+        PBLOCK block;
+
+        if(lane != NULL) {
+                block = laneTake(lane->spent, &lane->spent_head,
+                        &lane->spent_tail, lane->size);
+                if(block == NULL && lane->allocated >= output->blocks) {
+                        lane->stalls++;
+                        while((block = laneTake(lane->spent,
+                                        &lane->spent_head, &lane->spent_tail,
+                                        lane->size)) == NULL) {
+                                sched_yield();
+                        }
+                }
+                if(block == NULL) {
+                        lane->allocated++;
+                }
+        } else {
+                if(output->uring != NULL && output->free == NULL) {
+                        output->stalls++;
+                        while(output->free == NULL) {
+                                uringEnter(output->uring, 1, -1);
+                        }
+                }
+
+                pthread_mutex_lock(&output->lock);
+                if(output->free == NULL &&
+                                output->allocated >= output->blocks) {
+                        output->stalls++;
+                        while(output->free == NULL) {
+                                pthread_cond_wait(&output->freed,
+                                        &output->lock);
+                        }
+                }
+
+                if((block = output->free) != NULL) {
+                        output->free = block->next;
+                } else {
+                        output->allocated++;
+                }
+                pthread_mutex_unlock(&output->lock);
+        }
+
+        if(block == NULL) {
+                if((block = (PBLOCK)malloc(sizeof(BLOCK) +
+                                output->block_size)) == NULL) {
+                        perror("Cannot allocate output block");
+                        exit(1);
+                }
+                block->data = (unsigned char*)(block + 1);
+        }
+
+        block->next = NULL;
+        block->length = 0;
+        block->close = 0;
+        block->done = 0;
+
+        return block;
+}
+
+/*******************************************************************************
+* FUNCTION: outputPut
+*
+* DATE: October 18, 2026
+*
+* REVISIONS: (Date and Description)
+*
+* DESIGNER: Karl Castillo (c)
+*
+* PROGRAMMER: Karl Castillo (c)
+*
+* INTERFACE: static void outputPut(POUTPUT output, PBLOCK block)
+* output: the stage
+* block: a block that has been written
+*
+* RETURN: void
+*******************************************************************************/
+static void outputPut(POUTPUT output, PBLOCK block)
+{
+        pthread_mutex_lock(&output->lock);
+        block->next = output->free;
+        output->free = block;
+        pthread_cond_signal(&output->freed);
+        pthread_mutex_unlock(&output->lock);
+}
+
+/*******************************************************************************
+* FUNCTION: outputSubmit
+*
+* DATE: October 18, 2026
+*
+* REVISIONS: (Date and Description)
+*
+* DESIGNER: Karl Castillo (c)
+*
+* PROGRAMMER: Karl Castillo (c)
+*
+* INTERFACE: static void outputSubmit(POUTPUT output, PLANE lane,
+*       PBLOCK block)
+* output: the stage
+* lane: the lane of the caller, or NULL
+* block: a filled block
+*
+* RETURN: void
+*******************************************************************************/
+static void outputSubmit(POUTPUT output, PLANE lane, PBLOCK block)
+{
+        if(lane != NULL) {
+                laneGive(lane->queued, &lane->queued_tail, lane->size, block);
+                return;
+        }
+
+        if(output->uring != NULL) {
+                output->inflight++;
+                outputQueue(output, block);
+                return;
+        }
+
+        if(!output->threaded) {
+                outputWrite(output, block);
+                outputPut(output, block);
+                return;
+        }
+
+        pthread_mutex_lock(&output->lock);
+        if(output->tail == NULL) {
+                output->head = block;
+        } else {
+                output->tail->next = block;
+        }
+        output->tail = block;
+        pthread_cond_signal(&output->queued);
+        pthread_mutex_unlock(&output->lock);
+}
+
+/*******************************************************************************
+* FUNCTION: outputWrite
+*
+* DATE: October 18, 2026
+*
+* REVISIONS: (Date and Description)
+*
+* DESIGNER: Karl Castillo (c)
+*
+* PROGRAMMER: Karl Castillo (c)
+*
+* INTERFACE: static void outputWrite(POUTPUT output, PBLOCK block)
+* output: the stage
+* block: the block to write
+*
+* RETURN: void
+*
+* NOTES:
+* The counters are only touched by whoever writes, the thread or the receive
+* loop, never both.
+*******************************************************************************/
+static void outputWrite(POUTPUT output, PBLOCK block)
+{
+        unsigned char *data = block->data;
+        off_t offset = block->offset;
+        int length = block->length;
+        ssize_t n;
+
+        while(length > 0) {
+                if((n = pwrite(block->fd, data, length, offset)) < 0) {
+                        if(errno == EINTR) {
+                                continue;
+                        }
+                        output->errors++;
+                        break;
+                }
+                output->writes++;
+                output->bytes += n;
+                data += n;
+                offset += n;
+                length -= n;
+        }
+
+        if(block->close) {
+                close(block->fd);
+        }
+}
+
+/*******************************************************************************
+* FUNCTION: outputQueue
+*
+* DATE: October 18, 2026
+*
+* REVISIONS: (Date and Description)
+*
+* DESIGNER: Karl Castillo (c)
+*
+* PROGRAMMER: Karl Castillo (c)
+*
+* INTERFACE: static void outputQueue(POUTPUT output, PBLOCK block)
+* output: a ring stage
+* block: a block with bytes left to write
+*
+* RETURN: void
+*
+* NOTES:
+* The write is submitted right away so that it overlaps the receive loop
+* even when nothing else waits on the ring. When the kernel takes no more
+* requests, the completions are reaped until it does.
+*******************************************************************************/
+static void outputQueue(POUTPUT output, PBLOCK block)
+{
+        struct io_uring_sqe *sqe;
+
+        while((sqe = uringGet(output->uring, &block->op)) == NULL) {
+                uringEnter(output->uring, 1, -1);
+        }
+
+        sqe->opcode = output->fixed ? IORING_OP_WRITE_FIXED : IORING_OP_WRITE;
+        sqe->fd = block->fd;
+        sqe->addr = (unsigned long long)(uintptr_t)(block->data + block->done);
+        sqe->len = block->length - block->done;
+        sqe->off = block->offset + block->done;
+        sqe->buf_index = output->fixed ? block->index : 0;
+        uringEnter(output->uring, 0, 0);
+}
+
+/*******************************************************************************
+* FUNCTION: outputDone
+*
+* DATE: October 18, 2026
+*
+* REVISIONS: (Date and Description)
+*
+* DESIGNER: Karl Castillo (c)
+*
+* PROGRAMMER: Karl Castillo (c)
+*
+* INTERFACE: static void outputDone(PURINGOP op, int res, unsigned int flags)
+* op: the ring write of a block
+* res: the bytes written, or an error
+* flags: unused
+*
+* RETURN: void
+*
+* NOTES:
+* A short write is submitted again for the rest of the block. A finished
+* block that closes its file waits on the closing list until no write is in
+* flight, since other blocks of the file may still be on their way.
+*******************************************************************************/
+static void outputDone(PURINGOP op, int res, unsigned int flags)
+{
+        PBLOCK block = (PBLOCK)op->owner;
+        POUTPUT output = block->output;
+
+        (void)flags;
+
+        if(res == -EINTR || res == -EAGAIN) {
+                outputQueue(output, block);
+                return;
+        }
+        if(res < 0) {
+                output->errors++;
+        } else if(res > 0) {
+                output->writes++;
+                output->bytes += res;
+                block->done += res;
+                if(block->done < block->length) {
+                        outputQueue(output, block);
+                        return;
+                }
+        }
+
+        output->inflight--;
+        if(block->close) {
+                block->next = output->closing;
+                output->closing = block;
+        } else {
+                outputPut(output, block);
+        }
+        if(output->inflight == 0) {
+                outputIdle(output);
+        }
+}
+
+/*******************************************************************************
+* FUNCTION: outputIdle
+*
+* DATE: October 18, 2026
+*
+* REVISIONS: (Date and Description)
+*
+* DESIGNER: Karl Castillo (c)
+*
+* PROGRAMMER: Karl Castillo (c)
+*
+* INTERFACE: static void outputIdle(POUTPUT output)
+* output: a ring stage with no write in flight
+*
+* RETURN: void
+*
+* NOTES:
+* Closes the files whose last block has been written and frees the blocks.
+*******************************************************************************/
+static void outputIdle(POUTPUT output)
+{
+        PBLOCK block;
+
+        while((block = output->closing) != NULL) {
+                output->closing = block->next;
+                close(block->fd);
+                outputPut(output, block);
+        }
+}
+
+/*******************************************************************************
+* FUNCTION: outputMain
+*
+* DATE: October 18, 2026
+*
+* REVISIONS: (Date and Description)
+*
+* DESIGNER: Karl Castillo (c)
+*
+* PROGRAMMER: Karl Castillo (c)
+*
+* INTERFACE: static void *outputMain(void *arg)
+* arg: the stage
+*
+* RETURN: void *: NULL
+*
+* NOTES:
+* The writer thread. It exits once it is told to stop and the queue is
+* empty.
+*******************************************************************************/
+static void *outputMain(void *arg)
+{
+        POUTPUT output = (POUTPUT)arg;
+        PBLOCK block;
+
+        if(output->lanes != NULL) {
+                outputLanes(output);
+                return NULL;
+        }
+
+        for(;;) {
+                pthread_mutex_lock(&output->lock);
+                while(output->head == NULL && !output->stop) {
+                        pthread_cond_wait(&output->queued, &output->lock);
+                }
+                if((block = output->head) == NULL) {
+                        pthread_mutex_unlock(&output->lock);
+                        break;
+                }
+                if((output->head = block->next) == NULL) {
+                        output->tail = NULL;
+                }
+                pthread_mutex_unlock(&output->lock);
+
+                outputWrite(output, block);
+                outputPut(output, block);
+        }
+
+        return NULL;
+}
+
+/*******************************************************************************
+* FUNCTION: outputLanes
+*
+* DATE: October 18, 2026
+*
+* REVISIONS: (Date and Description)
+*
+* DESIGNER: Karl Castillo (c)
+*
+* PROGRAMMER: Karl Castillo (c)
+*
+* INTERFACE: static void outputLanes(POUTPUT output)
+* output: the stage
+*
+* RETURN: void
+*
+* NOTES:
+* The writer thread of a stage with lanes. Every lane is emptied in turn and
+* its blocks go back to it once written. The sleep between empty sweeps
+* doubles up to LANE_IDLE_US, so a busy stage is polled often and an idle
+* one costs little. The stop flag is read before the sweep, so the last
+* sweep sees every block queued before the workers ended.
+*******************************************************************************/
+static void outputLanes(POUTPUT output)
+{
+        struct timespec idle;
+        PLANE lane;
+        PBLOCK block;
+        int found;
+        int stop;
+        int i;
+
+        idle.tv_sec = 0;
+        idle.tv_nsec = 0;
+
+        for(;;) {
+                stop = __atomic_load_n(&output->stop, __ATOMIC_ACQUIRE);
+                found = 0;
+                for(i = 0; i < output->lane_count; i++) {
+                        lane = &output->lanes[i];
+                        while((block = laneTake(lane->queued,
+                                        &lane->queued_head, &lane->queued_tail,
+                                        lane->size)) != NULL) {
+                                outputWrite(output, block);
+                                laneGive(lane->spent, &lane->spent_tail,
+                                        lane->size, block);
+                                found = 1;
+                        }
+                }
+
+                if(found) {
+                        idle.tv_nsec = 0;
+                        continue;
+                }
+                if(stop) {
+                        break;
+                }
+
+                idle.tv_nsec = idle.tv_nsec == 0 ? 16000 : idle.tv_nsec * 2;
+                if(idle.tv_nsec > LANE_IDLE_US * 1000L) {
+                        idle.tv_nsec = LANE_IDLE_US * 1000L;
+                }
+                nanosleep(&idle, NULL);
+        }
+}
+
+/*******************************************************************************
+* FUNCTION: laneGive
+*
+* DATE: October 18, 2026
+*
+* REVISIONS: (Date and Description)
+*
+* DESIGNER: Karl Castillo (c)
+*
+* PROGRAMMER: Karl Castillo (c)
+*
+* INTERFACE: static void laneGive(PBLOCK *ring, unsigned long *tail,
+*       int size, PBLOCK block)
+* ring: one ring of a lane
+* tail: where the next block goes, only moved by the caller
+* size: the slots in the ring
+* block: the block to add
+*
+* RETURN: void
+*
+* NOTES:
+* A lane never owns more blocks than its rings have slots, so the ring
+* cannot fill up and the producer never has to look at the head. The
+* release store publishes the slot along with the block it points to.
+*******************************************************************************/
+static void laneGive(PBLOCK *ring, unsigned long *tail, int size,
+        PBLOCK block)
+{
+        unsigned long at = *tail;
+
+        ring[at % size] = block;
+        __atomic_store_n(tail, at + 1, __ATOMIC_RELEASE);
+}
+
+/*******************************************************************************
+* FUNCTION: laneTake
+*
+* DATE: October 18, 2026
+*
+* REVISIONS: (Date and Description)
+*
+* DESIGNER: Karl Castillo (c)
+*
+* PROGRAMMER: Karl Castillo (c)
+*
+* INTERFACE: static PBLOCK laneTake(PBLOCK *ring, unsigned long *head,
+*       unsigned long *tail, int size)
+* ring: one ring of a lane
+* head: the next block to take, only moved by the caller
+* tail: where the producer adds blocks
+* size: the slots in the ring
+*
+* RETURN: PBLOCK: the oldest block in the ring, or NULL when it is empty
+*******************************************************************************/
+static PBLOCK laneTake(PBLOCK *ring, unsigned long *head,
+        unsigned long *tail, int size)
+{
+        unsigned long at = *head;
+        PBLOCK block;
+
+        if(at == __atomic_load_n(tail, __ATOMIC_ACQUIRE)) {
+                return NULL;
+        }
+        block = ring[at % size];
+        __atomic_store_n(head, at + 1, __ATOMIC_RELEASE);
+
+        return block;
+}
@@ -0,0 +1,123 @@
+/*******************************************************************************
+* HEADER FILE: writer.h
+*
+* PROGRAM: Covert
+*
+* FUNCTIONS:
+* int outputInit(POUTPUT output, int block_size, int blocks, int threaded,
+*        int lanes);
+* void outputClose(POUTPUT output);
+* void outputReport(POUTPUT output, FILE *out);
+* PLANE outputLane(POUTPUT output, int index);
+* int outputUring(POUTPUT output, PURING ring);
+* int writerOpen(PWRITER writer, POUTPUT output, char *name);
+* void writerWrite(PWRITER writer, const unsigned char *data, int length);
+* void writerFlush(PWRITER writer);
+* void writerClose(PWRITER writer);
+*
+* DATE: October 18, 2026
+*
+* DESIGNER: Karl Castillo (c)
+*
+* PROGRAMMER: Karl Castillo (c)
+*
+* NOTES:
+* The output stage of the server. Decoded bytes are collected in large
+* blocks and every block is written with a single pwrite, either right away
+* or by a writer thread so the receive loop never waits on the disk.
+*
+* With several receive workers every worker has a lane of its own: two
+* single-producer, single-consumer rings that carry its filled blocks to the
+* writer thread and the written ones back, without a lock.
+*
+* Given an io_uring, the blocks are written asynchronously from buffers
+* registered with the ring, and the receive loop only waits when every block
+* is still being written.
+*******************************************************************************/
+#ifndef WRITER_H
+#define WRITER_H
+
+#include <stdio.h>
+#include <pthread.h>
+#include <sys/types.h>
+#include "uring.h"
+
+/* DEFINES */
+#define DEF_BLOCK_KB    256     /* bytes collected before a write */
+#define DEF_BLOCKS      16      /* blocks queued or being filled at most */
+#define DEF_FLUSH_MS    1000    /* longest a partial block is held */
+#define LANE_IDLE_US    1000    /* longest the writer sleeps on empty lanes */
+
+/* STRUCTURES */
+typedef struct block {
+        struct block *next;             /* the next block in the queue */
+        int fd;                         /* the file it belongs to */
+        off_t offset;                   /* where it goes in the file */
+        int length;                     /* bytes in data */
+        int close;                      /* close fd once written */
+        unsigned char *data;            /* block_size bytes */
+        struct output *output;          /* the stage, for a ring write */
+        URINGOP op;                     /* the ring write */
+        int index;                      /* its registered buffer */
+        int done;                       /* bytes of it written so far */
+} BLOCK, *PBLOCK;
+
+typedef struct lane {
+        PBLOCK *queued;                 /* filled blocks, worker to writer */
+        PBLOCK *spent;                  /* written blocks, writer to worker */
+        int size;                       /* slots in each ring */
+        unsigned long queued_head;      /* taken by the writer */
+        unsigned long queued_tail;      /* added by the worker */
+        unsigned long spent_head;       /* taken by the worker */
+        unsigned long spent_tail;       /* added by the writer */
+        int allocated;                  /* blocks the worker allocated */
+        unsigned long stalls;           /* times no block came back in time */
+} LANE, *PLANE;
+
+typedef struct output {
+        int block_size;                 /* bytes per block */
+        int blocks;                     /* most blocks allocated */
+        int allocated;                  /* blocks allocated so far */
+        int threaded;                   /* blocks are written by a thread */
+        int stop;                       /* the thread should exit */
+        pthread_t thread;               /* the writer thread */
+        pthread_mutex_t lock;           /* protects the lists and counters */
+        pthread_cond_t queued;          /* a block was queued or stop set */
+        pthread_cond_t freed;           /* a block was given back */
+        PBLOCK head;                    /* blocks waiting to be written */
+        PBLOCK tail;
+        PBLOCK free;                    /* blocks ready to be filled */
+        PLANE lanes;                    /* one per worker, or NULL */
+        int lane_count;                 /* the number of lanes */
+        PURING uring;                   /* blocks are written through it */
+        PBLOCK arena;                   /* every block of the ring */
+        int fixed;                      /* their buffers are registered */
+        int inflight;                   /* ring writes not completed */
+        PBLOCK closing;                 /* written, closed once idle */
+        unsigned long writes;           /* pwrite calls */
+        unsigned long bytes;            /* bytes written */
+        unsigned long stalls;           /* times no block was free */
+        unsigned long errors;           /* failed writes */
+} OUTPUT, *POUTPUT;
+
+typedef struct writer {
+        POUTPUT output;                 /* the stage the writer feeds */
+        int fd;                         /* the output file */
+        off_t offset;                   /* where the next block goes */
+        PBLOCK block;                   /* the block being filled, or NULL */
+        PLANE lane;                     /* the lane of its worker, or NULL */
+} WRITER, *PWRITER;
+
+/* PROTOTYPES */
+int outputInit(POUTPUT output, int block_size, int blocks, int threaded,
+        int lanes);
+void outputClose(POUTPUT output);
+void outputReport(POUTPUT output, FILE *out);
+PLANE outputLane(POUTPUT output, int index);
+int outputUring(POUTPUT output, PURING ring);
+int writerOpen(PWRITER writer, POUTPUT output, char *name);
+void writerWrite(PWRITER writer, const unsigned char *data, int length);
+void writerFlush(PWRITER writer);
+void writerClose(PWRITER writer);
+
+#endif
@@ -0,0 +1,101 @@
+#!/bin/bash
+################################################################################
+# SCRIPT FILE: transfers.sh
+#
+# PROGRAM: Covert
+#
+# DATE: October 18, 2026
+#
+# DESIGNER: Karl Castillo (c)
+#
+# PROGRAMMER: Karl Castillo (c)
+#
+# USAGE: transfers.sh [bin directory]
+#
+# NOTES:
+# Back to back transfers on the same source port. The client writes its
+# packets to pcap files instead of sending them, so no root is needed, and
+# the server reads two of them joined into one capture, the second transfer
+# right behind the first. Its output has to be both payloads, byte for byte.
+#
+# Each mode is run twice: with two client runs, which draw their own
+# transfer ids, and with one run replayed twice, so the second transfer has
+# the id of the first and is only told apart by its packet 0.
+#
+# Settings come from the environment:
+#       SIZE    the payload of each transfer, as head -c takes it  (100K)
+#       LAYOUT  the layout both sides use                          (seq,id)
+################################################################################
+
+BDIR=${1:-./bin}
+SIZE=${SIZE:-100K}
+LAYOUT=${LAYOUT:-seq,id}
+
+if [ ! -x "$BDIR/client" ] || [ ! -x "$BDIR/server" ]; then
+        echo "Build the client and the server first" >&2
+        exit 1
+fi
+
+TMP=$(mktemp -d)
+trap 'rm -rf "$TMP"' EXIT
+
+failed=0
+
+# capture NAME INPUT ARGS: the packets of one client run
+capture() {
+        "$BDIR/client" -S 127.0.0.1 -D 127.0.0.1 -r 0 -L $LAYOUT $3 \
+                -f "$2" -w "$TMP/$1.pcap" > "$TMP/client.log" 2>&1
+}
+
+# run NAME ARGS SECOND: replays first.pcap followed by SECOND.pcap
+run() {
+        local name=$1 args=$2 second=$3
+
+        head -c 24 "$TMP/first.pcap" > "$TMP/both.pcap"
+        tail -c +25 "$TMP/first.pcap" >> "$TMP/both.pcap"
+        tail -c +25 "$TMP/$second.pcap" >> "$TMP/both.pcap"
+        cat "$TMP/one.bin" "$TMP/$second.bin" > "$TMP/expected.bin"
+        rm -f "$TMP/out.bin"
+
+        "$BDIR/server" -S 127.0.0.1 -L $LAYOUT $args -r "$TMP/both.pcap" \
+                -f "$TMP/out.bin" > "$TMP/server.log" 2>&1
+
+        if cmp -s "$TMP/expected.bin" "$TMP/out.bin"; then
+                echo "$name: ok"
+        else
+                echo "$name: FAILED"
+                grep -a "Reassembled\|Reordered\|Loss" "$TMP/server.log"
+                failed=1
+        fi
+}
+
+head -c "$SIZE" /dev/urandom > "$TMP/one.bin"
+head -c "$SIZE" /dev/urandom > "$TMP/two.bin"
+cp "$TMP/one.bin" "$TMP/first.bin"
+
+for mode in plain fec flows; do
+        case $mode in
+        plain)
+                args=""
+                ;;
+        fec)
+                args="-E 4:2"
+                ;;
+        flows)
+                args="-P 4"
+                ;;
+        esac
+
+        capture first "$TMP/one.bin" "$args" &&
+                capture two "$TMP/two.bin" "$args"
+        if [ $? != 0 ]; then
+                echo "$mode: the client failed"
+                cat "$TMP/client.log"
+                failed=1
+                continue
+        fi
+        run "$mode, two runs" "${args/-P 4/}" two
+        run "$mode, one run twice" "${args/-P 4/}" first
+done
+
+exit $failed